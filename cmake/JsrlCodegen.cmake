@@ -0,0 +1,49 @@
+# jsrl_generate_parser(<target>
+#     NAME <struct name>
+#     INPUT <schema or example file>
+#     [EXAMPLE]
+#     [NAMESPACE <namespace>]
+#     [OUTPUT <header file>])
+#
+# Runs jsrl_codegen on INPUT at build time, producing a header that
+# defines struct NAME with specialized encode/decode (see jsrl_fields.hpp).
+# The header (by default <NAME>.hpp in a directory of the target's binary
+# dir) is added to <target>'s sources and include path.
+# jsrl_codegen is only built (and installed) with JSRL_BUILD_TOOLS.
+function(jsrl_generate_parser target)
+    cmake_parse_arguments(ARG "EXAMPLE" "NAME;INPUT;NAMESPACE;OUTPUT" "" ${ARGN})
+    if(NOT ARG_NAME OR NOT ARG_INPUT)
+        message(FATAL_ERROR "jsrl_generate_parser: NAME and INPUT are required")
+    endif()
+    if(NOT TARGET jsrl::jsrl_codegen)
+        message(FATAL_ERROR "jsrl_generate_parser: jsrl::jsrl_codegen is not "
+            "available; build jsrl with JSRL_BUILD_TOOLS=ON")
+    endif()
+    get_filename_component(input "${ARG_INPUT}" ABSOLUTE)
+    if(ARG_OUTPUT)
+        get_filename_component(output "${ARG_OUTPUT}" ABSOLUTE
+            BASE_DIR "${CMAKE_CURRENT_BINARY_DIR}")
+    else()
+        set(output "${CMAKE_CURRENT_BINARY_DIR}/${target}_jsrl/${ARG_NAME}.hpp")
+    endif()
+    get_filename_component(output_dir "${output}" DIRECTORY)
+
+    set(flags)
+    if(ARG_EXAMPLE)
+        list(APPEND flags --example)
+    endif()
+    if(ARG_NAMESPACE)
+        list(APPEND flags --namespace ${ARG_NAMESPACE})
+    endif()
+
+    add_custom_command(
+        OUTPUT "${output}"
+        COMMAND ${CMAKE_COMMAND} -E make_directory "${output_dir}"
+        COMMAND jsrl::jsrl_codegen ${flags} ${ARG_NAME} "${input}" "${output}"
+        DEPENDS "${input}" jsrl::jsrl_codegen
+        COMMENT "Generating JSON parser ${ARG_NAME} from ${ARG_INPUT}"
+        VERBATIM
+    )
+    target_sources(${target} PRIVATE "${output}")
+    target_include_directories(${target} PRIVATE "${output_dir}")
+endfunction()
@@ -20,9 +20,13 @@
 #include <exception>
 #include <limits>
 #include <cctype>
+#include <charconv>
+#include <cstdlib>
 #include <cassert>
 #include <cstdio>
 #include <cmath>
+#include <mutex>
+#include <type_traits>
 #include <stdint.h>
 
 namespace jsrl {
@@ -44,6 +48,8 @@ namespace jsrl {
     using std::isnan;
     using std::shared_ptr;
     using std::make_shared;
+    using std::once_flag;
+    using std::call_once;
 
 
     Json::Error::~Error() noexcept = default;
@@ -137,6 +143,14 @@ namespace jsrl {
         int p_compare( ElementBase const &rhs) const noexcept {
             return v_compare( rhs );
         }
+        /*! @brief  The element that actually holds this element's value.
+         *
+         *  Deferred elements (such as lazily converted numbers)
+         *  return the element they convert to; all others return themselves.
+         */
+        ElementBase const &resolved() const {
+            return v_resolved();
+        }
     protected:
         static
         void s_write(
@@ -163,6 +177,10 @@ namespace jsrl {
     private:
         virtual void v_write( ostream &, EncodeOptions ) const = 0;
 
+        virtual ElementBase const &v_resolved() const {
+            return *this;
+        }
+
         virtual
         int v_compare( ElementBase const &rhs ) const noexcept = 0;
 
@@ -206,10 +224,21 @@ namespace jsrl {
     };
     struct internal_grant {
         using ElementBase = Json::ElementBase;
+        using ElementBasePtr = Json::ElementBasePtr;
         static
         int compare( Json lhs, Json rhs ) noexcept {
             return Json::s_compare( std::move(lhs), std::move(rhs) );
         }
+        static
+        ElementBasePtr const &element( Json const &json ) noexcept {
+            return json.m_el;
+        }
+        static
+        Json make( ElementBasePtr el ) noexcept {
+            Json result;
+            result.m_el = std::move(el);
+            return result;
+        }
     };
     using ElementBase = internal_grant::ElementBase;
 
@@ -408,6 +437,8 @@ namespace jsrl {
         template<typename N>
         static
         int s_compare_helper( N const &n, ElementBase const &rhs ) {
+            // A deferred rhs answers these without converting
+            // (bar a general number, which converts as any would).
             switch ( rhs.get_typetag( true ) ) {
             case Json::TT_NUMBER_INTEGER_UNSIGNED:
                 return json_number_compare(n, rhs.as_number_uint());
@@ -609,11 +640,142 @@ namespace jsrl {
         GeneralNumber m_value;
     };
     GeneralNumber const &ElementBase::downcast_as_number_general() const {
-        assert( dynamic_cast<JSONElementNumberGeneral const*>(this) );
-        return static_cast<JSONElementNumberGeneral const*>(this)
+        ElementBase const &self = resolved();
+        assert( dynamic_cast<JSONElementNumberGeneral const*>(&self) );
+        return static_cast<JSONElementNumberGeneral const*>(&self)
                 ->as_number_general();
     }
 
+    namespace {
+        Json make_number_json(
+                GeneralNumber const &n,
+                Json::ParseOptions const &parse_options
+                ) {
+            if ( n.is_long_long_unsigned() ) {
+                return Json( n.as_long_long_unsigned() );
+            } else if ( n.is_long_long() ) {
+                return Json( n.as_long_long() );
+            } else if ( parse_options.use_GN_for_floats ) {
+                return Json( n );
+            } else {
+                size_t const sigdigs = n.digits().size();
+                return Json( n.as_long_double(), sigdigs ? sigdigs : 1 );
+            }
+        }
+    }
+
+    // A number kept as its source text.
+    // The typetag is decided up front from the text alone;
+    // integers and doubles are read straight from the text when asked for,
+    // and the full conversion (the element the eager parser would have
+    // built) is done at most once, when anything else needs it.
+    struct JSONElementNumberLazy : JSONElementNumberCommon {
+        JSONElementNumberLazy(
+                string text,
+                NumberTextClass text_class,
+                bool use_GN_for_floats
+                )
+            : m_text( std::move(text) )
+            , m_use_GN_for_floats( use_GN_for_floats )
+            , m_typetag( s_typetag( text_class, use_GN_for_floats ) )
+        { }
+    private:
+        static
+        TypeTag s_typetag( NumberTextClass text_class, bool use_GN_for_floats ) {
+            switch ( text_class ) {
+            case NTC_UNSIGNED:
+                return Json::TT_NUMBER_INTEGER_UNSIGNED;
+            case NTC_SIGNED:
+                return Json::TT_NUMBER_INTEGER;
+            default:
+                return use_GN_for_floats
+                        ? Json::TT_NUMBER_GENERAL
+                        : Json::TT_NUMBER
+                        ;
+            }
+        }
+        shared_ptr<ElementBase const> const &p_resolved_ptr() const {
+            call_once( m_once, [this] {
+                m_resolved = make_number_json(
+                        GeneralNumber::parse( m_text ),
+                        Json::ParseOptions( m_use_GN_for_floats ) );
+            } );
+            return internal_grant::element( m_resolved );
+        }
+        ElementBase const &v_resolved() const override {
+            return *p_resolved_ptr();
+        }
+        TypeTag v_get_typetag() const noexcept override {
+            return m_typetag;
+        }
+        // The value of the text, read without converting the whole number
+        // (so without allocating, and so fit for comparisons,
+        // which mustn't throw).  The text was checked when parsed.
+        template<typename I>
+        I p_integer() const noexcept {
+            char const *first = m_text.data();
+            if ( std::is_unsigned<I>::value and *first == '-' )
+                ++first;    // "-0"
+            I value = 0;
+            std::from_chars( first, m_text.data() + m_text.size(), value );
+            return value;
+        }
+        long double p_float() const noexcept {
+            return std::strtold( m_text.c_str(), nullptr );
+        }
+        long double v_as_number_float() const override {
+            if ( m_typetag == Json::TT_NUMBER )
+                return p_float();
+            return v_resolved().as_number_float();
+        }
+        shared_ptr<GeneralNumber const> v_as_number_general(
+                shared_ptr<ElementBase const> const &
+                ) const override {
+            auto const &resolved = p_resolved_ptr();
+            return resolved->as_number_general( resolved );
+        }
+        long long v_as_number_sint() const override {
+            if ( m_typetag == Json::TT_NUMBER_INTEGER )
+                return p_integer<long long>();
+            return v_resolved().as_number_sint();
+        }
+        long long unsigned v_as_number_uint() const override {
+            if ( m_typetag == Json::TT_NUMBER_INTEGER_UNSIGNED )
+                return p_integer<long long unsigned>();
+            return v_resolved().as_number_uint();
+        }
+        void v_write(
+                ostream &ost,
+                EncodeOptions encode_options
+                ) const override {
+            if ( encode_options.tightness == EncodeOptions::TN_EXACT ) {
+                ost.write( m_text.data(), streamsize( m_text.size() ) );
+            } else {
+                v_resolved().write( ost, encode_options );
+            }
+        }
+
+        int v_compare( ElementBase const &rhs ) const noexcept override {
+            switch ( m_typetag ) {
+            case Json::TT_NUMBER_INTEGER_UNSIGNED:
+                return s_compare_helper(
+                        p_integer<long long unsigned>(), rhs );
+            case Json::TT_NUMBER_INTEGER:
+                return s_compare_helper( p_integer<long long>(), rhs );
+            case Json::TT_NUMBER:
+                return s_compare_helper( p_float(), rhs );
+            default:
+                return s_compare_helper( downcast_as_number_general(), rhs );
+            }
+        }
+
+        string const m_text;
+        bool const m_use_GN_for_floats;
+        TypeTag const m_typetag;
+        mutable once_flag m_once;
+        mutable Json m_resolved;
+    };
+
     Json::EncodeError::~EncodeError() noexcept = default;
 
     Json::EncodeError::EncodeError( string const &message )
@@ -656,6 +818,30 @@ namespace jsrl {
             FormatHexStream fhs( ost, 4 );
             ost << codeunit;
         }
+        // Minimal output target for writing JSON text straight into a string.
+        struct StringAppender {
+            string &out;
+
+            StringAppender &operator<<( char c ) {
+                out.push_back( c );
+                return *this;
+            }
+            StringAppender &operator<<( char const *s ) {
+                out.append( s );
+                return *this;
+            }
+        };
+        void write_codeunit( StringAppender &ost, uint16_t codeunit) {
+            static char const hex_digits[] = "0123456789abcdef";
+            char const escape[] = {
+                '\\', 'u',
+                hex_digits[ ( codeunit >> 12 ) & 0xF ],
+                hex_digits[ ( codeunit >> 8 ) & 0xF ],
+                hex_digits[ ( codeunit >> 4 ) & 0xF ],
+                hex_digits[ codeunit & 0xF ],
+            };
+            ost.out.append( escape, sizeof escape );
+        }
         inline
         bool byte_is_utf8_continuation( uint8_t byte ) {
             return (byte & 0xC0) == 0x80;
@@ -735,9 +921,9 @@ namespace jsrl {
                 return 0xFFFD;
             }
         }
-        template<bool WRITE_UTF, typename STRINGISH>
+        template<bool WRITE_UTF, typename OST, typename STRINGISH>
         void write_JSON_string_UTF(
-                ostream &ost,
+                OST &ost,
                 STRINGISH const &value,
                 bool fail_bad_utf8
                 ) {
@@ -830,6 +1016,19 @@ namespace jsrl {
             return write_JSON_string_UTF<false>( ost, value, fail_bad_utf8 );
     }
 
+    void Json::append_JSON_string(
+            string &out,
+            string_view value,
+            bool fail_bad_utf8,
+            bool write_utf
+            ) {
+        StringAppender ost{ out };
+        if ( write_utf )
+            return write_JSON_string_UTF<true>( ost, value, fail_bad_utf8 );
+        else
+            return write_JSON_string_UTF<false>( ost, value, fail_bad_utf8 );
+    }
+
     struct JSONElementString : ElementBase {
         JSONElementString( string value )
             : m_value( std::move(value) )
@@ -1409,10 +1608,29 @@ namespace jsrl {
 
     namespace {
 
+        // State shared by the recursive-descent reader functions.
+        struct ParseContext {
+            explicit
+            ParseContext(
+                    Json::ParseOptions const &parse_options,
+                    jsrl_streambuf *span_source = nullptr,
+                    ParseSpanSink *spans = nullptr
+                    )
+                : options( parse_options )
+                , span_source( span_source )
+                , spans( spans )
+            { }
+
+            StringPackager sp;
+            Json::ParseOptions const options;
+            // Both set when element spans are being recorded:
+            jsrl_streambuf *const span_source;
+            ParseSpanSink *const spans;
+        };
+
         Json read_internal_json(
                 streambuf &sbuf,
-                StringPackager &sp,
-                bool use_GN_for_floats
+                ParseContext &ctx
                 );
 
         char get_separator_byte( streambuf &sbuf, bool eof_okay ) {
@@ -1462,23 +1680,21 @@ namespace jsrl {
         Json read_number_element(
                 streambuf &sbuf,
                 char firstchar,
-                bool use_GN_for_floats
+                Json::ParseOptions const &parse_options
                 ) {
             try {
                 sbuf.sputbackc(firstchar);
-                GeneralNumber n = GeneralNumber::parse( sbuf );
-                if ( n.is_long_long_unsigned() ) {
-                    return Json( n.as_long_long_unsigned() );
-                } else if ( n.is_long_long() ) {
-                    return Json( n.as_long_long() );
-                } else {
-                    if ( use_GN_for_floats ) {
-                        return Json( n );
-                    } else {
-                        size_t const sigdigs = n.digits().size();
-                        return Json( n.as_long_double(), sigdigs ? sigdigs : 1 );
-                    }
+                if ( parse_options.lazy_numbers ) {
+                    string text;
+                    NumberTextClass const text_class
+                            = read_json_number_text( sbuf, text );
+                    return internal_grant::make(
+                            make_shared<JSONElementNumberLazy>(
+                                std::move(text), text_class,
+                                parse_options.use_GN_for_floats ) );
                 }
+                return make_number_json(
+                        GeneralNumber::parse( sbuf ), parse_options );
             } catch ( GeneralNumber::BadEOFParseError const &e ) {
                 throw BadEOFParseError( e.what() );
             } catch ( GeneralNumber::NumberParseError const &e ) {
@@ -1491,8 +1707,7 @@ namespace jsrl {
         }
         Json read_array(
                 streambuf &sbuf,
-                StringPackager &sp,
-                bool use_GN_for_floats
+                ParseContext &ctx
                 ) {
             Json::ArrayBody items;
 
@@ -1500,7 +1715,7 @@ namespace jsrl {
                 sbuf.sungetc();
                 for (;;) {
                     Json element
-                            = read_internal_json( sbuf, sp, use_GN_for_floats );
+                            = read_internal_json( sbuf, ctx );
                     items.push_back( element );
                     char c = get_separator_byte(sbuf, false);
                     switch (c) {
@@ -1533,14 +1748,13 @@ namespace jsrl {
         }
         Json read_object(
                 streambuf &sbuf,
-                StringPackager &sp,
-                bool use_GN_for_floats
+                ParseContext &ctx
                 ) {
             Json::ObjectBody object;
             if ( get_separator_byte(sbuf, false) != '}' ) {
                 sbuf.sungetc();
                 for (;;) {
-                    string key = read_object_key( sbuf, sp );
+                    string key = read_object_key( sbuf, ctx.sp );
                     char c = get_separator_byte(sbuf, false);
                     if ( ':' != c ) {
                         sbuf.sungetc();
@@ -1548,7 +1762,7 @@ namespace jsrl {
                                 "Missing separator for object key", c );
                     }
                     Json element
-                            = read_internal_json( sbuf, sp, use_GN_for_floats );
+                            = read_internal_json( sbuf, ctx );
                     insert( object, std::move(key), std::move(element) );
 
                     switch ( c = get_separator_byte(sbuf, false) ) {
@@ -1566,23 +1780,22 @@ namespace jsrl {
             }
             return Json( std::move(object) );
         }
-        Json read_json(
+        Json read_json_element(
                 streambuf &sbuf,
-                StringPackager &sp,
-                bool use_GN_for_floats
+                ParseContext &ctx,
+                char byte
                 ) {
-            char byte = get_separator_byte(sbuf, true);
             switch ( byte ) {
-            case '"': return read_string_element( sbuf, sp );
-            case '[': return read_array( sbuf, sp, use_GN_for_floats );
-            case '{': return read_object( sbuf, sp, use_GN_for_floats );
+            case '"': return read_string_element( sbuf, ctx.sp );
+            case '[': return read_array( sbuf, ctx );
+            case '{': return read_object( sbuf, ctx );
             case 'n': eat_word_rmdr(sbuf, "null" ); return Json();
             case 'f': eat_word_rmdr(sbuf, "false"); return Json(false);
             case 't': eat_word_rmdr(sbuf, "true" ); return Json(true);
-            case '-': return read_number_element(sbuf, byte, use_GN_for_floats);
+            case '-': return read_number_element(sbuf, byte, ctx.options);
             default:
                 if ( isdigit( byte ) ) {
-                    return read_number_element( sbuf, byte, use_GN_for_floats );
+                    return read_number_element( sbuf, byte, ctx.options );
                 } else {
                     sbuf.sungetc();
                     throw UnexpectedByteParseError(
@@ -1591,28 +1804,47 @@ namespace jsrl {
                 }
             }
         }
+        Json read_json(
+                streambuf &sbuf,
+                ParseContext &ctx
+                ) {
+            char byte = get_separator_byte(sbuf, true);
+            if ( not ctx.spans )
+                return read_json_element( sbuf, ctx, byte );
+            assert( &sbuf == ctx.span_source );
+            size_t const begin = ctx.span_source->position() - 1;
+            Json element = read_json_element( sbuf, ctx, byte );
+            if ( element.is_null() ) {
+                // The shared null instance has no single location;
+                // give each parsed null its own identity instead.
+                element = internal_grant::make(
+                        make_shared<JSONElementNull const>() );
+            }
+            ctx.spans->element_span(
+                    element, begin, ctx.span_source->position() );
+            return element;
+        }
         Json read_internal_json(
                 streambuf &sbuf,
-                StringPackager &sp,
-                bool use_GN_for_floats
+                ParseContext &ctx
                 ) {
             try {
-                return read_json( sbuf, sp, use_GN_for_floats );
+                return read_json( sbuf, ctx );
             } catch ( StartEOFParseError const &e ) {
                 throw BadEOFParseError( e );
             }
         }
     }
 
-    Json Json::parse( streambuf &sbuf, bool use_GN_for_floats ) {
-        StringPackager sp;
-        return read_json( sbuf, sp, use_GN_for_floats );
+    Json Json::parse( streambuf &sbuf, ParseOptions parse_options ) {
+        ParseContext ctx( parse_options );
+        return read_json( sbuf, ctx );
     }
 
     namespace {
-        Json context_parse( jsrl_streambuf &sbuf ) {
+        Json context_parse( jsrl_streambuf &sbuf, ParseContext &ctx ) {
             try {
-                auto result = Json::parse( sbuf );
+                auto result = read_json( sbuf, ctx );
                 int byte = jsrl_get_nonspace_byte( sbuf );
                 if ( byte != EOF ) {
                     sbuf.sungetc();
@@ -1630,13 +1862,29 @@ namespace jsrl {
             }
         }
     }
-    Json Json::parse( char const *start, char const *finish ) {
+    Json Json::parse(
+            char const *start,
+            char const *finish,
+            ParseOptions parse_options
+            ) {
         jsrl_streambuf sbuf( start, finish );
-        return context_parse( sbuf );
+        ParseContext ctx( parse_options );
+        return context_parse( sbuf, ctx );
     }
-    Json Json::parse( string_view str ) {
+    Json Json::parse( string_view str, ParseOptions parse_options ) {
         char const *const s = str.data();
-        return parse( s, s+str.size() );
+        return parse( s, s+str.size(), parse_options );
+    }
+
+    Json parse_json_with_spans(
+            char const *start,
+            char const *finish,
+            Json::ParseOptions const &parse_options,
+            ParseSpanSink &spans
+            ) {
+        jsrl_streambuf sbuf( start, finish );
+        ParseContext ctx( parse_options, &sbuf, &spans );
+        return context_parse( sbuf, ctx );
     }
 
     string encode( Json const &json ) {
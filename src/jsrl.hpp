@@ -548,6 +548,16 @@ namespace jsrl {
          */
         ObjectPtr as_object_ptr() const;
 
+        /*! @brief  Identity of the shared entity this handle refers to.
+         *
+         *  Handles copied from one another share an identity.
+         *  Since entities are immutable, equal identities imply equal values
+         *  (but equal values may well have different identities).
+         */
+        void const *identity() const noexcept {
+            return m_el.get();
+        }
+
         size_t size() const;    /*!< @brief Query array length. */
         /*! @brief  Test for an array element. */
         Json const *find_key( size_t index ) const;
@@ -632,6 +642,18 @@ namespace jsrl {
             return write_JSON_string( ost, string_view( value ),
                     fail_bad_utf8, write_utf );
         }
+        /*! @brief  Append string data in JSON syntax to a string.
+         *
+         *  The output is the same as @ref write_JSON_string,
+         *  without going through a stream.
+         */
+        static
+        void append_JSON_string(
+                string &out,
+                string_view value,
+                bool fail_bad_utf8 = false,
+                bool write_utf = false
+                );
 
         struct EncodeOptions {
             enum Tightness {
@@ -785,9 +807,18 @@ namespace jsrl {
 
         struct ParseOptions {
             bool use_GN_for_floats;
+            /*! @brief  Keep numbers as source text until first access.
+             *
+             *  Each number stores a copy of its source bytes
+             *  and a cheap integer/float classification;
+             *  conversion happens (once) when the value is examined.
+             *  Numbers encoded with @c TN_EXACT are written verbatim.
+             */
+            bool lazy_numbers;
 
-            ParseOptions( bool use_GN_for_floats )
+            ParseOptions( bool use_GN_for_floats, bool lazy_numbers = false )
                 : use_GN_for_floats(use_GN_for_floats)
+                , lazy_numbers(lazy_numbers)
             { }
         };
 
@@ -822,12 +853,12 @@ namespace jsrl {
             }
 
             friend OptionedParse use_GN_for_floats( OptionedParse );
+            friend OptionedParse lazy_numbers( OptionedParse );
 
         private:
 
             void p_parse( istream &is ) const {
-                p_stream_extract( is, *m_target,
-                        m_parse_options.use_GN_for_floats );
+                p_stream_extract( is, *m_target, m_parse_options );
             }
 
             Json *m_target;
@@ -840,6 +871,12 @@ namespace jsrl {
             op.m_parse_options.use_GN_for_floats = true;
             return op;
         }
+        /*! @brief  Wrap JSON value in a proxy to defer number conversion.
+         */
+        friend OptionedParse lazy_numbers( OptionedParse op ) {
+            op.m_parse_options.lazy_numbers = true;
+            return op;
+        }
 
         /*! @brief  Stream extraction (parsing) for JSON.
          *
@@ -853,27 +890,49 @@ namespace jsrl {
          */
         template<typename IST>
         friend IST &operator>>( IST &is, Json &el ) {
-            return p_stream_extract( is, el, false );
+            return p_stream_extract( is, el, ParseOptions(false) );
         }
 
         /*! @brief  Parse the given character range into Json.
          */
         static
-        Json parse( char const *start, char const *finish );
+        Json parse( char const *start, char const *finish ) {
+            return parse( start, finish, ParseOptions(false) );
+        }
+        /*! @brief  Parse the given character range into Json.
+         */
+        static
+        Json parse(
+                char const *start,
+                char const *finish,
+                ParseOptions parse_options
+                );
+        /*! @brief  Parse the given string or string_view into Json.
+         */
+        static
+        Json parse( string_view str ) {
+            return parse( str, ParseOptions(false) );
+        }
         /*! @brief  Parse the given string or string_view into Json.
          */
         static
-        Json parse( string_view str );
+        Json parse( string_view str, ParseOptions parse_options );
         /*! @brief  Parse JSON from a streambuf object.
          */
         static
         Json parse( streambuf &sbuf ) {
-            return parse( sbuf, false );
+            return parse( sbuf, ParseOptions(false) );
         }
         /*! @brief  Parse JSON from a streambuf object.
          */
         static
-        Json parse( streambuf &sbuf, bool use_GN_for_floats );
+        Json parse( streambuf &sbuf, bool use_GN_for_floats ) {
+            return parse( sbuf, ParseOptions(use_GN_for_floats) );
+        }
+        /*! @brief  Parse JSON from a streambuf object.
+         */
+        static
+        Json parse( streambuf &sbuf, ParseOptions parse_options );
 
         /*! @brief  Encode the Json object as a string.
          */
@@ -913,7 +972,7 @@ namespace jsrl {
 
         template<typename IST>
         static
-        IST &p_stream_extract( IST &is, Json &el, bool use_GN_for_floats );
+        IST &p_stream_extract( IST &is, Json &el, ParseOptions parse_options );
 
         static
         void p_set_elem( ObjectBody &as_obj, string key, Json value ) {
@@ -1091,9 +1150,13 @@ namespace jsrl {
     };
 
     template<typename IST>
-    IST &Json::p_stream_extract( IST &is, Json &el, bool use_GN_for_floats ) {
+    IST &Json::p_stream_extract(
+            IST &is,
+            Json &el,
+            ParseOptions parse_options
+            ) {
         try {
-            el = parse( *is.rdbuf(), use_GN_for_floats );
+            el = parse( *is.rdbuf(), parse_options );
         } catch ( Error const & ) {
             try {
                 is.setstate( ios_base::failbit );
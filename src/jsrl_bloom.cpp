@@ -0,0 +1,242 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#include "jsrl_bloom.hpp"
+#include "jsrl_impl_util.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace jsrl {
+
+    namespace {
+        char const index_magic[8] = { 'J', 'S', 'R', 'L', 'B', 'L', 'M', '2' };
+        unsigned const max_hashes = 24;
+
+        uint64_t get_varint( std::istream &in ) {
+            uint64_t value;
+            if ( not read_varint( in, value ) )
+                throw NdjsonIndexError( "Truncated Bloom filter index" );
+            return value;
+        }
+
+        // Bit i of a value's filter bits, by double hashing.
+        uint64_t bit_number( uint64_t hash, unsigned i, uint64_t bits ) {
+            uint64_t const step = ( ( hash << 32 ) | ( hash >> 32 ) ) | 1;
+            return ( hash + i * step ) % bits;
+        }
+    }
+
+    NdjsonBloomIndex NdjsonBloomIndex::s_build(
+            streambuf &input,
+            std::vector<JsonPointer> paths,
+            uint64_t block_records,
+            double false_positive_rate
+            )
+    {
+        NdjsonBloomIndex index;
+        index.m_paths = std::move( paths );
+        block_records = std::max<uint64_t>( block_records, 1 );
+        double const rate = std::min( std::max( false_positive_rate, 1e-9 ), 0.5 );
+        double const ln2 = std::log( 2.0 );
+
+        std::vector<uint64_t> path_hashes;
+        for ( auto &&path : index.m_paths )
+            path_hashes.push_back( hash_bytes( path.to_string() ) );
+        std::vector<uint64_t> pending;
+        uint64_t in_block = 0;
+        auto const flush = [&]() {
+            std::sort( pending.begin(), pending.end() );
+            pending.erase( std::unique( pending.begin(), pending.end() ),
+                    pending.end() );
+            // Size each filter for the values its block actually holds.
+            double const values = double( std::max<size_t>( pending.size(), 1 ) );
+            double const bits = std::ceil( -values * std::log( rate ) / ( ln2 * ln2 ) );
+            Filter filter;
+            filter.first_word = index.m_bits.size();
+            filter.words = std::max<size_t>( 1, size_t( ( bits + 63 ) / 64 ) );
+            filter.hashes = unsigned( std::lround( filter.words * 64 / values * ln2 ) );
+            filter.hashes = std::min( std::max( filter.hashes, 1u ), max_hashes );
+            index.m_bits.resize( index.m_bits.size() + filter.words );
+            uint64_t *const words = &index.m_bits[filter.first_word];
+            for ( uint64_t hash : pending ) {
+                for ( unsigned i = 0; i != filter.hashes; ++i ) {
+                    uint64_t const bit = bit_number( hash, i, filter.words * 64 );
+                    words[bit / 64] |= uint64_t( 1 ) << ( bit % 64 );
+                }
+            }
+            index.m_blocks.push_back( filter );
+            pending.clear();
+            in_block = 0;
+        };
+
+        index.m_offsets = NdjsonIndex::s_build( input, block_records,
+                [&]( string_view text ) {
+                    Json const record = Json::parse( text );
+                    for ( size_t i = 0; i != index.m_paths.size(); ++i ) {
+                        Json const *const value = index.m_paths[i].find( record );
+                        if ( value ) {
+                            pending.push_back(
+                                    path_hashes[i] ^ json_value_hash( *value ) );
+                        }
+                    }
+                    if ( ++in_block == block_records )
+                        flush();
+                } );
+        if ( in_block )
+            flush();
+        return index;
+    }
+
+    void NdjsonBloomIndex::save( std::ostream &output ) const
+    {
+        output.write( index_magic, sizeof index_magic );
+        m_offsets.save( output );
+        write_varint( output, m_paths.size() );
+        for ( auto &&path : m_paths ) {
+            string const text = path.to_string();
+            write_varint( output, text.size() );
+            output.write( text.data(), std::streamsize( text.size() ) );
+        }
+        write_varint( output, m_blocks.size() );
+        for ( auto &&filter : m_blocks ) {
+            write_varint( output, filter.hashes );
+            write_varint( output, filter.words );
+            for ( size_t w = 0; w != filter.words; ++w ) {
+                uint64_t const word = m_bits[filter.first_word + w];
+                for ( unsigned shift = 0; shift != 64; shift += 8 )
+                    output.put( char( ( word >> shift ) & 0xFF ) );
+            }
+        }
+    }
+
+    NdjsonBloomIndex NdjsonBloomIndex::s_load( std::istream &input )
+    {
+        char magic[sizeof index_magic];
+        if ( not input.read( magic, sizeof magic )
+                || not std::equal( magic, magic + sizeof magic, index_magic ) )
+            throw NdjsonIndexError( "Not a Bloom filter index" );
+        NdjsonBloomIndex index;
+        index.m_offsets = NdjsonIndex::s_load( input );
+        uint64_t const paths = get_varint( input );
+        for ( uint64_t i = 0; i != paths; ++i ) {
+            string text( size_t( get_varint( input ) ), '\0' );
+            if ( not input.read( &text[0], std::streamsize( text.size() ) ) )
+                throw NdjsonIndexError( "Truncated Bloom filter index" );
+            try {
+                index.m_paths.emplace_back( text );
+            } catch ( JsonPointerError const & ) {
+                throw NdjsonIndexError( "Bad path in Bloom filter index" );
+            }
+        }
+        uint64_t const blocks = get_varint( input );
+        uint64_t const every = index.m_offsets.sample_every();
+        if ( blocks != ( index.m_offsets.records() + every - 1 ) / every )
+            throw NdjsonIndexError( "Wrong block count in Bloom filter index" );
+        for ( uint64_t b = 0; b != blocks; ++b ) {
+            Filter filter;
+            filter.hashes = unsigned( get_varint( input ) );
+            filter.words = size_t( get_varint( input ) );
+            filter.first_word = index.m_bits.size();
+            if ( filter.hashes == 0 || filter.hashes > max_hashes || filter.words == 0 )
+                throw NdjsonIndexError( "Bad filter in Bloom filter index" );
+            for ( size_t w = 0; w != filter.words; ++w ) {
+                char bytes[8];
+                if ( not input.read( bytes, sizeof bytes ) )
+                    throw NdjsonIndexError( "Truncated Bloom filter index" );
+                uint64_t word = 0;
+                for ( unsigned i = 0; i != 8; ++i )
+                    word |= uint64_t( static_cast<unsigned char>( bytes[i] ) ) << ( 8 * i );
+                index.m_bits.push_back( word );
+            }
+            index.m_blocks.push_back( filter );
+        }
+        return index;
+    }
+
+    uint64_t NdjsonBloomIndex::p_hash( JsonPointer const &path, Json const &value ) const
+    {
+        if ( std::find( m_paths.begin(), m_paths.end(), path ) == m_paths.end() )
+            throw NdjsonIndexError( "Path " + path.to_string() + " isn't indexed" );
+        return hash_bytes( path.to_string() ) ^ json_value_hash( value );
+    }
+
+    bool NdjsonBloomIndex::p_test( Filter const &filter, uint64_t hash ) const
+    {
+        uint64_t const *const words = &m_bits[filter.first_word];
+        for ( unsigned i = 0; i != filter.hashes; ++i ) {
+            uint64_t const bit = bit_number( hash, i, filter.words * 64 );
+            if ( not ( words[bit / 64] & ( uint64_t( 1 ) << ( bit % 64 ) ) ) )
+                return false;
+        }
+        return true;
+    }
+
+    bool NdjsonBloomIndex::may_contain(
+            uint64_t block,
+            JsonPointer const &path,
+            Json const &value
+            ) const
+    {
+        if ( block >= m_blocks.size() )
+            throw Json::ArrayKeyError( size_t( block ), m_blocks.size() );
+        return p_test( m_blocks[ size_t( block ) ], p_hash( path, value ) );
+    }
+
+    std::vector<NdjsonRange> NdjsonBloomIndex::candidates(
+            JsonPointer const &path,
+            Json const &value
+            ) const
+    {
+        uint64_t const hash = p_hash( path, value );
+        uint64_t const every = m_offsets.sample_every();
+        std::vector<NdjsonRange> ranges;
+        for ( size_t b = 0; b != m_blocks.size(); ++b ) {
+            if ( not p_test( m_blocks[b], hash ) )
+                continue;
+            uint64_t const first = b * every;
+            uint64_t const records = std::min( every, m_offsets.records() - first );
+            auto const position = m_offsets.locate( first );
+            if ( not ranges.empty() && ranges.back().end == position.offset ) {
+                ranges.back().end = position.end;
+                ranges.back().records += records;
+            } else {
+                ranges.push_back( NdjsonRange{
+                        position.offset, position.end, first, records } );
+            }
+        }
+        return ranges;
+    }
+
+    std::vector<string> NdjsonBloomIndex::find(
+            NdjsonFile const &file,
+            JsonPointer const &path,
+            Json const &value
+            ) const
+    {
+        std::vector<string> found;
+        string block;
+        for ( auto &&range : candidates( path, value ) ) {
+            file.read( range.begin, range.end, block );
+            NdjsonReader records{ string_view( block ) };
+            string_view text;
+            while ( records.next( text ) ) {
+                Json const record = Json::parse( text );
+                Json const *const at = path.find( record );
+                if ( at && json_value_compare( *at, value ) == 0 )
+                    found.emplace_back( text );
+            }
+        }
+        return found;
+    }
+
+}
+// vi: et ts=4 sts=4 sw=4
@@ -0,0 +1,145 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#ifndef JSRL_BLOOM_HPP_A41C7E96D3B05F28E7A9C1D4B6F02E83
+#define JSRL_BLOOM_HPP_A41C7E96D3B05F28E7A9C1D4B6F02E83
+
+#include "jsrl.hpp"
+#include "jsrl_ndjson.hpp"
+#include "jsrl_pointer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+/*! @file jsrl_bloom.hpp
+ *  @brief Bloom filters over the values of NDJSON records.
+ */
+namespace jsrl {
+    using std::size_t;
+    using std::streambuf;
+    using std::string;
+    using std::uint64_t;
+
+    /*! @brief  Per-block Bloom filters over the values at chosen paths
+     *          of an NDJSON file.
+     *
+     *  The file is cut into blocks of a fixed number of records,
+     *  and each block gets a filter holding the values
+     *  found at the indexed paths in its records.
+     *  A search for one value then reads and parses only the blocks
+     *  whose filter may hold it:
+     *  no block holding the value is ever passed over,
+     *  and other blocks are read only at about the false positive rate.
+     *
+     *  Values are hashed and compared as @ref json_value_compare does,
+     *  so @c 1, @c 1.0 and @c 1e0 are the same value.
+     *  The blocks are located with an @ref NdjsonIndex
+     *  built in the same pass, sampling each block's first record.
+     *
+     *  Example:
+     *  @code
+     *      std::ifstream archive( path, std::ios::binary );
+     *      auto bloom = NdjsonBloomIndex::s_build( *archive.rdbuf(),
+     *              { JsonPointer( "/user_id" ) } );
+     *      NdjsonFile file( path );
+     *      for ( auto &&record : bloom.find( file,
+     *                  JsonPointer( "/user_id" ), Json( "u-1234" ) ) )
+     *          ...
+     *  @endcode
+     */
+    struct NdjsonBloomIndex {
+        /*! @brief  Empty index. */
+        NdjsonBloomIndex() = default;
+
+        /*! @brief  Index NDJSON input.
+         *
+         *  Records without a value at a path add nothing for it.
+         *
+         *  @throw Json::ParseError A record isn't valid JSON.
+         */
+        static
+        NdjsonBloomIndex s_build(
+                streambuf &input,
+                std::vector<JsonPointer> paths,
+                uint64_t block_records = 4096,
+                double false_positive_rate = 0.01
+                );
+
+        /*! @brief  Read an index written by @ref save.
+         *
+         *  @throw NdjsonIndexError The input isn't a valid index.
+         */
+        static
+        NdjsonBloomIndex s_load( std::istream &input );
+        /*! @brief  Write the index in its compact form.
+         */
+        void save( std::ostream &output ) const;
+
+        std::vector<JsonPointer> const &paths() const { return m_paths; }
+        /*! @brief  Offsets of the records, sampled once per block. */
+        NdjsonIndex const &offsets() const { return m_offsets; }
+        uint64_t blocks() const { return m_blocks.size(); }
+
+        /*! @brief  Whether block @c block may hold @c value at @c path.
+         *
+         *  @throw NdjsonIndexError     The path isn't indexed.
+         */
+        bool may_contain(
+                uint64_t block,
+                JsonPointer const &path,
+                Json const &value
+                ) const;
+
+        /*! @brief  The parts of the file that may hold @c value at @c path,
+         *          with adjacent blocks joined.
+         *
+         *  @throw NdjsonIndexError     The path isn't indexed.
+         */
+        std::vector<NdjsonRange> candidates(
+                JsonPointer const &path,
+                Json const &value
+                ) const;
+
+        /*! @brief  The records holding @c value at @c path,
+         *          reading only candidate blocks of @c file.
+         *
+         *  @throw NdjsonIndexError     The path isn't indexed.
+         */
+        std::vector<string> find(
+                NdjsonFile const &file,
+                JsonPointer const &path,
+                Json const &value
+                ) const;
+
+    private:
+        struct Filter {
+            unsigned hashes;        // Bits set per value.
+            size_t first_word;      // Start of the filter's bits in m_bits.
+            size_t words;
+        };
+
+        uint64_t p_hash( JsonPointer const &path, Json const &value ) const;
+        bool p_test( Filter const &filter, uint64_t hash ) const;
+
+        std::vector<JsonPointer> m_paths;
+        NdjsonIndex m_offsets;
+        std::vector<Filter> m_blocks;
+        std::vector<uint64_t> m_bits;
+    };
+
+}
+#endif
+// vi: et ts=4 sts=4 sw=4
@@ -0,0 +1,442 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#include "jsrl_canonical.hpp"
+#include "jsrl_general_number.hpp"
+#include "jsrl_impl_util.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+namespace jsrl {
+    using std::uint32_t;
+    using std::vector;
+
+    namespace {
+        // Collects output in a small buffer, passing it on when full.
+        struct Output {
+            explicit
+            Output( CanonicalSink const &sink )
+                : m_sink( sink )
+            { }
+
+            void put( char c ) {
+                if ( m_used == sizeof m_buffer )
+                    flush();
+                m_buffer[ m_used++ ] = c;
+            }
+
+            void write( string_view text ) {
+                if ( text.size() > sizeof m_buffer - m_used ) {
+                    flush();
+                    if ( text.size() >= sizeof m_buffer ) {
+                        m_sink( text );
+                        return;
+                    }
+                }
+                std::memcpy( m_buffer + m_used, text.data(), text.size() );
+                m_used += text.size();
+            }
+
+            void flush() {
+                if ( m_used )
+                    m_sink( string_view( m_buffer, m_used ) );
+                m_used = 0;
+            }
+
+        private:
+            CanonicalSink const &m_sink;
+            char m_buffer[4096];
+            size_t m_used = 0;
+        };
+
+        double number_value( Json const &number ) {
+            double value;
+            if ( number.is_number_sint() )
+                value = double( number.as_number_sint() );
+            else if ( number.is_number_uint() )
+                value = double( number.as_number_uint() );
+            else if ( number.is_number_general() ) {
+                // Round the digits straight to a double, not by way of long double.
+                std::ostringstream text;
+                text << *number.as_number_general();
+                value = std::strtod( text.str().c_str(), nullptr );
+            } else
+                value = double( number.as_number_float() );
+            if ( not std::isfinite( value ) ) {
+                std::ostringstream message;
+                message << "No canonical encoding for " << number;
+                throw CanonicalError( message.str() );
+            }
+            return value;
+        }
+
+        // ECMAScript's Number.prototype.toString, from the shortest
+        // digits that read back as the same double.
+        void write_number( Output &out, double value ) {
+            if ( value == 0 ) {
+                out.put( '0' );     // Including -0.
+                return;
+            }
+            char scientific[32];
+            auto const end = std::to_chars( scientific, scientific + sizeof scientific,
+                    value, std::chars_format::scientific ).ptr;
+            char const *const e = std::find( scientific, end, 'e' );
+            int const n = std::atoi( string( e + 1, size_t( end - e - 1 ) ).c_str() ) + 1;
+            string digits;
+            for ( char const *c = scientific; c != e; ++c ) {
+                if ( *c >= '0' && *c <= '9' )
+                    digits += *c;
+            }
+            int const k = int( digits.size() );
+
+            if ( value < 0 )
+                out.put( '-' );
+            if ( k <= n && n <= 21 ) {
+                out.write( digits );
+                out.write( string( size_t( n - k ), '0' ) );
+            } else if ( 0 < n && n <= 21 ) {
+                out.write( string_view( digits ).substr( 0, size_t( n ) ) );
+                out.put( '.' );
+                out.write( string_view( digits ).substr( size_t( n ) ) );
+            } else if ( -6 < n && n <= 0 ) {
+                out.write( "0." );
+                out.write( string( size_t( -n ), '0' ) );
+                out.write( digits );
+            } else {
+                out.put( digits[0] );
+                if ( k > 1 ) {
+                    out.put( '.' );
+                    out.write( string_view( digits ).substr( 1 ) );
+                }
+                out.put( 'e' );
+                out.put( n - 1 < 0 ? '-' : '+' );
+                out.write( std::to_string( std::abs( n - 1 ) ) );
+            }
+        }
+
+        void write_string( Output &out, string const &text ) {
+            static char const hex[] = "0123456789abcdef";
+            out.put( '"' );
+            size_t run = 0;     // Start of the text not yet written.
+            for ( size_t i = 0; i != text.size(); ++i ) {
+                unsigned char const c = static_cast<unsigned char>( text[i] );
+                if ( c >= 0x20 && c != '"' && c != '\\' )
+                    continue;
+                out.write( string_view( text ).substr( run, i - run ) );
+                run = i + 1;
+                out.put( '\\' );
+                switch ( c ) {
+                case '"': out.put( '"' ); break;
+                case '\\': out.put( '\\' ); break;
+                case '\b': out.put( 'b' ); break;
+                case '\t': out.put( 't' ); break;
+                case '\n': out.put( 'n' ); break;
+                case '\f': out.put( 'f' ); break;
+                case '\r': out.put( 'r' ); break;
+                default:
+                    out.write( "u00" );
+                    out.put( hex[ c >> 4 ] );
+                    out.put( hex[ c & 0xf ] );
+                }
+            }
+            out.write( string_view( text ).substr( run ) );
+            out.put( '"' );
+        }
+
+        // The code point starting at text[i] (a lone byte, if it isn't UTF-8).
+        uint32_t code_point( string const &text, size_t i ) {
+            unsigned char const lead = static_cast<unsigned char>( text[i] );
+            size_t const length = lead >= 0xf0 ? 4 : lead >= 0xe0 ? 3 : lead >= 0xc0 ? 2 : 1;
+            if ( length == 1 || i + length > text.size() )
+                return lead;
+            uint32_t point = lead & ( 0x7f >> length );
+            for ( size_t j = 1; j != length; ++j )
+                point = point << 6 | ( static_cast<unsigned char>( text[ i + j ] ) & 0x3f );
+            return point;
+        }
+
+        // Order by UTF-16 code units. That's code point order (and so UTF-8
+        // byte order) except that code points past U+FFFF, as surrogates,
+        // come before U+E000 to U+FFFF.
+        bool utf16_less( string const &lhs, string const &rhs ) {
+            auto const mismatch = std::mismatch( lhs.begin(), lhs.end(),
+                    rhs.begin(), rhs.end() );
+            if ( mismatch.second == rhs.end() )
+                return false;
+            if ( mismatch.first == lhs.end() )
+                return true;
+            size_t i = size_t( mismatch.first - lhs.begin() );
+            while ( i > 0 && ( static_cast<unsigned char>( lhs[i] ) & 0xc0 ) == 0x80 )
+                --i;
+            uint32_t const l = code_point( lhs, i ), r = code_point( rhs, i );
+            auto unit = []( uint32_t point ) {
+                return point > 0xffff ? 0xd800 + ( ( point - 0x10000 ) >> 10 ) : point;
+            };
+            if ( unit( l ) != unit( r ) )
+                return unit( l ) < unit( r );
+            return l < r;
+        }
+
+        void write_value( Output &out, Json const &value ) {
+            switch ( value.get_typetag( false ) ) {
+            case Json::TT_NULL:
+                out.write( "null" );
+                break;
+            case Json::TT_BOOL:
+                out.write( value.as_bool() ? "true" : "false" );
+                break;
+            case Json::TT_STRING:
+                write_string( out, value.as_string() );
+                break;
+            case Json::TT_ARRAY: {
+                out.put( '[' );
+                bool first = true;
+                for ( auto &&element : value.as_array() ) {
+                    if ( not first )
+                        out.put( ',' );
+                    first = false;
+                    write_value( out, element );
+                }
+                out.put( ']' );
+                break;
+            }
+            case Json::TT_OBJECT: {
+                using Member = Json::ObjectBody::value_type;
+                Json::ObjectBody const &members = value.as_object();
+                vector<Member const *> order;
+                order.reserve( members.size() );
+                for ( auto &&member : members )
+                    order.push_back( &member );
+                auto less = []( Member const *lhs, Member const *rhs ) {
+                    return utf16_less( lhs->first, rhs->first );
+                };
+                if ( not std::is_sorted( order.begin(), order.end(), less ) )
+                    std::stable_sort( order.begin(), order.end(), less );
+                out.put( '{' );
+                for ( size_t i = 0; i != order.size(); ++i ) {
+                    if ( i )
+                        out.put( ',' );
+                    write_string( out, order[i]->first );
+                    out.put( ':' );
+                    write_value( out, order[i]->second );
+                }
+                out.put( '}' );
+                break;
+            }
+            default:
+                write_number( out, number_value( value ) );
+            }
+        }
+
+        uint32_t rotr( uint32_t x, unsigned n ) {
+            return x >> n | x << ( 32 - n );
+        }
+
+        uint64_t rotl( uint64_t x, unsigned n ) {
+            return x << n | x >> ( 64 - n );
+        }
+
+        uint64_t load_le64( unsigned char const *bytes ) {
+            uint64_t word = 0;
+            for ( unsigned i = 8; i-- != 0; )
+                word = word << 8 | bytes[i];
+            return word;
+        }
+
+        uint64_t const hash_prime_1 = 0x9e3779b185ebca87ull;
+        uint64_t const hash_prime_2 = 0xc2b2ae3d27d4eb4full;
+
+        uint32_t const sha256_k[64] = {
+            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+            0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+            0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+            0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+            0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+            0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+        };
+    }
+
+    void canonical_encode( Json const &value, CanonicalSink const &sink )
+    {
+        Output out( sink );
+        write_value( out, value );
+        out.flush();
+    }
+
+    string canonical_encode( Json const &value )
+    {
+        string text;
+        canonical_encode( value, [&]( string_view piece ) { text += piece; } );
+        return text;
+    }
+
+    void canonical_write( std::ostream &os, Json const &value )
+    {
+        canonical_encode( value, [&]( string_view piece ) {
+                os.write( piece.data(), std::streamsize( piece.size() ) );
+            } );
+    }
+
+    Sha256::Sha256()
+    {
+        p_reset();
+    }
+
+    void Sha256::p_reset()
+    {
+        m_state = { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                    0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+        m_length = 0;
+    }
+
+    void Sha256::p_block( unsigned char const *block )
+    {
+        uint32_t w[64];
+        for ( unsigned i = 0; i != 16; ++i ) {
+            w[i] = uint32_t( block[ 4 * i ] ) << 24 | uint32_t( block[ 4 * i + 1 ] ) << 16
+                    | uint32_t( block[ 4 * i + 2 ] ) << 8 | block[ 4 * i + 3 ];
+        }
+        for ( unsigned i = 16; i != 64; ++i ) {
+            uint32_t const s0 = rotr( w[ i - 15 ], 7 ) ^ rotr( w[ i - 15 ], 18 ) ^ w[ i - 15 ] >> 3;
+            uint32_t const s1 = rotr( w[ i - 2 ], 17 ) ^ rotr( w[ i - 2 ], 19 ) ^ w[ i - 2 ] >> 10;
+            w[i] = w[ i - 16 ] + s0 + w[ i - 7 ] + s1;
+        }
+        uint32_t a = m_state[0], b = m_state[1], c = m_state[2], d = m_state[3];
+        uint32_t e = m_state[4], f = m_state[5], g = m_state[6], h = m_state[7];
+        for ( unsigned i = 0; i != 64; ++i ) {
+            uint32_t const s1 = rotr( e, 6 ) ^ rotr( e, 11 ) ^ rotr( e, 25 );
+            uint32_t const choice = ( e & f ) ^ ( ~e & g );
+            uint32_t const t1 = h + s1 + choice + sha256_k[i] + w[i];
+            uint32_t const s0 = rotr( a, 2 ) ^ rotr( a, 13 ) ^ rotr( a, 22 );
+            uint32_t const majority = ( a & b ) ^ ( a & c ) ^ ( b & c );
+            uint32_t const t2 = s0 + majority;
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+        m_state[0] += a; m_state[1] += b; m_state[2] += c; m_state[3] += d;
+        m_state[4] += e; m_state[5] += f; m_state[6] += g; m_state[7] += h;
+    }
+
+    void Sha256::update( string_view bytes )
+    {
+        auto const *data = reinterpret_cast<unsigned char const *>( bytes.data() );
+        size_t size = bytes.size();
+        size_t buffered = size_t( m_length % 64 );
+        m_length += size;
+        if ( buffered ) {
+            size_t const take = std::min( size, 64 - buffered );
+            std::memcpy( m_buffer.data() + buffered, data, take );
+            data += take;
+            size -= take;
+            if ( buffered + take != 64 )
+                return;
+            p_block( m_buffer.data() );
+        }
+        for ( ; size >= 64; data += 64, size -= 64 )
+            p_block( data );
+        std::memcpy( m_buffer.data(), data, size );
+    }
+
+    Sha256::Digest Sha256::finish()
+    {
+        uint64_t const bits = m_length * 8;
+        unsigned char padding[72] = { 0x80 };
+        size_t const pad = ( m_length % 64 < 56 ? 56 : 120 ) - m_length % 64;
+        for ( unsigned i = 0; i != 8; ++i )
+            padding[ pad + i ] = static_cast<unsigned char>( bits >> ( 56 - 8 * i ) );
+        update( string_view( reinterpret_cast<char const *>( padding ), pad + 8 ) );
+        Digest digest;
+        for ( unsigned i = 0; i != 32; ++i )
+            digest[i] = static_cast<unsigned char>( m_state[ i / 4 ] >> ( 24 - 8 * ( i % 4 ) ) );
+        p_reset();
+        return digest;
+    }
+
+    string Sha256::s_hex( Digest const &digest )
+    {
+        static char const hex[] = "0123456789abcdef";
+        string text;
+        text.reserve( 2 * digest.size() );
+        for ( unsigned char byte : digest ) {
+            text += hex[ byte >> 4 ];
+            text += hex[ byte & 0xf ];
+        }
+        return text;
+    }
+
+    Hash64::Hash64( uint64_t seed )
+        : m_hash( mix_hash( seed ^ hash_prime_1 ) )
+    { }
+
+    void Hash64::p_word( uint64_t word )
+    {
+        m_hash = rotl( m_hash ^ rotl( word * hash_prime_2, 31 ) * hash_prime_1, 27 )
+                * hash_prime_1 + hash_prime_2;
+    }
+
+    void Hash64::update( string_view bytes )
+    {
+        auto const *data = reinterpret_cast<unsigned char const *>( bytes.data() );
+        size_t size = bytes.size();
+        size_t const buffered = size_t( m_length % 8 );
+        m_length += size;
+        if ( buffered ) {
+            size_t const take = std::min( size, 8 - buffered );
+            std::memcpy( m_tail + buffered, data, take );
+            data += take;
+            size -= take;
+            if ( buffered + take != 8 )
+                return;
+            p_word( load_le64( m_tail ) );
+        }
+        for ( ; size >= 8; data += 8, size -= 8 )
+            p_word( load_le64( data ) );
+        std::memcpy( m_tail, data, size );
+    }
+
+    uint64_t Hash64::finish() const
+    {
+        uint64_t last = 0;
+        for ( unsigned i = unsigned( m_length % 8 ); i-- != 0; )
+            last = last << 8 | m_tail[i];
+        return mix_hash( m_hash ^ rotl( last * hash_prime_2, 31 ) * hash_prime_1 ^ m_length );
+    }
+
+    Sha256::Digest canonical_sha256( Json const &value )
+    {
+        Sha256 sha;
+        canonical_encode( value, [&]( string_view piece ) { sha.update( piece ); } );
+        return sha.finish();
+    }
+
+    uint64_t canonical_hash( Json const &value, uint64_t seed )
+    {
+        Hash64 hash( seed );
+        canonical_encode( value, [&]( string_view piece ) { hash.update( piece ); } );
+        return hash.finish();
+    }
+
+}
+// vi: et ts=4 sts=4 sw=4
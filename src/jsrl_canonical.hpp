@@ -0,0 +1,161 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#ifndef JSRL_CANONICAL_HPP_5C1E8A3D72F94B06A9D3E6B1F0274C85
+#define JSRL_CANONICAL_HPP_5C1E8A3D72F94B06A9D3E6B1F0274C85
+
+#include "jsrl.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+/*! @file jsrl_canonical.hpp
+ *  @brief Canonical encoding (RFC 8785, JCS) and hashing it.
+ */
+namespace jsrl {
+    using std::size_t;
+    using std::string;
+    using std::string_view;
+    using std::uint64_t;
+
+    /*! @brief  Error thrown for a value with no canonical encoding:
+     *          a number that isn't finite as a double.
+     */
+    struct CanonicalError : Json::Error {
+        explicit CanonicalError( string const &msg ) : Error( msg ) { }
+    protected:
+        char const *v_failtag() const override { return "Canonical Encoding Error"; }
+    };
+
+    /*! @brief  Receives a canonical encoding a piece at a time.
+     */
+    using CanonicalSink = std::function<void( string_view )>;
+
+    /*! @brief  Pass the JSON Canonicalization Scheme (RFC 8785)
+     *          encoding of @c value to @c sink, in pieces.
+     *
+     *  There is no whitespace; object members are ordered by their keys'
+     *  UTF-16 code units; strings escape only @c ", @c \\ and control
+     *  characters, the latter as @c \\b, @c \\t, @c \\n, @c \\f, @c \\r
+     *  or lowercase @c \\u00xx; and numbers are read as IEEE doubles
+     *  and written as ECMAScript's @c Number.prototype.toString would,
+     *  so @c 1.0, @c 1e0 and @c 1 all encode as @c 1,
+     *  and integers past 2^53 lose precision.
+     *
+     *  The pieces come from a small buffer, filled as the tree is walked,
+     *  so the whole encoding is never held in memory.
+     *
+     *  @throw CanonicalError   A number is infinite or NaN,
+     *      or too large for a double.
+     */
+    void canonical_encode( Json const &value, CanonicalSink const &sink );
+
+    /*! @brief  The canonical encoding of @c value, as a string.
+     *
+     *  @throw CanonicalError   As for the @ref canonical_encode sink form.
+     */
+    string canonical_encode( Json const &value );
+
+    /*! @brief  Write the canonical encoding of @c value to @c os.
+     *
+     *  @throw CanonicalError   As for the @ref canonical_encode sink form.
+     */
+    void canonical_write( std::ostream &os, Json const &value );
+
+    /*! @brief  Incremental SHA-256 (FIPS 180-4).
+     *
+     *  Example:
+     *  @code
+     *      Sha256 sha;
+     *      sha.update( "ab" );
+     *      sha.update( "c" );
+     *      string const hex = Sha256::s_hex( sha.finish() );
+     *  @endcode
+     */
+    struct Sha256 {
+        using Digest = std::array<unsigned char, 32>;
+
+        Sha256();
+
+        /*! @brief  Hash more bytes. */
+        void update( string_view bytes );
+
+        /*! @brief  The digest of every byte given;
+         *          the hasher starts over afterwards.
+         */
+        Digest finish();
+
+        /*! @brief  A digest in lowercase hexadecimal. */
+        static string s_hex( Digest const &digest );
+
+    private:
+        void p_block( unsigned char const *block );
+        void p_reset();
+
+        std::array<std::uint32_t, 8> m_state;
+        std::array<unsigned char, 64> m_buffer;
+        uint64_t m_length;      // Bytes given so far.
+    };
+
+    /*! @brief  Incremental 64-bit non-cryptographic hash,
+     *          taking the input eight bytes at a time.
+     *
+     *  The result depends only on the bytes given and the seed,
+     *  not on how they were split between calls to @ref update.
+     *  Suited to cache keys and hash tables, not to signatures:
+     *  collisions can be made deliberately.
+     */
+    struct Hash64 {
+        explicit
+        Hash64( uint64_t seed = 0 );
+
+        /*! @brief  Hash more bytes. */
+        void update( string_view bytes );
+
+        /*! @brief  The hash of every byte given (the hasher is unchanged). */
+        uint64_t finish() const;
+
+    private:
+        void p_word( uint64_t word );
+
+        uint64_t m_hash;
+        uint64_t m_length = 0;
+        unsigned char m_tail[8];    // The last m_length % 8 bytes.
+    };
+
+    /*! @brief  SHA-256 of the canonical encoding of @c value,
+     *          hashed as it is produced, without building the string.
+     *
+     *  Equal to hashing @ref canonical_encode( value ),
+     *  so suitable for signing.
+     *
+     *  @throw CanonicalError   As for @ref canonical_encode.
+     */
+    Sha256::Digest canonical_sha256( Json const &value );
+
+    /*! @brief  @ref Hash64 of the canonical encoding of @c value,
+     *          hashed as it is produced, without building the string.
+     *
+     *  Values with the same canonical encoding hash alike,
+     *  whatever their key order or the way their numbers were written.
+     *
+     *  @throw CanonicalError   As for @ref canonical_encode.
+     */
+    uint64_t canonical_hash( Json const &value, uint64_t seed = 0 );
+
+}
+#endif
+// vi: et ts=4 sts=4 sw=4
@@ -0,0 +1,390 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#include "jsrl_dedup.hpp"
+#include "jsrl_impl_util.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <fstream>
+#include <mutex>
+#include <system_error>
+
+namespace jsrl {
+    using std::system_error;
+    using std::unique_ptr;
+    using std::vector;
+
+    namespace {
+        std::uint64_t const second_seed = 0x5bd1e9955bd1e995ull;
+        size_t const block_fingerprints = 256;  // Per sparse index entry.
+        size_t const max_runs = 8;              // Before they are merged.
+        unsigned const bloom_hashes = 7;        // About 1% false positives
+        size_t const bloom_bits_each = 10;      // at 10 bits a fingerprint.
+
+        bool is_empty( Fingerprint const &fingerprint ) {
+            return fingerprint.high == 0 && fingerprint.low == 0;
+        }
+
+        // Open addressing with linear probing; an all-zero slot is empty.
+        struct FingerprintSet {
+            FingerprintSet() { clear(); }
+
+            size_t size() const { return m_size; }
+
+            bool contains( Fingerprint const &fingerprint ) const {
+                return m_slots[ p_find( fingerprint ) ] == fingerprint;
+            }
+
+            // Whether it wasn't there already.
+            bool insert( Fingerprint const &fingerprint ) {
+                if ( ( m_size + 1 ) * 4 > m_slots.size() * 3 )
+                    p_grow();
+                Fingerprint &slot = m_slots[ p_find( fingerprint ) ];
+                if ( slot == fingerprint )
+                    return false;
+                slot = fingerprint;
+                ++m_size;
+                return true;
+            }
+
+            void erase( Fingerprint const &fingerprint ) {
+                size_t const mask = m_slots.size() - 1;
+                size_t hole = p_find( fingerprint );
+                if ( is_empty( m_slots[hole] ) )
+                    return;
+                // Shift back later entries that would no longer be found.
+                for ( size_t i = ( hole + 1 ) & mask; not is_empty( m_slots[i] );
+                        i = ( i + 1 ) & mask ) {
+                    size_t const home = p_home( m_slots[i] );
+                    bool const stays = hole < i ? hole < home && home <= i
+                            : hole < home || home <= i;
+                    if ( not stays ) {
+                        m_slots[hole] = m_slots[i];
+                        hole = i;
+                    }
+                }
+                m_slots[hole] = Fingerprint();
+                --m_size;
+            }
+
+            vector<Fingerprint> sorted() const {
+                vector<Fingerprint> fingerprints;
+                fingerprints.reserve( m_size );
+                for ( auto &&slot : m_slots ) {
+                    if ( not is_empty( slot ) )
+                        fingerprints.push_back( slot );
+                }
+                std::sort( fingerprints.begin(), fingerprints.end() );
+                return fingerprints;
+            }
+
+            void clear() {
+                m_slots.assign( 16, Fingerprint() );
+                m_size = 0;
+            }
+
+        private:
+            size_t p_home( Fingerprint const &fingerprint ) const {
+                return size_t( fingerprint.low ) & ( m_slots.size() - 1 );
+            }
+
+            // The fingerprint's slot, or the empty one where it would go.
+            size_t p_find( Fingerprint const &fingerprint ) const {
+                size_t const mask = m_slots.size() - 1;
+                for ( size_t i = p_home( fingerprint );; i = ( i + 1 ) & mask ) {
+                    if ( m_slots[i] == fingerprint || is_empty( m_slots[i] ) )
+                        return i;
+                }
+            }
+
+            void p_grow() {
+                vector<Fingerprint> const old = std::move(m_slots);
+                m_slots.assign( old.size() * 2, Fingerprint() );
+                for ( auto &&slot : old ) {
+                    if ( not is_empty( slot ) )
+                        m_slots[ p_find( slot ) ] = slot;
+                }
+            }
+
+            vector<Fingerprint> m_slots;    // A power of two long.
+            size_t m_size;
+        };
+
+        // Sorted fingerprints in a temporary file, with a Bloom filter
+        // and the first fingerprint of each block, to look them up.
+        struct SpilledRun {
+            unique_ptr<TempFile> file;
+            uint64_t count = 0;
+            vector<uint64_t> bloom;
+            vector<Fingerprint> samples;
+            std::ifstream reader;
+
+            size_t bloom_bit( Fingerprint const &fingerprint, unsigned i ) const {
+                return size_t( ( fingerprint.high + i * fingerprint.low )
+                        % ( bloom.size() * 64 ) );
+            }
+
+            bool contains( Fingerprint const &fingerprint ) {
+                for ( unsigned i = 0; i != bloom_hashes; ++i ) {
+                    size_t const bit = bloom_bit( fingerprint, i );
+                    if ( not ( bloom[ bit / 64 ] >> ( bit % 64 ) & 1 ) )
+                        return false;
+                }
+                auto const after = std::upper_bound( samples.begin(), samples.end(),
+                        fingerprint );
+                if ( after == samples.begin() )
+                    return false;
+                uint64_t const first
+                        = uint64_t( after - samples.begin() - 1 ) * block_fingerprints;
+                size_t const n = size_t( std::min<uint64_t>( block_fingerprints,
+                            count - first ) );
+                Fingerprint block[ block_fingerprints ];
+                reader.seekg( std::streamoff( first * sizeof( Fingerprint ) ) );
+                if ( not reader.read( reinterpret_cast<char *>( block ),
+                            std::streamsize( n * sizeof( Fingerprint ) ) ) ) {
+                    throw system_error( std::make_error_code( std::errc::io_error ),
+                            "Cannot read " + file->path.string() );
+                }
+                return std::binary_search( block, block + n, fingerprint );
+            }
+        };
+
+        // Writes a run's fingerprints, in order, building its lookups.
+        struct RunWriter {
+            RunWriter( SpilledRun &run, unique_ptr<TempFile> file, uint64_t count )
+                : m_run( run )
+                , m_out( file->path, std::ios::binary | std::ios::trunc )
+            {
+                if ( not m_out ) {
+                    throw system_error( errno, std::generic_category(),
+                            "Cannot write " + file->path.string() );
+                }
+                m_run.file = std::move(file);
+                m_run.bloom.assign( std::max<uint64_t>( 1,
+                            ( count * bloom_bits_each + 63 ) / 64 ), 0 );
+            }
+
+            void add( Fingerprint const &fingerprint ) {
+                if ( m_run.count % block_fingerprints == 0 )
+                    m_run.samples.push_back( fingerprint );
+                for ( unsigned i = 0; i != bloom_hashes; ++i ) {
+                    size_t const bit = m_run.bloom_bit( fingerprint, i );
+                    m_run.bloom[ bit / 64 ] |= uint64_t( 1 ) << ( bit % 64 );
+                }
+                m_out.write( reinterpret_cast<char const *>( &fingerprint ),
+                        sizeof fingerprint );
+                ++m_run.count;
+            }
+
+            void finish() {
+                if ( not m_out.flush() ) {
+                    throw system_error( std::make_error_code( std::errc::io_error ),
+                            "Cannot write " + m_run.file->path.string() );
+                }
+                m_out.close();
+                m_run.reader.open( m_run.file->path, std::ios::binary );
+                if ( not m_run.reader ) {
+                    throw system_error( errno, std::generic_category(),
+                            "Cannot read " + m_run.file->path.string() );
+                }
+            }
+
+        private:
+            SpilledRun &m_run;
+            std::ofstream m_out;
+        };
+    }
+
+    Fingerprint Fingerprint::s_of( Json const &value )
+    {
+        Fingerprint fingerprint;
+        fingerprint.high = json_hash( value );
+        fingerprint.low = json_hash( value, second_seed );
+        return fingerprint;
+    }
+
+    struct Deduplicator::State {
+        explicit
+        State( DedupOptions const &options )
+            : window( options.window )
+            , memory( std::max<size_t>( 1, options.memory_fingerprints ) )
+            , temp_directory( options.temp_directory )
+        { }
+
+        bool first( Fingerprint const &fingerprint );
+
+        std::mutex mutex;
+        size_t const window;
+        size_t const memory;
+        string const temp_directory;
+        FingerprintSet set;
+        vector<Fingerprint> ring;   // The window, oldest at ring_next.
+        size_t ring_next = 0;
+        unique_ptr<TempFileNamer> temp;
+        vector<unique_ptr<SpilledRun>> runs;
+        uint64_t records = 0;
+        uint64_t duplicates = 0;
+        uint64_t spilled = 0;
+
+    private:
+        bool p_spilled( Fingerprint const &fingerprint );
+        void p_spill();
+        void p_merge_runs();
+    };
+
+    bool Deduplicator::State::first( Fingerprint const &fingerprint )
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        ++records;
+        if ( window ) {
+            if ( not set.insert( fingerprint ) ) {
+                ++duplicates;
+                return false;
+            }
+            if ( ring.size() < window ) {
+                ring.push_back( fingerprint );
+            } else {
+                set.erase( ring[ ring_next ] );
+                ring[ ring_next ] = fingerprint;
+                ring_next = ( ring_next + 1 ) % window;
+            }
+            return true;
+        }
+        if ( set.contains( fingerprint ) || p_spilled( fingerprint ) ) {
+            ++duplicates;
+            return false;
+        }
+        set.insert( fingerprint );
+        if ( set.size() >= memory )
+            p_spill();
+        return true;
+    }
+
+    bool Deduplicator::State::p_spilled( Fingerprint const &fingerprint )
+    {
+        for ( auto &&run : runs ) {
+            if ( run->contains( fingerprint ) )
+                return true;
+        }
+        return false;
+    }
+
+    void Deduplicator::State::p_spill()
+    {
+        if ( not temp )
+            temp = std::make_unique<TempFileNamer>( temp_directory, "jsrl-dedup" );
+        vector<Fingerprint> const fingerprints = set.sorted();
+        auto run = std::make_unique<SpilledRun>();
+        RunWriter writer( *run, temp->make(), fingerprints.size() );
+        for ( auto &&fingerprint : fingerprints )
+            writer.add( fingerprint );
+        writer.finish();
+        runs.push_back( std::move(run) );
+        spilled += fingerprints.size();
+        set.clear();
+        if ( runs.size() > max_runs )
+            p_merge_runs();
+    }
+
+    // Merge every run into one, so that lookups test one Bloom filter.
+    void Deduplicator::State::p_merge_runs()
+    {
+        struct Input {
+            std::ifstream in;
+            Fingerprint next;
+            bool more;
+
+            void read() {
+                more = bool( in.read( reinterpret_cast<char *>( &next ), sizeof next ) );
+            }
+        };
+        vector<unique_ptr<Input>> inputs;
+        uint64_t total = 0;
+        for ( auto &&run : runs ) {
+            auto input = std::make_unique<Input>();
+            input->in.open( run->file->path, std::ios::binary );
+            input->read();
+            inputs.push_back( std::move(input) );
+            total += run->count;
+        }
+        auto merged = std::make_unique<SpilledRun>();
+        RunWriter writer( *merged, temp->make(), total );
+        for ( uint64_t written = 0; written != total; ++written ) {
+            Input *least = nullptr;
+            for ( auto &&input : inputs ) {
+                if ( input->more && ( not least || input->next < least->next ) )
+                    least = input.get();
+            }
+            if ( not least ) {
+                throw system_error( std::make_error_code( std::errc::io_error ),
+                        "Cannot read spilled fingerprints" );
+            }
+            writer.add( least->next );
+            least->read();
+        }
+        writer.finish();
+        inputs.clear();
+        runs.clear();
+        runs.push_back( std::move(merged) );
+    }
+
+    Deduplicator::Deduplicator( DedupOptions options )
+        : m_keys( std::move( options.keys ) )
+        , m_state( std::make_shared<State>( options ) )
+    { }
+
+    Fingerprint Deduplicator::fingerprint( Json const &record ) const
+    {
+        if ( m_keys.empty() )
+            return Fingerprint::s_of( record );
+        Json::ArrayBody values;
+        values.reserve( m_keys.size() );
+        for ( auto &&key : m_keys ) {
+            Json const *const value = key.find( record );
+            values.push_back( value ? *value : Json() );
+        }
+        return Fingerprint::s_of( Json( std::move(values) ) );
+    }
+
+    bool Deduplicator::first( Json const &record )
+    {
+        return first( fingerprint( record ) );
+    }
+
+    bool Deduplicator::first( Fingerprint fingerprint )
+    {
+        // All zeros marks an empty slot.
+        if ( is_empty( fingerprint ) )
+            fingerprint.low = 1;
+        return m_state->first( fingerprint );
+    }
+
+    uint64_t Deduplicator::records() const
+    {
+        std::lock_guard<std::mutex> lock( m_state->mutex );
+        return m_state->records;
+    }
+
+    uint64_t Deduplicator::duplicates() const
+    {
+        std::lock_guard<std::mutex> lock( m_state->mutex );
+        return m_state->duplicates;
+    }
+
+    uint64_t Deduplicator::spilled() const
+    {
+        std::lock_guard<std::mutex> lock( m_state->mutex );
+        return m_state->spilled;
+    }
+
+}
+// vi: et ts=4 sts=4 sw=4
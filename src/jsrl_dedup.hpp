@@ -0,0 +1,135 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#ifndef JSRL_DEDUP_HPP_E7B40C2A95D81F63A4C0E2B97D15F38A
+#define JSRL_DEDUP_HPP_E7B40C2A95D81F63A4C0E2B97D15F38A
+
+#include "jsrl.hpp"
+#include "jsrl_pointer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*! @file jsrl_dedup.hpp
+ *  @brief Dropping repeated records.
+ */
+namespace jsrl {
+    using std::size_t;
+    using std::string;
+    using std::uint64_t;
+
+    /*! @brief  128-bit structural hash of a value.
+     *
+     *  Values that compare equal (as Json does, numbers by
+     *  @ref json_number_compare) have equal fingerprints:
+     *  numbers however they were written, so @c 1.50 and @c 1.5,
+     *  though not @c 1 and @c 1.0, and objects whatever their key order.
+     *  Its halves are @ref json_hash with two different seeds,
+     *  so values that differ rarely share a fingerprint.
+     */
+    struct Fingerprint {
+        uint64_t high = 0;
+        uint64_t low = 0;
+
+        /*! @brief  The fingerprint of @c value, computed from its tree
+         *          without encoding it. */
+        static Fingerprint s_of( Json const &value );
+
+        friend bool operator==( Fingerprint const &lhs, Fingerprint const &rhs ) {
+            return lhs.high == rhs.high && lhs.low == rhs.low;
+        }
+        friend bool operator!=( Fingerprint const &lhs, Fingerprint const &rhs ) {
+            return not ( lhs == rhs );
+        }
+        friend bool operator<( Fingerprint const &lhs, Fingerprint const &rhs ) {
+            return lhs.high != rhs.high ? lhs.high < rhs.high : lhs.low < rhs.low;
+        }
+    };
+
+    /*! @brief  What a @ref Deduplicator counts as a repeat,
+     *          and how much it remembers.
+     */
+    struct DedupOptions {
+        /*! @brief  Paths whose values identify a record
+         *          (missing ones read as null); empty for the whole record.
+         */
+        std::vector<JsonPointer> keys;
+        /*! @brief  Distinct records remembered, the oldest forgotten first;
+         *          0 to remember every one.
+         */
+        size_t window = 0;
+        /*! @brief  Fingerprints held in memory, without a window,
+         *          before they are spilled to a temporary file.
+         *
+         *  One takes 16 to 32 bytes in memory;
+         *  a spilled one, about 10 bits (a Bloom filter and a sparse index),
+         *  and only about 1% of new records need a disk read per file.
+         */
+        size_t memory_fingerprints = 1 << 20;
+        string temp_directory;      //!< Where to spill (empty: the system's).
+    };
+
+    /*! @brief  Passes on the first of each set of equal records.
+     *
+     *  Records are remembered by @ref Fingerprint, so equal numbers
+     *  such as @c 1.50 and @c 1.5 make equal records,
+     *  and no record is encoded or kept.
+     *  Fingerprints live in an open-addressing hash set;
+     *  without a window, once the set is full it is sorted
+     *  and spilled to a temporary file, which is then searched
+     *  (through a Bloom filter) for records not found in memory.
+     *
+     *  Copies share what has been seen, and may be used from
+     *  several threads at once, so a @c Deduplicator can be
+     *  a @ref Pipeline stage with any number of threads.
+     *
+     *  Example:
+     *  @code
+     *      DedupOptions options;
+     *      options.keys = { JsonPointer( "/event_id" ) };
+     *      pipeline.stage( "dedup", Deduplicator( options ) );
+     *  @endcode
+     */
+    struct Deduplicator {
+        explicit
+        Deduplicator( DedupOptions options = DedupOptions() );
+
+        /*! @brief  Whether @c record is the first of its kind;
+         *          remembers it if it is.
+         *
+         *  @throw std::system_error A temporary file can't be written or read.
+         */
+        bool first( Json const &record );
+        /*! @overload */
+        bool first( Fingerprint fingerprint );
+        /*! @brief  As @ref first, for use as a @ref Pipeline::Transform. */
+        bool operator()( Json &record ) { return first( record ); }
+
+        /*! @brief  The fingerprint by which @c record is remembered. */
+        Fingerprint fingerprint( Json const &record ) const;
+
+        uint64_t records() const;       //!< Records tested.
+        uint64_t duplicates() const;    //!< Records found to be repeats.
+        uint64_t spilled() const;       //!< Fingerprints in temporary files.
+
+    private:
+        struct State;
+
+        std::vector<JsonPointer> m_keys;
+        std::shared_ptr<State> m_state;
+    };
+
+}
+#endif
+// vi: et ts=4 sts=4 sw=4
@@ -0,0 +1,245 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#include "jsrl_doc_index.hpp"
+#include "jsrl_impl_util.hpp"
+#include "jsrl_reader.hpp"
+
+#include <algorithm>
+
+namespace jsrl {
+
+    namespace {
+        char const index_magic[8] = { 'J', 'S', 'R', 'L', 'D', 'I', 'X', '1' };
+
+        // Passes another streambuf through, counting the bytes consumed.
+        struct OffsetStreambuf : streambuf {
+            explicit
+            OffsetStreambuf( streambuf &source )
+                : m_source( source )
+                , m_buffer( 64 * 1024 )
+            { }
+
+            uint64_t position() const {
+                return m_base + uint64_t( gptr() - eback() );
+            }
+
+        protected:
+            int_type underflow() override {
+                if ( gptr() < egptr() )
+                    return traits_type::to_int_type( *gptr() );
+                // Keep the last byte, so it can be put back.
+                size_t keep = 0;
+                if ( gptr() != eback() ) {
+                    m_buffer[0] = gptr()[-1];
+                    keep = 1;
+                }
+                m_base = position() - keep;
+                char *const data = m_buffer.data();
+                auto const got = m_source.sgetn( data + keep,
+                        std::streamsize( m_buffer.size() - keep ) );
+                setg( data, data + keep, data + keep + ( got > 0 ? got : 0 ) );
+                return got > 0 ? traits_type::to_int_type( *gptr() )
+                        : traits_type::eof();
+            }
+
+        private:
+            streambuf &m_source;
+            std::vector<char> m_buffer;
+            uint64_t m_base = 0;    // Input offset of m_buffer[0].
+        };
+
+        struct Builder {
+            Builder( OffsetStreambuf &sbuf, size_t max_depth )
+                : sbuf( sbuf )
+                , reader( sbuf )
+                , max_depth( max_depth )
+            { }
+
+            void index( string const &pointer, size_t depth ) {
+                auto const token = reader.peek();
+                uint64_t const begin = sbuf.position();
+                if ( depth < max_depth && token == JsonReader::TK_OBJECT ) {
+                    reader.enter_object();
+                    string key;
+                    while ( reader.next_key( key ) ) {
+                        JsonPointer const child( std::vector<string>{ key } );
+                        index( pointer + child.to_string(), depth + 1 );
+                    }
+                } else if ( depth < max_depth && token == JsonReader::TK_ARRAY ) {
+                    reader.enter_array();
+                    for ( size_t i = 0; reader.next_element(); ++i )
+                        index( pointer + "/" + std::to_string( i ), depth + 1 );
+                } else {
+                    reader.skip_value();
+                }
+                entries.push_back( DocumentIndex::Entry{
+                        pointer, begin, sbuf.position() } );
+            }
+
+            OffsetStreambuf &sbuf;
+            JsonReader reader;
+            size_t const max_depth;
+            std::vector<DocumentIndex::Entry> entries;
+        };
+
+        bool entry_less( DocumentIndex::Entry const &lhs, string const &rhs ) {
+            return lhs.pointer < rhs;
+        }
+
+        uint64_t get_varint( std::istream &in ) {
+            uint64_t value;
+            if ( not read_varint( in, value ) )
+                throw DocumentIndexError( "Truncated document index" );
+            return value;
+        }
+
+        // Walk the rest of a pointer from the reader's next value.
+        bool descend(
+                JsonReader &reader,
+                std::vector<string> const &tokens,
+                size_t from
+                )
+        {
+            string key;
+            for ( size_t t = from; t != tokens.size(); ++t ) {
+                auto const token = reader.peek();
+                if ( token == JsonReader::TK_OBJECT ) {
+                    reader.enter_object();
+                    for (;;) {
+                        if ( not reader.next_key( key ) )
+                            return false;
+                        if ( key == tokens[t] )
+                            break;
+                        reader.skip_value();
+                    }
+                } else if ( token == JsonReader::TK_ARRAY ) {
+                    size_t const index = JsonPointer::s_index( tokens[t] );
+                    if ( index == JsonPointer::npos )
+                        return false;
+                    reader.enter_array();
+                    for ( size_t i = 0; ; ++i ) {
+                        if ( not reader.next_element() )
+                            return false;
+                        if ( i == index )
+                            break;
+                        reader.skip_value();
+                    }
+                } else {
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+
+    DocumentIndex DocumentIndex::s_build( streambuf &document, size_t max_depth )
+    {
+        OffsetStreambuf sbuf( document );
+        Builder builder( sbuf, max_depth );
+        builder.index( string(), 0 );
+        builder.reader.finish();
+        DocumentIndex index;
+        index.m_max_depth = max_depth;
+        index.m_entries = std::move( builder.entries );
+        std::sort( index.m_entries.begin(), index.m_entries.end(),
+                []( Entry const &lhs, Entry const &rhs ) {
+                    return lhs.pointer < rhs.pointer;
+                } );
+        return index;
+    }
+
+    void DocumentIndex::save( std::ostream &output ) const
+    {
+        output.write( index_magic, sizeof index_magic );
+        write_varint( output, m_max_depth );
+        write_varint( output, m_entries.size() );
+        for ( auto &&entry : m_entries ) {
+            write_varint( output, entry.pointer.size() );
+            output.write( entry.pointer.data(), std::streamsize( entry.pointer.size() ) );
+            write_varint( output, entry.begin );
+            write_varint( output, entry.end - entry.begin );
+        }
+    }
+
+    DocumentIndex DocumentIndex::s_load( std::istream &input )
+    {
+        char magic[sizeof index_magic];
+        if ( not input.read( magic, sizeof magic )
+                || not std::equal( magic, magic + sizeof magic, index_magic ) )
+            throw DocumentIndexError( "Not a document index" );
+        DocumentIndex index;
+        index.m_max_depth = size_t( get_varint( input ) );
+        uint64_t const count = get_varint( input );
+        for ( uint64_t i = 0; i != count; ++i ) {
+            Entry entry;
+            entry.pointer.resize( size_t( get_varint( input ) ) );
+            if ( not input.read( &entry.pointer[0],
+                        std::streamsize( entry.pointer.size() ) ) )
+                throw DocumentIndexError( "Truncated document index" );
+            entry.begin = get_varint( input );
+            entry.end = entry.begin + get_varint( input );
+            if ( not index.m_entries.empty()
+                    && not ( index.m_entries.back().pointer < entry.pointer ) )
+                throw DocumentIndexError( "Unsorted document index" );
+            index.m_entries.push_back( std::move( entry ) );
+        }
+        return index;
+    }
+
+    auto DocumentIndex::p_entry( string const &text ) const -> Entry const *
+    {
+        auto const found = std::lower_bound( m_entries.begin(), m_entries.end(),
+                text, entry_less );
+        return found != m_entries.end() && found->pointer == text
+                ? &*found
+                : nullptr
+                ;
+    }
+
+    auto DocumentIndex::entry( JsonPointer const &pointer ) const -> Entry const *
+    {
+        return p_entry( pointer.to_string() );
+    }
+
+    bool DocumentIndex::find(
+            streambuf &document,
+            JsonPointer const &pointer,
+            Json &value,
+            Json::ParseOptions parse_options
+            ) const
+    {
+        auto const &tokens = pointer.tokens();
+        // Every value down to max_depth is indexed, so the deepest indexed
+        // ancestor is the starting point, and a missing one above
+        // max_depth means there's no such value.
+        size_t depth = std::min( tokens.size(), m_max_depth );
+        Entry const *start = nullptr;
+        for ( ;; --depth ) {
+            start = p_entry( JsonPointer( std::vector<string>(
+                            tokens.begin(), tokens.begin() + depth ) ).to_string() );
+            if ( start || depth == 0 )
+                break;
+        }
+        if ( not start || ( depth < tokens.size() && depth < m_max_depth ) )
+            return false;
+        if ( document.pubseekpos( std::streampos( std::streamoff( start->begin ) ),
+                    std::ios::in ) == std::streampos( std::streamoff( -1 ) ) )
+            throw DocumentIndexError( "Cannot seek in the document" );
+        JsonReader reader( document, parse_options );
+        if ( not descend( reader, tokens, depth ) )
+            return false;
+        value = reader.read_value();
+        return true;
+    }
+
+}
+// vi: et ts=4 sts=4 sw=4
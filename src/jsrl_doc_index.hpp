@@ -0,0 +1,130 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#ifndef JSRL_DOC_INDEX_HPP_3E9A61C0B7D2485F9C14A6E07B3D28F5
+#define JSRL_DOC_INDEX_HPP_3E9A61C0B7D2485F9C14A6E07B3D28F5
+
+#include "jsrl.hpp"
+#include "jsrl_pointer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+/*! @file jsrl_doc_index.hpp
+ *  @brief Structural index for point lookups in large documents.
+ */
+namespace jsrl {
+    using std::size_t;
+    using std::streambuf;
+    using std::string;
+    using std::uint64_t;
+
+    /*! @brief  Error thrown for a damaged @ref DocumentIndex file,
+     *          or a document that can't be seeked.
+     */
+    struct DocumentIndexError : Json::Error {
+        explicit DocumentIndexError( string const &msg ) : Error( msg ) { }
+    protected:
+        char const *v_failtag() const override { return "Document Index Error"; }
+    };
+
+    /*! @brief  Byte offsets of the values near the top of one JSON document.
+     *
+     *  Built in one pass over the document,
+     *  the index records where every value down to @c max_depth
+     *  levels below the root begins and ends.
+     *  A @ref JsonPointer lookup then seeks to the deepest indexed value
+     *  on its path, walks the rest of the path from there
+     *  (skipping siblings without decoding them),
+     *  and parses only the value pointed to;
+     *  the document itself is never held in memory.
+     *
+     *  A pointer whose key is missing at an indexed level
+     *  is answered from the index alone.
+     *  The index must be rebuilt whenever the document changes.
+     *
+     *  Example:
+     *  @code
+     *      std::ifstream catalog( path, std::ios::binary );
+     *      auto index = DocumentIndex::s_build( *catalog.rdbuf(), 2 );
+     *      Json product;
+     *      if ( index.find( *catalog.rdbuf(),
+     *                  JsonPointer( "/products/ab-123" ), product ) )
+     *          ...
+     *  @endcode
+     */
+    struct DocumentIndex {
+        /*! @brief  Extent of an indexed value. */
+        struct Entry {
+            string pointer;     //!< The value's JSON Pointer text.
+            uint64_t begin;     //!< Offset of its first byte.
+            uint64_t end;       //!< Offset just past its last byte.
+        };
+
+        /*! @brief  Empty index, which finds nothing. */
+        DocumentIndex() = default;
+
+        /*! @brief  Index a document, which must be positioned at its start.
+         *
+         *  @throw Json::ParseError The document isn't valid JSON.
+         */
+        static
+        DocumentIndex s_build( streambuf &document, size_t max_depth = 2 );
+
+        /*! @brief  Read an index written by @ref save.
+         *
+         *  @throw DocumentIndexError   The input isn't a valid index.
+         */
+        static
+        DocumentIndex s_load( std::istream &input );
+        /*! @brief  Write the index in its compact form.
+         */
+        void save( std::ostream &output ) const;
+
+        size_t max_depth() const { return m_max_depth; }
+        /*! @brief  Indexed values, sorted by pointer text. */
+        std::vector<Entry> const &entries() const { return m_entries; }
+
+        /*! @brief  The indexed value at a pointer, or null if not indexed.
+         */
+        Entry const *entry( JsonPointer const &pointer ) const;
+
+        /*! @brief  Read the value at @c pointer from the indexed document.
+         *
+         *  @c document is seeked, so it must support @c pubseekpos;
+         *  its position is left unspecified.
+         *
+         *  @retval false   There is no value at @c pointer.
+         *  @throw DocumentIndexError   The document couldn't be seeked.
+         *  @throw Json::ParseError     The document doesn't match the index.
+         */
+        bool find(
+                streambuf &document,
+                JsonPointer const &pointer,
+                Json &value,
+                Json::ParseOptions parse_options = Json::ParseOptions(false)
+                ) const;
+
+    private:
+        Entry const *p_entry( string const &text ) const;
+
+        size_t m_max_depth = 0;
+        std::vector<Entry> m_entries;
+    };
+
+}
+#endif
+// vi: et ts=4 sts=4 sw=4
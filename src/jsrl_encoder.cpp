@@ -0,0 +1,499 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#include "jsrl_encoder.hpp"
+#include "jsrl_impl_util.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <ostream>
+#include <string_view>
+
+namespace jsrl {
+    using std::make_unique;
+    using std::memcpy;
+    using std::max;
+    using std::min;
+    using std::ostream;
+    using std::string_view;
+    using std::to_string;
+
+    // Staged output, with a stream writing into it.
+    struct ChunkedEncoder::Output {
+        Output()
+            : buf( pending )
+            , os( &buf )
+        {
+            os.exceptions( ostream::badbit );
+        }
+
+        string pending;
+        size_t pending_pos = 0;
+        jsrl_string_outbuf buf;
+        ostream os;
+    };
+
+    ChunkedEncoder::ChunkedEncoder( Json value )
+        : ChunkedEncoder( std::move(value), Json::EncodeOptions(
+                    Json::EncodeOptions::TN_EXACT, false, false ) )
+    { }
+
+    ChunkedEncoder::ChunkedEncoder(
+            Json value,
+            Json::EncodeOptions encode_options
+            )
+        : m_root( std::move(value) )
+        , m_options( encode_options )
+        , m_output( make_unique<Output>() )
+    { }
+
+    ChunkedEncoder::ChunkedEncoder( ChunkedEncoder && ) noexcept = default;
+    ChunkedEncoder &ChunkedEncoder::operator=( ChunkedEncoder && ) noexcept
+            = default;
+    ChunkedEncoder::~ChunkedEncoder() = default;
+
+    size_t ChunkedEncoder::next_chunk( char *buf, size_t cap )
+    {
+        Output &out = *m_output;
+        size_t written = 0;
+        while ( written != cap ) {
+            if ( out.pending_pos == out.pending.size() && not p_refill() )
+                break;
+            size_t const count
+                    = min( cap - written, out.pending.size() - out.pending_pos );
+            memcpy( buf + written, out.pending.data() + out.pending_pos, count );
+            written += count;
+            out.pending_pos += count;
+        }
+        return written;
+    }
+
+    bool ChunkedEncoder::done() const
+    {
+        return m_started && m_stack.empty()
+                && m_output->pending_pos == m_output->pending.size();
+    }
+
+    // Stage the next piece of output: an opening or closing bracket,
+    // or one element (with its separator and key) of the innermost container.
+    bool ChunkedEncoder::p_refill()
+    {
+        string &pending = m_output->pending;
+        pending.clear();
+        m_output->pending_pos = 0;
+        if ( not m_started ) {
+            m_started = true;
+            p_open( m_root );
+            return true;
+        }
+        if ( m_stack.empty() )
+            return false;
+        Frame &frame = m_stack.back();
+        Json const container = frame.container;
+        size_t const index = frame.index++;
+        if ( container.is_array() ) {
+            auto &&body = container.as_array();
+            if ( index == body.size() ) {
+                pending.push_back( ']' );
+                m_stack.pop_back();
+                return true;
+            }
+            if ( index )
+                pending.push_back( ',' );
+            p_open( body[index] );
+        } else {
+            auto &&body = container.as_object();
+            if ( index == body.size() ) {
+                pending.push_back( '}' );
+                m_stack.pop_back();
+                return true;
+            }
+            if ( index )
+                pending.push_back( ',' );
+            Json::write_JSON_string( m_output->os, body[index].first,
+                    m_options.fail_bad_utf8, m_options.write_utf );
+            pending.push_back( ':' );
+            p_open( body[index].second );
+        }
+        return true;
+    }
+
+    // Stage the start of a value: scalars are encoded whole,
+    // and non-empty containers are pushed to be continued later.
+    void ChunkedEncoder::p_open( Json const &value )
+    {
+        if ( value.is_array() && not value.as_array().empty() ) {
+            m_output->pending.push_back( '[' );
+            m_stack.push_back( Frame{ value, 0 } );
+        } else if ( value.is_object() && not value.as_object().empty() ) {
+            m_output->pending.push_back( '{' );
+            m_stack.push_back( Frame{ value, 0 } );
+        } else {
+            m_output->os << Json::OptionedWrite( value, m_options );
+        }
+    }
+
+    namespace {
+
+        // Writes as much of a value as fits below an output size limit.
+        // Each write_* function either writes its value entirely (FULL),
+        // writes a truncated but well-formed version (PARTIAL),
+        // or leaves the output as it was (NOTHING).
+        struct BoundedWriter {
+            enum Completion { FULL, PARTIAL, NOTHING };
+
+            explicit BoundedWriter( Json::EncodeOptions const &options )
+                : options( options )
+                , ellipsis( options.write_utf ? "\xE2\x80\xA6" : "\\u2026" )
+                , scratch_buf( scratch )
+                , scratch_os( &scratch_buf )
+            {
+                scratch_os.exceptions( ostream::badbit );
+            }
+
+            Json::EncodeOptions const options;
+            string_view const ellipsis;
+            string out;
+
+            Completion write_value( Json const &value, size_t limit ) {
+                switch ( value.get_typetag( false ) ) {
+                case Json::TT_ARRAY:
+                    return write_array( value.as_array(), limit );
+                case Json::TT_OBJECT:
+                    return write_object( value.as_object(), limit );
+                case Json::TT_STRING:
+                    if ( write_whole( value, limit ) )
+                        return FULL;
+                    return write_string( value.as_string(), limit );
+                default:
+                    scratch.clear();
+                    scratch_os << Json::OptionedWrite( value, options );
+                    if ( not fits( scratch.size(), limit ) )
+                        return NOTHING;
+                    out += scratch;
+                    return FULL;
+                }
+            }
+
+            void write_bare_ellipsis() {
+                out.push_back( '"' );
+                out.append( ellipsis );
+                out.push_back( '"' );
+            }
+
+        private:
+            string scratch;
+            jsrl_string_outbuf scratch_buf;
+            ostream scratch_os;
+
+            bool fits( size_t size, size_t limit ) const {
+                return out.size() <= limit && size <= limit - out.size();
+            }
+
+            // Length of ,"… N more" (the leading comma is always counted).
+            size_t array_marker_size( size_t omitted ) const {
+                if ( not omitted )
+                    return 0;
+                return 1 + 2 + ellipsis.size() + 1 + to_string( omitted ).size()
+                        + 5;
+            }
+            void write_array_marker( size_t omitted, bool comma ) {
+                if ( comma )
+                    out.push_back( ',' );
+                out.push_back( '"' );
+                out.append( ellipsis );
+                out.push_back( ' ' );
+                out += to_string( omitted );
+                out += " more\"";
+            }
+
+            // Length of ,"…":N (the leading comma is always counted).
+            size_t object_marker_size( size_t omitted ) const {
+                if ( not omitted )
+                    return 0;
+                return 1 + 2 + ellipsis.size() + 1 + to_string( omitted ).size();
+            }
+            void write_object_marker( size_t omitted, bool comma ) {
+                if ( comma )
+                    out.push_back( ',' );
+                out.push_back( '"' );
+                out.append( ellipsis );
+                out += "\":";
+                out += to_string( omitted );
+            }
+
+            Completion write_array( Json::ArrayBody const &body, size_t limit ) {
+                size_t const count = body.size();
+                size_t const start = out.size();
+                out.push_back( '[' );
+                if ( write_array_tail( body, 0, limit ) )
+                    return FULL;
+                out.resize( start );
+                if ( not fits( 1 + max<size_t>( 1, array_marker_size( count ) ),
+                            limit ) )
+                    return NOTHING;
+                out.push_back( '[' );
+                for ( size_t i = 0; i != count; ++i ) {
+                    size_t const rollback = out.size();
+                    // Keep room to close, and to count what follows.
+                    size_t const reserve = 1 + array_marker_size( count - i - 1 );
+                    if ( i )
+                        out.push_back( ',' );
+                    Completion const result = limit - out.size() < reserve
+                            ? NOTHING
+                            : write_value( body[i], limit - reserve );
+                    // Only cut if what's left doesn't fit without markers.
+                    if ( result != FULL && i != 0 && retry_tail( rollback, [&] {
+                                return write_array_tail( body, i, limit );
+                            } ) )
+                        return FULL;
+                    if ( result == NOTHING ) {
+                        out.resize( rollback );
+                        write_array_marker( count - i, i != 0 );
+                    } else if ( result == PARTIAL && i + 1 != count ) {
+                        write_array_marker( count - i - 1, true );
+                    }
+                    if ( result != FULL ) {
+                        out.push_back( ']' );
+                        return PARTIAL;
+                    }
+                }
+                out.push_back( ']' );
+                return FULL;
+            }
+
+            Completion write_object( Json::ObjectBody const &body, size_t limit ) {
+                size_t const count = body.size();
+                size_t const start = out.size();
+                out.push_back( '{' );
+                if ( write_object_tail( body, 0, limit ) )
+                    return FULL;
+                out.resize( start );
+                if ( not fits( 1 + max<size_t>( 1, object_marker_size( count ) ),
+                            limit ) )
+                    return NOTHING;
+                out.push_back( '{' );
+                for ( size_t i = 0; i != count; ++i ) {
+                    size_t const rollback = out.size();
+                    size_t const reserve = 1 + object_marker_size( count - i - 1 );
+                    if ( i )
+                        out.push_back( ',' );
+                    Completion result = NOTHING;
+                    if ( limit - out.size() >= reserve
+                            && write_key( body[i].first, limit - reserve ) ) {
+                        out.push_back( ':' );
+                        result = limit - out.size() < reserve
+                                ? NOTHING
+                                : write_value( body[i].second, limit - reserve );
+                    }
+                    if ( result != FULL && i != 0 && retry_tail( rollback, [&] {
+                                return write_object_tail( body, i, limit );
+                            } ) )
+                        return FULL;
+                    if ( result == NOTHING ) {
+                        out.resize( rollback );
+                        write_object_marker( count - i, i != 0 );
+                    } else if ( result == PARTIAL && i + 1 != count ) {
+                        write_object_marker( count - i - 1, true );
+                    }
+                    if ( result != FULL ) {
+                        out.push_back( '}' );
+                        return PARTIAL;
+                    }
+                }
+                out.push_back( '}' );
+                return FULL;
+            }
+
+            // Replace what was written from rollback on with the tail
+            // written by write_tail(), if that fits; else leave it be.
+            template<typename WriteTail>
+            bool retry_tail( size_t rollback, WriteTail &&write_tail ) {
+                string const partial = out.substr( rollback );
+                out.resize( rollback );
+                if ( write_tail() )
+                    return true;
+                out += partial;
+                return false;
+            }
+
+            // Elements from the one at from on, and the closing bracket,
+            // if they all fit; else the output is left as it was.
+            bool write_array_tail( Json::ArrayBody const &body, size_t from,
+                    size_t limit ) {
+                size_t const rollback = out.size();
+                for ( size_t i = from; i != body.size(); ++i ) {
+                    if ( i )
+                        out.push_back( ',' );
+                    if ( not write_whole( body[i], limit ) ) {
+                        out.resize( rollback );
+                        return false;
+                    }
+                }
+                out.push_back( ']' );
+                if ( not fits( 0, limit ) ) {
+                    out.resize( rollback );
+                    return false;
+                }
+                return true;
+            }
+
+            // Members from the one at from on, as write_array_tail.
+            bool write_object_tail( Json::ObjectBody const &body, size_t from,
+                    size_t limit ) {
+                size_t const rollback = out.size();
+                for ( size_t i = from; i != body.size(); ++i ) {
+                    if ( i )
+                        out.push_back( ',' );
+                    bool const fitted = write_key( body[i].first, limit );
+                    if ( fitted )
+                        out.push_back( ':' );
+                    if ( not fitted || not write_whole( body[i].second, limit ) ) {
+                        out.resize( rollback );
+                        return false;
+                    }
+                }
+                out.push_back( '}' );
+                if ( not fits( 0, limit ) ) {
+                    out.resize( rollback );
+                    return false;
+                }
+                return true;
+            }
+
+            // Write a value uncut, if it fits (leaving the output
+            // as it was if not). Stops as soon as the limit is passed,
+            // so the work done is bounded by the limit.
+            bool write_whole( Json const &value, size_t limit ) {
+                switch ( value.get_typetag( false ) ) {
+                case Json::TT_ARRAY:
+                    out.push_back( '[' );
+                    if ( write_array_tail( value.as_array(), 0, limit ) )
+                        return true;
+                    out.pop_back();
+                    return false;
+                case Json::TT_OBJECT:
+                    out.push_back( '{' );
+                    if ( write_object_tail( value.as_object(), 0, limit ) )
+                        return true;
+                    out.pop_back();
+                    return false;
+                case Json::TT_STRING:
+                    // Escaping never shortens a string.
+                    if ( not fits( value.as_string().size() + 2, limit ) )
+                        return false;
+                    scratch.clear();
+                    Json::write_JSON_string( scratch_os, value.as_string(),
+                            options.fail_bad_utf8, options.write_utf );
+                    break;
+                default:
+                    scratch.clear();
+                    scratch_os << Json::OptionedWrite( value, options );
+                }
+                if ( not fits( scratch.size(), limit ) )
+                    return false;
+                out += scratch;
+                return true;
+            }
+
+            // Keys are never cut; the colon is counted with them.
+            bool write_key( string_view key, size_t limit ) {
+                if ( not fits( key.size() + 3, limit ) )
+                    return false;
+                scratch.clear();
+                Json::write_JSON_string( scratch_os, key,
+                        options.fail_bad_utf8, options.write_utf );
+                if ( not fits( scratch.size() + 1, limit ) )
+                    return false;
+                out += scratch;
+                return true;
+            }
+
+            Completion write_string( string_view text, size_t limit ) {
+                if ( not fits( 2 + ellipsis.size(), limit ) )
+                    return NOTHING;
+                size_t const room = limit - out.size();
+                // Every input byte makes at least one output byte,
+                // so no more than the room left is worth escaping.
+                size_t cut = text.size();
+                if ( cut > room ) {
+                    cut = room;
+                    while ( cut && ( text[cut] & 0xC0 ) == 0x80 )
+                        --cut;
+                }
+                scratch.clear();
+                Json::write_JSON_string( scratch_os, text.substr( 0, cut ),
+                        options.fail_bad_utf8, options.write_utf );
+                if ( cut == text.size() && scratch.size() <= room ) {
+                    out += scratch;
+                    return FULL;
+                }
+                // Keep whole escapes and characters of the quoted content.
+                size_t const available = room - 2 - ellipsis.size();
+                size_t const content_end = scratch.size() - 1;
+                size_t used = 1;
+                while ( used != content_end ) {
+                    size_t const next = used + token_size( used );
+                    if ( next - 1 > available )
+                        break;
+                    used = next;
+                }
+                out.append( scratch, 0, used );
+                out.append( ellipsis );
+                out.push_back( '"' );
+                return PARTIAL;
+            }
+
+            // Size of the escape or character starting at scratch[pos].
+            size_t token_size( size_t pos ) const {
+                unsigned char const c = scratch[pos];
+                if ( c == '\\' ) {
+                    if ( scratch[pos + 1] != 'u' )
+                        return 2;
+                    // A high surrogate escape is kept with its low half.
+                    bool const high = ( scratch[pos + 2] == 'd'
+                            || scratch[pos + 2] == 'D' )
+                            && string_view( "89abAB" ).find( scratch[pos + 3] )
+                                    != string_view::npos;
+                    return high ? 12 : 6;
+                }
+                if ( c >= 0xF0 )
+                    return 4;
+                if ( c >= 0xE0 )
+                    return 3;
+                if ( c >= 0xC0 )
+                    return 2;
+                return 1;
+            }
+        };
+
+    }
+
+    string encode_bounded(
+            Json const &json,
+            size_t budget,
+            Json::EncodeOptions encode_options
+            )
+    {
+        BoundedWriter writer( encode_options );
+        if ( writer.write_value( json, budget ) == BoundedWriter::NOTHING )
+            writer.write_bare_ellipsis();
+        return std::move(writer.out);
+    }
+
+    string encode_bounded( Json const &json, size_t budget )
+    {
+        return encode_bounded( json, budget, Json::EncodeOptions(
+                    Json::EncodeOptions::TN_EXACT, false, false ) );
+    }
+
+}
+// vi: et ts=4 sts=4 sw=4
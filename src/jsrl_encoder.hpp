@@ -0,0 +1,132 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#ifndef JSRL_ENCODER_HPP_3F9A61C0D2B84E7791A5C36E0B8D24F7
+#define JSRL_ENCODER_HPP_3F9A61C0D2B84E7791A5C36E0B8D24F7
+
+#include "jsrl.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*! @file jsrl_encoder.hpp
+ *  @brief Incremental encoders.
+ *
+ *  These produce the same text as the stream insertion operators,
+ *  but let the caller decide when (and how much of) the output is made.
+ */
+namespace jsrl {
+    using std::string;
+    using std::unique_ptr;
+    using std::vector;
+
+    /*! @brief  Pull-based encoder producing a Json's encoding in chunks.
+     *
+     *  Each call to @ref next_chunk fills a caller-provided buffer
+     *  with the next bytes of the encoding;
+     *  the position in the tree is kept on an explicit stack between calls,
+     *  so no more than one scalar element is ever encoded ahead of demand.
+     *  This suits event loops writing to non-blocking sockets:
+     *  encode what the socket will take, and resume when it's writable.
+     *
+     *  Example:
+     *  @code
+     *      ChunkedEncoder encoder( response );
+     *      char buf[4096];
+     *      while ( size_t n = encoder.next_chunk( buf, sizeof buf ) )
+     *          send_all( fd, buf, n );
+     *  @endcode
+     *
+     *  The encoder holds a handle to the value it encodes,
+     *  so the value stays alive (and unchanged) for the encoder's lifetime.
+     */
+    struct ChunkedEncoder {
+        /*! @brief  Encode with exact numbers and escaped non-ASCII text.
+         */
+        explicit ChunkedEncoder( Json value );
+        /*! @brief  Encode with the given options.
+         */
+        ChunkedEncoder( Json value, Json::EncodeOptions encode_options );
+
+        ChunkedEncoder( ChunkedEncoder && ) noexcept;
+        ChunkedEncoder &operator=( ChunkedEncoder && ) noexcept;
+        ~ChunkedEncoder();
+
+        /*! @brief  Write the next bytes of the encoding.
+         *
+         *  @return The number of bytes written to @c buf (at most @c cap).
+         *      Zero means the encoding is complete (given a nonzero @c cap).
+         *  @throw Json::EncodeError    A string couldn't be encoded
+         *      under the requested options;
+         *      the encoder can't be resumed afterwards.
+         */
+        size_t next_chunk( char *buf, size_t cap );
+
+        /*! @brief  Test whether every byte has been produced.
+         */
+        bool done() const;
+
+    private:
+        struct Frame {
+            Json container;
+            size_t index;       // Next element to encode.
+        };
+        struct Output;
+
+        bool p_refill();
+        void p_open( Json const &value );
+
+        Json m_root;
+        Json::EncodeOptions m_options;
+        vector<Frame> m_stack;
+        bool m_started = false;
+        unique_ptr<Output> m_output;    // Bytes staged for the caller.
+    };
+
+    /*! @brief  Encode at most @c budget bytes of a value, as valid JSON.
+     *
+     *  Encoding stops where the budget runs out,
+     *  and what was left out is marked:
+     *  - a cut string ends in an ellipsis (@c "abc…");
+     *  - an array's missing tail is replaced by one string element
+     *    counting the missing elements (@c [1,2,"… 998 more"]);
+     *  - an object's missing keys are counted
+     *    under an ellipsis key (@c {"a":1,"…":12}).
+     *
+     *  A value whose encoding fits the budget is written unchanged.
+     *  Otherwise room for markers is set aside while writing
+     *  (unless what's left of a container fits without them),
+     *  so a cut result can end somewhat short of the budget.
+     *  The work done is proportional to the output, not the input:
+     *  elements past the budget aren't visited,
+     *  and long strings are only escaped as far as they're written.
+     *  A value that can't be started within the budget
+     *  (even as a marker) is written as a bare @c "…",
+     *  which is the only case where the budget is exceeded.
+     *
+     *  @throw Json::EncodeError    Bad UTF-8, if the options require failure.
+     */
+    string encode_bounded(
+            Json const &json,
+            size_t budget,
+            Json::EncodeOptions encode_options
+            );
+    /*! @overload
+     *
+     *  Numbers are written exactly and non-ASCII text escaped.
+     */
+    string encode_bounded( Json const &json, size_t budget );
+
+}
+#endif
+// vi: et ts=4 sts=4 sw=4
@@ -0,0 +1,100 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#include "jsrl_enrich.hpp"
+#include "jsrl_impl_util.hpp"
+
+#include <algorithm>
+
+namespace jsrl {
+
+    ReferenceIndex::ReferenceIndex( Json reference, JsonPointer key )
+        : m_reference( std::move(reference) )
+        , m_key( std::move(key) )
+    {
+        Json::ArrayBody const &elements = m_reference.as_array();
+        // At most half full, so that probes stay short.
+        size_t capacity = 16;
+        while ( capacity < 2 * elements.size() )
+            capacity *= 2;
+        m_slots.assign( capacity, Slot{ 0, nullptr, nullptr } );
+        size_t const mask = capacity - 1;
+        for ( auto &&element : elements ) {
+            Json const *const value = m_key.find( element );
+            if ( not value || value->is_null() )
+                continue;
+            uint64_t const hash = json_value_hash( *value );
+            for ( size_t i = size_t( hash ) & mask;; i = ( i + 1 ) & mask ) {
+                Slot &slot = m_slots[i];
+                if ( not slot.key ) {
+                    slot = Slot{ hash, value, &element };
+                    ++m_size;
+                    break;
+                }
+                if ( slot.hash == hash && json_value_compare( *slot.key, *value ) == 0 )
+                    break;
+            }
+        }
+    }
+
+    Json const *ReferenceIndex::find( Json const &key ) const
+    {
+        uint64_t const hash = json_value_hash( key );
+        size_t const mask = m_slots.size() - 1;
+        for ( size_t i = size_t( hash ) & mask;; i = ( i + 1 ) & mask ) {
+            Slot const &slot = m_slots[i];
+            if ( not slot.key )
+                return nullptr;
+            if ( slot.hash == hash && json_value_compare( *slot.key, key ) == 0 )
+                return slot.element;
+        }
+    }
+
+    Enricher::Enricher(
+            std::shared_ptr<ReferenceIndex const> index,
+            JsonPointer key,
+            string field,
+            bool keep_unmatched
+            )
+        : m_index( std::move(index) )
+        , m_key( std::move(key) )
+        , m_field( std::move(field) )
+        , m_keep_unmatched( keep_unmatched )
+    { }
+
+    bool Enricher::operator()( Json &record ) const
+    {
+        Json const *const key = m_key.find( record );
+        Json const *const match = key && not key->is_null() ? m_index->find( *key ) : nullptr;
+        if ( not match )
+            return m_keep_unmatched;
+        record = with_member( record, m_field, *match );
+        return true;
+    }
+
+    Json with_member( Json const &object, string const &name, Json value )
+    {
+        Json::ObjectBody const &members = object.as_object();
+        auto const at = std::lower_bound( members.begin(), members.end(), name,
+                []( std::pair<string,Json> const &member, string const &name ) {
+                    return member.first < name;
+                } );
+        bool const replaces = at != members.end() && at->first == name;
+        Json::ObjectBody body;
+        body.reserve( members.size() + ( replaces ? 0 : 1 ) );
+        body.insert( body.end(), members.begin(), at );
+        body.emplace_back( name, std::move(value) );
+        body.insert( body.end(), replaces ? at + 1 : at, members.end() );
+        return Json( std::move(body) );
+    }
+
+}
+// vi: et ts=4 sts=4 sw=4
@@ -0,0 +1,130 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#ifndef JSRL_ENRICH_HPP_A0C6E93F17B24D58C3E1F7092B6D4A8E
+#define JSRL_ENRICH_HPP_A0C6E93F17B24D58C3E1F7092B6D4A8E
+
+#include "jsrl.hpp"
+#include "jsrl_pointer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*! @file jsrl_enrich.hpp
+ *  @brief Enriching records from a reference table.
+ */
+namespace jsrl {
+    using std::size_t;
+    using std::string;
+    using std::uint64_t;
+
+    /*! @brief  Immutable hash index of a reference array's elements
+     *          by the value at a key path.
+     *
+     *  Built once, the index is only read afterwards,
+     *  so any number of threads may probe it at once without locking.
+     *  Keys compare like @ref json_value_compare,
+     *  so a record's @c 1.0 finds the element keyed @c 1.
+     *  Elements without a key (or with a null one) aren't indexed,
+     *  and where keys repeat, the first element is kept.
+     */
+    struct ReferenceIndex {
+        /*! @brief  Index the elements of @c reference by the value at @c key.
+         *
+         *  @throw Json::TypeError @c reference isn't an array.
+         */
+        ReferenceIndex( Json reference, JsonPointer key );
+        ReferenceIndex( ReferenceIndex const & ) = delete;
+        ReferenceIndex &operator=( ReferenceIndex const & ) = delete;
+
+        /*! @brief  The element whose key equals @c key, or null if none.
+         *
+         *  The element belongs to the index's reference array.
+         */
+        Json const *find( Json const &key ) const;
+
+        size_t size() const { return m_size; }      //!< Elements indexed.
+        Json const &reference() const { return m_reference; }
+        JsonPointer const &key() const { return m_key; }
+
+    private:
+        struct Slot {
+            uint64_t hash;
+            Json const *key;        // Null for an empty slot.
+            Json const *element;
+        };
+
+        Json const m_reference;
+        JsonPointer const m_key;
+        std::vector<Slot> m_slots;  // Open addressing, a power of two long.
+        size_t m_size = 0;
+    };
+
+    /*! @brief  Attaches to each record the reference element
+     *          matching the value at a key path.
+     *
+     *  The element is attached as a handle to the index's own value,
+     *  without copying it, and the record's new body is built
+     *  with its members kept in order, in one pass.
+     *  A call is a @ref Pipeline::Transform, so it can be a pipeline stage,
+     *  with any number of threads sharing one index.
+     *
+     *  Example:
+     *  @code
+     *      auto customers = std::make_shared<ReferenceIndex const>(
+     *              Json::parse( customers_text ), JsonPointer( "/id" ) );
+     *      pipeline.stage( "enrich",
+     *              Enricher( customers, JsonPointer( "/customer_id" ), "customer" ),
+     *              8 );
+     *  @endcode
+     */
+    struct Enricher {
+        /*! @param  index       The reference elements.
+         *  @param  key         Where each record holds its key.
+         *  @param  field       The member the element is set as.
+         *  @param  keep_unmatched  Pass on records without a match
+         *                          (unchanged), rather than dropping them.
+         */
+        Enricher(
+                std::shared_ptr<ReferenceIndex const> index,
+                JsonPointer key,
+                string field,
+                bool keep_unmatched = true
+                );
+
+        /*! @brief  Attach the matching element to @c record.
+         *
+         *  @return Whether to keep the record.
+         *  @throw Json::TypeError A match was found,
+         *                         but @c record isn't an object.
+         */
+        bool operator()( Json &record ) const;
+
+    private:
+        std::shared_ptr<ReferenceIndex const> m_index;
+        JsonPointer m_key;
+        string m_field;
+        bool m_keep_unmatched;
+    };
+
+    /*! @brief  A copy of an object with member @c name set to @c value,
+     *          replacing any it had; built in one pass over its sorted body.
+     *
+     *  @throw Json::TypeError @c object isn't an object.
+     */
+    Json with_member( Json const &object, string const &name, Json value );
+
+}
+#endif
+// vi: et ts=4 sts=4 sw=4
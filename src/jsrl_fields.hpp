@@ -0,0 +1,462 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#ifndef JSRL_FIELDS_HPP_E51B7C3A9D0F4628B4E1A6C8D2F07B93
+#define JSRL_FIELDS_HPP_E51B7C3A9D0F4628B4E1A6C8D2F07B93
+
+#include "jsrl.hpp"
+#include "jsrl_reader.hpp"
+
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*! @file jsrl_fields.hpp
+ *  @brief Encoding and decoding structs directly, without @c Json trees.
+ *
+ *  List a struct's members with @ref JSRL_FIELDS
+ *  (at namespace scope, in the struct's namespace):
+ *  @code
+ *      struct Point { double x, y; string label; };
+ *      JSRL_FIELDS( Point, x, y, label )
+ *
+ *      string text = jsrl::encode_fields( point );
+ *      // {"x":1.5,"y":-2,"label":"origin"}
+ *      Point copy = jsrl::decode_fields<Point>( text );
+ *  @endcode
+ *
+ *  Encoding appends to one output string;
+ *  decoding reads the text with a @ref JsonReader
+ *  straight into the members.
+ *  Members can be @c bool, arithmetic types, @c string, @c Json,
+ *  @c vector and @c optional of supported types,
+ *  and other structs with @c JSRL_FIELDS;
+ *  specialize @ref FieldCodec to add more.
+ *
+ *  When decoding, unknown keys are skipped,
+ *  missing keys leave members as they were,
+ *  and the last of duplicate keys wins.
+ */
+namespace jsrl {
+
+    /*! @brief  How one member type is written and read.
+     *
+     *  Specializations provide
+     *  @code
+     *      static void write( string &out, V const &value );
+     *      static void read( JsonReader &reader, V &value );
+     *  @endcode
+     */
+    template<typename V, typename Enable = void>
+    struct FieldCodec;
+
+    namespace fields_impl {
+        template<typename C, typename M>
+        struct Field {
+            std::string_view name;
+            M C::*member;
+        };
+
+        template<typename C, typename M>
+        constexpr Field<C, M> make_field( std::string_view name, M C::*member ) {
+            return Field<C, M>{ name, member };
+        }
+
+        template<typename T, typename = void>
+        struct has_fields : std::false_type { };
+        template<typename T>
+        struct has_fields<T, std::void_t<
+                decltype( jsrl_fields( static_cast<T const*>( nullptr ) ) )>>
+            : std::true_type { };
+
+        template<typename T>
+        auto const &fields_of() {
+            static auto const fields
+                    = jsrl_fields( static_cast<T const*>( nullptr ) );
+            return fields;
+        }
+
+        template<typename Tuple, size_t... I>
+        auto names_of( Tuple const &fields, std::index_sequence<I...> ) {
+            return std::array<std::string_view, sizeof...(I)>{
+                std::get<I>( fields ).name... };
+        }
+
+        template<typename V>
+        void write_value( string &out, V const &value ) {
+            FieldCodec<V>::write( out, value );
+        }
+        template<typename V>
+        void read_value( JsonReader &reader, V &value ) {
+            FieldCodec<V>::read( reader, value );
+        }
+
+        template<typename T, typename Tuple, size_t... I>
+        void write_object(
+                string &out,
+                T const &value,
+                Tuple const &fields,
+                std::index_sequence<I...>
+                ) {
+            out.push_back( '{' );
+            ( ( out.append( I ? ",\"" : "\"" ),
+                out.append( std::get<I>( fields ).name ),
+                out.append( "\":" ),
+                write_value( out, value.*( std::get<I>( fields ).member ) ) ),
+              ... );
+            out.push_back( '}' );
+        }
+
+        template<typename T, typename Tuple, size_t... I>
+        void read_member(
+                JsonReader &reader,
+                T &value,
+                Tuple const &fields,
+                size_t index,
+                std::index_sequence<I...>
+                ) {
+            static_cast<void>( (
+                ( index == I
+                  && ( read_value( reader,
+                            value.*( std::get<I>( fields ).member ) ), true ) )
+                || ... ) );
+        }
+
+        template<typename T>
+        void read_object( JsonReader &reader, T &value ) {
+            auto const &fields = fields_of<T>();
+            constexpr size_t count
+                    = std::tuple_size<std::decay_t<decltype( fields )>>::value;
+            using Indices = std::make_index_sequence<count>;
+            static auto const names = names_of( fields, Indices() );
+            thread_local string key;
+            reader.enter_object();
+            // Keys usually come in declaration order,
+            // so the search starts just after the last match.
+            size_t next = 0;
+            while ( reader.next_key( key ) ) {
+                size_t index = count;
+                for ( size_t n = 0; n != count; ++n ) {
+                    size_t const candidate = ( next + n ) % count;
+                    if ( names[candidate] == key ) {
+                        index = candidate;
+                        break;
+                    }
+                }
+                if ( index == count ) {
+                    reader.skip_value();
+                    continue;
+                }
+                read_member( reader, value, fields, index, Indices() );
+                next = index + 1;
+            }
+        }
+
+        template<typename V>
+        void write_number( string &out, V value ) {
+            char buf[ 64 ];
+            auto const result = std::to_chars( buf, buf + sizeof buf, value );
+            out.append( buf, result.ptr );
+        }
+    }
+
+    template<>
+    struct FieldCodec<bool> {
+        static void write( string &out, bool value ) {
+            out.append( value ? "true" : "false" );
+        }
+        static void read( JsonReader &reader, bool &value ) {
+            value = reader.read_bool();
+        }
+    };
+
+    template<typename V>
+    struct FieldCodec<V, std::enable_if_t<
+            std::is_integral<V>::value && not std::is_same<V, bool>::value>> {
+        static void write( string &out, V value ) {
+            fields_impl::write_number( out, value );
+        }
+        static void read( JsonReader &reader, V &value ) {
+            using limits = std::numeric_limits<V>;
+            if constexpr ( std::is_signed<V>::value ) {
+                long long const n = reader.read_sint();
+                if ( n < (long long)( limits::min() )
+                        || n > (long long)( limits::max() ) )
+                    throw Json::NumberParseError( "Number out of range" );
+                value = V( n );
+            } else {
+                long long unsigned const n = reader.read_uint();
+                if ( n > (long long unsigned)( limits::max() ) )
+                    throw Json::NumberParseError( "Number out of range" );
+                value = V( n );
+            }
+        }
+    };
+
+    /*! @brief  Floating point members are written with the fewest digits
+     *          that read back exactly; NaN and infinities are written as
+     *          @c null (and read back as NaN).
+     */
+    template<typename V>
+    struct FieldCodec<V, std::enable_if_t<std::is_floating_point<V>::value>> {
+        static void write( string &out, V value ) {
+            if ( not std::isfinite( value ) )
+                out.append( "null" );
+            else
+                fields_impl::write_number( out, value );
+        }
+        static void read( JsonReader &reader, V &value ) {
+            if ( reader.peek() == JsonReader::TK_NULL ) {
+                reader.read_null();
+                value = std::numeric_limits<V>::quiet_NaN();
+            } else {
+                value = V( reader.read_double() );
+            }
+        }
+    };
+
+    template<>
+    struct FieldCodec<string> {
+        static void write( string &out, string const &value ) {
+            Json::append_JSON_string( out, value );
+        }
+        static void read( JsonReader &reader, string &value ) {
+            reader.read_string( value );
+        }
+    };
+
+    template<>
+    struct FieldCodec<Json> {
+        static void write( string &out, Json const &value ) {
+            out.append( encode( value ) );
+        }
+        static void read( JsonReader &reader, Json &value ) {
+            value = reader.read_value();
+        }
+    };
+
+    template<typename E>
+    struct FieldCodec<std::vector<E>> {
+        static void write( string &out, std::vector<E> const &value ) {
+            out.push_back( '[' );
+            bool first = true;
+            for ( auto &&item : value ) {
+                if ( not first )
+                    out.push_back( ',' );
+                first = false;
+                fields_impl::write_value<E>( out, item );
+            }
+            out.push_back( ']' );
+        }
+        static void read( JsonReader &reader, std::vector<E> &value ) {
+            value.clear();
+            reader.enter_array();
+            while ( reader.next_element() ) {
+                if constexpr ( std::is_same<E, bool>::value ) {
+                    value.push_back( reader.read_bool() );
+                } else {
+                    value.emplace_back();
+                    fields_impl::read_value( reader, value.back() );
+                }
+            }
+        }
+    };
+
+    template<typename E>
+    struct FieldCodec<std::optional<E>> {
+        static void write( string &out, std::optional<E> const &value ) {
+            if ( value )
+                fields_impl::write_value( out, *value );
+            else
+                out.append( "null" );
+        }
+        static void read( JsonReader &reader, std::optional<E> &value ) {
+            if ( reader.peek() == JsonReader::TK_NULL ) {
+                reader.read_null();
+                value.reset();
+            } else {
+                fields_impl::read_value( reader, value.emplace() );
+            }
+        }
+    };
+
+    template<typename T>
+    struct FieldCodec<T, std::enable_if_t<fields_impl::has_fields<T>::value>> {
+        static void write( string &out, T const &value ) {
+            auto const &fields = fields_impl::fields_of<T>();
+            fields_impl::write_object( out, value, fields,
+                    std::make_index_sequence<std::tuple_size<
+                        std::decay_t<decltype( fields )>>::value>() );
+        }
+        static void read( JsonReader &reader, T &value ) {
+            fields_impl::read_object( reader, value );
+        }
+    };
+
+    /*! @brief  Append the JSON encoding of a value to @c out.
+     */
+    template<typename T>
+    void encode_fields_into( string &out, T const &value ) {
+        FieldCodec<T>::write( out, value );
+    }
+
+    /*! @brief  Encode a value (usually a struct with @ref JSRL_FIELDS).
+     */
+    template<typename T>
+    string encode_fields( T const &value ) {
+        string out;
+        encode_fields_into( out, value );
+        return out;
+    }
+
+    /*! @brief  Read the next value from a reader into @c value.
+     *
+     *  @throw Json::ParseError The input doesn't match the value's type.
+     */
+    template<typename T>
+    void read_fields( JsonReader &reader, T &value ) {
+        FieldCodec<T>::read( reader, value );
+    }
+
+    /*! @brief  Decode JSON text (all of it) into @c value.
+     *
+     *  @throw Json::ParseError The input doesn't match the value's type.
+     */
+    template<typename T>
+    void decode_fields( string_view text, T &value ) {
+        JsonReader reader( text );
+        read_fields( reader, value );
+        reader.finish();
+    }
+
+    /*! @overload */
+    template<typename T>
+    T decode_fields( string_view text ) {
+        T value{};
+        decode_fields( text, value );
+        return value;
+    }
+
+}
+
+/*! @brief  List the members of @c Type to encode and decode.
+ *
+ *  Use at namespace scope, in the namespace of @c Type;
+ *  the members must be accessible there.
+ *  Up to 32 members can be listed,
+ *  and are encoded under their own names, in the order given.
+ */
+#define JSRL_FIELDS(Type, ...) \
+    inline auto jsrl_fields( Type const * ) { \
+        using jsrl_fields_type = Type; \
+        return std::make_tuple( JSRL_FIELDS_IMPL_MAP( \
+                    JSRL_FIELDS_IMPL_FIELD, __VA_ARGS__ ) ); \
+    }
+
+#define JSRL_FIELDS_IMPL_FIELD(name) \
+    ::jsrl::fields_impl::make_field( #name, &jsrl_fields_type::name )
+
+// The extra expansions keep MSVC's preprocessor
+// from passing __VA_ARGS__ on as a single argument.
+#define JSRL_FIELDS_IMPL_EXPAND(x) x
+#define JSRL_FIELDS_IMPL_CAT(a, b) JSRL_FIELDS_IMPL_CAT_(a, b)
+#define JSRL_FIELDS_IMPL_CAT_(a, b) a##b
+#define JSRL_FIELDS_IMPL_MAP(f, ...) \
+    JSRL_FIELDS_IMPL_EXPAND(JSRL_FIELDS_IMPL_CAT( \
+            JSRL_FIELDS_IMPL_MAP_, JSRL_FIELDS_IMPL_COUNT(__VA_ARGS__) \
+            )(f, __VA_ARGS__))
+#define JSRL_FIELDS_IMPL_COUNT(...) \
+    JSRL_FIELDS_IMPL_EXPAND(JSRL_FIELDS_IMPL_NTH(__VA_ARGS__, \
+            32, 31, 30, 29, 28, 27, 26, 25, \
+            24, 23, 22, 21, 20, 19, 18, 17, \
+            16, 15, 14, 13, 12, 11, 10, 9, \
+            8, 7, 6, 5, 4, 3, 2, 1))
+#define JSRL_FIELDS_IMPL_NTH( \
+        _1, _2, _3, _4, _5, _6, _7, _8, \
+        _9, _10, _11, _12, _13, _14, _15, _16, \
+        _17, _18, _19, _20, _21, _22, _23, _24, \
+        _25, _26, _27, _28, _29, _30, _31, _32, \
+        N, ...) N
+#define JSRL_FIELDS_IMPL_MAP_1(f, x) f(x)
+#define JSRL_FIELDS_IMPL_MAP_2(f, x, ...) \
+    f(x), JSRL_FIELDS_IMPL_EXPAND(JSRL_FIELDS_IMPL_MAP_1(f, __VA_ARGS__))
+#define JSRL_FIELDS_IMPL_MAP_3(f, x, ...) \
+    f(x), JSRL_FIELDS_IMPL_EXPAND(JSRL_FIELDS_IMPL_MAP_2(f, __VA_ARGS__))
+#define JSRL_FIELDS_IMPL_MAP_4(f, x, ...) \
+    f(x), JSRL_FIELDS_IMPL_EXPAND(JSRL_FIELDS_IMPL_MAP_3(f, __VA_ARGS__))
+#define JSRL_FIELDS_IMPL_MAP_5(f, x, ...) \
+    f(x), JSRL_FIELDS_IMPL_EXPAND(JSRL_FIELDS_IMPL_MAP_4(f, __VA_ARGS__))
+#define JSRL_FIELDS_IMPL_MAP_6(f, x, ...) \
+    f(x), JSRL_FIELDS_IMPL_EXPAND(JSRL_FIELDS_IMPL_MAP_5(f, __VA_ARGS__))
+#define JSRL_FIELDS_IMPL_MAP_7(f, x, ...) \
+    f(x), JSRL_FIELDS_IMPL_EXPAND(JSRL_FIELDS_IMPL_MAP_6(f, __VA_ARGS__))
+#define JSRL_FIELDS_IMPL_MAP_8(f, x, ...) \
+    f(x), JSRL_FIELDS_IMPL_EXPAND(JSRL_FIELDS_IMPL_MAP_7(f, __VA_ARGS__))
+#define JSRL_FIELDS_IMPL_MAP_9(f, x, ...) \
+    f(x), JSRL_FIELDS_IMPL_EXPAND(JSRL_FIELDS_IMPL_MAP_8(f, __VA_ARGS__))
+#define JSRL_FIELDS_IMPL_MAP_10(f, x, ...) \
+    f(x), JSRL_FIELDS_IMPL_EXPAND(JSRL_FIELDS_IMPL_MAP_9(f, __VA_ARGS__))
+#define JSRL_FIELDS_IMPL_MAP_11(f, x, ...) \
+    f(x), JSRL_FIELDS_IMPL_EXPAND(JSRL_FIELDS_IMPL_MAP_10(f, __VA_ARGS__))
+#define JSRL_FIELDS_IMPL_MAP_12(f, x, ...) \
+    f(x), JSRL_FIELDS_IMPL_EXPAND(JSRL_FIELDS_IMPL_MAP_11(f, __VA_ARGS__))
+#define JSRL_FIELDS_IMPL_MAP_13(f, x, ...) \
+    f(x), JSRL_FIELDS_IMPL_EXPAND(JSRL_FIELDS_IMPL_MAP_12(f, __VA_ARGS__))
+#define JSRL_FIELDS_IMPL_MAP_14(f, x, ...) \
+    f(x), JSRL_FIELDS_IMPL_EXPAND(JSRL_FIELDS_IMPL_MAP_13(f, __VA_ARGS__))
+#define JSRL_FIELDS_IMPL_MAP_15(f, x, ...) \
+    f(x), JSRL_FIELDS_IMPL_EXPAND(JSRL_FIELDS_IMPL_MAP_14(f, __VA_ARGS__))
+#define JSRL_FIELDS_IMPL_MAP_16(f, x, ...) \
+    f(x), JSRL_FIELDS_IMPL_EXPAND(JSRL_FIELDS_IMPL_MAP_15(f, __VA_ARGS__))
+#define JSRL_FIELDS_IMPL_MAP_17(f, x, ...) \
+    f(x), JSRL_FIELDS_IMPL_EXPAND(JSRL_FIELDS_IMPL_MAP_16(f, __VA_ARGS__))
+#define JSRL_FIELDS_IMPL_MAP_18(f, x, ...) \
+    f(x), JSRL_FIELDS_IMPL_EXPAND(JSRL_FIELDS_IMPL_MAP_17(f, __VA_ARGS__))
+#define JSRL_FIELDS_IMPL_MAP_19(f, x, ...) \
+    f(x), JSRL_FIELDS_IMPL_EXPAND(JSRL_FIELDS_IMPL_MAP_18(f, __VA_ARGS__))
+#define JSRL_FIELDS_IMPL_MAP_20(f, x, ...) \
+    f(x), JSRL_FIELDS_IMPL_EXPAND(JSRL_FIELDS_IMPL_MAP_19(f, __VA_ARGS__))
+#define JSRL_FIELDS_IMPL_MAP_21(f, x, ...) \
+    f(x), JSRL_FIELDS_IMPL_EXPAND(JSRL_FIELDS_IMPL_MAP_20(f, __VA_ARGS__))
+#define JSRL_FIELDS_IMPL_MAP_22(f, x, ...) \
+    f(x), JSRL_FIELDS_IMPL_EXPAND(JSRL_FIELDS_IMPL_MAP_21(f, __VA_ARGS__))
+#define JSRL_FIELDS_IMPL_MAP_23(f, x, ...) \
+    f(x), JSRL_FIELDS_IMPL_EXPAND(JSRL_FIELDS_IMPL_MAP_22(f, __VA_ARGS__))
+#define JSRL_FIELDS_IMPL_MAP_24(f, x, ...) \
+    f(x), JSRL_FIELDS_IMPL_EXPAND(JSRL_FIELDS_IMPL_MAP_23(f, __VA_ARGS__))
+#define JSRL_FIELDS_IMPL_MAP_25(f, x, ...) \
+    f(x), JSRL_FIELDS_IMPL_EXPAND(JSRL_FIELDS_IMPL_MAP_24(f, __VA_ARGS__))
+#define JSRL_FIELDS_IMPL_MAP_26(f, x, ...) \
+    f(x), JSRL_FIELDS_IMPL_EXPAND(JSRL_FIELDS_IMPL_MAP_25(f, __VA_ARGS__))
+#define JSRL_FIELDS_IMPL_MAP_27(f, x, ...) \
+    f(x), JSRL_FIELDS_IMPL_EXPAND(JSRL_FIELDS_IMPL_MAP_26(f, __VA_ARGS__))
+#define JSRL_FIELDS_IMPL_MAP_28(f, x, ...) \
+    f(x), JSRL_FIELDS_IMPL_EXPAND(JSRL_FIELDS_IMPL_MAP_27(f, __VA_ARGS__))
+#define JSRL_FIELDS_IMPL_MAP_29(f, x, ...) \
+    f(x), JSRL_FIELDS_IMPL_EXPAND(JSRL_FIELDS_IMPL_MAP_28(f, __VA_ARGS__))
+#define JSRL_FIELDS_IMPL_MAP_30(f, x, ...) \
+    f(x), JSRL_FIELDS_IMPL_EXPAND(JSRL_FIELDS_IMPL_MAP_29(f, __VA_ARGS__))
+#define JSRL_FIELDS_IMPL_MAP_31(f, x, ...) \
+    f(x), JSRL_FIELDS_IMPL_EXPAND(JSRL_FIELDS_IMPL_MAP_30(f, __VA_ARGS__))
+#define JSRL_FIELDS_IMPL_MAP_32(f, x, ...) \
+    f(x), JSRL_FIELDS_IMPL_EXPAND(JSRL_FIELDS_IMPL_MAP_31(f, __VA_ARGS__))
+
+#endif
+// vi: et ts=4 sts=4 sw=4
@@ -0,0 +1,539 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#include "jsrl_groupby.hpp"
+#include "jsrl_general_number.hpp"
+#include "jsrl_impl_util.hpp"
+#include "jsrl_ndjson.hpp"
+#include "jsrl_predicate.hpp"
+#include "jsrl_queue.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <thread>
+#include <unordered_map>
+
+namespace jsrl {
+    using std::memory_order_acquire;
+    using std::memory_order_release;
+    using std::vector;
+
+    namespace {
+        size_t const npos = size_t( -1 );
+
+        // Exact decimal sum: a digit per power of ten, least significant
+        // first. Digits may go out of 0..9 (or negative) between the
+        // occasional carrying passes, so adding costs a pass over the
+        // number's own digits and nothing more.
+        struct DecimalSum {
+            void add( GeneralNumber const &number ) {
+                decimal = decimal || number.is_decimal();
+                Digits const digits = number.digits();
+                if ( digits.empty() )
+                    return;
+                int const top = number.exponent() - 1;
+                int const bottom = top - int( digits.size() ) + 1;
+                p_extend( bottom, top );
+                int64_t const sign = number.is_negative() ? -1 : 1;
+                for ( size_t i = 0; i != digits.size(); ++i ) {
+                    places[ size_t( top - int( i ) - low ) ]
+                            += sign * ( digits.data()[i] - '0' );
+                }
+                if ( ++pending == 1u << 20 )
+                    p_carry();
+            }
+
+            void add( DecimalSum const &other ) {
+                decimal = decimal || other.decimal;
+                if ( other.places.empty() )
+                    return;
+                p_extend( other.low, other.low + int( other.places.size() ) - 1 );
+                for ( size_t i = 0; i != other.places.size(); ++i )
+                    places[ size_t( other.low + int( i ) - low ) ] += other.places[i];
+                p_carry();
+            }
+
+            GeneralNumber value() const {
+                DecimalSum sum = *this;
+                sum.p_carry();
+                auto &p = sum.places;
+                // Digits are now within -9..9,
+                // and the leading non-zero one has the sum's sign.
+                size_t top = p.size();
+                while ( top && p[top - 1] == 0 )
+                    --top;
+                if ( not top )
+                    return GeneralNumber( decimal, false, 0, vector<char>() );
+                bool const negative = p[top - 1] < 0;
+                int64_t borrow = 0;
+                for ( size_t i = 0; i != top; ++i ) {
+                    int64_t digit = ( negative ? -p[i] : p[i] ) + borrow;
+                    borrow = digit < 0 ? -1 : 0;
+                    p[i] = digit - 10 * borrow;
+                }
+                while ( top && p[top - 1] == 0 )
+                    --top;
+                int const exponent = sum.low + int( top );
+                if ( exponent > INT16_MAX || exponent - int( top ) < INT16_MIN ) {
+                    throw GeneralNumber::NumberParseError(
+                            "Range error in exponent" );
+                }
+                vector<char> digits;
+                for ( size_t i = top; i--; )
+                    digits.push_back( char( '0' + p[i] ) );
+                return GeneralNumber( decimal, negative, int16_t( exponent ),
+                        std::move(digits) );
+            }
+
+            int low = 0;                // Power of ten of places[0].
+            vector<int64_t> places;
+            bool decimal = false;       // Some number added had a fraction.
+            uint32_t pending = 0;       // Additions since carrying.
+
+        private:
+            void p_extend( int bottom, int top ) {
+                if ( places.empty() ) {
+                    low = bottom;
+                    places.assign( size_t( top - bottom + 1 ), 0 );
+                    return;
+                }
+                if ( bottom < low ) {
+                    places.insert( places.begin(), size_t( low - bottom ), 0 );
+                    low = bottom;
+                }
+                if ( size_t( top - low + 1 ) > places.size() )
+                    places.resize( size_t( top - low + 1 ), 0 );
+            }
+
+            // Bring each digit within -9..9, keeping the value.
+            void p_carry() {
+                int64_t carry = 0;
+                for ( auto &&place : places ) {
+                    int64_t const digit = place + carry;
+                    carry = digit / 10;
+                    place = digit % 10;
+                }
+                for ( ; carry; carry /= 10 )
+                    places.push_back( carry % 10 );
+                pending = 0;
+            }
+        };
+
+        struct Accumulator {
+            uint64_t count = 0;     // Values taken (or records, for a count).
+            long long integer = 0;  // Sum while every number is a fitting integer.
+            bool integral = true;
+            long double real = 0;
+            DecimalSum exact;
+            Json extreme;           // Least or greatest value.
+            vector<unsigned char> registers;
+
+            static bool add_fits( long long &sum, long long value ) {
+                if ( ( value > 0 && sum > LLONG_MAX - value )
+                        || ( value < 0 && sum < LLONG_MIN - value ) )
+                    return false;
+                sum += value;
+                return true;
+            }
+
+            void add_integer( long long value ) {
+                real += value;
+                integral = integral && add_fits( integer, value );
+            }
+
+            void add_number( Json const &number, bool exact_sums ) {
+                if ( exact_sums ) {
+                    exact.add( number_as_general( number ) );
+                } else if ( number.is_number_sint() ) {
+                    add_integer( number.as_number_sint() );
+                } else if ( number.is_number_uint()
+                        && number.as_number_uint() <= LLONG_MAX ) {
+                    add_integer( static_cast<long long>( number.as_number_uint() ) );
+                } else {
+                    integral = false;
+                    real += number.as_number_float();
+                }
+            }
+
+            void merge( Accumulator const &other, Aggregate::Kind kind ) {
+                switch ( kind ) {
+                case Aggregate::AG_MIN:
+                case Aggregate::AG_MAX:
+                    if ( other.count && ( not count
+                                || ( json_value_compare( other.extreme, extreme ) < 0 )
+                                    == ( kind == Aggregate::AG_MIN ) ) )
+                        extreme = other.extreme;
+                    break;
+                case Aggregate::AG_SUM:
+                case Aggregate::AG_AVG:
+                    exact.add( other.exact );
+                    real += other.real;
+                    integral = integral && other.integral
+                            && add_fits( integer, other.integer );
+                    break;
+                case Aggregate::AG_DISTINCT:
+                    if ( registers.empty() ) {
+                        registers = other.registers;
+                    } else {
+                        for ( size_t i = 0; i != other.registers.size(); ++i )
+                            registers[i] = std::max( registers[i], other.registers[i] );
+                    }
+                    break;
+                default:
+                    break;
+                }
+                count += other.count;
+            }
+
+            long double sum_value( bool exact_sums ) const {
+                if ( exact_sums )
+                    return exact.value().as_long_double();
+                return integral ? static_cast<long double>( integer ) : real;
+            }
+        };
+
+        struct KeyHash {
+            size_t operator()( vector<Json> const &key ) const {
+                uint64_t hash = 0;
+                for ( auto &&value : key )
+                    hash = hash * 0x100000001b3ull ^ json_value_hash( value );
+                return size_t( hash );
+            }
+        };
+
+        struct KeyEqual {
+            bool operator()( vector<Json> const &lhs, vector<Json> const &rhs ) const {
+                for ( size_t i = 0; i != lhs.size(); ++i ) {
+                    if ( json_value_compare( lhs[i], rhs[i] ) != 0 )
+                        return false;
+                }
+                return true;
+            }
+        };
+
+        // The paths read from each record: the keys,
+        // then each aggregated path once.
+        vector<JsonPointer> field_paths(
+                vector<JsonPointer> const &keys,
+                vector<Aggregate> const &aggregates,
+                vector<size_t> &value_field
+                ) {
+            vector<JsonPointer> paths = keys;
+            for ( auto &&aggregate : aggregates ) {
+                if ( not aggregate.has_path() ) {
+                    value_field.push_back( npos );
+                    continue;
+                }
+                auto const found = std::find( paths.begin() + keys.size(),
+                        paths.end(), aggregate.path() );
+                value_field.push_back( size_t( found - paths.begin() ) );
+                if ( found == paths.end() )
+                    paths.push_back( aggregate.path() );
+            }
+            return paths;
+        }
+
+        size_t thread_count( GroupByOptions const &options ) {
+            if ( options.threads )
+                return options.threads;
+            return std::max( 1u, std::thread::hardware_concurrency() );
+        }
+    }
+
+    Aggregate Aggregate::s_count( string name )
+    {
+        return Aggregate( std::move(name), AG_COUNT, false, JsonPointer() );
+    }
+
+    Aggregate Aggregate::s_count( string name, JsonPointer path )
+    {
+        return Aggregate( std::move(name), AG_COUNT, true, std::move(path) );
+    }
+
+    Aggregate Aggregate::s_sum( string name, JsonPointer path )
+    {
+        return Aggregate( std::move(name), AG_SUM, true, std::move(path) );
+    }
+
+    Aggregate Aggregate::s_min( string name, JsonPointer path )
+    {
+        return Aggregate( std::move(name), AG_MIN, true, std::move(path) );
+    }
+
+    Aggregate Aggregate::s_max( string name, JsonPointer path )
+    {
+        return Aggregate( std::move(name), AG_MAX, true, std::move(path) );
+    }
+
+    Aggregate Aggregate::s_avg( string name, JsonPointer path )
+    {
+        return Aggregate( std::move(name), AG_AVG, true, std::move(path) );
+    }
+
+    Aggregate Aggregate::s_distinct( string name, JsonPointer path )
+    {
+        return Aggregate( std::move(name), AG_DISTINCT, true, std::move(path) );
+    }
+
+    struct GroupBy::Table {
+        Table(
+                vector<JsonPointer> const &keys,
+                vector<Aggregate> const &aggregates,
+                GroupByOptions const &options
+                )
+            : paths( field_paths( keys, aggregates, value_field ) )
+            , scanner( {}, paths, true, Json::ParseOptions( options.exact_sums ) )
+        { }
+
+        vector<size_t> value_field;     // Per aggregate: index into fields.
+        vector<JsonPointer> const paths;
+        RecordScanner scanner;
+        vector<Json> fields;            // Scratch, per record.
+        std::unordered_map<vector<Json>, vector<Accumulator>, KeyHash, KeyEqual>
+                groups;
+    };
+
+    GroupBy::GroupBy(
+            vector<JsonPointer> keys,
+            vector<Aggregate> aggregates,
+            GroupByOptions const &options
+            )
+        : m_keys( std::move(keys) )
+        , m_aggregates( std::move(aggregates) )
+        , m_options( options )
+        , m_table( std::make_unique<Table>( m_keys, m_aggregates, m_options ) )
+    {
+        m_options.hll_precision = std::min( 16u, std::max( 4u, m_options.hll_precision ) );
+    }
+
+    GroupBy::GroupBy( GroupBy && ) noexcept = default;
+    GroupBy &GroupBy::operator=( GroupBy && ) noexcept = default;
+    GroupBy::~GroupBy() = default;
+
+    void GroupBy::add( Json const &record )
+    {
+        auto &fields = m_table->fields;
+        fields.clear();
+        for ( auto &&path : m_table->paths ) {
+            Json const *const found = path.find( record );
+            fields.push_back( found ? *found : Json() );
+        }
+        p_accumulate();
+    }
+
+    void GroupBy::add( string_view record )
+    {
+        try {
+            m_table->scanner.match( record, &m_table->fields );
+        } catch ( Json::ParseError const & ) {
+            if ( not m_options.skip_invalid )
+                throw;
+            ++m_invalid;
+            return;
+        }
+        p_accumulate();
+    }
+
+    void GroupBy::p_accumulate()
+    {
+        ++m_records;
+        auto const &fields = m_table->fields;
+        vector<Json> key( fields.begin(), fields.begin() + m_keys.size() );
+        auto found = m_table->groups.find( key );
+        if ( found == m_table->groups.end() ) {
+            found = m_table->groups.emplace( std::move(key),
+                    vector<Accumulator>( m_aggregates.size() ) ).first;
+        }
+        auto &accumulators = found->second;
+        for ( size_t j = 0; j != m_aggregates.size(); ++j ) {
+            Accumulator &acc = accumulators[j];
+            Aggregate const &aggregate = m_aggregates[j];
+            if ( not aggregate.has_path() ) {
+                ++acc.count;
+                continue;
+            }
+            Json const &value = fields[ m_table->value_field[j] ];
+            if ( value.is_null() )
+                continue;
+            switch ( aggregate.kind() ) {
+            case Aggregate::AG_COUNT:
+                ++acc.count;
+                break;
+            case Aggregate::AG_SUM:
+            case Aggregate::AG_AVG:
+                if ( value.is_number() ) {
+                    ++acc.count;
+                    acc.add_number( value, m_options.exact_sums );
+                }
+                break;
+            case Aggregate::AG_MIN:
+            case Aggregate::AG_MAX:
+                if ( not acc.count++ || ( json_value_compare( value, acc.extreme ) < 0 )
+                        == ( aggregate.kind() == Aggregate::AG_MIN ) )
+                    acc.extreme = value;
+                break;
+            case Aggregate::AG_DISTINCT:
+                ++acc.count;
+                hll_add( acc.registers, m_options.hll_precision,
+                        json_value_hash( value ) );
+                break;
+            }
+        }
+    }
+
+    void GroupBy::merge( GroupBy const &other )
+    {
+        m_records += other.m_records;
+        m_invalid += other.m_invalid;
+        for ( auto &&group : other.m_table->groups ) {
+            auto found = m_table->groups.find( group.first );
+            if ( found == m_table->groups.end() ) {
+                m_table->groups.emplace( group );
+                continue;
+            }
+            for ( size_t j = 0; j != m_aggregates.size(); ++j )
+                found->second[j].merge( group.second[j], m_aggregates[j].kind() );
+        }
+    }
+
+    size_t GroupBy::groups() const
+    {
+        return m_table->groups.size();
+    }
+
+    std::vector<GroupRow> GroupBy::rows() const
+    {
+        std::vector<GroupRow> rows;
+        rows.reserve( m_table->groups.size() );
+        bool const exact = m_options.exact_sums;
+        for ( auto &&group : m_table->groups ) {
+            GroupRow row;
+            row.key = group.first;
+            for ( size_t j = 0; j != m_aggregates.size(); ++j ) {
+                Accumulator const &acc = group.second[j];
+                switch ( m_aggregates[j].kind() ) {
+                case Aggregate::AG_COUNT:
+                    row.values.push_back( Json( acc.count ) );
+                    break;
+                case Aggregate::AG_SUM:
+                    if ( not acc.count )
+                        row.values.push_back( Json() );
+                    else if ( exact )
+                        row.values.push_back( Json( acc.exact.value() ) );
+                    else if ( acc.integral )
+                        row.values.push_back( Json( acc.integer ) );
+                    else
+                        row.values.push_back( Json( acc.real ) );
+                    break;
+                case Aggregate::AG_AVG:
+                    row.values.push_back( acc.count
+                            ? Json( acc.sum_value( exact ) / static_cast<long double>( acc.count ) )
+                            : Json() );
+                    break;
+                case Aggregate::AG_MIN:
+                case Aggregate::AG_MAX:
+                    row.values.push_back( acc.extreme );
+                    break;
+                case Aggregate::AG_DISTINCT:
+                    row.values.push_back( Json( hll_estimate( acc.registers ) ) );
+                    break;
+                }
+            }
+            rows.push_back( std::move(row) );
+        }
+        std::sort( rows.begin(), rows.end(),
+                []( GroupRow const &lhs, GroupRow const &rhs ) {
+                    for ( size_t i = 0; i != lhs.key.size(); ++i ) {
+                        if ( int const c = json_value_compare( lhs.key[i], rhs.key[i] ) )
+                            return c < 0;
+                    }
+                    return false;
+                } );
+        return rows;
+    }
+
+    GroupBy group_ndjson(
+            std::streambuf &input,
+            vector<JsonPointer> keys,
+            vector<Aggregate> aggregates,
+            GroupByOptions const &options
+            )
+    {
+        size_t const count = thread_count( options );
+        BoundedQueue<string> queue( 2 * count );
+        std::atomic<bool> done{ false };
+        FirstError errors;
+        vector<GroupBy> tables;
+        for ( size_t i = 0; i != count; ++i )
+            tables.emplace_back( keys, aggregates, options );
+
+        auto add_chunk = []( GroupBy &table, string const &chunk ) {
+            string_view rest( chunk );
+            while ( not rest.empty() ) {
+                size_t const end = rest.find( '\n' );
+                table.add( rest.substr( 0, end ) );
+                rest.remove_prefix( end == string_view::npos ? rest.size() : end + 1 );
+            }
+        };
+        auto work = [&]( GroupBy &table ) {
+            string chunk;
+            unsigned spins = 0;
+            try {
+                while ( not errors.any() ) {
+                    if ( queue.try_pop( chunk ) ) {
+                        add_chunk( table, chunk );
+                        spins = 0;
+                    } else if ( done.load( memory_order_acquire ) ) {
+                        // Anything pushed before "done" is in the queue by now.
+                        if ( not queue.try_pop( chunk ) )
+                            return;
+                        add_chunk( table, chunk );
+                    } else {
+                        back_off( spins );
+                    }
+                }
+            } catch ( ... ) {
+                errors.capture();
+            }
+        };
+        vector<std::thread> workers;
+        auto join = [&] {
+            done.store( true, memory_order_release );
+            for ( auto &&worker : workers )
+                worker.join();
+        };
+        try {
+            for ( auto &&table : tables )
+                workers.emplace_back( work, std::ref( table ) );
+            NdjsonReader reader( input );
+            string chunk;
+            while ( not errors.any()
+                    && reader.next_chunk( chunk, options.chunk_bytes ) ) {
+                unsigned spins = 0;
+                while ( not queue.try_push( chunk ) && not errors.any() )
+                    back_off( spins );
+                chunk.clear();
+            }
+        } catch ( ... ) {
+            join();
+            throw;
+        }
+        join();
+        errors.rethrow();
+        GroupBy result = std::move( tables.front() );
+        for ( size_t i = 1; i != tables.size(); ++i )
+            result.merge( tables[i] );
+        return result;
+    }
+
+}
+// vi: et ts=4 sts=4 sw=4
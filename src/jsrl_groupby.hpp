@@ -0,0 +1,190 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#ifndef JSRL_GROUPBY_HPP_C41E7A9B2D605F38E9A1B4C7D02E6F95
+#define JSRL_GROUPBY_HPP_C41E7A9B2D605F38E9A1B4C7D02E6F95
+
+#include "jsrl.hpp"
+#include "jsrl_pointer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*! @file jsrl_groupby.hpp
+ *  @brief Grouping and aggregating records.
+ */
+namespace jsrl {
+    using std::size_t;
+    using std::string;
+    using std::string_view;
+    using std::uint64_t;
+
+    /*! @brief  One value computed for each group.
+     *
+     *  Null values (and missing ones, which read as null)
+     *  are left out of every aggregate but the plain record count.
+     */
+    struct Aggregate {
+        enum Kind {
+            AG_COUNT,       //!< Records, or non-null values at the path.
+            AG_SUM,         //!< Sum of the numbers at the path.
+            AG_MIN,         //!< Least value (in @c Json order).
+            AG_MAX,         //!< Greatest value (in @c Json order).
+            AG_AVG,         //!< Mean of the numbers at the path.
+            AG_DISTINCT,    //!< Estimated distinct values (HyperLogLog).
+        };
+
+        /*! @brief  Records in the group. */
+        static Aggregate s_count( string name );
+        /*! @brief  Non-null values at @c path. */
+        static Aggregate s_count( string name, JsonPointer path );
+        static Aggregate s_sum( string name, JsonPointer path );
+        static Aggregate s_min( string name, JsonPointer path );
+        static Aggregate s_max( string name, JsonPointer path );
+        static Aggregate s_avg( string name, JsonPointer path );
+        /*! @brief  Distinct values at @c path, with equal numbers
+         *          such as @c 1 and @c 1.0 counted once.
+         */
+        static Aggregate s_distinct( string name, JsonPointer path );
+
+        string const &name() const { return m_name; }
+        Kind kind() const { return m_kind; }
+        /*! @brief  Whether the aggregate reads a value (all but a plain count). */
+        bool has_path() const { return m_has_path; }
+        JsonPointer const &path() const { return m_path; }
+
+    private:
+        Aggregate( string name, Kind kind, bool has_path, JsonPointer path )
+            : m_name( std::move(name) )
+            , m_kind( kind )
+            , m_has_path( has_path )
+            , m_path( std::move(path) )
+        { }
+
+        string m_name;
+        Kind m_kind;
+        bool m_has_path;
+        JsonPointer m_path;
+    };
+
+    /*! @brief  How a @ref GroupBy aggregates.
+     */
+    struct GroupByOptions {
+        size_t threads = 0;         //!< Worker threads (0: one per core).
+        /*! @brief  Add numbers as decimals, without rounding.
+         *
+         *  Sums and averages are then exact to the digits written
+         *  (records are read with @c use_GN_for_floats),
+         *  and sums come out as @ref GeneralNumber values.
+         *  Otherwise integers are summed exactly while they fit
+         *  in a @c long @c long, and other numbers as @c long @c double.
+         */
+        bool exact_sums = false;
+        unsigned hll_precision = 10;    //!< Log2 of distinct-count registers
+                                        //!< per group (4 to 16).
+        size_t chunk_bytes = 1 << 20;   //!< NDJSON bytes per work item.
+        bool skip_invalid = false;  //!< Count bad records instead of throwing.
+    };
+
+    /*! @brief  One group's key and aggregates.
+     */
+    struct GroupRow {
+        std::vector<Json> key;      //!< Values at the key paths.
+        std::vector<Json> values;   //!< One per aggregate, in order;
+                                    //!< null where nothing was aggregated.
+    };
+
+    /*! @brief  Hash aggregation of records grouped by the values
+     *          at some key paths.
+     *
+     *  Records are reduced to their key and aggregated values as they
+     *  are added: NDJSON text is read through a compiled @ref RecordScanner,
+     *  so only those paths are parsed, and no @c Json tree is built.
+     *  Key values compare like @ref json_value_compare,
+     *  so @c 1 and @c 1.0 fall in one group.
+     *  Each thread fills a @c GroupBy of its own;
+     *  @ref merge combines them.
+     *
+     *  Example:
+     *  @code
+     *      auto totals = group_ndjson( *feed.rdbuf(),
+     *              { JsonPointer( "/country" ) },
+     *              { Aggregate::s_count( "orders" ),
+     *                Aggregate::s_sum( "revenue", JsonPointer( "/amount" ) ) } );
+     *      for ( auto &&row : totals.rows() )
+     *          cout << row.key[0] << ' ' << row.values[1] << '\n';
+     *  @endcode
+     */
+    struct GroupBy {
+        GroupBy(
+                std::vector<JsonPointer> keys,
+                std::vector<Aggregate> aggregates,
+                GroupByOptions const &options = GroupByOptions()
+                );
+        GroupBy( GroupBy && ) noexcept;
+        GroupBy &operator=( GroupBy && ) noexcept;
+        ~GroupBy();
+
+        /*! @brief  Aggregate one record. */
+        void add( Json const &record );
+        /*! @brief  Aggregate one record of NDJSON text.
+         *
+         *  @throw Json::ParseError Invalid JSON (unless @c skip_invalid).
+         */
+        void add( string_view record );
+        /*! @brief  Count a record that wasn't valid JSON. */
+        void add_invalid() { ++m_invalid; }
+
+        /*! @brief  Fold in what another instance aggregated,
+         *          over the same keys and aggregates.
+         */
+        void merge( GroupBy const &other );
+
+        uint64_t records() const { return m_records; }  //!< Records added.
+        uint64_t invalid() const { return m_invalid; }  //!< Bad records.
+        size_t groups() const;                          //!< Groups so far.
+
+        /*! @brief  The groups, ordered by key. */
+        std::vector<GroupRow> rows() const;
+
+    private:
+        struct Table;
+
+        void p_accumulate();
+
+        std::vector<JsonPointer> m_keys;
+        std::vector<Aggregate> m_aggregates;
+        GroupByOptions m_options;
+        std::unique_ptr<Table> m_table;
+        uint64_t m_records = 0;
+        uint64_t m_invalid = 0;
+    };
+
+    /*! @brief  Group NDJSON records on several threads.
+     *
+     *  @throw Json::ParseError A record isn't valid JSON
+     *                          (unless @c skip_invalid).
+     */
+    GroupBy group_ndjson(
+            std::streambuf &input,
+            std::vector<JsonPointer> keys,
+            std::vector<Aggregate> aggregates,
+            GroupByOptions const &options = GroupByOptions()
+            );
+
+}
+#endif
+// vi: et ts=4 sts=4 sw=4
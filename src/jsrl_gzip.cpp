@@ -0,0 +1,185 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#include "jsrl_gzip.hpp"
+
+#include <algorithm>
+#include <climits>
+
+#include <zlib.h>
+
+namespace jsrl {
+    using std::lock_guard;
+    using std::mutex;
+    using std::unique_lock;
+
+    struct GzipStreambuf::Inflater {
+        explicit
+        Inflater( streambuf &source )
+            : source( source )
+            , input( 64 * 1024 )
+        {
+            // 15 bits of window, plus 32 to detect gzip or zlib headers.
+            if ( inflateInit2( &stream, 15 + 32 ) != Z_OK )
+                throw GzipError( "Cannot start inflating" );
+        }
+        ~Inflater() { inflateEnd( &stream ); }
+
+        // Inflate up to size bytes; fewer only at the end of the input.
+        size_t read( char *out, size_t size ) {
+            size = std::min<size_t>( size, UINT_MAX );
+            stream.next_out = reinterpret_cast<Bytef *>( out );
+            stream.avail_out = uInt( size );
+            while ( stream.avail_out != 0 && not finished ) {
+                if ( stream.avail_in == 0 && not input_ended ) {
+                    auto const got = source.sgetn( input.data(),
+                            std::streamsize( input.size() ) );
+                    if ( got <= 0 ) {
+                        input_ended = true;
+                    } else {
+                        stream.next_in = reinterpret_cast<Bytef *>( input.data() );
+                        stream.avail_in = uInt( got );
+                        any_input = true;
+                    }
+                }
+                if ( member_ended || not any_input ) {
+                    if ( stream.avail_in == 0 && input_ended ) {
+                        finished = true;
+                        break;
+                    }
+                    if ( member_ended ) {
+                        // Another gzip member follows.
+                        inflateReset( &stream );
+                        member_ended = false;
+                    }
+                    if ( stream.avail_in == 0 )
+                        continue;
+                }
+                int const result = inflate( &stream, Z_NO_FLUSH );
+                if ( result == Z_STREAM_END ) {
+                    member_ended = true;
+                } else if ( result == Z_BUF_ERROR ) {
+                    if ( stream.avail_in == 0 && input_ended )
+                        throw GzipError( "Compressed input is truncated" );
+                } else if ( result != Z_OK ) {
+                    throw GzipError( stream.msg
+                            ? string( "Bad compressed input: " ) + stream.msg
+                            : string( "Bad compressed input" ) );
+                }
+            }
+            return size - stream.avail_out;
+        }
+
+        streambuf &source;
+        std::vector<char> input;
+        z_stream stream = z_stream();
+        bool any_input = false;
+        bool input_ended = false;
+        bool member_ended = false;
+        bool finished = false;
+    };
+
+    GzipStreambuf::GzipStreambuf( streambuf &compressed, GzipOptions const &options )
+        : m_inflater( new Inflater( compressed ) )
+    {
+        size_t const block_size = std::max<size_t>( options.block_size, 64 );
+        m_current.data.resize( block_size );
+        if ( options.background ) {
+            // Two blocks in flight while the reader holds a third.
+            for ( int i = 0; i != 2; ++i ) {
+                m_free.emplace_back();
+                m_free.back().data.resize( block_size );
+            }
+            m_thread = std::thread( &GzipStreambuf::p_produce, this );
+        }
+    }
+
+    GzipStreambuf::~GzipStreambuf()
+    {
+        if ( m_thread.joinable() ) {
+            {
+                lock_guard<mutex> lock( m_mutex );
+                m_stopping = true;
+            }
+            m_changed.notify_all();
+            m_thread.join();
+        }
+    }
+
+    void GzipStreambuf::p_produce()
+    {
+        for (;;) {
+            Block block;
+            {
+                unique_lock<mutex> lock( m_mutex );
+                m_changed.wait( lock, [this] {
+                        return m_stopping || not m_free.empty();
+                    } );
+                if ( m_stopping )
+                    return;
+                block = std::move( m_free.back() );
+                m_free.pop_back();
+            }
+            try {
+                block.size = m_inflater->read( block.data.data(), block.data.size() );
+            } catch ( ... ) {
+                lock_guard<mutex> lock( m_mutex );
+                m_error = std::current_exception();
+                m_changed.notify_all();
+                return;
+            }
+            bool const last = block.size == 0;
+            {
+                lock_guard<mutex> lock( m_mutex );
+                m_ready.push_back( std::move( block ) );
+            }
+            m_changed.notify_all();
+            if ( last )
+                return;
+        }
+    }
+
+    auto GzipStreambuf::underflow() -> int_type
+    {
+        if ( gptr() < egptr() )
+            return traits_type::to_int_type( *gptr() );
+        if ( m_finished )
+            return traits_type::eof();
+        if ( not m_thread.joinable() ) {
+            m_current.size = m_inflater->read(
+                    m_current.data.data(), m_current.data.size() );
+        } else {
+            unique_lock<mutex> lock( m_mutex );
+            m_free.push_back( std::move( m_current ) );
+            m_changed.notify_all();
+            m_changed.wait( lock, [this] {
+                    return not m_ready.empty() || m_error;
+                } );
+            if ( m_ready.empty() ) {
+                m_finished = true;
+                std::rethrow_exception( m_error );
+            }
+            m_current = std::move( m_ready.front() );
+            m_ready.pop_front();
+        }
+        if ( m_current.size == 0 ) {
+            m_finished = true;
+            setg( nullptr, nullptr, nullptr );
+            return traits_type::eof();
+        }
+        char *const data = m_current.data.data();
+        setg( data, data, data + m_current.size );
+        m_inflated += m_current.size;
+        return traits_type::to_int_type( *gptr() );
+    }
+
+}
+// vi: et ts=4 sts=4 sw=4
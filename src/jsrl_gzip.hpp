@@ -0,0 +1,124 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#ifndef JSRL_GZIP_HPP_C83B2F17E95A40D6B1E7342A9D0C58F6
+#define JSRL_GZIP_HPP_C83B2F17E95A40D6B1E7342A9D0C58F6
+
+#include "jsrl.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*! @file jsrl_gzip.hpp
+ *  @brief Reading gzip and zlib compressed input.
+ *
+ *  Only built when the library is configured with @c JSRL_WITH_ZLIB.
+ */
+namespace jsrl {
+    using std::size_t;
+    using std::streambuf;
+    using std::string;
+
+    /*! @brief  Error thrown for compressed input that can't be inflated.
+     */
+    struct GzipError : Json::Error {
+        explicit GzipError( string const &msg ) : Error( msg ) { }
+    protected:
+        char const *v_failtag() const override { return "Gzip Error"; }
+    };
+
+    /*! @brief  How a @ref GzipStreambuf inflates.
+     */
+    struct GzipOptions {
+        size_t block_size = 256 * 1024;     //!< Bytes inflated at a time.
+        /*! @brief  Inflate on a thread of its own,
+         *          a block or two ahead of the reader,
+         *          so that inflating and parsing overlap.
+         */
+        bool background = false;
+    };
+
+    /*! @brief  Streambuf giving the inflated bytes of gzip or zlib input.
+     *
+     *  The format is detected from the header,
+     *  and concatenated gzip members (as written by @c "cat a.gz b.gz")
+     *  are read one after another.
+     *  Input is inflated a block at a time into the get area,
+     *  so block readers such as @ref NdjsonReader,
+     *  which use @c sgetn, copy whole blocks at once.
+     *
+     *  Errors in the compressed data throw @ref GzipError
+     *  from the read that reaches them;
+     *  with @c background set, the error is raised
+     *  when the reader gets to the failed block.
+     *
+     *  Example:
+     *  @code
+     *      std::ifstream archive( "events.ndjson.gz", std::ios::binary );
+     *      GzipStreambuf inflated( *archive.rdbuf() );
+     *      NdjsonReader records( inflated );
+     *  @endcode
+     */
+    struct GzipStreambuf : streambuf {
+        /*! @brief  Inflate from @c compressed, which must outlive this.
+         */
+        explicit
+        GzipStreambuf(
+                streambuf &compressed,
+                GzipOptions const &options = GzipOptions()
+                );
+        GzipStreambuf( GzipStreambuf const & ) = delete;
+        GzipStreambuf &operator=( GzipStreambuf const & ) = delete;
+        ~GzipStreambuf() override;
+
+        /*! @brief  Inflated bytes handed out so far (including any in the
+         *          get area not yet read).
+         */
+        std::uint64_t inflated() const { return m_inflated; }
+
+    protected:
+        int_type underflow() override;
+
+    private:
+        struct Inflater;
+        struct Block {
+            std::vector<char> data;
+            size_t size = 0;
+        };
+
+        void p_produce();
+
+        std::unique_ptr<Inflater> m_inflater;
+        Block m_current;
+        std::uint64_t m_inflated = 0;
+        bool m_finished = false;
+        // With a background thread:
+        std::mutex m_mutex;
+        std::condition_variable m_changed;
+        std::deque<Block> m_ready;      // Inflated, in order.
+        std::vector<Block> m_free;      // Handed back by the reader.
+        std::exception_ptr m_error;
+        bool m_stopping = false;
+        std::thread m_thread;
+    };
+
+}
+#endif
+// vi: et ts=4 sts=4 sw=4
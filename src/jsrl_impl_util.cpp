@@ -11,10 +11,23 @@
  */
 #include "jsrl_impl_util.hpp"
 #include "jsrl.hpp"
+#include <algorithm>
 #include <cctype>
+#include <charconv>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <thread>
 
 namespace jsrl {
     using std::isspace;
+    using std::isdigit;
+    using std::memcmp;
+    using std::strlen;
 
     using UnexpectedByteParseError = Json::UnexpectedByteParseError;
     using BadEOFParseError = Json::BadEOFParseError;
@@ -49,9 +62,10 @@ namespace jsrl {
             }
             return codepoint;
         }
+        template<typename SINK>
         void add_utf8_seq(
                 uint32_t codepoint,
-                StringPackager::Make &value,
+                SINK &value,
                 uint8_t mask,
                 unsigned cont_bytes
                 ) {
@@ -61,9 +75,10 @@ namespace jsrl {
                 value.add_byte( char( byte ) );
             }
         }
+        template<typename SINK>
         void add_unicode_codepoint(
                 streambuf &sbuf,
-                StringPackager::Make &value
+                SINK &value
                 ) {
             uint32_t codepoint = read_escaped_codepoint( sbuf );
             if ( ( codepoint & ~0x3FF ) == 0xD800 ) {
@@ -101,46 +116,72 @@ namespace jsrl {
                 add_utf8_seq( codepoint, value, 0xF0, 3 );
             }
         }
-    }
 
-    string read_json_string_value( streambuf &sbuf, StringPackager &sp ) {
-        StringPackager::Make value(sp);
-        for (;;) {
-            int byte = sbuf.sbumpc();
-            switch ( byte ) {
-            case EOF:
-                throw BadEOFParseError( "Input ended within string" );
-            case '"':
-                return value.package();
-            case '\\':
-                byte = sbuf.sbumpc();
+        // Decode string content up to and including the closing quote,
+        // passing each byte of the value to the sink.
+        template<typename SINK>
+        void read_json_string_body( streambuf &sbuf, SINK &value ) {
+            for (;;) {
+                int byte = sbuf.sbumpc();
                 switch ( byte ) {
+                case EOF:
+                    throw BadEOFParseError( "Input ended within string" );
+                case '"':
+                    return;
                 case '\\':
-                case '/':
-                case '"': value.add_byte( byte ); break;
-                case 'b': value.add_byte( '\b' ); break;
-                case 'f': value.add_byte( '\f' ); break;
-                case 'n': value.add_byte( '\n' ); break;
-                case 'r': value.add_byte( '\r' ); break;
-                case 't': value.add_byte( '\t' ); break;
-                case 'u': add_unicode_codepoint( sbuf, value ); break;
-                default: throw UnexpectedByteParseError(
-                                 "Bad escape sequence, \"\\" + ( byte
-                                     ? string(1, byte)
-                                     : string("<0x00>")
-                                     ) + "\"",
-                                 char(byte) );
-                }
-                break;
-            default:
-                if ( uint8_t(byte) < 0x20 ) {
-                    sbuf.sungetc();
-                    throw UnexpectedByteParseError(
-                            "Control byte within string", char(byte) );
+                    byte = sbuf.sbumpc();
+                    switch ( byte ) {
+                    case '\\':
+                    case '/':
+                    case '"': value.add_byte( byte ); break;
+                    case 'b': value.add_byte( '\b' ); break;
+                    case 'f': value.add_byte( '\f' ); break;
+                    case 'n': value.add_byte( '\n' ); break;
+                    case 'r': value.add_byte( '\r' ); break;
+                    case 't': value.add_byte( '\t' ); break;
+                    case 'u': add_unicode_codepoint( sbuf, value ); break;
+                    default: throw UnexpectedByteParseError(
+                                     "Bad escape sequence, \"\\" + ( byte
+                                         ? string(1, byte)
+                                         : string("<0x00>")
+                                         ) + "\"",
+                                     char(byte) );
+                    }
+                    break;
+                default:
+                    if ( uint8_t(byte) < 0x20 ) {
+                        sbuf.sungetc();
+                        throw UnexpectedByteParseError(
+                                "Control byte within string", char(byte) );
+                    }
+                    value.add_byte( byte );
                 }
-                value.add_byte( byte );
             }
         }
+
+        struct AppendSink {
+            string &out;
+            void add_byte( char c ) { out.push_back( c ); }
+        };
+        struct DiscardSink {
+            void add_byte( char ) { }
+        };
+    }
+
+    string read_json_string_value( streambuf &sbuf, StringPackager &sp ) {
+        StringPackager::Make value(sp);
+        read_json_string_body( sbuf, value );
+        return value.package();
+    }
+
+    void read_json_string_into( streambuf &sbuf, string &out ) {
+        AppendSink sink{ out };
+        read_json_string_body( sbuf, sink );
+    }
+
+    void skip_json_string( streambuf &sbuf ) {
+        DiscardSink sink;
+        read_json_string_body( sbuf, sink );
     }
 
     int jsrl_get_nonspace_byte( streambuf &sbuf ) {
@@ -187,5 +228,499 @@ namespace jsrl {
         }
     }
 
+    namespace {
+        [[noreturn]]
+        void fail_number_text( streambuf &sbuf, int byte, char const *need ) {
+            if ( byte == EOF ) {
+                throw GeneralNumber::BadEOFParseError(
+                        "Malformed input number (stream end, "
+                        + string(need) + ")" );
+            }
+            sbuf.sungetc();
+            throw GeneralNumber::NumberParseError( "Malformed input number ("
+                    + string(need) + ")" );
+        }
+        // Compare a digit run against the decimal text of a limit value.
+        bool digits_within( char const *digits, size_t count, char const *limit ) {
+            size_t const limit_count = strlen( limit );
+            if ( count != limit_count )
+                return count < limit_count;
+            return memcmp( digits, limit, count ) <= 0;
+        }
+    }
+
+    NumberTextClass read_json_number_text( streambuf &sbuf, string &text ) {
+        size_t const start = text.size();
+        int byte = sbuf.sbumpc();
+        bool const negative = byte == '-';
+        if ( negative ) {
+            text.push_back( '-' );
+            byte = sbuf.sbumpc();
+        }
+        size_t const int_start = text.size();
+        while ( byte != EOF and isdigit( byte ) ) {
+            text.push_back( char(byte) );
+            byte = sbuf.sbumpc();
+        }
+        size_t const int_digits = text.size() - int_start;
+        if ( 0 == int_digits )
+            fail_number_text( sbuf, byte, "No digits seen" );
+        bool is_float = false;
+        size_t exponent_digits = 0;
+        if ( byte == '.' ) {
+            is_float = true;
+            text.push_back( '.' );
+            byte = sbuf.sbumpc();
+            size_t const frac_start = text.size();
+            while ( byte != EOF and isdigit( byte ) ) {
+                text.push_back( char(byte) );
+                byte = sbuf.sbumpc();
+            }
+            if ( text.size() == frac_start )
+                fail_number_text( sbuf, byte, "No digits after decimal" );
+        }
+        if ( byte == 'e' or byte == 'E' ) {
+            is_float = true;
+            text.push_back( char(byte) );
+            byte = sbuf.sbumpc();
+            char const *need = "No digits after exponent";
+            if ( byte == '+' or byte == '-' ) {
+                text.push_back( char(byte) );
+                byte = sbuf.sbumpc();
+                need = "No digits after exponent 'E'";
+            }
+            while ( byte != EOF and isdigit( byte ) ) {
+                text.push_back( char(byte) );
+                ++exponent_digits;
+                byte = sbuf.sbumpc();
+            }
+            if ( 0 == exponent_digits )
+                fail_number_text( sbuf, byte, need );
+        }
+        if ( byte != EOF )
+            sbuf.sungetc();
+        char const *const digits = text.data() + int_start;
+        if ( int_digits > 1 and digits[0] == '0' ) {
+            throw GeneralNumber::NumberParseError(
+                    "Malformed input number (leading zero)" );
+        }
+        // Only pathologically long numbers or exponents can run into
+        // GeneralNumber's exponent range limits; check those the slow way.
+        if ( exponent_digits > 3 or text.size() - start > 1000 ) {
+            char const *const b = text.data() + start;
+            GeneralNumber::parse( b, b + ( text.size() - start ) );
+        }
+        if ( is_float )
+            return NTC_FLOAT;
+        if ( not negative )
+            return digits_within( digits, int_digits, "18446744073709551615" )
+                    ? NTC_UNSIGNED
+                    : NTC_FLOAT
+                    ;
+        if ( int_digits == 1 and digits[0] == '0' )
+            return NTC_UNSIGNED; // "-0" reads as plain zero
+        return digits_within( digits, int_digits, "9223372036854775808" )
+                ? NTC_SIGNED
+                : NTC_FLOAT
+                ;
+    }
+
+    GeneralNumber number_as_general( Json const &number )
+    {
+        if ( number.is_number_general() )
+            return *number.as_number_general();
+        if ( number.is_number_sint() )
+            return GeneralNumber( number.as_number_sint() );
+        if ( number.is_number_uint() )
+            return GeneralNumber( number.as_number_uint() );
+        return GeneralNumber( number.as_number_float() );
+    }
+
+    namespace {
+        // Whether a double and an integer that compare adjacent are equal.
+        bool numbers_tie( Json const &dbl, Json const &integer ) {
+            long double const d = dbl.as_number_float();
+            if ( integer.is_number_sint() ) {
+                long long const i = integer.as_number_sint();
+                return d == static_cast<long double>( i )
+                        && static_cast<long long>( d ) == i;
+            }
+            long long unsigned const u = integer.as_number_uint();
+            return d == static_cast<long double>( u )
+                    && static_cast<long long unsigned>( d ) == u;
+        }
+
+        // The number without its decimal flag, so that only its value counts.
+        GeneralNumber plain_general( GeneralNumber const &number ) {
+            auto const digits = number.digits();
+            return GeneralNumber( false, number.is_negative(), number.exponent(),
+                    std::vector<char>( digits.begin(), digits.end() ) );
+        }
+
+        // Whether numbers, one of them a GeneralNumber, have equal values.
+        bool numbers_general_tie( Json const &lhs, Json const &rhs ) {
+            return cmp3way( plain_general( number_as_general( lhs ) ),
+                    plain_general( number_as_general( rhs ) ) ) == 0;
+        }
+    }
+
+    int json_number_compare( Json const &lhs, Json const &rhs )
+    {
+        assert( lhs.is_number() && rhs.is_number() );
+        // Json's operators compare numbers by nothing else.
+        return lhs < rhs ? -1 : rhs < lhs ? 1 : 0;
+    }
+
+    int json_value_compare( Json const &lhs, Json const &rhs )
+    {
+        if ( lhs == rhs )
+            return 0;
+        int const result = lhs < rhs ? -1 : 1;
+        Json::TypeTag const tt = lhs.get_typetag( false );
+        if ( tt != rhs.get_typetag( false ) )
+            return result;
+        switch ( tt ) {
+        case Json::TT_NUMBER:
+            if ( lhs.is_number_general() || rhs.is_number_general() )
+                return numbers_general_tie( lhs, rhs ) ? 0 : result;
+            if ( lhs.is_number_float() && rhs.is_number_integer() )
+                return numbers_tie( lhs, rhs ) ? 0 : result;
+            if ( rhs.is_number_float() && lhs.is_number_integer() )
+                return numbers_tie( rhs, lhs ) ? 0 : result;
+            return result;
+        case Json::TT_ARRAY: {
+            auto const &l = lhs.as_array();
+            auto const &r = rhs.as_array();
+            for ( size_t i = 0; i != l.size() && i != r.size(); ++i ) {
+                if ( int const c = json_value_compare( l[i], r[i] ) )
+                    return c;
+            }
+            return l.size() < r.size() ? -1 : l.size() > r.size() ? 1 : 0;
+        }
+        case Json::TT_OBJECT: {
+            auto const &l = lhs.as_object();
+            auto const &r = rhs.as_object();
+            for ( size_t i = 0; i != l.size() && i != r.size(); ++i ) {
+                if ( int const c = l[i].first.compare( r[i].first ) )
+                    return c < 0 ? -1 : 1;
+                if ( int const c = json_value_compare( l[i].second, r[i].second ) )
+                    return c;
+            }
+            return l.size() < r.size() ? -1 : l.size() > r.size() ? 1 : 0;
+        }
+        default:
+            return result;
+        }
+    }
+
+    std::uint64_t mix_hash( std::uint64_t hash )
+    {
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdull;
+        hash ^= hash >> 33;
+        hash *= 0xc4ceb9fe1a85ec53ull;
+        hash ^= hash >> 33;
+        return hash;
+    }
+
+    std::uint64_t hash_bytes( std::string_view bytes, std::uint64_t seed )
+    {
+        std::uint64_t hash = 0xcbf29ce484222325ull ^ seed;
+        for ( char c : bytes ) {
+            hash ^= static_cast<unsigned char>( c );
+            hash *= 0x100000001b3ull;
+        }
+        return mix_hash( hash );
+    }
+
+    namespace {
+        std::uint64_t combine_hash( std::uint64_t seed, std::uint64_t value ) {
+            return mix_hash( seed ^ ( value + 0x9e3779b97f4a7c15ull
+                        + ( seed << 6 ) + ( seed >> 2 ) ) );
+        }
+
+        enum HashTag : std::uint64_t {
+            HT_NULL = 1,
+            HT_FALSE,
+            HT_TRUE,
+            HT_INTEGER,
+            HT_FLOAT,
+            HT_STRING,
+            HT_ARRAY,
+            HT_OBJECT,
+        };
+
+        // A type's starting hash; with seed 0, just its tag.
+        std::uint64_t tag_hash( HashTag tag, std::uint64_t seed ) {
+            return seed ? combine_hash( seed, tag ) : tag;
+        }
+
+        std::uint64_t float_hash( long double value, std::uint64_t seed ) {
+            std::uint64_t const start = tag_hash( HT_FLOAT, seed );
+            if ( std::isnan( value ) )
+                return combine_hash( start, 0 );
+            if ( std::isinf( value ) )
+                return combine_hash( start, value < 0 ? 1 : 2 );
+            int exponent;
+            long double const mantissa = std::frexp( std::fabs( value ), &exponent );
+            std::uint64_t const bits
+                    = static_cast<std::uint64_t>( std::ldexp( mantissa, 64 ) );
+            return combine_hash( combine_hash( start, bits ),
+                    std::uint64_t( exponent ) * 2 + ( value < 0 ) );
+        }
+
+        std::uint64_t integer_hash( std::uint64_t bits, std::uint64_t seed ) {
+            return combine_hash( tag_hash( HT_INTEGER, seed ), bits );
+        }
+
+        // Equal numbers convert alike: integral values hash as integers,
+        // whatever their type, and the rest by their long double value
+        // (a GeneralNumber equals a double only if its digits are the
+        // double's, which read back as the same long double).
+        std::uint64_t number_hash( Json const &number, std::uint64_t seed ) {
+            if ( number.is_number_sint() )
+                return integer_hash( std::uint64_t( number.as_number_sint() ), seed );
+            if ( number.is_number_uint() )
+                return integer_hash( number.as_number_uint(), seed );
+            if ( number.is_number_general() ) {
+                auto const general = number.as_number_general();
+                if ( general->exponent() >= ptrdiff_t( general->digits().size() ) ) {
+                    // Integral, though perhaps written with a fraction.
+                    GeneralNumber const integer = plain_general( *general );
+                    if ( integer.is_long_long() )
+                        return integer_hash( std::uint64_t( integer.as_long_long() ), seed );
+                    if ( integer.is_long_long_unsigned() )
+                        return integer_hash( integer.as_long_long_unsigned(), seed );
+                }
+                return float_hash( general->as_long_double(), seed );
+            }
+            long double const value = number.as_number_float();
+            if ( value == std::trunc( value ) ) {
+                if ( value >= -0x1p63L && value < 0 ) {
+                    return integer_hash(
+                            std::uint64_t( static_cast<long long>( value ) ), seed );
+                }
+                if ( value >= 0 && value < 0x1p64L )
+                    return integer_hash( static_cast<long long unsigned>( value ), seed );
+            }
+            return float_hash( value, seed );
+        }
+    }
+
+    namespace {
+        std::uint64_t digits_hash(
+                HashTag tag,
+                bool negative,
+                int exponent,
+                std::string_view digits,
+                std::uint64_t seed
+                ) {
+            std::uint64_t const hash = combine_hash( tag_hash( tag, seed ),
+                    std::uint64_t( std::int64_t( exponent ) ) * 2 + negative );
+            return combine_hash( hash, hash_bytes( digits, seed ) );
+        }
+
+        std::uint64_t general_hash(
+                HashTag tag,
+                GeneralNumber const &number,
+                std::uint64_t seed
+                ) {
+            auto const digits = number.digits();
+            return digits_hash( tag, number.is_negative(), number.exponent(),
+                    std::string_view( digits.data(), digits.size() ), seed );
+        }
+
+        // A double's hash by the digits of GeneralNumber( value ),
+        // which is what json_number_compare compares with a GeneralNumber:
+        // max_digits10 significant digits, without trailing zeros.
+        // That many digits also tell every long double apart.
+        std::uint64_t double_hash( long double value, std::uint64_t seed ) {
+            if ( not std::isfinite( value ) )
+                return float_hash( value, seed );
+            if ( value == 0 )
+                return digits_hash( HT_FLOAT, false, INT16_MIN, {}, seed );
+            char text[64];
+            char *const end = std::to_chars( text, text + sizeof text,
+                    std::fabs( value ), std::chars_format::scientific,
+                    std::numeric_limits<long double>::max_digits10 - 1 ).ptr;
+            char *const e = std::find( text, end, 'e' );
+            int exponent = 0;
+            std::from_chars( e[1] == '+' ? e + 2 : e + 1, end, exponent );
+            // "d.ddd": close up the point, then drop trailing zeros.
+            char *last = std::copy( text + 2, e, text + 1 );
+            while ( last[-1] == '0' )
+                --last;
+            return digits_hash( HT_FLOAT, value < 0, exponent + 1,
+                    std::string_view( text, size_t( last - text ) ), seed );
+        }
+
+        // As number_hash, but consistent with json_number_compare:
+        // integers, including GeneralNumbers written without a decimal
+        // point, never equal doubles or GeneralNumbers written with one.
+        std::uint64_t exact_number_hash( Json const &number, std::uint64_t seed ) {
+            if ( number.is_number_sint() )
+                return integer_hash( std::uint64_t( number.as_number_sint() ), seed );
+            if ( number.is_number_uint() )
+                return integer_hash( number.as_number_uint(), seed );
+            if ( number.is_number_general() ) {
+                auto const general = number.as_number_general();
+                if ( general->is_decimal() )
+                    return general_hash( HT_FLOAT, *general, seed );
+                if ( general->is_long_long() )
+                    return integer_hash( std::uint64_t( general->as_long_long() ), seed );
+                if ( general->is_long_long_unsigned() )
+                    return integer_hash( general->as_long_long_unsigned(), seed );
+                return general_hash( HT_INTEGER, *general, seed );
+            }
+            return double_hash( number.as_number_float(), seed );
+        }
+
+        template<std::uint64_t NUMBER_HASH( Json const &, std::uint64_t )>
+        std::uint64_t structure_hash( Json const &value, std::uint64_t seed ) {
+            switch ( value.get_typetag( false ) ) {
+            case Json::TT_NULL:
+                return combine_hash( tag_hash( HT_NULL, seed ), 0 );
+            case Json::TT_BOOL:
+                return combine_hash(
+                        tag_hash( value.as_bool() ? HT_TRUE : HT_FALSE, seed ), 0 );
+            case Json::TT_STRING:
+                return combine_hash( tag_hash( HT_STRING, seed ),
+                        hash_bytes( value.as_string(), seed ) );
+            case Json::TT_ARRAY: {
+                std::uint64_t hash = combine_hash( tag_hash( HT_ARRAY, seed ), 0 );
+                for ( auto &&element : value.as_array() ) {
+                    hash = combine_hash( hash,
+                            structure_hash<NUMBER_HASH>( element, seed ) );
+                }
+                return hash;
+            }
+            case Json::TT_OBJECT: {
+                // Members are kept in key order, so equal objects hash alike.
+                std::uint64_t hash = combine_hash( tag_hash( HT_OBJECT, seed ), 0 );
+                for ( auto &&member : value.as_object() ) {
+                    hash = combine_hash( hash, hash_bytes( member.first, seed ) );
+                    hash = combine_hash( hash,
+                            structure_hash<NUMBER_HASH>( member.second, seed ) );
+                }
+                return hash;
+            }
+            default:
+                return NUMBER_HASH( value, seed );
+            }
+        }
+    }
+
+    std::uint64_t json_value_hash( Json const &value, std::uint64_t seed )
+    {
+        return structure_hash<number_hash>( value, seed );
+    }
+
+    std::uint64_t json_hash( Json const &value, std::uint64_t seed )
+    {
+        return structure_hash<exact_number_hash>( value, seed );
+    }
+
+    void hll_add(
+            std::vector<unsigned char> &registers,
+            unsigned precision,
+            std::uint64_t hash
+            )
+    {
+        if ( registers.empty() )
+            registers.resize( size_t( 1 ) << precision );
+        size_t const index = size_t( hash >> ( 64 - precision ) );
+        // The marker bit bounds the rank.
+        std::uint64_t rest = ( hash << precision )
+                | ( std::uint64_t( 1 ) << ( precision - 1 ) );
+        unsigned char rank = 1;
+        for ( ; not ( rest >> 63 ); rest <<= 1 )
+            ++rank;
+        registers[index] = std::max( registers[index], rank );
+    }
+
+    std::uint64_t hll_estimate( std::vector<unsigned char> const &registers )
+    {
+        if ( registers.empty() )
+            return 0;
+        double const m = double( registers.size() );
+        double sum = 0;
+        size_t zeros = 0;
+        for ( unsigned char rank : registers ) {
+            sum += std::ldexp( 1.0, -int( rank ) );
+            zeros += rank == 0;
+        }
+        double const alpha = registers.size() == 16 ? 0.673
+                : registers.size() == 32 ? 0.697
+                : registers.size() == 64 ? 0.709
+                : 0.7213 / ( 1 + 1.079 / m )
+                ;
+        double estimate = alpha * m * m / sum;
+        if ( estimate <= 2.5 * m && zeros )
+            estimate = m * std::log( m / double( zeros ) );    // Linear counting.
+        return std::uint64_t( std::llround( estimate ) );
+    }
+
+    void write_varint( std::ostream &out, std::uint64_t value )
+    {
+        while ( value >= 0x80 ) {
+            out.put( char( ( value & 0x7F ) | 0x80 ) );
+            value >>= 7;
+        }
+        out.put( char( value ) );
+    }
+
+    bool read_varint( std::istream &in, std::uint64_t &value )
+    {
+        value = 0;
+        for ( unsigned shift = 0; shift < 64; shift += 7 ) {
+            int const byte = in.get();
+            if ( byte == EOF )
+                return false;
+            value |= std::uint64_t( byte & 0x7F ) << shift;
+            if ( not ( byte & 0x80 ) )
+                return true;
+        }
+        return false;
+    }
+
+    void back_off( unsigned &spins )
+    {
+        if ( ++spins < 64 )
+            std::this_thread::yield();
+        else
+            std::this_thread::sleep_for( std::chrono::microseconds( 100 ) );
+    }
+
+    TempFile::~TempFile()
+    {
+        std::error_code ignored;
+        std::filesystem::remove( path, ignored );
+    }
+
+    TempFileNamer::TempFileNamer(
+            string const &directory,
+            string const &stem,
+            string suffix
+            )
+        : m_directory( directory.empty() ? std::filesystem::temp_directory_path()
+                : std::filesystem::path( directory ) )
+        , m_suffix( std::move(suffix) )
+    {
+        std::random_device random;
+        auto const seed = std::uint64_t( random() ) << 32
+                ^ std::uint64_t( std::chrono::steady_clock::now()
+                        .time_since_epoch().count() );
+        char unique[24];
+        std::snprintf( unique, sizeof unique, "-%016llx-",
+                static_cast<unsigned long long>( seed ) );
+        m_prefix = stem + unique;
+    }
+
+    std::unique_ptr<TempFile> TempFileNamer::make()
+    {
+        return std::make_unique<TempFile>( m_directory
+                / ( m_prefix + std::to_string( m_count++ ) + m_suffix ) );
+    }
+
 }
 // vi: et ts=4 sts=4 sw=4
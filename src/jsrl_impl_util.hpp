@@ -11,10 +11,21 @@
  */
 #ifndef JSRL_IMPL_UTIL_HPP_B8F82B7DC8889D7E8E015CDB9103EB8F
 #define JSRL_IMPL_UTIL_HPP_B8F82B7DC8889D7E8E015CDB9103EB8F
+#include "jsrl.hpp"
 #include <streambuf>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <cassert>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <istream>
+#include <ostream>
+#include <mutex>
 
 namespace jsrl {
     using std::streambuf;
@@ -30,6 +41,37 @@ namespace jsrl {
                  *const end = begin + (finish-start);
             setg( begin, begin, end );
         }
+
+        /*! @brief  Offset of the next byte to be read from the start. */
+        size_t position() const {
+            return size_t( gptr() - eback() );
+        }
+    };
+
+    /*! @brief  Output streambuf appending to a string.
+     *
+     *  Lets encoders reuse one growing buffer
+     *  instead of building an @c ostringstream per element.
+     */
+    struct jsrl_string_outbuf : streambuf {
+        explicit
+        jsrl_string_outbuf( string &target )
+            : m_target( target )
+        { }
+
+    protected:
+        int_type overflow( int_type c ) override {
+            if ( c != traits_type::eof() )
+                m_target.push_back( traits_type::to_char_type( c ) );
+            return traits_type::not_eof( c );
+        }
+        std::streamsize xsputn( char const *s, std::streamsize n ) override {
+            m_target.append( s, size_t( n ) );
+            return n;
+        }
+
+    private:
+        string &m_target;
     };
 
     /*! @brief  Reusable buffer for read_json_string_value to build a result. */
@@ -73,8 +115,218 @@ namespace jsrl {
             StringPackager &sp //!<[in] Reusable buffer
             );
 
+    /*! @brief  Read a json string's value, appending it to @c out.
+     *
+     *  Like @ref read_json_string_value, but without a temporary copy.
+     */
+    void read_json_string_into(
+            streambuf &sbuf,    //!<[in] Positioned after the opening quote.
+            string &out         //!<[out] Receives the decoded bytes.
+            );
+
+    /*! @brief  Read past a json string, validating but not keeping it.
+     */
+    void skip_json_string(
+            streambuf &sbuf     //!<[in] Positioned after the opening quote.
+            );
+
     int jsrl_get_nonspace_byte( streambuf &sbuf );
 
+    /*! @brief  Receives the source extent of each element as it is parsed.
+     */
+    struct ParseSpanSink {
+        /*! @brief  Called after each element (including nested ones) is read.
+         *
+         *  Offsets are relative to the start of the parsed range;
+         *  @c end is one past the element's last byte.
+         */
+        virtual void element_span(
+                Json const &element,
+                size_t begin,
+                size_t end
+                ) = 0;
+    protected:
+        ~ParseSpanSink() = default;
+    };
+
+    /*! @brief  Parse a whole character range, reporting each element's span.
+     *
+     *  This behaves like @ref Json::parse on the same range,
+     *  except that each @c null element gets an identity of its own
+     *  (so that its span can be looked up later).
+     *
+     *  @throw Json::ParseError Invalid JSON or trailing bytes.
+     */
+    Json parse_json_with_spans(
+            char const *start,      //!<[in] Start of the JSON text.
+            char const *finish,     //!<[in] End of the JSON text.
+            Json::ParseOptions const &parse_options, //!<[in] Parse options.
+            ParseSpanSink &spans    //!<[in] Span recipient.
+            );
+
+    /*! @brief  Cheap classification of a number from its source text.
+     */
+    enum NumberTextClass {
+        NTC_UNSIGNED,   //!< Integral, fits in @c long @c long @c unsigned.
+        NTC_SIGNED,     //!< Integral and negative, fits in @c long @c long.
+        NTC_FLOAT,      //!< Fractional, exponent, or out of integral range.
+    };
+
+    /*! @brief  Read a json number from a streambuf as raw text.
+     *
+     *  The number is validated with the same grammar as
+     *  @ref GeneralNumber::parse, but no digit vector is built;
+     *  the bytes are appended to @c text as they appear in the input.
+     *
+     *  @throw GeneralNumber::NumberParseError  Malformed number.
+     *  @throw GeneralNumber::BadEOFParseError  Input ended within the number.
+     */
+    NumberTextClass read_json_number_text(
+            streambuf &sbuf,    //!<[in] The buffer to read the number out of.
+            string &text        //!<[out] Receives the number's source bytes.
+            );
+
+    /*! @brief  Any number's value as a GeneralNumber
+     *          (a double's to @c long @c double precision).
+     */
+    GeneralNumber number_as_general( Json const &number );
+
+    /*! @brief  Json's own comparison of two numbers,
+     *          the one its comparison operators use.
+     *
+     *  Numbers of equal value are equal, except that a double
+     *  or a GeneralNumber with a decimal point orders after the equal
+     *  integer: @c 1.50 equals @c 1.5, but @c 1.0 follows @c 1.
+     *
+     *  @return Negative, zero or positive, like @c strcmp.
+     */
+    int json_number_compare( Json const &lhs, Json const &rhs );
+
+    /*! @brief  Total order like Json comparison,
+     *          except that numbers of equal value are equal
+     *          (Json orders a double or GeneralNumber after the equal integer).
+     *
+     *  @return Negative, zero or positive, like @c strcmp.
+     */
+    int json_value_compare( Json const &lhs, Json const &rhs );
+
+    /*! @brief  The MurmurHash3 64-bit finalizer: every input bit affects every output bit.
+     */
+    std::uint64_t mix_hash( std::uint64_t hash );
+
+    /*! @brief  64-bit FNV-1a, with a final mix so that every bit is usable.
+     *
+     *  A nonzero @c seed is XORed into the FNV offset basis.
+     */
+    std::uint64_t hash_bytes( std::string_view bytes, std::uint64_t seed = 0 );
+
+    /*! @brief  Hash consistent with @ref json_value_compare:
+     *          values that compare equal hash alike,
+     *          so @c 1, @c 1.0 and @c 1e0 all have one hash.
+     *
+     *  A nonzero @c seed is mixed into each type's starting hash
+     *  and passed on to @ref hash_bytes, giving a different hash
+     *  of the same structure.
+     */
+    std::uint64_t json_value_hash( Json const &value, std::uint64_t seed = 0 );
+
+    /*! @brief  Hash consistent with Json's own comparison
+     *          (@ref json_number_compare for numbers):
+     *          values that compare equal hash alike,
+     *          so @c 1.50 and @c 1.5 have one hash, while @c 1 and @c 1.0
+     *          are told apart.
+     *
+     *  @c seed works as for @ref json_value_hash.
+     */
+    std::uint64_t json_hash( Json const &value, std::uint64_t seed = 0 );
+
+    /*! @brief  Count a hash in HyperLogLog registers,
+     *          which are allocated (2^@c precision of them) on first use.
+     */
+    void hll_add(
+            std::vector<unsigned char> &registers,
+            unsigned precision,     //!<[in] From 4 to 16.
+            std::uint64_t hash
+            );
+
+    /*! @brief  Estimated number of distinct hashes counted by @ref hll_add.
+     */
+    std::uint64_t hll_estimate( std::vector<unsigned char> const &registers );
+
+    /*! @brief  Write an unsigned LEB128 varint, as used by saved indexes.
+     */
+    void write_varint( std::ostream &out, std::uint64_t value );
+
+    /*! @brief  Read a varint written by @ref write_varint.
+     *
+     *  @retval false   The input ended or the number is too long.
+     */
+    bool read_varint( std::istream &in, std::uint64_t &value );
+
+    /*! @brief  Keeps the first exception thrown by any of a set of workers.
+     */
+    struct FirstError {
+        std::mutex mutex;
+        std::exception_ptr error;
+        std::atomic<bool> failed{ false };
+
+        /*! @brief  Record the exception being handled, unless one was. */
+        void capture() {
+            std::lock_guard<std::mutex> lock( mutex );
+            if ( not error )
+                error = std::current_exception();
+            failed.store( true, std::memory_order_release );
+        }
+        /*! @brief  Whether any worker has failed, so others can stop. */
+        bool any() const {
+            return failed.load( std::memory_order_acquire );
+        }
+        void rethrow() {
+            if ( error )
+                std::rethrow_exception( error );
+        }
+    };
+
+    /*! @brief  Wait a little longer each time a queue is found full or empty.
+     *
+     *  Yields at first, then sleeps briefly; reset @c spins to 0
+     *  after making progress.
+     */
+    void back_off( unsigned &spins );
+
+    /*! @brief  A temporary file, removed along with this (if it was made).
+     */
+    struct TempFile {
+        explicit
+        TempFile( std::filesystem::path path )
+            : path( std::move(path) )
+        { }
+        ~TempFile();
+        TempFile( TempFile const & ) = delete;
+        TempFile &operator=( TempFile const & ) = delete;
+
+        std::filesystem::path const path;
+    };
+
+    /*! @brief  Names temporary files that no other user of the directory
+     *          will name alike; safe to use from several threads.
+     */
+    struct TempFileNamer {
+        TempFileNamer(
+                string const &directory,    //!<[in] Empty for the system's.
+                string const &stem,         //!<[in] Start of each name.
+                string suffix = string()    //!<[in] End of each name.
+                );
+
+        std::unique_ptr<TempFile> make();
+
+    private:
+        std::filesystem::path const m_directory;
+        string m_prefix;
+        string const m_suffix;
+        std::atomic<std::uint64_t> m_count{ 0 };
+    };
+
 }
 #endif
 // vi: et ts=4 sts=4 sw=4
@@ -0,0 +1,240 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#include "jsrl_join.hpp"
+#include "jsrl_ndjson.hpp"
+
+#include <stdexcept>
+#include <system_error>
+
+namespace jsrl {
+    using std::vector;
+
+    namespace {
+        size_t const npos = size_t( -1 );
+    }
+
+    struct MergeJoin::Cursor {
+        Cursor( JoinInput input, size_t index )
+            : reader( *input.input )
+            , key_path( std::move(input.key) )
+            , index( index )
+        { }
+
+        NdjsonReader reader;
+        JsonPointer const key_path;
+        size_t const index;
+        bool has = false;       // Whether record and key are the next ones.
+        bool started = false;   // Whether any record has been read.
+        Json record;
+        Json key;
+    };
+
+    MergeJoin::MergeJoin( vector<JoinInput> inputs, JoinOptions const &options )
+        : m_options( options )
+        , m_groups( inputs.size() )
+        , m_sources( inputs.size(), false )
+    {
+        if ( inputs.size() < 2 )
+            throw std::invalid_argument( "A join needs at least two inputs" );
+        for ( size_t i = 0; i != inputs.size(); ++i )
+            m_cursors.push_back( std::make_unique<Cursor>( std::move(inputs[i]), i ) );
+    }
+
+    MergeJoin::~MergeJoin() = default;
+
+    bool MergeJoin::p_is_less( Json const &lhs, Json const &rhs ) const
+    {
+        return m_options.descending ? rhs < lhs : lhs < rhs;
+    }
+
+    // Read a cursor's next record, checking that keys stay in order.
+    void MergeJoin::p_advance( Cursor &cursor )
+    {
+        cursor.has = false;
+        string_view line;
+        while ( cursor.reader.next( line ) ) {
+            Json record;
+            try {
+                record = Json::parse( line, m_options.parse_options );
+            } catch ( Json::ParseError const & ) {
+                if ( not m_options.skip_invalid )
+                    throw;
+                ++m_invalid;
+                continue;
+            }
+            if ( not record.is_object() ) {
+                throw JoinError( "Input " + std::to_string( cursor.index )
+                        + " has a record that isn't an object" );
+            }
+            Json const *const found = cursor.key_path.find( record );
+            Json key = found ? *found : Json();
+            if ( cursor.started && p_is_less( key, cursor.key ) ) {
+                throw JoinError( "Input " + std::to_string( cursor.index )
+                        + " isn't sorted by " + cursor.key_path.to_string() );
+            }
+            cursor.record = std::move(record);
+            cursor.key = std::move(key);
+            cursor.has = cursor.started = true;
+            return;
+        }
+    }
+
+    // Whether an input's null-keyed records are joined, each on its own.
+    bool MergeJoin::p_keeps_unmatched( size_t input ) const
+    {
+        return m_options.kind == JoinOptions::JK_FULL
+            || ( m_options.kind == JoinOptions::JK_LEFT && input == 0 );
+    }
+
+    // Find the next key with records to join, and gather them.
+    bool MergeJoin::p_next_group()
+    {
+        if ( m_alone ) {
+            for ( size_t i = m_joined.front() + 1; i != m_groups.size(); ++i ) {
+                if ( p_keeps_unmatched( i ) && not m_groups[i].empty() ) {
+                    m_joined.assign( 1, i );
+                    m_picks.assign( 1, 0 );
+                    return true;
+                }
+            }
+            m_alone = false;
+        }
+        if ( not m_primed ) {
+            for ( auto &&cursor : m_cursors )
+                p_advance( *cursor );
+            m_primed = true;
+        }
+        for (;;) {
+            Cursor const *least = nullptr;
+            for ( auto &&cursor : m_cursors ) {
+                if ( cursor->has && ( not least || p_is_less( cursor->key, least->key ) ) )
+                    least = cursor.get();
+            }
+            if ( not least )
+                return false;
+            Json const key = least->key;
+            m_joined.clear();
+            for ( auto &&cursor : m_cursors ) {
+                auto &group = m_groups[ cursor->index ];
+                group.clear();
+                while ( cursor->has && not p_is_less( key, cursor->key ) ) {
+                    group.push_back( std::move( cursor->record ) );
+                    p_advance( *cursor );
+                }
+                if ( not group.empty() )
+                    m_joined.push_back( cursor->index );
+            }
+            if ( key.is_null() ) {
+                // Null keys match nothing: each record stands alone.
+                for ( size_t i : m_joined ) {
+                    if ( p_keeps_unmatched( i ) ) {
+                        m_alone = true;
+                        m_joined.assign( 1, i );
+                        m_picks.assign( 1, 0 );
+                        return true;
+                    }
+                }
+                continue;
+            }
+            bool const wanted
+                = m_options.kind == JoinOptions::JK_FULL
+                || ( m_options.kind == JoinOptions::JK_LEFT && not m_groups[0].empty() )
+                || m_joined.size() == m_groups.size()
+                ;
+            if ( wanted ) {
+                m_picks.assign( m_joined.size(), 0 );
+                return true;
+            }
+        }
+    }
+
+    bool MergeJoin::next( Json &record )
+    {
+        if ( not m_pending ) {
+            if ( not p_next_group() )
+                return false;
+            m_pending = true;
+        }
+        vector<Json::ObjectBody const *> bodies;
+        m_sources.assign( m_sources.size(), false );
+        for ( size_t j = 0; j != m_joined.size(); ++j ) {
+            bodies.push_back( &m_groups[ m_joined[j] ][ m_picks[j] ].as_object() );
+            m_sources[ m_joined[j] ] = true;
+        }
+        record = bodies.size() == 1 ? m_groups[ m_joined[0] ][ m_picks[0] ]
+                : Json( merge_object_bodies( bodies ) );
+        // The next combination, the last input's records turning fastest.
+        size_t j = m_joined.size();
+        while ( j != 0 ) {
+            --j;
+            if ( ++m_picks[j] != m_groups[ m_joined[j] ].size() )
+                return true;
+            m_picks[j] = 0;
+        }
+        m_pending = false;
+        return true;
+    }
+
+    uint64_t merge_join_ndjson(
+            vector<JoinInput> inputs,
+            std::ostream &output,
+            JoinOptions const &options
+            )
+    {
+        MergeJoin join( std::move(inputs), options );
+        uint64_t written = 0;
+        Json record;
+        while ( join.next( record ) ) {
+            output << Json::OptionedWrite( record, options.encode_options ) << '\n';
+            if ( not output ) {
+                throw std::system_error( std::make_error_code( std::errc::io_error ),
+                        "Cannot write joined output" );
+            }
+            ++written;
+        }
+        output.flush();
+        return written;
+    }
+
+    Json::ObjectBody merge_object_bodies(
+            vector<Json::ObjectBody const *> const &bodies
+            )
+    {
+        Json::ObjectBody merged;
+        size_t total = 0;
+        for ( auto &&body : bodies )
+            total += body->size();
+        merged.reserve( total );
+        vector<size_t> at( bodies.size(), 0 );
+        for (;;) {
+            // The least name at any body's head, from the last body having it.
+            size_t least = npos;
+            for ( size_t i = 0; i != bodies.size(); ++i ) {
+                if ( at[i] != bodies[i]->size() && ( least == npos
+                            or not ( (*bodies[least])[ at[least] ].first
+                                < (*bodies[i])[ at[i] ].first ) ) )
+                    least = i;
+            }
+            if ( least == npos )
+                return merged;
+            auto const &member = (*bodies[least])[ at[least] ];
+            merged.push_back( member );
+            for ( size_t i = 0; i != bodies.size(); ++i ) {
+                if ( at[i] != bodies[i]->size()
+                        && (*bodies[i])[ at[i] ].first == member.first )
+                    ++at[i];
+            }
+        }
+    }
+
+}
+// vi: et ts=4 sts=4 sw=4
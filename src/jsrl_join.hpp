@@ -0,0 +1,169 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#ifndef JSRL_JOIN_HPP_5D92C7E04A1B83F6E2D9A0B57C3F6148
+#define JSRL_JOIN_HPP_5D92C7E04A1B83F6E2D9A0B57C3F6148
+
+#include "jsrl.hpp"
+#include "jsrl_pointer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+/*! @file jsrl_join.hpp
+ *  @brief Joining sorted NDJSON streams.
+ */
+namespace jsrl {
+    using std::size_t;
+    using std::string;
+    using std::uint64_t;
+
+    /*! @brief  Error thrown for input a @ref MergeJoin can't join:
+     *          records out of key order, or that aren't objects.
+     */
+    struct JoinError : Json::Error {
+        explicit JoinError( string const &msg ) : Error( msg ) { }
+    protected:
+        char const *v_failtag() const override { return "Join Error"; }
+    };
+
+    /*! @brief  One NDJSON stream to join, sorted on the value at @c key.
+     */
+    struct JoinInput {
+        std::streambuf *input;  //!< Must outlive the join.
+        JsonPointer key;        //!< A missing value reads as null.
+    };
+
+    /*! @brief  How a @ref MergeJoin joins.
+     */
+    struct JoinOptions {
+        enum Kind {
+            JK_INNER,   //!< Keys found in every input.
+            JK_LEFT,    //!< Keys found in the first input.
+            JK_FULL,    //!< Keys found in any input.
+        };
+
+        Kind kind = JK_INNER;
+        bool descending = false;    //!< Inputs are sorted greatest key first.
+        bool skip_invalid = false;  //!< Count bad records instead of throwing.
+        Json::ParseOptions parse_options = Json::ParseOptions( false );
+        Json::EncodeOptions encode_options = Json::EncodeOptions(
+                Json::EncodeOptions::TN_EXACT, false, false );
+    };
+
+    /*! @brief  Joins NDJSON streams sorted on a key, in one pass over each.
+     *
+     *  Each input is read in step with the others,
+     *  holding only the records that share the current key,
+     *  so memory use doesn't grow with the inputs.
+     *  Keys compare like @c Json values (as @ref sort_ndjson orders them),
+     *  and null keys match nothing.
+     *  Where several records of some inputs share a key,
+     *  every combination of them is joined.
+     *
+     *  A joined record has the members of the records it was joined from,
+     *  merged in one linear pass over their (sorted) bodies;
+     *  where a name is in more than one, the later input's value is kept.
+     *  Inputs without a record for the key add nothing
+     *  (in left and full joins).
+     *
+     *  Example:
+     *  @code
+     *      JoinOptions options;
+     *      options.kind = JoinOptions::JK_FULL;
+     *      MergeJoin join( { { orders.rdbuf(), JsonPointer( "/order_id" ) },
+     *                        { payments.rdbuf(), JsonPointer( "/order" ) } },
+     *              options );
+     *      Json record;
+     *      while ( join.next( record ) ) {
+     *          if ( not join.sources()[1] )
+     *              unpaid( record );
+     *      }
+     *  @endcode
+     */
+    struct MergeJoin {
+        /*! @throw std::invalid_argument Fewer than two inputs.
+         */
+        explicit
+        MergeJoin(
+                std::vector<JoinInput> inputs,
+                JoinOptions const &options = JoinOptions()
+                );
+        MergeJoin( MergeJoin const & ) = delete;
+        MergeJoin &operator=( MergeJoin const & ) = delete;
+        ~MergeJoin();
+
+        /*! @brief  Get the next joined record.
+         *
+         *  @retval false   The join is done.
+         *  @throw JoinError        An input is out of key order,
+         *                          or has a record that isn't an object.
+         *  @throw Json::ParseError A record isn't valid JSON
+         *                          (unless @c skip_invalid).
+         */
+        bool next( Json &record );
+
+        /*! @brief  Which inputs the last record was joined from, by index. */
+        std::vector<bool> const &sources() const { return m_sources; }
+
+        uint64_t invalid() const { return m_invalid; }  //!< Bad records skipped.
+
+    private:
+        struct Cursor;
+
+        void p_advance( Cursor &cursor );
+        bool p_keeps_unmatched( size_t input ) const;
+        bool p_next_group();
+        bool p_is_less( Json const &lhs, Json const &rhs ) const;
+
+        JoinOptions const m_options;
+        std::vector<std::unique_ptr<Cursor>> m_cursors;
+        // Records of each input sharing the current key, and the one
+        // taken from each for the next combination (all inputs with any).
+        std::vector<std::vector<Json>> m_groups;
+        std::vector<size_t> m_picks;
+        std::vector<size_t> m_joined;   // Inputs in the combinations.
+        bool m_primed = false;          // Whether every cursor has been read.
+        bool m_pending = false;         // Whether m_picks is still to be joined.
+        bool m_alone = false;           // Joining null-keyed records one by one.
+        std::vector<bool> m_sources;
+        uint64_t m_invalid = 0;
+    };
+
+    /*! @brief  Join NDJSON inputs, writing the joined records as NDJSON.
+     *
+     *  @return The number of records written.
+     *  @throw JoinError        See @ref MergeJoin::next.
+     *  @throw Json::ParseError A record isn't valid JSON
+     *                          (unless @c skip_invalid).
+     */
+    uint64_t merge_join_ndjson(
+            std::vector<JoinInput> inputs,
+            std::ostream &output,
+            JoinOptions const &options = JoinOptions()
+            );
+
+    /*! @brief  An object with the members of sorted object bodies,
+     *          merged in one pass;
+     *          where a name repeats, the later body's value is kept.
+     */
+    Json::ObjectBody merge_object_bodies(
+            std::vector<Json::ObjectBody const *> const &bodies
+            );
+
+}
+#endif
+// vi: et ts=4 sts=4 sw=4
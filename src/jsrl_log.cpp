@@ -0,0 +1,271 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#include "jsrl_log.hpp"
+#include "jsrl_impl_util.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <ostream>
+#include <system_error>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace jsrl {
+    using std::lock_guard;
+    using std::max;
+    using std::memory_order_acquire;
+    using std::memory_order_relaxed;
+    using std::memory_order_release;
+    using std::memory_order_seq_cst;
+    using std::mutex;
+    using std::ostream;
+    using std::system_error;
+    using std::unique_lock;
+
+    namespace {
+
+        auto const full_wait = std::chrono::milliseconds( 1 );
+        unsigned const full_spins = 64;
+
+        int open_log_file( string const &path ) {
+#ifdef _WIN32
+            int const fd = ::_open( path.c_str(),
+                    _O_WRONLY | _O_APPEND | _O_CREAT | _O_BINARY, 0644 );
+#else
+            int const fd = ::open( path.c_str(),
+                    O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644 );
+#endif
+            if ( fd < 0 ) {
+                throw system_error( errno, std::generic_category(),
+                        "Cannot open log file " + path );
+            }
+            return fd;
+        }
+
+        void close_log_file( int fd ) {
+#ifdef _WIN32
+            ::_close( fd );
+#else
+            ::close( fd );
+#endif
+        }
+
+        bool write_all( int fd, char const *data, size_t size ) {
+            while ( size ) {
+#ifdef _WIN32
+                auto const n = ::_write( fd, data, unsigned( size ) );
+#else
+                auto const n = ::write( fd, data, size );
+#endif
+                if ( n < 0 ) {
+                    if ( errno == EINTR )
+                        continue;
+                    return false;
+                }
+                data += n;
+                size -= size_t( n );
+            }
+            return true;
+        }
+
+    }
+
+    AsyncLogSink::AsyncLogSink( int fd, AsyncLogOptions const &options )
+        : m_options( options )
+        , m_fd( fd )
+        , m_owns_fd( false )
+        , m_queue( options.capacity )
+    {
+        p_start();
+    }
+
+    AsyncLogSink::AsyncLogSink(
+            string const &path,
+            AsyncLogOptions const &options
+            )
+        : m_options( options )
+        , m_fd( open_log_file( path ) )
+        , m_owns_fd( true )
+        , m_queue( options.capacity )
+    {
+        p_start();
+    }
+
+    AsyncLogSink::~AsyncLogSink()
+    {
+        m_stopping.store( true, memory_order_release );
+        {
+            lock_guard<mutex> lock( m_wait_mutex );
+        }
+        m_work.notify_all();
+        for ( auto &&thread : m_threads )
+            thread.join();
+        if ( m_owns_fd )
+            close_log_file( m_fd );
+    }
+
+    void AsyncLogSink::p_start()
+    {
+        size_t const count = max<size_t>( 1, m_options.encoder_threads );
+        try {
+            for ( size_t i = 0; i != count; ++i )
+                m_threads.emplace_back( [this] { p_encoder_loop(); } );
+        } catch ( ... ) {
+            m_stopping.store( true, memory_order_release );
+            m_work.notify_all();
+            for ( auto &&thread : m_threads )
+                thread.join();
+            if ( m_owns_fd )
+                close_log_file( m_fd );
+            throw;
+        }
+    }
+
+    bool AsyncLogSink::log( Json record )
+    {
+        switch ( m_options.backpressure ) {
+        case AsyncLogOptions::BP_SAMPLE:
+            if ( m_queue.size_approx() * 2 >= m_queue.capacity()
+                    && m_options.sample_rate > 1
+                    && m_sampled.fetch_add( 1, memory_order_relaxed )
+                            % m_options.sample_rate ) {
+                m_dropped.fetch_add( 1, memory_order_relaxed );
+                return false;
+            }
+            [[fallthrough]];
+        case AsyncLogOptions::BP_DROP:
+            if ( not m_queue.try_push( record ) ) {
+                m_dropped.fetch_add( 1, memory_order_relaxed );
+                return false;
+            }
+            break;
+        case AsyncLogOptions::BP_BLOCK:
+            for ( unsigned spins = 0; not m_queue.try_push( record ); ++spins ) {
+                if ( spins < full_spins ) {
+                    std::this_thread::yield();
+                } else {
+                    unique_lock<mutex> lock( m_wait_mutex );
+                    m_progress.wait_for( lock, full_wait );
+                }
+            }
+            break;
+        }
+        m_queued.fetch_add( 1, memory_order_relaxed );
+        // Pairs with the fence in p_encoder_loop(): either the encoder
+        // going idle sees this record in the queue, or this sees it idle.
+        // Taking the lock means it is then already waiting, not just
+        // about to, so the notification can't be missed.
+        std::atomic_thread_fence( memory_order_seq_cst );
+        if ( m_idle.load( memory_order_relaxed ) ) {
+            {
+                lock_guard<mutex> lock( m_wait_mutex );
+            }
+            m_work.notify_one();
+        }
+        return true;
+    }
+
+    void AsyncLogSink::flush()
+    {
+        uint64_t const target = m_queued.load( memory_order_acquire );
+        unique_lock<mutex> lock( m_wait_mutex );
+        m_progress.wait( lock, [&] {
+            return m_written.load( memory_order_acquire )
+                    + m_write_errors.load( memory_order_acquire ) >= target;
+        } );
+    }
+
+    auto AsyncLogSink::stats() const -> Stats
+    {
+        return Stats{
+            m_queued.load( memory_order_relaxed ),
+            m_dropped.load( memory_order_relaxed ),
+            m_written.load( memory_order_relaxed ),
+            m_write_errors.load( memory_order_relaxed ),
+        };
+    }
+
+    void AsyncLogSink::p_encoder_loop()
+    {
+        string batch;
+        uint64_t records = 0;
+        uint64_t failed = 0;
+        jsrl_string_outbuf buf( batch );
+        ostream os( &buf );
+        os.exceptions( ostream::badbit );
+        Json record;
+        for (;;) {
+            if ( m_queue.try_pop( record ) ) {
+                size_t const rollback = batch.size();
+                try {
+                    os << Json::OptionedWrite( record, m_options.encode_options );
+                    batch.push_back( '\n' );
+                    ++records;
+                } catch ( Json::Error const & ) {
+                    os.clear();
+                    batch.resize( rollback );
+                    ++failed;
+                }
+                record = Json();
+                if ( batch.size() < m_options.batch_bytes )
+                    continue;
+            }
+            if ( records || failed ) {
+                if ( failed )
+                    m_write_errors.fetch_add( failed, memory_order_release );
+                p_write( batch, records );
+                batch.clear();
+                records = failed = 0;
+                continue;
+            }
+            if ( m_stopping.load( memory_order_acquire ) ) {
+                if ( m_queue.size_approx() == 0 )
+                    return;
+                continue;
+            }
+            unique_lock<mutex> lock( m_wait_mutex );
+            m_idle.fetch_add( 1, memory_order_relaxed );
+            std::atomic_thread_fence( memory_order_seq_cst );
+            m_work.wait( lock, [this] {
+                return m_queue.size_approx() != 0
+                        || m_stopping.load( memory_order_acquire );
+            } );
+            m_idle.fetch_sub( 1, memory_order_relaxed );
+        }
+    }
+
+    void AsyncLogSink::p_write( string const &batch, uint64_t records )
+    {
+        bool ok;
+        {
+            lock_guard<mutex> lock( m_write_mutex );
+            ok = write_all( m_fd, batch.data(), batch.size() );
+        }
+        if ( ok )
+            m_written.fetch_add( records, memory_order_release );
+        else
+            m_write_errors.fetch_add( records, memory_order_release );
+        {
+            lock_guard<mutex> lock( m_wait_mutex );
+        }
+        m_progress.notify_all();
+    }
+
+}
+// vi: et ts=4 sts=4 sw=4
@@ -0,0 +1,139 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#ifndef JSRL_LOG_HPP_C47D1E9B0A3F48E2B6D5713A9E0C8F24
+#define JSRL_LOG_HPP_C47D1E9B0A3F48E2B6D5713A9E0C8F24
+
+#include "jsrl.hpp"
+#include "jsrl_queue.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*! @file jsrl_log.hpp
+ *  @brief Asynchronous structured logging.
+ */
+namespace jsrl {
+    using std::string;
+    using std::uint64_t;
+
+    /*! @brief  Settings for an @ref AsyncLogSink.
+     */
+    struct AsyncLogOptions {
+        /*! @brief  What @c log() does when records arrive faster
+         *  than they can be written.
+         */
+        enum Backpressure {
+            BP_DROP,    //!< Discard records while the queue is full.
+            BP_BLOCK,   //!< Wait for room in the queue.
+            BP_SAMPLE,  //!< Once the queue is half full, keep one in
+                        //!< @c sample_rate records (and drop when full).
+        };
+
+        size_t capacity = 8192;         //!< Records the queue can hold.
+        size_t encoder_threads = 1;     //!< Background encoding threads.
+        size_t batch_bytes = 64 * 1024; //!< Encoded bytes per write.
+        Backpressure backpressure = BP_DROP;    //!< Policy when behind.
+        size_t sample_rate = 16;        //!< For @c BP_SAMPLE.
+        Json::EncodeOptions encode_options = Json::EncodeOptions(
+                Json::EncodeOptions::TN_EXACT, false, false );
+    };
+
+    /*! @brief  Logging sink that encodes records on background threads.
+     *
+     *  Because @c Json values are immutable,
+     *  @c log() only has to copy a handle into a lock-free ring;
+     *  encoder threads take records off the ring,
+     *  encode each as one line of JSON (newline-delimited),
+     *  and write them to the file descriptor in batches.
+     *
+     *  With more than one encoder thread,
+     *  lines from different batches can be written out of order.
+     *
+     *  Example:
+     *  @code
+     *      AsyncLogSink sink( "/var/log/app.ndjson", AsyncLogOptions() );
+     *      sink.log( Json::ObjectBody{ {"event", "start"}, {"pid", pid} } );
+     *  @endcode
+     */
+    struct AsyncLogSink {
+        /*! @brief  Log to an open file descriptor.
+         *
+         *  The descriptor isn't closed by the sink.
+         */
+        AsyncLogSink( int fd, AsyncLogOptions const &options );
+        /*! @brief  Log to a file, appending to it (or creating it).
+         *
+         *  @throw std::system_error    The file couldn't be opened.
+         */
+        AsyncLogSink( string const &path, AsyncLogOptions const &options );
+
+        AsyncLogSink( AsyncLogSink const & ) = delete;
+        AsyncLogSink &operator=( AsyncLogSink const & ) = delete;
+
+        /*! @brief  Write every queued record, then stop the threads.
+         */
+        ~AsyncLogSink();
+
+        /*! @brief  Queue a record for writing.
+         *
+         *  @retval false   The record was dropped by the backpressure policy.
+         */
+        bool log( Json record );
+
+        /*! @brief  Wait until every record queued so far has been written.
+         */
+        void flush();
+
+        /*! @brief  Record counts since the sink was created.
+         */
+        struct Stats {
+            uint64_t queued;        //!< Records accepted by @c log().
+            uint64_t dropped;       //!< Records refused by @c log().
+            uint64_t written;       //!< Records written out.
+            uint64_t write_errors;  //!< Records lost (unencodable or unwritten).
+        };
+        Stats stats() const;
+
+    private:
+        void p_start();
+        void p_encoder_loop();
+        void p_write( string const &batch, uint64_t records );
+
+        AsyncLogOptions const m_options;
+        int m_fd;
+        bool m_owns_fd;
+
+        BoundedQueue<Json> m_queue;
+        std::atomic<uint64_t> m_queued{ 0 };
+        std::atomic<uint64_t> m_dropped{ 0 };
+        std::atomic<uint64_t> m_sampled{ 0 };
+        std::atomic<uint64_t> m_written{ 0 };
+        std::atomic<uint64_t> m_write_errors{ 0 };
+        std::atomic<size_t> m_idle{ 0 };
+        std::atomic<bool> m_stopping{ false };
+
+        std::mutex m_write_mutex;   // Serializes writes to m_fd.
+        std::mutex m_wait_mutex;    // For the condition variables.
+        std::condition_variable m_work;
+        std::condition_variable m_progress;
+        std::vector<std::thread> m_threads;
+    };
+
+}
+#endif
+// vi: et ts=4 sts=4 sw=4
@@ -0,0 +1,367 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#include "jsrl_ndjson.hpp"
+#include "jsrl_impl_util.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace jsrl {
+    using std::make_unique;
+    using std::system_error;
+
+    namespace {
+        bool is_blank( char const *begin, char const *end ) {
+            for ( ; begin != end; ++begin ) {
+                switch ( *begin ) {
+                case ' ': case '\t': case '\r': case '\n':
+                    break;
+                default:
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+
+    NdjsonReader::NdjsonReader( streambuf &sbuf, size_t block_size )
+        : m_sbuf( sbuf )
+        , m_block_size( std::max<size_t>( block_size, 16 ) )
+    { }
+
+    NdjsonReader::NdjsonReader( string_view text )
+        : m_owned( make_unique<jsrl_streambuf>(
+                    text.data(), text.data() + text.size() ) )
+        , m_sbuf( *m_owned )
+        , m_block_size( std::max<size_t>( text.size(), 16 ) )
+    { }
+
+    NdjsonReader::~NdjsonReader() = default;
+
+    // Read another block after the unread data; false at the end of input.
+    bool NdjsonReader::p_fill()
+    {
+        if ( m_eof )
+            return false;
+        if ( m_begin ) {
+            // Move the partial line to the front.
+            std::memmove( m_buffer.data(), m_buffer.data() + m_begin,
+                    m_end - m_begin );
+            m_offset += m_begin;
+            m_end -= m_begin;
+            m_begin = 0;
+        }
+        if ( m_buffer.size() < m_end + m_block_size )
+            m_buffer.resize( m_end + m_block_size );
+        auto const got = m_sbuf.sgetn( m_buffer.data() + m_end,
+                std::streamsize( m_block_size ) );
+        if ( got <= 0 ) {
+            m_eof = true;
+            return false;
+        }
+        m_end += size_t( got );
+        return true;
+    }
+
+    bool NdjsonReader::next( string_view &record )
+    {
+        size_t scanned = m_begin;
+        for (;;) {
+            char const *data = m_buffer.data();
+            auto const newline = scanned == m_end
+                    ? nullptr
+                    : static_cast<char const *>( std::memchr(
+                                data + scanned, '\n', m_end - scanned ) )
+                    ;
+            size_t line_end;
+            size_t next_begin;
+            if ( newline ) {
+                line_end = size_t( newline - data );
+                next_begin = line_end + 1;
+            } else {
+                size_t const unread = m_end - m_begin;
+                if ( p_fill() ) {
+                    scanned = unread;
+                    continue;
+                }
+                if ( m_begin == m_end )
+                    return false;
+                // Last line, without a newline (the buffer may have moved).
+                data = m_buffer.data();
+                line_end = next_begin = m_end;
+            }
+            ++m_line;
+            size_t const begin = m_begin;
+            m_begin = next_begin;
+            scanned = m_begin;
+            if ( is_blank( data + begin, data + line_end ) )
+                continue;
+            if ( line_end != begin && data[line_end - 1] == '\r' )
+                --line_end;
+            if ( not m_searchers.empty()
+                    && not p_has_literals( data + begin, data + line_end ) ) {
+                ++m_filtered;
+                continue;
+            }
+            m_record_offset = m_offset + begin;
+            record = string_view( data + begin, line_end - begin );
+            return true;
+        }
+    }
+
+    void NdjsonReader::require_literals( std::vector<string> literals )
+    {
+        m_searchers.clear();
+        m_literals = std::move( literals );
+        m_literals.erase( std::remove( m_literals.begin(), m_literals.end(),
+                    string() ), m_literals.end() );
+        for ( auto &&literal : m_literals ) {
+            m_searchers.emplace_back(
+                    literal.data(), literal.data() + literal.size() );
+        }
+    }
+
+    bool NdjsonReader::p_has_literals( char const *begin, char const *end ) const
+    {
+        for ( auto &&searcher : m_searchers ) {
+            if ( std::search( begin, end, searcher ) == end )
+                return false;
+        }
+        return true;
+    }
+
+    size_t NdjsonReader::next_chunk( string &chunk, size_t min_bytes )
+    {
+        size_t count = 0;
+        string_view record;
+        while ( chunk.size() < min_bytes && next( record ) ) {
+            chunk.append( record.data(), record.size() );
+            chunk.push_back( '\n' );
+            ++count;
+        }
+        return count;
+    }
+
+    namespace {
+        char const index_magic[8] = { 'J', 'S', 'R', 'L', 'N', 'D', 'X', '1' };
+
+        uint64_t get_varint( std::istream &in ) {
+            uint64_t value;
+            if ( not read_varint( in, value ) )
+                throw NdjsonIndexError( "Truncated NDJSON index" );
+            return value;
+        }
+    }
+
+    NdjsonIndex NdjsonIndex::s_build( streambuf &input, uint64_t sample_every )
+    {
+        return s_build( input, sample_every, nullptr );
+    }
+
+    NdjsonIndex NdjsonIndex::s_build(
+            streambuf &input,
+            uint64_t sample_every,
+            std::function<void( string_view record )> const &on_record
+            )
+    {
+        NdjsonIndex index;
+        index.m_sample_every = std::max<uint64_t>( sample_every, 1 );
+        NdjsonReader reader( input );
+        string_view record;
+        while ( reader.next( record ) ) {
+            if ( index.m_records % index.m_sample_every == 0 )
+                index.m_offsets.push_back( reader.record_offset() );
+            ++index.m_records;
+            if ( on_record )
+                on_record( record );
+        }
+        index.m_data_size = reader.end_offset();
+        return index;
+    }
+
+    void NdjsonIndex::save( std::ostream &output ) const
+    {
+        output.write( index_magic, sizeof index_magic );
+        write_varint( output, m_sample_every );
+        write_varint( output, m_records );
+        write_varint( output, m_data_size );
+        uint64_t previous = 0;
+        for ( uint64_t offset : m_offsets ) {
+            write_varint( output, offset - previous );
+            previous = offset;
+        }
+    }
+
+    NdjsonIndex NdjsonIndex::s_load( std::istream &input )
+    {
+        char magic[sizeof index_magic];
+        if ( not input.read( magic, sizeof magic )
+                || not std::equal( magic, magic + sizeof magic, index_magic ) )
+            throw NdjsonIndexError( "Not an NDJSON index" );
+        NdjsonIndex index;
+        index.m_sample_every = get_varint( input );
+        index.m_records = get_varint( input );
+        index.m_data_size = get_varint( input );
+        if ( index.m_sample_every == 0 )
+            throw NdjsonIndexError( "Bad sampling in NDJSON index" );
+        uint64_t const count = index.m_records / index.m_sample_every
+                + ( index.m_records % index.m_sample_every != 0 );
+        uint64_t offset = 0;
+        for ( uint64_t i = 0; i != count; ++i ) {
+            offset += get_varint( input );
+            if ( offset >= index.m_data_size )
+                throw NdjsonIndexError( "Offset out of range in NDJSON index" );
+            index.m_offsets.push_back( offset );
+        }
+        return index;
+    }
+
+    auto NdjsonIndex::locate( uint64_t record ) const -> Position
+    {
+        if ( record >= m_records )
+            throw Json::ArrayKeyError( size_t( record ), size_t( m_records ) );
+        size_t const sample = size_t( record / m_sample_every );
+        return Position{
+            m_offsets[sample],
+            record % m_sample_every,
+            sample + 1 < m_offsets.size() ? m_offsets[sample + 1] : m_data_size,
+        };
+    }
+
+    std::vector<NdjsonRange> NdjsonIndex::split( size_t parts ) const
+    {
+        std::vector<NdjsonRange> ranges;
+        if ( m_offsets.empty() )
+            return ranges;
+        parts = std::max<size_t>( 1, std::min( parts, m_offsets.size() ) );
+        // Start each range at the first indexed record past its share.
+        std::vector<size_t> starts{ 0 };
+        for ( size_t j = 1; j != parts; ++j ) {
+            uint64_t const target = m_offsets.front()
+                    + ( m_data_size - m_offsets.front() ) / parts * j;
+            size_t const sample = size_t( std::lower_bound( m_offsets.begin(),
+                        m_offsets.end(), target ) - m_offsets.begin() );
+            if ( sample > starts.back() && sample < m_offsets.size() )
+                starts.push_back( sample );
+        }
+        for ( size_t j = 0; j != starts.size(); ++j ) {
+            bool const last = j + 1 == starts.size();
+            uint64_t const first = starts[j] * m_sample_every;
+            uint64_t const next = last
+                    ? m_records
+                    : starts[j + 1] * m_sample_every
+                    ;
+            ranges.push_back( NdjsonRange{
+                    m_offsets[ starts[j] ],
+                    last ? m_data_size : m_offsets[ starts[j + 1] ],
+                    first,
+                    next - first,
+                } );
+        }
+        return ranges;
+    }
+
+    NdjsonFile::NdjsonFile( string const &path )
+    {
+#ifdef _WIN32
+        m_fd = ::_open( path.c_str(), _O_RDONLY | _O_BINARY );
+#else
+        m_fd = ::open( path.c_str(), O_RDONLY | O_CLOEXEC );
+#endif
+        if ( m_fd < 0 ) {
+            throw system_error( errno, std::generic_category(),
+                    "Cannot open " + path );
+        }
+    }
+
+    NdjsonFile::~NdjsonFile()
+    {
+#ifdef _WIN32
+        ::_close( m_fd );
+#else
+        ::close( m_fd );
+#endif
+    }
+
+    uint64_t NdjsonFile::size() const
+    {
+#ifdef _WIN32
+        struct _stat64 st;
+        if ( ::_fstat64( m_fd, &st ) != 0 )
+#else
+        struct stat st;
+        if ( ::fstat( m_fd, &st ) != 0 )
+#endif
+            throw system_error( errno, std::generic_category(), "Cannot stat" );
+        return uint64_t( st.st_size );
+    }
+
+    void NdjsonFile::read( uint64_t begin, uint64_t end, string &out ) const
+    {
+        out.resize( size_t( end - begin ) );
+        size_t done = 0;
+        while ( done != out.size() ) {
+#ifdef _WIN32
+            int n;
+            {
+                std::lock_guard<std::mutex> lock( m_mutex );
+                if ( ::_lseeki64( m_fd, __int64( begin + done ), SEEK_SET ) < 0 )
+                    n = -1;
+                else
+                    n = ::_read( m_fd, &out[done], unsigned( out.size() - done ) );
+            }
+#else
+            auto const n = ::pread( m_fd, &out[done], out.size() - done,
+                    off_t( begin + done ) );
+#endif
+            if ( n < 0 ) {
+                if ( errno == EINTR )
+                    continue;
+                throw system_error( errno, std::generic_category(),
+                        "Cannot read NDJSON file" );
+            }
+            if ( n == 0 ) {
+                throw system_error( std::make_error_code( std::errc::io_error ),
+                        "NDJSON file is shorter than expected" );
+            }
+            done += size_t( n );
+        }
+    }
+
+    string NdjsonFile::record( NdjsonIndex const &index, uint64_t number ) const
+    {
+        NdjsonIndex::Position const position = index.locate( number );
+        string block;
+        read( position.offset, position.end, block );
+        NdjsonReader reader{ string_view( block ) };
+        string_view record;
+        for ( uint64_t i = 0; i <= position.skip; ++i ) {
+            if ( not reader.next( record ) )
+                throw NdjsonIndexError( "NDJSON file doesn't match its index" );
+        }
+        return string( record );
+    }
+
+}
+// vi: et ts=4 sts=4 sw=4
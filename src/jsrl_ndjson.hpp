@@ -0,0 +1,269 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#ifndef JSRL_NDJSON_HPP_5D2A8C71F04E9B36A1C7D9E28B4F6103
+#define JSRL_NDJSON_HPP_5D2A8C71F04E9B36A1C7D9E28B4F6103
+
+#include "jsrl.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*! @file jsrl_ndjson.hpp
+ *  @brief Reading newline-delimited JSON.
+ */
+namespace jsrl {
+    using std::size_t;
+    using std::streambuf;
+    using std::string;
+    using std::string_view;
+    using std::uint64_t;
+
+    /*! @brief  Splits newline-delimited JSON input into records.
+     *
+     *  Input is read in large blocks,
+     *  and each record is handed out as a view into the block,
+     *  so nothing is copied per record.
+     *  Lines holding only whitespace are skipped,
+     *  and a @c "\r" before the newline is dropped.
+     *  The records themselves aren't parsed.
+     *
+     *  Example:
+     *  @code
+     *      NdjsonReader records( *file.rdbuf() );
+     *      string_view record;
+     *      while ( records.next( record ) ) {
+     *          JsonReader reader( record );
+     *          ...
+     *      }
+     *  @endcode
+     */
+    struct NdjsonReader {
+        /*! @brief  Read from a streambuf, which must outlive the reader.
+         */
+        explicit
+        NdjsonReader(
+                streambuf &sbuf,
+                size_t block_size = 256 * 1024  //!< Bytes read at a time.
+                );
+        /*! @brief  Read from text, which must outlive the reader.
+         */
+        explicit
+        NdjsonReader( string_view text );
+        ~NdjsonReader();
+
+        NdjsonReader( NdjsonReader const & ) = delete;
+        NdjsonReader &operator=( NdjsonReader const & ) = delete;
+
+        /*! @brief  Get the next record, without its line ending.
+         *
+         *  The view is valid until the next call.
+         *
+         *  @retval false   The input has ended.
+         */
+        bool next( string_view &record );
+
+        /*! @brief  Append whole records, each followed by a newline,
+         *          until @c chunk holds at least @c min_bytes.
+         *
+         *  Suited to handing out work in batches to other threads.
+         *
+         *  @return The number of records appended.
+         */
+        size_t next_chunk( string &chunk, size_t min_bytes );
+
+        /*! @brief  Pass over records whose text lacks any of @c literals.
+         *
+         *  A cheap test on the raw bytes, made before anything is parsed,
+         *  for selective jobs: a literal such as @c "\"event\":\"purchase\""
+         *  must appear byte for byte, so records written with other spacing
+         *  or escapes are passed over too.
+         *  Literals are searched for in order,
+         *  so the rarest is best put first.
+         *  An empty list turns the filter off.
+         */
+        void require_literals( std::vector<string> literals );
+        /*! @brief  Records passed over for lacking a required literal. */
+        uint64_t filtered() const { return m_filtered; }
+
+        /*! @brief  Offset in the input of the last record's first byte. */
+        uint64_t record_offset() const { return m_record_offset; }
+        /*! @brief  Line number (from 1) of the last record. */
+        uint64_t line_number() const { return m_line; }
+        /*! @brief  Offset just past the last line read;
+         *          the input size once @c next has returned @c false.
+         */
+        uint64_t end_offset() const { return m_offset + m_begin; }
+
+    private:
+        using Searcher = std::boyer_moore_horspool_searcher<char const *>;
+
+        bool p_fill();
+        bool p_has_literals( char const *begin, char const *end ) const;
+
+        std::unique_ptr<streambuf> m_owned;
+        streambuf &m_sbuf;
+        size_t const m_block_size;
+        std::vector<char> m_buffer;
+        size_t m_begin = 0;         // Unread data in the buffer.
+        size_t m_end = 0;
+        uint64_t m_offset = 0;      // Input offset of m_buffer[0].
+        uint64_t m_record_offset = 0;
+        uint64_t m_line = 0;
+        uint64_t m_filtered = 0;
+        bool m_eof = false;
+        std::vector<string> m_literals;
+        std::vector<Searcher> m_searchers;  // Over m_literals.
+    };
+
+    /*! @brief  Error thrown for a damaged @ref NdjsonIndex file.
+     */
+    struct NdjsonIndexError : Json::Error {
+        explicit NdjsonIndexError( string const &msg ) : Error( msg ) { }
+    protected:
+        char const *v_failtag() const override { return "NDJSON Index Error"; }
+    };
+
+    /*! @brief  Part of an NDJSON file holding whole records.
+     */
+    struct NdjsonRange {
+        uint64_t begin;         //!< Offset of the first record.
+        uint64_t end;           //!< Offset just past the last record's line.
+        uint64_t first_record;  //!< Number (from 0) of the first record.
+        uint64_t records;       //!< Records in the range.
+    };
+
+    /*! @brief  Byte offsets of the records of an NDJSON file.
+     *
+     *  Built in one pass over the file,
+     *  the index lets a record be fetched by number,
+     *  and the file be cut at record boundaries into ranges of similar size
+     *  for parallel workers, without looking for newlines again.
+     *  To keep it small, the index can hold the offset of
+     *  only every Nth record;
+     *  finding another record then means skipping
+     *  at most N - 1 lines after the nearest indexed one.
+     *
+     *  Saved indexes are a magic string followed by LEB128 varints,
+     *  with offsets stored as differences:
+     *  typically two bytes or less per indexed record.
+     */
+    struct NdjsonIndex {
+        /*! @brief  Where to find a record. */
+        struct Position {
+            uint64_t offset;    //!< Offset of an indexed record's line.
+            uint64_t skip;      //!< Records to skip from there.
+            uint64_t end;       //!< Offset past the records that may need
+                                //!< reading (the next indexed record).
+        };
+
+        /*! @brief  Empty index. */
+        NdjsonIndex() = default;
+
+        /*! @brief  Index NDJSON input, recording every
+         *          @c sample_every'th record's offset.
+         */
+        static
+        NdjsonIndex s_build( streambuf &input, uint64_t sample_every = 1 );
+        /*! @brief  Index NDJSON input as above,
+         *          handing each record to @c on_record as it's passed,
+         *          for building other indexes in the same pass.
+         */
+        static
+        NdjsonIndex s_build(
+                streambuf &input,
+                uint64_t sample_every,
+                std::function<void( string_view record )> const &on_record
+                );
+
+        /*! @brief  Read an index written by @ref save.
+         *
+         *  @throw NdjsonIndexError The input isn't a valid index.
+         */
+        static
+        NdjsonIndex s_load( std::istream &input );
+        /*! @brief  Write the index in its compact form.
+         */
+        void save( std::ostream &output ) const;
+
+        uint64_t records() const { return m_records; }      //!< Records indexed.
+        uint64_t data_size() const { return m_data_size; }  //!< Input bytes.
+        uint64_t sample_every() const { return m_sample_every; }
+
+        /*! @brief  Locate a record by number (from 0).
+         *
+         *  @throw Json::ArrayKeyError  There is no such record.
+         */
+        Position locate( uint64_t record ) const;
+
+        /*! @brief  Cut the indexed file into at most @c parts ranges
+         *          of about equal size, at indexed records.
+         */
+        std::vector<NdjsonRange> split( size_t parts ) const;
+
+    private:
+        uint64_t m_sample_every = 1;
+        uint64_t m_records = 0;
+        uint64_t m_data_size = 0;
+        std::vector<uint64_t> m_offsets;
+    };
+
+    /*! @brief  NDJSON file read by offset, for use with an @ref NdjsonIndex.
+     *
+     *  Reads are positioned (@c pread),
+     *  so one file can be shared by several threads.
+     */
+    struct NdjsonFile {
+        /*! @brief  Open a file for reading.
+         *
+         *  @throw std::system_error    The file couldn't be opened.
+         */
+        explicit
+        NdjsonFile( string const &path );
+        NdjsonFile( NdjsonFile const & ) = delete;
+        NdjsonFile &operator=( NdjsonFile const & ) = delete;
+        ~NdjsonFile();
+
+        /*! @brief  Current size of the file. */
+        uint64_t size() const;
+
+        /*! @brief  Read bytes @c begin to @c end into @c out (replacing it),
+         *          with a single read where the system allows.
+         *
+         *  @throw std::system_error    The read failed,
+         *                              or the file is shorter than @c end.
+         */
+        void read( uint64_t begin, uint64_t end, string &out ) const;
+
+        /*! @brief  Fetch a record by number, without its line ending.
+         *
+         *  @throw Json::ArrayKeyError  There is no such record.
+         *  @throw NdjsonIndexError     The file doesn't match the index.
+         */
+        string record( NdjsonIndex const &index, uint64_t number ) const;
+
+    private:
+        int m_fd;
+        mutable std::mutex m_mutex; // Serializes seek and read without pread.
+    };
+
+}
+#endif
+// vi: et ts=4 sts=4 sw=4
@@ -0,0 +1,403 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#include "jsrl_pipeline.hpp"
+#include "jsrl_impl_util.hpp"
+#include "jsrl_ndjson.hpp"
+#include "jsrl_queue.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <string_view>
+#include <system_error>
+#include <thread>
+
+namespace jsrl {
+    using std::atomic;
+    using std::make_unique;
+    using std::memory_order_acq_rel;
+    using std::memory_order_acquire;
+    using std::memory_order_relaxed;
+    using std::memory_order_release;
+    using std::string_view;
+    using std::unique_ptr;
+    using std::vector;
+
+    namespace {
+        // Records travel between stages in batches.
+        struct Batch {
+            uint64_t sequence = 0;      // Order in the input.
+            size_t lines = 0;           // Records in text.
+            string text;                // NDJSON, before parsing or after encoding.
+            vector<Json> records;
+        };
+
+        using Queue = BoundedQueue<Batch>;
+
+        int64_t now_ns() {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch() ).count();
+        }
+
+        void add_relaxed( atomic<uint64_t> &counter, uint64_t amount ) {
+            counter.fetch_add( amount, memory_order_relaxed );
+        }
+    }
+
+    struct Pipeline::Stage {
+        Stage( string name, size_t threads, Transform transform = nullptr )
+            : name( std::move(name) )
+            , threads( std::max<size_t>( threads, 1 ) )
+            , transform( std::move(transform) )
+        { }
+
+        void reset( int64_t start, size_t capacity ) {
+            records_in.store( 0, memory_order_relaxed );
+            records_out.store( 0, memory_order_relaxed );
+            bytes.store( 0, memory_order_relaxed );
+            busy_ns.store( 0, memory_order_relaxed );
+            depth_total.store( 0, memory_order_relaxed );
+            depth_samples.store( 0, memory_order_relaxed );
+            max_depth.store( 0, memory_order_relaxed );
+            queue_capacity.store( capacity, memory_order_relaxed );
+            finished_ns.store( -1, memory_order_relaxed );
+            started_ns.store( start, memory_order_release );
+        }
+
+        void sample_depth( size_t depth ) {
+            add_relaxed( depth_total, depth );
+            add_relaxed( depth_samples, 1 );
+            size_t seen = max_depth.load( memory_order_relaxed );
+            while ( depth > seen && not max_depth.compare_exchange_weak(
+                        seen, depth, memory_order_relaxed ) )
+                ;
+        }
+
+        // Take the next batch from the stage's input queue;
+        // false once it is closed and drained, or some stage failed.
+        bool take( Queue &queue, atomic<bool> const &closed, Batch &batch,
+                FirstError const &errors ) {
+            unsigned spins = 0;
+            while ( not errors.any() ) {
+                size_t const depth = queue.size_approx();
+                if ( queue.try_pop( batch ) ) {
+                    sample_depth( depth );
+                    return true;
+                }
+                // Anything pushed before "closed" is in the queue by now.
+                if ( closed.load( memory_order_acquire ) ) {
+                    if ( not queue.try_pop( batch ) )
+                        return false;
+                    sample_depth( 1 );
+                    return true;
+                }
+                back_off( spins );
+            }
+            return false;
+        }
+
+        string const name;
+        size_t const threads;
+        Transform const transform;
+        atomic<uint64_t> records_in{ 0 };
+        atomic<uint64_t> records_out{ 0 };
+        atomic<uint64_t> bytes{ 0 };
+        atomic<uint64_t> busy_ns{ 0 };
+        atomic<uint64_t> depth_total{ 0 };
+        atomic<uint64_t> depth_samples{ 0 };
+        atomic<size_t> max_depth{ 0 };
+        atomic<size_t> queue_capacity{ 0 };
+        atomic<int64_t> started_ns{ 0 };
+        atomic<int64_t> finished_ns{ -1 };
+    };
+
+    namespace {
+        // Pass a batch to the next stage; false if some stage failed.
+        bool give( Queue &queue, Batch &batch, FirstError const &errors ) {
+            unsigned spins = 0;
+            while ( not queue.try_push( batch ) ) {
+                if ( errors.any() )
+                    return false;
+                back_off( spins );
+            }
+            return true;
+        }
+    }
+
+    Pipeline::Pipeline( PipelineOptions const &options )
+        : m_options( options )
+    {
+        size_t const parse_threads = options.parse_threads
+                ? options.parse_threads
+                : std::max( 1u, std::thread::hardware_concurrency() )
+                ;
+        m_stages.push_back( make_unique<Stage>( "source", 1 ) );
+        m_stages.push_back( make_unique<Stage>( "parse", parse_threads ) );
+        m_stages.push_back( make_unique<Stage>( "encode", options.encode_threads ) );
+        m_stages.push_back( make_unique<Stage>( "sink", 1 ) );
+    }
+
+    Pipeline::~Pipeline() = default;
+
+    Pipeline &Pipeline::stage( string name, Transform transform, size_t threads )
+    {
+        m_stages.insert( m_stages.end() - 2, make_unique<Stage>(
+                    std::move(name), threads, std::move(transform) ) );
+        return *this;
+    }
+
+    Pipeline &Pipeline::map(
+            string name,
+            std::function<Json( Json const &record )> function,
+            size_t threads
+            )
+    {
+        return stage( std::move(name), [function]( Json &record ) {
+                    record = function( record );
+                    return true;
+                }, threads );
+    }
+
+    Pipeline &Pipeline::filter(
+            string name,
+            std::function<bool( Json const &record )> keep,
+            size_t threads
+            )
+    {
+        return stage( std::move(name), [keep]( Json &record ) {
+                    return keep( record );
+                }, threads );
+    }
+
+    uint64_t Pipeline::run( streambuf &input, std::ostream &output )
+    {
+        size_t const count = m_stages.size();
+        size_t const parse = 1;
+        size_t const encode = count - 2;
+        size_t const sink = count - 1;
+        // Queue i feeds stage i + 1.
+        vector<unique_ptr<Queue>> queues;
+        for ( size_t i = 0; i != sink; ++i )
+            queues.push_back( make_unique<Queue>( m_options.queue_capacity ) );
+        unique_ptr<atomic<bool>[]> closed( new atomic<bool>[sink] );
+        unique_ptr<atomic<size_t>[]> running( new atomic<size_t>[count] );
+        int64_t const start = now_ns();
+        for ( size_t i = 0; i != count; ++i ) {
+            if ( i != sink )
+                closed[i].store( false, memory_order_relaxed );
+            running[i].store( m_stages[i]->threads, memory_order_relaxed );
+            m_stages[i]->reset( start, i ? queues[i - 1]->capacity() : 0 );
+        }
+        FirstError errors;
+        // In order, the sink holds batches that overtook an earlier one.
+        // Keeping the reader no more batches ahead of the sink than
+        // the queues and threads between them can hold bounds those,
+        // and the batch the sink waits for is always among them.
+        size_t window = 1;
+        for ( size_t i = 1; i != sink; ++i )
+            window += queues[i - 1]->capacity() + m_stages[i]->threads;
+        window += queues[sink - 1]->capacity();
+        atomic<uint64_t> released{ 0 };    // Batches the sink has written.
+
+        // The last of a stage's threads to finish closes its output.
+        auto finish = [&]( size_t i ) {
+            if ( running[i].fetch_sub( 1, memory_order_acq_rel ) != 1 )
+                return;
+            if ( i != sink )
+                closed[i].store( true, memory_order_release );
+            m_stages[i]->finished_ns.store( now_ns(), memory_order_release );
+        };
+
+        auto read = [&] {
+            Stage &stage = *m_stages[0];
+            try {
+                NdjsonReader reader( input );
+                Batch batch;
+                for ( uint64_t sequence = 0; not errors.any(); ++sequence ) {
+                    int64_t const begin = now_ns();
+                    batch.lines = reader.next_chunk( batch.text, m_options.batch_bytes );
+                    add_relaxed( stage.busy_ns, uint64_t( now_ns() - begin ) );
+                    if ( not batch.lines )
+                        break;
+                    batch.sequence = sequence;
+                    if ( m_options.ordered ) {
+                        unsigned spins = 0;
+                        while ( sequence >= released.load( memory_order_acquire ) + window
+                                && not errors.any() )
+                            back_off( spins );
+                    }
+                    add_relaxed( stage.records_in, batch.lines );
+                    add_relaxed( stage.records_out, batch.lines );
+                    add_relaxed( stage.bytes, batch.text.size() );
+                    if ( not give( *queues[0], batch, errors ) )
+                        break;
+                    batch.text.clear();
+                }
+            } catch ( ... ) {
+                errors.capture();
+            }
+            finish( 0 );
+        };
+
+        auto process = [&]( size_t i, Batch &batch ) {
+            Stage &stage = *m_stages[i];
+            if ( i == parse ) {
+                add_relaxed( stage.records_in, batch.lines );
+                batch.records.reserve( batch.lines );
+                string_view rest( batch.text );
+                while ( not rest.empty() ) {
+                    size_t const end = rest.find( '\n' );
+                    string_view const line = rest.substr( 0, end );
+                    rest.remove_prefix( end == string_view::npos ? rest.size() : end + 1 );
+                    try {
+                        batch.records.push_back(
+                                Json::parse( line, m_options.parse_options ) );
+                    } catch ( Json::ParseError const & ) {
+                        if ( not m_options.skip_invalid )
+                            throw;
+                    }
+                }
+                batch.text.clear();
+            } else if ( i == encode ) {
+                add_relaxed( stage.records_in, batch.records.size() );
+                jsrl_string_outbuf outbuf( batch.text );
+                std::ostream out( &outbuf );
+                for ( auto &&record : batch.records )
+                    out << Json::OptionedWrite( record, m_options.encode_options ) << '\n';
+                batch.lines = batch.records.size();
+                batch.records.clear();
+            } else {
+                add_relaxed( stage.records_in, batch.records.size() );
+                auto const kept = std::remove_if(
+                        batch.records.begin(), batch.records.end(),
+                        [&]( Json &record ) { return not stage.transform( record ); } );
+                batch.records.erase( kept, batch.records.end() );
+            }
+            add_relaxed( stage.records_out,
+                    i == encode ? batch.lines : batch.records.size() );
+        };
+
+        auto work = [&]( size_t i ) {
+            Stage &stage = *m_stages[i];
+            try {
+                Batch batch;
+                while ( stage.take( *queues[i - 1], closed[i - 1], batch, errors ) ) {
+                    int64_t const begin = now_ns();
+                    process( i, batch );
+                    add_relaxed( stage.busy_ns, uint64_t( now_ns() - begin ) );
+                    if ( not give( *queues[i], batch, errors ) )
+                        break;
+                }
+            } catch ( ... ) {
+                errors.capture();
+            }
+            finish( i );
+        };
+
+        uint64_t written = 0;
+        auto write = [&] {
+            Stage &stage = *m_stages[sink];
+            try {
+                // Batches that finished ahead of an earlier one.
+                std::map<uint64_t, Batch> pending;
+                uint64_t next = 0;
+                Batch batch;
+                auto put = [&]( Batch const &ready ) {
+                    int64_t const begin = now_ns();
+                    output.write( ready.text.data(), std::streamsize( ready.text.size() ) );
+                    if ( not output ) {
+                        throw std::system_error( std::make_error_code( std::errc::io_error ),
+                                "Cannot write pipeline output" );
+                    }
+                    written += ready.lines;
+                    add_relaxed( stage.records_in, ready.lines );
+                    add_relaxed( stage.records_out, ready.lines );
+                    add_relaxed( stage.bytes, ready.text.size() );
+                    add_relaxed( stage.busy_ns, uint64_t( now_ns() - begin ) );
+                };
+                while ( stage.take( *queues[sink - 1], closed[sink - 1], batch, errors ) ) {
+                    if ( not m_options.ordered ) {
+                        put( batch );
+                        continue;
+                    }
+                    pending.emplace( batch.sequence, std::move(batch) );
+                    for ( auto first = pending.begin();
+                            first != pending.end() && first->first == next;
+                            first = pending.erase( first ), ++next )
+                        put( first->second );
+                    released.store( next, memory_order_release );
+                }
+            } catch ( ... ) {
+                errors.capture();
+            }
+            finish( sink );
+        };
+
+        vector<std::thread> threads;
+        try {
+            threads.emplace_back( read );
+            for ( size_t i = 1; i != sink; ++i ) {
+                for ( size_t t = 0; t != m_stages[i]->threads; ++t )
+                    threads.emplace_back( work, i );
+            }
+        } catch ( ... ) {
+            errors.capture();
+        }
+        // Without all of its threads, a stage would never close its output;
+        // the failure stops every stage instead.
+        write();
+        for ( auto &&thread : threads )
+            thread.join();
+        errors.rethrow();
+        output.flush();
+        return written;
+    }
+
+    std::vector<StageMetrics> Pipeline::metrics() const
+    {
+        std::vector<StageMetrics> result;
+        int64_t const now = now_ns();
+        for ( auto &&stage : m_stages ) {
+            StageMetrics metrics;
+            metrics.name = stage->name;
+            metrics.threads = stage->threads;
+            int64_t const started = stage->started_ns.load( memory_order_acquire );
+            if ( started ) {
+                int64_t const finished = stage->finished_ns.load( memory_order_acquire );
+                metrics.seconds = double( ( finished < 0 ? now : finished ) - started ) / 1e9;
+            }
+            metrics.records_in = stage->records_in.load( memory_order_relaxed );
+            metrics.records_out = stage->records_out.load( memory_order_relaxed );
+            metrics.bytes = stage->bytes.load( memory_order_relaxed );
+            metrics.busy_seconds = double( stage->busy_ns.load( memory_order_relaxed ) ) / 1e9;
+            metrics.queue_capacity = stage->queue_capacity.load( memory_order_relaxed );
+            metrics.max_queue_depth = stage->max_depth.load( memory_order_relaxed );
+            uint64_t const samples = stage->depth_samples.load( memory_order_relaxed );
+            if ( samples ) {
+                metrics.mean_queue_depth = double( stage->depth_total.load(
+                            memory_order_relaxed ) ) / double( samples );
+            }
+            result.push_back( std::move(metrics) );
+        }
+        return result;
+    }
+
+    uint64_t Pipeline::invalid() const
+    {
+        Stage const &parse = *m_stages[1];
+        return parse.records_in.load( memory_order_relaxed )
+                - parse.records_out.load( memory_order_relaxed );
+    }
+
+}
+// vi: et ts=4 sts=4 sw=4
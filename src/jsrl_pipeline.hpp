@@ -0,0 +1,167 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#ifndef JSRL_PIPELINE_HPP_2F6A9D13E85B4C70A1D2E9F84B3C5A17
+#define JSRL_PIPELINE_HPP_2F6A9D13E85B4C70A1D2E9F84B3C5A17
+
+#include "jsrl.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+/*! @file jsrl_pipeline.hpp
+ *  @brief Multi-threaded NDJSON transformation.
+ */
+namespace jsrl {
+    using std::size_t;
+    using std::streambuf;
+    using std::string;
+    using std::uint64_t;
+
+    /*! @brief  How a @ref Pipeline runs.
+     */
+    struct PipelineOptions {
+        size_t parse_threads = 0;       //!< Parsing threads (0: one per core).
+        size_t encode_threads = 1;      //!< Encoding threads.
+        size_t queue_capacity = 16;     //!< Batches held between two stages.
+        size_t batch_bytes = 64 * 1024; //!< NDJSON bytes per batch.
+        bool ordered = true;            //!< Write records in input order.
+        bool skip_invalid = false;      //!< Count bad records instead of throwing.
+        Json::ParseOptions parse_options = Json::ParseOptions( false );
+        Json::EncodeOptions encode_options = Json::EncodeOptions(
+                Json::EncodeOptions::TN_EXACT, false, false );
+    };
+
+    /*! @brief  What one stage of a @ref Pipeline has done.
+     *
+     *  Taken while the pipeline runs, this shows where it is held up:
+     *  the slowest stage is busy all the time with its input queue full,
+     *  and the stages after it wait on empty queues.
+     */
+    struct StageMetrics {
+        string name;                //!< @c "source", @c "parse", a stage's
+                                    //!< own name, @c "encode" or @c "sink".
+        size_t threads = 0;         //!< Threads running the stage.
+        uint64_t records_in = 0;    //!< Records taken in.
+        uint64_t records_out = 0;   //!< Records passed on.
+        uint64_t bytes = 0;         //!< Bytes read (source) or written (sink).
+        double seconds = 0;         //!< Time since the run started,
+                                    //!< until the stage finished.
+        double busy_seconds = 0;    //!< Time spent working, over all threads.
+        size_t queue_capacity = 0;  //!< Batches its input queue holds.
+        size_t max_queue_depth = 0; //!< Most batches found waiting.
+        double mean_queue_depth = 0;    //!< Batches waiting, on average.
+
+        /*! @brief  Records passed on per second. */
+        double records_per_second() const {
+            return seconds > 0 ? double( records_out ) / seconds : 0;
+        }
+    };
+
+    /*! @brief  Transforms NDJSON records on several threads at once.
+     *
+     *  Records flow from the source through parsing,
+     *  the stages added with @ref stage, @ref map and @ref filter,
+     *  and encoding, to the sink.
+     *  Each stage runs on threads of its own,
+     *  and hands batches of records to the next stage
+     *  through a bounded lock-free queue,
+     *  so memory use stays bounded however large the input,
+     *  and a slow stage holds back the ones before it.
+     *  When ordering is required, batches are written
+     *  in the order they were read, whatever order they finish in;
+     *  reading then stays no further ahead of writing
+     *  than the queues and threads between can hold,
+     *  so one slow batch can't make the rest pile up behind it.
+     *
+     *  Example:
+     *  @code
+     *      Pipeline pipeline;
+     *      pipeline
+     *          .filter( "purchases", []( Json const &r ) {
+     *                  return r["event"] == "purchase"; } )
+     *          .stage( "tag", []( Json &r ) {
+     *                  r.set( "source", "web" );
+     *                  return true; }, 4 );
+     *      pipeline.run( *in.rdbuf(), out );
+     *  @endcode
+     */
+    struct Pipeline {
+        /*! @brief  Changes a record in place;
+         *          returns @c false to drop it.
+         */
+        using Transform = std::function<bool( Json &record )>;
+
+        explicit
+        Pipeline( PipelineOptions const &options = PipelineOptions() );
+        Pipeline( Pipeline const & ) = delete;
+        Pipeline &operator=( Pipeline const & ) = delete;
+        ~Pipeline();
+
+        /*! @brief  Add a stage running @c transform on @c threads threads.
+         *
+         *  With more than one thread, @c transform is called concurrently
+         *  (on different records), so it must be thread-safe.
+         */
+        Pipeline &stage( string name, Transform transform, size_t threads = 1 );
+        /*! @brief  Add a stage replacing each record with @c function's result.
+         */
+        Pipeline &map(
+                string name,
+                std::function<Json( Json const &record )> function,
+                size_t threads = 1
+                );
+        /*! @brief  Add a stage keeping the records @c keep accepts.
+         */
+        Pipeline &filter(
+                string name,
+                std::function<bool( Json const &record )> keep,
+                size_t threads = 1
+                );
+
+        /*! @brief  Read NDJSON from @c input,
+         *          and write what comes out as NDJSON to @c output.
+         *
+         *  The first exception thrown by any stage stops every stage,
+         *  and is thrown from here once they have.
+         *
+         *  @return The number of records written.
+         *  @throw Json::ParseError A record isn't valid JSON
+         *                          (unless @c skip_invalid).
+         */
+        uint64_t run( streambuf &input, std::ostream &output );
+
+        /*! @brief  Metrics for each stage, in order.
+         *
+         *  May be called from another thread while @ref run is going;
+         *  after a run, these describe it in full.
+         */
+        std::vector<StageMetrics> metrics() const;
+        /*! @brief  Records that weren't valid JSON, when skipped. */
+        uint64_t invalid() const;
+
+    private:
+        struct Stage;
+
+        PipelineOptions const m_options;
+        // Source, parse, the added stages, encode and sink.
+        std::vector<std::unique_ptr<Stage>> m_stages;
+    };
+
+}
+#endif
+// vi: et ts=4 sts=4 sw=4
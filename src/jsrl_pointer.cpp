@@ -0,0 +1,92 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#include "jsrl_pointer.hpp"
+
+#include <limits>
+
+namespace jsrl {
+
+    JsonPointer::JsonPointer( string_view text )
+    {
+        if ( text.empty() )
+            return;
+        if ( text[0] != '/' )
+            throw JsonPointerError( "JSON Pointer must start with '/'" );
+        string token;
+        for ( size_t i = 1; i <= text.size(); ++i ) {
+            if ( i == text.size() || text[i] == '/' ) {
+                m_tokens.push_back( std::move(token) );
+                token.clear();
+            } else if ( text[i] == '~' ) {
+                if ( i + 1 == text.size()
+                        || ( text[i + 1] != '0' && text[i + 1] != '1' ) )
+                    throw JsonPointerError( "Bad escape in JSON Pointer" );
+                token.push_back( text[++i] == '0' ? '~' : '/' );
+            } else {
+                token.push_back( text[i] );
+            }
+        }
+    }
+
+    string JsonPointer::to_string() const
+    {
+        string result;
+        for ( auto &&token : m_tokens ) {
+            result.push_back( '/' );
+            for ( char c : token ) {
+                if ( c == '~' )
+                    result += "~0";
+                else if ( c == '/' )
+                    result += "~1";
+                else
+                    result.push_back( c );
+            }
+        }
+        return result;
+    }
+
+    Json const *JsonPointer::find( Json const &root ) const
+    {
+        Json const *value = &root;
+        for ( auto &&token : m_tokens ) {
+            if ( value->is_object() ) {
+                value = value->find_key( string_view( token ) );
+            } else if ( value->is_array() ) {
+                size_t const index = s_index( token );
+                value = index == npos ? nullptr : value->find_key( index );
+            } else {
+                value = nullptr;
+            }
+            if ( not value )
+                return nullptr;
+        }
+        return value;
+    }
+
+    size_t JsonPointer::s_index( string_view token )
+    {
+        if ( token.empty() || ( token[0] == '0' && token.size() != 1 ) )
+            return npos;
+        size_t index = 0;
+        for ( char c : token ) {
+            if ( c < '0' || c > '9' )
+                return npos;
+            size_t const digit = size_t( c - '0' );
+            if ( index > ( std::numeric_limits<size_t>::max() - 1 - digit ) / 10 )
+                return npos;
+            index = index * 10 + digit;
+        }
+        return index;
+    }
+
+}
+// vi: et ts=4 sts=4 sw=4
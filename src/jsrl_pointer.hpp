@@ -0,0 +1,90 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#ifndef JSRL_POINTER_HPP_7F3B1E08D94C26A5B0E1C73D8A2F5946
+#define JSRL_POINTER_HPP_7F3B1E08D94C26A5B0E1C73D8A2F5946
+
+#include "jsrl.hpp"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*! @file jsrl_pointer.hpp
+ *  @brief JSON Pointers (RFC 6901).
+ */
+namespace jsrl {
+    using std::size_t;
+    using std::string;
+    using std::string_view;
+
+    /*! @brief  Error thrown for text that isn't a JSON Pointer.
+     */
+    struct JsonPointerError : Json::Error {
+        explicit JsonPointerError( string const &msg ) : Error( msg ) { }
+    protected:
+        char const *v_failtag() const override { return "JSON Pointer Error"; }
+    };
+
+    /*! @brief  Parsed JSON Pointer: the keys leading to a value.
+     *
+     *  Reference tokens are kept unescaped,
+     *  so they can be compared with object keys directly.
+     */
+    struct JsonPointer {
+        /*! @brief  The pointer to the whole document. */
+        JsonPointer() = default;
+        /*! @brief  Parse pointer text, such as @c "/a/0/b~1c".
+         *
+         *  @throw JsonPointerError Not empty and not starting with @c '/',
+         *                          or a @c '~' not followed by @c 0 or @c 1.
+         */
+        explicit
+        JsonPointer( string_view text );
+        /*! @brief  Pointer from unescaped reference tokens. */
+        explicit
+        JsonPointer( std::vector<string> tokens )
+            : m_tokens( std::move(tokens) )
+        { }
+
+        std::vector<string> const &tokens() const { return m_tokens; }
+        bool empty() const { return m_tokens.empty(); }
+
+        /*! @brief  The pointer text, with tokens escaped. */
+        string to_string() const;
+
+        /*! @brief  The value pointed to within @c root, or null if none.
+         */
+        Json const *find( Json const &root ) const;
+
+        /*! @brief  A token as an array index.
+         *
+         *  @return The index, or @c npos if the token isn't
+         *          a decimal number without leading zeros.
+         */
+        static size_t s_index( string_view token );
+        static constexpr size_t npos = size_t( -1 );
+
+        friend bool operator==( JsonPointer const &lhs, JsonPointer const &rhs ) {
+            return lhs.m_tokens == rhs.m_tokens;
+        }
+        friend bool operator!=( JsonPointer const &lhs, JsonPointer const &rhs ) {
+            return lhs.m_tokens != rhs.m_tokens;
+        }
+
+    private:
+        std::vector<string> m_tokens;
+    };
+
+}
+#endif
+// vi: et ts=4 sts=4 sw=4
@@ -0,0 +1,244 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#include "jsrl_predicate.hpp"
+#include "jsrl_impl_util.hpp"
+
+#include <algorithm>
+
+namespace jsrl {
+
+    namespace {
+        bool value_less( Json const &lhs, Json const &rhs ) {
+            return json_value_compare( lhs, rhs ) < 0;
+        }
+
+        bool is_ordered( Json const &value ) {
+            return value.is_number() || value.is_string();
+        }
+
+        bool same_kind( Json const &lhs, Json const &rhs ) {
+            return lhs.get_typetag( false ) == rhs.get_typetag( false );
+        }
+    }
+
+    FieldPredicate FieldPredicate::s_exists( JsonPointer path )
+    {
+        return FieldPredicate( FP_EXISTS, std::move(path) );
+    }
+
+    FieldPredicate FieldPredicate::s_equals( JsonPointer path, Json value )
+    {
+        FieldPredicate predicate( FP_EQUALS, std::move(path) );
+        predicate.m_values.push_back( std::move(value) );
+        return predicate;
+    }
+
+    FieldPredicate FieldPredicate::s_in_set( JsonPointer path, std::vector<Json> values )
+    {
+        FieldPredicate predicate( FP_IN_SET, std::move(path) );
+        predicate.m_values = std::move(values);
+        std::sort( predicate.m_values.begin(), predicate.m_values.end(), value_less );
+        return predicate;
+    }
+
+    FieldPredicate FieldPredicate::s_range( JsonPointer path, Json lower, Json upper )
+    {
+        if ( not ( lower.is_null() || is_ordered( lower ) )
+                || not ( upper.is_null() || is_ordered( upper ) )
+                || ( not lower.is_null() && not upper.is_null()
+                    && not same_kind( lower, upper ) ) )
+            throw PredicateError( "Range bounds must be numbers or strings alike" );
+        FieldPredicate predicate( FP_RANGE, std::move(path) );
+        predicate.m_values.push_back( std::move(lower) );
+        predicate.m_values.push_back( std::move(upper) );
+        return predicate;
+    }
+
+    bool FieldPredicate::test( Json const &value ) const
+    {
+        switch ( m_kind ) {
+        case FP_EXISTS:
+            return true;
+        case FP_EQUALS:
+            return json_value_compare( value, m_values[0] ) == 0;
+        case FP_IN_SET:
+            return std::binary_search( m_values.begin(), m_values.end(),
+                    value, value_less );
+        case FP_RANGE: {
+            Json const &lower = m_values[0];
+            Json const &upper = m_values[1];
+            Json const &bound = lower.is_null() ? upper : lower;
+            if ( not is_ordered( value )
+                    || ( not bound.is_null() && not same_kind( value, bound ) ) )
+                return false;
+            return ( lower.is_null() || json_value_compare( lower, value ) <= 0 )
+                    && ( upper.is_null() || json_value_compare( value, upper ) <= 0 );
+        }
+        }
+        return false;
+    }
+
+    RecordScanner::RecordScanner(
+            std::vector<FieldPredicate> predicates,
+            std::vector<JsonPointer> fields,
+            bool validate_rest,
+            Json::ParseOptions parse_options
+            )
+        : m_predicates( std::move(predicates) )
+        , m_fields( fields.size() )
+        , m_validate_rest( validate_rest )
+        , m_parse_options( parse_options )
+        , m_nodes( 1 )
+    {
+        struct Wanted {
+            std::vector<string> const *tokens;
+            bool field;
+            size_t index;
+        };
+        std::vector<Wanted> wanted;
+        for ( size_t i = 0; i != m_predicates.size(); ++i )
+            wanted.push_back( Wanted{ &m_predicates[i].path().tokens(), false, i } );
+        for ( size_t i = 0; i != fields.size(); ++i )
+            wanted.push_back( Wanted{ &fields[i].tokens(), true, i } );
+        // Shorter paths first: a value that is read whole
+        // answers every path below it too.
+        std::stable_sort( wanted.begin(), wanted.end(),
+                []( Wanted const &lhs, Wanted const &rhs ) {
+                    return lhs.tokens->size() < rhs.tokens->size();
+                } );
+        for ( auto &&want : wanted ) {
+            auto const &tokens = *want.tokens;
+            size_t node = 0;
+            size_t depth = 0;
+            for ( ; depth != tokens.size() && m_nodes[node].targets.empty(); ++depth ) {
+                auto const found = m_nodes[node].children.find( tokens[depth] );
+                if ( found != m_nodes[node].children.end() ) {
+                    node = found->second;
+                } else {
+                    size_t const child = m_nodes.size();
+                    m_nodes[node].children.emplace( tokens[depth], child );
+                    m_nodes.emplace_back();
+                    node = child;
+                }
+            }
+            m_nodes[node].targets.push_back( Target{ want.field, want.index,
+                    JsonPointer( std::vector<string>(
+                                tokens.begin() + depth, tokens.end() ) ) } );
+        }
+    }
+
+    auto RecordScanner::p_resolve( size_t node, Json const &value ) -> Step
+    {
+        for ( auto &&target : m_nodes[node].targets ) {
+            size_t const slot = target.field
+                    ? m_predicates.size() + target.index
+                    : target.index
+                    ;
+            if ( m_resolved[slot] )
+                continue;
+            Json const *const at = target.rest.find( value );
+            if ( not at )
+                continue;
+            if ( target.field ) {
+                if ( m_out )
+                    ( *m_out )[ target.index ] = *at;
+            } else if ( not m_predicates[ target.index ].test( *at ) ) {
+                return ST_REJECT;
+            }
+            m_resolved[slot] = true;
+            --m_pending;
+        }
+        return m_pending == 0 && not m_validate_rest ? ST_DONE : ST_CONTINUE;
+    }
+
+    auto RecordScanner::p_walk( JsonReader &reader, size_t node ) -> Step
+    {
+        Node const &here = m_nodes[node];
+        if ( not here.targets.empty() )
+            return p_resolve( node, reader.read_value() );
+        if ( here.children.empty() ) {
+            reader.skip_value();
+            return ST_CONTINUE;
+        }
+        string key;
+        switch ( reader.peek() ) {
+        case JsonReader::TK_OBJECT:
+            reader.enter_object();
+            while ( reader.next_key( key ) ) {
+                auto const found = here.children.find( key );
+                if ( found == here.children.end() ) {
+                    reader.skip_value();
+                    continue;
+                }
+                Step const step = p_walk( reader, found->second );
+                if ( step != ST_CONTINUE )
+                    return step;
+            }
+            return ST_CONTINUE;
+        case JsonReader::TK_ARRAY:
+            reader.enter_array();
+            for ( size_t i = 0; reader.next_element(); ++i ) {
+                key = std::to_string( i );
+                auto const found = here.children.find( key );
+                if ( found == here.children.end() ) {
+                    reader.skip_value();
+                    continue;
+                }
+                Step const step = p_walk( reader, found->second );
+                if ( step != ST_CONTINUE )
+                    return step;
+            }
+            return ST_CONTINUE;
+        default:
+            reader.skip_value();
+            return ST_CONTINUE;
+        }
+    }
+
+    bool RecordScanner::match( string_view record, std::vector<Json> *fields )
+    {
+        ++m_scanned;
+        m_out = fields;
+        if ( fields )
+            fields->assign( m_fields, Json() );
+        m_pending = m_predicates.size() + m_fields;
+        m_resolved.assign( m_pending, false );
+        JsonReader reader( record, m_parse_options );
+        Step const step = p_walk( reader, 0 );
+        if ( step == ST_REJECT )
+            return false;
+        if ( step == ST_CONTINUE )
+            reader.finish();
+        // A predicate whose path never turned up fails.
+        for ( size_t i = 0; i != m_predicates.size(); ++i ) {
+            if ( not m_resolved[i] )
+                return false;
+        }
+        ++m_matched;
+        return true;
+    }
+
+    bool RecordScanner::next(
+            NdjsonReader &records,
+            string_view &record,
+            std::vector<Json> *fields
+            )
+    {
+        while ( records.next( record ) ) {
+            if ( match( record, fields ) )
+                return true;
+        }
+        return false;
+    }
+
+}
+// vi: et ts=4 sts=4 sw=4
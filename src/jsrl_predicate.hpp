@@ -0,0 +1,185 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#ifndef JSRL_PREDICATE_HPP_62D0F4B9A17E3C58D2B6E91F04A7C35D
+#define JSRL_PREDICATE_HPP_62D0F4B9A17E3C58D2B6E91F04A7C35D
+
+#include "jsrl.hpp"
+#include "jsrl_ndjson.hpp"
+#include "jsrl_pointer.hpp"
+#include "jsrl_reader.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*! @file jsrl_predicate.hpp
+ *  @brief Filtering records by their fields while they are read.
+ */
+namespace jsrl {
+    using std::size_t;
+    using std::string;
+    using std::string_view;
+    using std::uint64_t;
+
+    /*! @brief  Error thrown for a predicate that can't be built.
+     */
+    struct PredicateError : Json::Error {
+        explicit PredicateError( string const &msg ) : Error( msg ) { }
+    protected:
+        char const *v_failtag() const override { return "Predicate Error"; }
+    };
+
+    /*! @brief  Test on the value at one path of a record.
+     *
+     *  Values are compared as by the schema validator:
+     *  numbers of equal value are equal, whatever their representation.
+     *  Every kind of predicate fails when the path is missing.
+     */
+    struct FieldPredicate {
+        enum Kind {
+            FP_EXISTS,
+            FP_EQUALS,
+            FP_IN_SET,
+            FP_RANGE,
+        };
+
+        /*! @brief  The path is present. */
+        static
+        FieldPredicate s_exists( JsonPointer path );
+        /*! @brief  The value equals @c value. */
+        static
+        FieldPredicate s_equals( JsonPointer path, Json value );
+        /*! @brief  The value equals one of @c values. */
+        static
+        FieldPredicate s_in_set( JsonPointer path, std::vector<Json> values );
+        /*! @brief  The value is within @c lower and @c upper (inclusive),
+         *          and of the same type: number or string.
+         *
+         *  A null bound is open.
+         *
+         *  @throw PredicateError   A bound isn't a number or string,
+         *                          or the bounds differ in type.
+         */
+        static
+        FieldPredicate s_range( JsonPointer path, Json lower, Json upper );
+
+        Kind kind() const { return m_kind; }
+        JsonPointer const &path() const { return m_path; }
+
+        /*! @brief  Whether a value present at the path passes. */
+        bool test( Json const &value ) const;
+
+    private:
+        FieldPredicate( Kind kind, JsonPointer path )
+            : m_kind( kind )
+            , m_path( std::move(path) )
+        { }
+
+        Kind m_kind;
+        JsonPointer m_path;
+        std::vector<Json> m_values;     // Sorted; the range's bounds.
+    };
+
+    /*! @brief  Compiled predicates and wanted fields, matched against
+     *          records as they are tokenized.
+     *
+     *  The paths are compiled into a tree,
+     *  so each record is read once with a @ref JsonReader:
+     *  members off every path are skipped without being decoded,
+     *  and only values at the paths themselves are parsed.
+     *  A record is given up as soon as a predicate fails.
+     *  With @c validate_rest off, reading also stops once every predicate
+     *  has passed and every wanted field has been found,
+     *  so the rest of the record is not checked for errors.
+     *
+     *  Example:
+     *  @code
+     *      RecordScanner scanner(
+     *              { FieldPredicate::s_equals( JsonPointer( "/event" ), "purchase" ),
+     *                FieldPredicate::s_range( JsonPointer( "/amount" ), 100, Json() ) },
+     *              { JsonPointer( "/user" ), JsonPointer( "/amount" ) } );
+     *      NdjsonReader records( *feed.rdbuf() );
+     *      string_view record;
+     *      std::vector<Json> fields;
+     *      while ( scanner.next( records, record, &fields ) )
+     *          total[ fields[0] ] += fields[1].as_number_float();
+     *  @endcode
+     */
+    struct RecordScanner {
+        /*! @brief  Compile predicates and wanted fields;
+         *          @c parse_options apply to the values read.
+         */
+        explicit
+        RecordScanner(
+                std::vector<FieldPredicate> predicates,
+                std::vector<JsonPointer> fields = {},
+                bool validate_rest = true,
+                Json::ParseOptions parse_options = Json::ParseOptions(false)
+                );
+
+        /*! @brief  Whether a record passes every predicate.
+         *
+         *  @param fields   If not null, receives the wanted fields' values
+         *                  in order (null for missing ones) when the record
+         *                  passes.
+         *  @throw Json::ParseError Invalid JSON was read before
+         *                          the record was decided.
+         */
+        bool match( string_view record, std::vector<Json> *fields = nullptr );
+
+        /*! @brief  Read records up to the next one that passes.
+         *
+         *  @retval false   The input has ended.
+         */
+        bool next(
+                NdjsonReader &records,
+                string_view &record,
+                std::vector<Json> *fields = nullptr
+                );
+
+        uint64_t scanned() const { return m_scanned; }      //!< Records tested.
+        uint64_t matched() const { return m_matched; }      //!< Records passed.
+
+    private:
+        struct Target {
+            bool field;             // A wanted field, else a predicate.
+            size_t index;
+            JsonPointer rest;       // Path below the node that reads it.
+        };
+        struct Node {
+            std::map<string, size_t, std::less<>> children;
+            std::vector<Target> targets;    // Resolved from the node's value.
+        };
+        enum Step { ST_CONTINUE, ST_REJECT, ST_DONE };
+
+        Step p_walk( JsonReader &reader, size_t node );
+        Step p_resolve( size_t node, Json const &value );
+
+        std::vector<FieldPredicate> const m_predicates;
+        size_t const m_fields;
+        bool const m_validate_rest;
+        Json::ParseOptions const m_parse_options;
+        std::vector<Node> m_nodes;
+        // Per record:
+        std::vector<Json> *m_out = nullptr;
+        size_t m_pending = 0;
+        std::vector<bool> m_resolved;
+        uint64_t m_scanned = 0;
+        uint64_t m_matched = 0;
+    };
+
+}
+#endif
+// vi: et ts=4 sts=4 sw=4
@@ -0,0 +1,686 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#include "jsrl_profile.hpp"
+#include "jsrl_impl_util.hpp"
+#include "jsrl_ndjson.hpp"
+#include "jsrl_queue.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+namespace jsrl {
+    using std::make_unique;
+    using std::memory_order_acquire;
+    using std::memory_order_release;
+    using std::pair;
+    using std::string_view;
+    using std::unique_ptr;
+    using std::unordered_map;
+    using std::vector;
+
+    namespace {
+
+        enum Kind {
+            K_NULL,
+            K_BOOL,
+            K_INTEGER,
+            K_NUMBER,
+            K_STRING,
+            K_ARRAY,
+            K_OBJECT,
+            K_COUNT
+        };
+
+        // Values tracked per path: more than are reported,
+        // so that the reported ones are likely to be the true top values.
+        size_t top_capacity( ProfileOptions const &options ) {
+            return std::max<size_t>( 4 * options.top_k, 16 );
+        }
+
+        unsigned hll_precision( ProfileOptions const &options ) {
+            return std::min( 16u, std::max( 4u, options.hll_precision ) );
+        }
+
+        size_t thread_count( ProfileOptions const &options ) {
+            if ( options.threads )
+                return options.threads;
+            return std::max( 1u, std::thread::hardware_concurrency() );
+        }
+
+        string escape_segment( string const &segment ) {
+            string result;
+            for ( char c : segment ) {
+                if ( c == '~' )
+                    result += "~0";
+                else if ( c == '/' )
+                    result += "~1";
+                else
+                    result.push_back( c );
+            }
+            return result;
+        }
+
+    }
+
+    struct Profiler::Node {
+        uint64_t kinds[K_COUNT] = {};
+        bool has_number = false;
+        Json minimum;
+        Json maximum;
+        long double min_float = 0;  // Values of minimum and maximum,
+        long double max_float = 0;  // to rule out most candidates cheaply.
+        size_t min_length = std::numeric_limits<size_t>::max();
+        size_t max_length = 0;
+        vector<unsigned char> registers;    // HyperLogLog; empty until used.
+        unordered_map<string, uint64_t> top;   // Counts by key_value key.
+        unordered_map<string, unique_ptr<Node>> members;
+        unique_ptr<Node> items;
+
+        uint64_t count() const {
+            uint64_t total = 0;
+            for ( uint64_t n : kinds )
+                total += n;
+            return total;
+        }
+    };
+
+    namespace {
+        using Node = Profiler::Node;
+
+        /*  Scalars are keyed by a type letter and their text:
+         *  "z" for null, "t" and "f", "n" and a number's canonical text
+         *  (see append_number_key), "s" and a string's (decoded) bytes.
+         */
+        Json key_value( string const &key ) {
+            switch ( key[0] ) {
+            case 't': return Json( true );
+            case 'f': return Json( false );
+            case 'n': return Json::parse( string_view( key ).substr( 1 ) );
+            case 's': return Json( key.substr( 1 ), Json::ignore_bad_unicode );
+            default: return Json();
+            }
+        }
+
+        template<typename N>
+        void append_chars( string &key, N value ) {
+            char buffer[64];
+            auto const end = std::to_chars( buffer, buffer + sizeof buffer,
+                    value ).ptr;
+            key.append( buffer, end );
+        }
+
+        /*  Append a number's canonical text, the same for equal numbers
+         *  however they were written or read (1e2 and 100, 1.50 and 1.5):
+         *  integral values as integers, others as the shortest text that
+         *  reads back as the same long double.
+         *  Values too large for a long double all read as infinite,
+         *  so they share one key each way.
+         */
+        void append_number_key( string &key, long double value ) {
+            if ( not std::isfinite( value ) ) {
+                key += value < 0 ? "-1e9999" : "1e9999";
+            } else if ( value == std::trunc( value )
+                    && value >= -0x1p63L && value < 0x1p64L ) {
+                if ( value < 0 )
+                    append_chars( key, static_cast<long long>( value ) );
+                else
+                    append_chars( key, static_cast<long long unsigned>( value ) );
+            } else {
+                append_chars( key, value );
+            }
+        }
+
+        void append_number_key( string &key, Json const &number ) {
+            if ( number.is_number_sint() )
+                append_chars( key, number.as_number_sint() );
+            else if ( number.is_number_uint() )
+                append_chars( key, number.as_number_uint() );
+            else
+                append_number_key( key, number.as_number_float() );
+        }
+
+        struct Walker {
+            explicit Walker( ProfileOptions const &options )
+                : options( options )
+                , capacity( top_capacity( options ) )
+                , precision( hll_precision( options ) )
+            { }
+
+            ProfileOptions const &options;
+            size_t const capacity;
+            unsigned const precision;
+            string key;         // Scratch for scalar keys.
+            string text;        // Scratch for number text.
+
+            // Count one occurrence in the Space-Saving table.
+            void add_top( Node &node, string const &k, uint64_t count ) const {
+                auto const found = node.top.find( k );
+                if ( found != node.top.end() ) {
+                    found->second += count;
+                    return;
+                }
+                if ( node.top.size() < capacity ) {
+                    node.top.emplace( k, count );
+                    return;
+                }
+                // Replace the least frequent value, inheriting its count.
+                auto least = node.top.begin();
+                for ( auto it = node.top.begin(); it != node.top.end(); ++it ) {
+                    if ( it->second < least->second )
+                        least = it;
+                }
+                uint64_t const floor = least->second;
+                node.top.erase( least );
+                node.top.emplace( k, floor + count );
+            }
+
+            void add_scalar( Node &node, Kind kind ) {
+                ++node.kinds[kind];
+                hll_add( node.registers, precision, hash_bytes( key ) );
+                if ( key.size() <= options.max_value_bytes + 1 )
+                    add_top( node, key, 1 );
+            }
+
+            template<typename MAKE>
+            void add_number( Node &node, long double value, MAKE &&make ) {
+                if ( not node.has_number ) {
+                    node.has_number = true;
+                    node.minimum = node.maximum = make();
+                    node.min_float = node.max_float = value;
+                    return;
+                }
+                if ( value <= node.min_float ) {
+                    Json const number = make();
+                    if ( number < node.minimum ) {
+                        node.minimum = number;
+                        node.min_float = value;
+                    }
+                }
+                if ( value >= node.max_float ) {
+                    Json const number = make();
+                    if ( number > node.maximum ) {
+                        node.maximum = number;
+                        node.max_float = value;
+                    }
+                }
+            }
+
+            void add_length( Node &node, size_t length ) const {
+                node.min_length = std::min( node.min_length, length );
+                node.max_length = std::max( node.max_length, length );
+            }
+
+            static Node &member( Node &node, string const &name ) {
+                auto &child = node.members[name];
+                if ( not child )
+                    child = make_unique<Node>();
+                return *child;
+            }
+
+            static Node &items( Node &node ) {
+                if ( not node.items )
+                    node.items = make_unique<Node>();
+                return *node.items;
+            }
+
+            void add( Node &node, Json const &value, size_t depth ) {
+                switch ( value.get_typetag( false ) ) {
+                case Json::TT_NULL:
+                    key = "z";
+                    add_scalar( node, K_NULL );
+                    break;
+                case Json::TT_BOOL:
+                    key = value.as_bool() ? "t" : "f";
+                    add_scalar( node, K_BOOL );
+                    break;
+                case Json::TT_STRING:
+                    key = "s";
+                    key += value.as_string();
+                    add_length( node, value.as_string().size() );
+                    add_scalar( node, K_STRING );
+                    break;
+                case Json::TT_ARRAY:
+                    ++node.kinds[K_ARRAY];
+                    if ( depth < options.max_depth ) {
+                        for ( auto &&element : value.as_array() )
+                            add( items( node ), element, depth + 1 );
+                    }
+                    break;
+                case Json::TT_OBJECT:
+                    ++node.kinds[K_OBJECT];
+                    if ( depth < options.max_depth ) {
+                        for ( auto &&m : value.as_object() )
+                            add( member( node, m.first ), m.second, depth + 1 );
+                    }
+                    break;
+                default:
+                    key = "n";
+                    append_number_key( key, value );
+                    add_number( node, value.as_number_float(),
+                            [&] { return value; } );
+                    add_scalar( node,
+                            value.is_number_integer() ? K_INTEGER : K_NUMBER );
+                    break;
+                }
+            }
+
+            void add( Node &node, JsonReader &reader, size_t depth ) {
+                switch ( reader.peek() ) {
+                case JsonReader::TK_NULL:
+                    reader.read_null();
+                    key = "z";
+                    add_scalar( node, K_NULL );
+                    break;
+                case JsonReader::TK_BOOL:
+                    key = reader.read_bool() ? "t" : "f";
+                    add_scalar( node, K_BOOL );
+                    break;
+                case JsonReader::TK_STRING:
+                    reader.read_string( text );
+                    key = "s";
+                    key += text;
+                    add_length( node, text.size() );
+                    add_scalar( node, K_STRING );
+                    break;
+                case JsonReader::TK_NUMBER: {
+                    Json::TypeTag const tag = reader.read_number_text( text );
+                    long double const value = std::strtold( text.c_str(), nullptr );
+                    key = "n";
+                    if ( tag == Json::TT_NUMBER )
+                        append_number_key( key, value );
+                    else
+                        key += text == "-0" ? "0" : text;   // Already canonical.
+                    add_number( node, value,
+                            [&] { return Json::parse( text ); } );
+                    add_scalar( node,
+                            tag == Json::TT_NUMBER ? K_NUMBER : K_INTEGER );
+                    break;
+                }
+                case JsonReader::TK_ARRAY:
+                    ++node.kinds[K_ARRAY];
+                    if ( depth >= options.max_depth ) {
+                        reader.skip_value();
+                        break;
+                    }
+                    reader.enter_array();
+                    while ( reader.next_element() )
+                        add( items( node ), reader, depth + 1 );
+                    break;
+                case JsonReader::TK_OBJECT: {
+                    ++node.kinds[K_OBJECT];
+                    if ( depth >= options.max_depth ) {
+                        reader.skip_value();
+                        break;
+                    }
+                    reader.enter_object();
+                    string name;
+                    while ( reader.next_key( name ) )
+                        add( member( node, name ), reader, depth + 1 );
+                    break;
+                }
+                }
+            }
+
+            void merge( Node &into, Node const &from ) {
+                for ( size_t i = 0; i != K_COUNT; ++i )
+                    into.kinds[i] += from.kinds[i];
+                if ( from.has_number ) {
+                    add_number( into, from.min_float,
+                            [&] { return from.minimum; } );
+                    add_number( into, from.max_float,
+                            [&] { return from.maximum; } );
+                }
+                if ( from.max_length >= from.min_length ) {
+                    add_length( into, from.min_length );
+                    add_length( into, from.max_length );
+                }
+                if ( not from.registers.empty() ) {
+                    if ( into.registers.empty() ) {
+                        into.registers = from.registers;
+                    } else {
+                        for ( size_t i = 0; i != into.registers.size(); ++i ) {
+                            into.registers[i] = std::max( into.registers[i],
+                                    from.registers[i] );
+                        }
+                    }
+                }
+                merge_top( into, from );
+                for ( auto &&m : from.members )
+                    merge( member( into, m.first ), *m.second );
+                if ( from.items )
+                    merge( items( into ), *from.items );
+            }
+
+            // Sum the tables, then keep the most frequent values.
+            void merge_top( Node &into, Node const &from ) const {
+                for ( auto &&entry : from.top )
+                    into.top[entry.first] += entry.second;
+                if ( into.top.size() <= capacity )
+                    return;
+                vector<pair<uint64_t, string const *>> ranked;
+                for ( auto &&entry : into.top )
+                    ranked.emplace_back( entry.second, &entry.first );
+                std::nth_element( ranked.begin(), ranked.begin() + capacity,
+                        ranked.end(), []( auto const &a, auto const &b ) {
+                            return a.first > b.first;
+                        } );
+                vector<string> evicted;
+                for ( auto it = ranked.begin() + capacity; it != ranked.end(); ++it )
+                    evicted.push_back( *it->second );
+                for ( auto &&name : evicted )
+                    into.top.erase( name );
+            }
+        };
+
+        void collect(
+                Node const &node,
+                string const &path,
+                uint64_t parent_objects,
+                size_t top_k,
+                vector<FieldProfile> &fields
+                ) {
+            FieldProfile field;
+            field.path = path;
+            field.count = node.count();
+            field.presence = parent_objects
+                    ? double( field.count ) / double( parent_objects )
+                    : 1.0
+                    ;
+            field.nulls = node.kinds[K_NULL];
+            field.booleans = node.kinds[K_BOOL];
+            field.integers = node.kinds[K_INTEGER];
+            field.numbers = node.kinds[K_NUMBER];
+            field.strings = node.kinds[K_STRING];
+            field.arrays = node.kinds[K_ARRAY];
+            field.objects = node.kinds[K_OBJECT];
+            if ( node.has_number ) {
+                field.minimum = node.minimum;
+                field.maximum = node.maximum;
+            }
+            if ( node.max_length >= node.min_length ) {
+                field.min_length = node.min_length;
+                field.max_length = node.max_length;
+            }
+            field.distinct = hll_estimate( node.registers );
+            vector<pair<string const *, uint64_t>> ranked;
+            for ( auto &&entry : node.top )
+                ranked.emplace_back( &entry.first, entry.second );
+            std::sort( ranked.begin(), ranked.end(),
+                    []( auto const &a, auto const &b ) {
+                        return a.second != b.second
+                                ? a.second > b.second
+                                : *a.first < *b.first
+                                ;
+                    } );
+            if ( ranked.size() > top_k )
+                ranked.resize( top_k );
+            for ( auto &&entry : ranked )
+                field.top_values.emplace_back( key_value( *entry.first ), entry.second );
+            fields.push_back( std::move(field) );
+
+            vector<pair<string, Node const *>> children;
+            for ( auto &&m : node.members )
+                children.emplace_back( m.first, m.second.get() );
+            if ( node.items )
+                children.emplace_back( "*", node.items.get() );
+            std::sort( children.begin(), children.end() );
+            for ( auto &&child : children ) {
+                bool const element = child.second == node.items.get();
+                collect( *child.second,
+                        path + "/" + ( element ? child.first
+                            : escape_segment( child.first ) ),
+                        element ? 0 : node.kinds[K_OBJECT], top_k, fields );
+            }
+        }
+
+        Json infer( Node const &node ) {
+            Json::ArrayBody types;
+            if ( node.kinds[K_NULL] )
+                types.push_back( "null" );
+            if ( node.kinds[K_BOOL] )
+                types.push_back( "boolean" );
+            if ( node.kinds[K_NUMBER] )
+                types.push_back( "number" );
+            else if ( node.kinds[K_INTEGER] )
+                types.push_back( "integer" );
+            if ( node.kinds[K_STRING] )
+                types.push_back( "string" );
+            if ( node.kinds[K_ARRAY] )
+                types.push_back( "array" );
+            if ( node.kinds[K_OBJECT] )
+                types.push_back( "object" );
+            if ( types.empty() )
+                return Json( true );
+            Json::ObjectBody schema;
+            schema.emplace_back( "type",
+                    types.size() == 1 ? types.front() : Json( types ) );
+            if ( node.kinds[K_OBJECT] && not node.members.empty() ) {
+                Json::ObjectBody properties;
+                Json::ArrayBody required;
+                for ( auto &&m : node.members ) {
+                    properties.emplace_back( m.first, infer( *m.second ) );
+                    if ( m.second->count() >= node.kinds[K_OBJECT] )
+                        required.push_back( m.first );
+                }
+                schema.emplace_back( "properties", Json( properties ) );
+                if ( not required.empty() ) {
+                    std::sort( required.begin(), required.end() );
+                    schema.emplace_back( "required", Json( required ) );
+                }
+            }
+            if ( node.kinds[K_ARRAY] && node.items )
+                schema.emplace_back( "items", infer( *node.items ) );
+            return Json( schema );
+        }
+
+    }
+
+    Profiler::Profiler( ProfileOptions const &options )
+        : m_options( options )
+        , m_root( make_unique<Node>() )
+    { }
+
+    Profiler::Profiler( Profiler && ) noexcept = default;
+    Profiler &Profiler::operator=( Profiler && ) noexcept = default;
+    Profiler::~Profiler() = default;
+
+    void Profiler::add( Json const &record )
+    {
+        Walker walker( m_options );
+        walker.add( *m_root, record, 0 );
+        ++m_records;
+    }
+
+    void Profiler::add( JsonReader &reader )
+    {
+        Walker walker( m_options );
+        walker.add( *m_root, reader, 0 );
+        ++m_records;
+    }
+
+    void Profiler::add_invalid()
+    {
+        ++m_invalid;
+    }
+
+    void Profiler::merge( Profiler const &other )
+    {
+        Walker walker( m_options );
+        walker.merge( *m_root, *other.m_root );
+        m_records += other.m_records;
+        m_invalid += other.m_invalid;
+    }
+
+    uint64_t Profiler::records() const
+    {
+        return m_records;
+    }
+
+    uint64_t Profiler::invalid() const
+    {
+        return m_invalid;
+    }
+
+    std::vector<FieldProfile> Profiler::fields() const
+    {
+        vector<FieldProfile> result;
+        if ( m_root->count() )
+            collect( *m_root, string(), 0, m_options.top_k, result );
+        return result;
+    }
+
+    Json Profiler::infer_schema() const
+    {
+        return infer( *m_root );
+    }
+
+    namespace {
+
+        // Profile each line of a chunk.
+        void profile_chunk(
+                Profiler &profiler,
+                string const &chunk,
+                ProfileOptions const &options
+                ) {
+            string_view rest( chunk );
+            while ( not rest.empty() ) {
+                size_t const end = rest.find( '\n' );
+                string_view const line = rest.substr( 0, end );
+                rest.remove_prefix( end == string_view::npos ? rest.size() : end + 1 );
+                try {
+                    JsonReader reader( line );
+                    profiler.add( reader );
+                    reader.finish();
+                } catch ( Json::ParseError const & ) {
+                    if ( not options.skip_invalid )
+                        throw;
+                    profiler.add_invalid();
+                }
+            }
+        }
+
+        Profiler merge_all( vector<Profiler> &profilers ) {
+            Profiler result = std::move(profilers.front());
+            for ( size_t i = 1; i != profilers.size(); ++i )
+                result.merge( profilers[i] );
+            return result;
+        }
+
+    }
+
+    Profiler profile_ndjson( std::streambuf &input, ProfileOptions const &options )
+    {
+        size_t const count = thread_count( options );
+        BoundedQueue<string> queue( 2 * count );
+        std::atomic<bool> done{ false };
+        FirstError errors;
+        vector<Profiler> profilers;
+        for ( size_t i = 0; i != count; ++i )
+            profilers.emplace_back( options );
+
+        auto work = [&]( Profiler &profiler ) {
+            string chunk;
+            unsigned spins = 0;
+            try {
+                while ( not errors.any() ) {
+                    if ( queue.try_pop( chunk ) ) {
+                        profile_chunk( profiler, chunk, options );
+                        spins = 0;
+                    } else if ( done.load( memory_order_acquire ) ) {
+                        // Anything pushed before "done" is in the queue by now.
+                        if ( not queue.try_pop( chunk ) )
+                            return;
+                        profile_chunk( profiler, chunk, options );
+                    } else {
+                        back_off( spins );
+                    }
+                }
+            } catch ( ... ) {
+                errors.capture();
+            }
+        };
+        vector<std::thread> workers;
+        auto join = [&] {
+            done.store( true, memory_order_release );
+            for ( auto &&worker : workers )
+                worker.join();
+        };
+        try {
+            for ( auto &&profiler : profilers )
+                workers.emplace_back( work, std::ref( profiler ) );
+            NdjsonReader reader( input );
+            string chunk;
+            while ( not errors.any()
+                    && reader.next_chunk( chunk, options.chunk_bytes ) ) {
+                unsigned spins = 0;
+                while ( not queue.try_push( chunk ) && not errors.any() )
+                    back_off( spins );
+                chunk.clear();
+            }
+        } catch ( ... ) {
+            join();
+            throw;
+        }
+        join();
+        errors.rethrow();
+        return merge_all( profilers );
+    }
+
+    Profiler profile_values(
+            std::vector<Json> const &records,
+            ProfileOptions const &options
+            )
+    {
+        size_t const count = std::max<size_t>( 1,
+                std::min( thread_count( options ), records.size() ) );
+        FirstError errors;
+        vector<Profiler> profilers;
+        for ( size_t i = 0; i != count; ++i )
+            profilers.emplace_back( options );
+        vector<std::thread> workers;
+        auto work = [&]( size_t index ) {
+            try {
+                size_t const begin = records.size() * index / count;
+                size_t const end = records.size() * ( index + 1 ) / count;
+                for ( size_t i = begin; i != end; ++i )
+                    profilers[index].add( records[i] );
+            } catch ( ... ) {
+                errors.capture();
+            }
+        };
+        try {
+            for ( size_t i = 1; i != count; ++i )
+                workers.emplace_back( work, i );
+        } catch ( ... ) {
+            for ( auto &&worker : workers )
+                worker.join();
+            throw;
+        }
+        work( 0 );
+        for ( auto &&worker : workers )
+            worker.join();
+        errors.rethrow();
+        return merge_all( profilers );
+    }
+
+}
+// vi: et ts=4 sts=4 sw=4
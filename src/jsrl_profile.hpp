@@ -0,0 +1,165 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#ifndef JSRL_PROFILE_HPP_E61C09B4A7D35F28C0B9E47A1D6F2C85
+#define JSRL_PROFILE_HPP_E61C09B4A7D35F28C0B9E47A1D6F2C85
+
+#include "jsrl.hpp"
+#include "jsrl_reader.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*! @file jsrl_profile.hpp
+ *  @brief Profiling the fields of a stream of JSON records.
+ */
+namespace jsrl {
+    using std::size_t;
+    using std::string;
+    using std::uint64_t;
+
+    /*! @brief  Settings for a @ref Profiler.
+     */
+    struct ProfileOptions {
+        size_t threads = 0;         //!< Worker threads (0: one per core).
+        size_t top_k = 10;          //!< Most frequent values kept per path.
+        unsigned hll_precision = 12;    //!< Log2 of distinct-count registers
+                                        //!< (4 to 16; error about
+                                        //!< 1.04 / sqrt(2^precision)).
+        size_t max_depth = 64;      //!< Deeper values are counted, not entered.
+        size_t max_value_bytes = 256;   //!< Longer strings aren't
+                                        //!< candidates for the top values.
+        size_t chunk_bytes = 1 << 20;   //!< NDJSON bytes per work item.
+        bool skip_invalid = false;  //!< Count bad records instead of throwing.
+    };
+
+    /*! @brief  Statistics for the values found at one path.
+     */
+    struct FieldProfile {
+        /*! @brief  Where the values are, as a JSON Pointer;
+         *          array elements all appear under the segment @c "*".
+         */
+        string path;
+        uint64_t count = 0;         //!< Values at this path.
+        double presence = 0;        //!< Fraction of the parent objects
+                                    //!< holding this member (1 for
+                                    //!< elements and the root).
+        uint64_t nulls = 0;         //!< Values that were @c null.
+        uint64_t booleans = 0;      //!< Values that were @c true or @c false.
+        uint64_t integers = 0;      //!< Numbers written as integers.
+        uint64_t numbers = 0;       //!< Other numbers.
+        uint64_t strings = 0;       //!< Values that were strings.
+        uint64_t arrays = 0;        //!< Values that were arrays.
+        uint64_t objects = 0;       //!< Values that were objects.
+        Json minimum;               //!< Least number (null if none).
+        Json maximum;               //!< Greatest number (null if none).
+        size_t min_length = 0;      //!< Shortest string, in bytes.
+        size_t max_length = 0;      //!< Longest string, in bytes.
+        uint64_t distinct = 0;      //!< Estimated distinct scalar values.
+        /*! @brief  Most frequent scalar values, most frequent first.
+         *
+         *  Counts are approximate (never low)
+         *  once a path has more distinct values than are tracked.
+         */
+        std::vector<std::pair<Json, uint64_t>> top_values;
+    };
+
+    /*! @brief  Accumulates per-path statistics over many records.
+     *
+     *  Every value is filed under its path,
+     *  with the elements of arrays sharing one path,
+     *  and counted by type;
+     *  numbers keep an exact minimum and maximum,
+     *  and scalars feed a HyperLogLog estimate of the number of
+     *  distinct values and a Space-Saving table of the most frequent ones.
+     *  All of these merge,
+     *  so records can be profiled by several threads at once,
+     *  each with its own profiler, and the results merged at the end
+     *  (as @ref profile_ndjson does).
+     *
+     *  Records read through @ref add(JsonReader&) are profiled as they are
+     *  tokenized, without building @c Json trees.
+     */
+    struct Profiler {
+        explicit
+        Profiler( ProfileOptions const &options = ProfileOptions() );
+        Profiler( Profiler && ) noexcept;
+        Profiler &operator=( Profiler && ) noexcept;
+        ~Profiler();
+
+        /*! @brief  Profile one record. */
+        void add( Json const &record );
+        /*! @brief  Profile the next value of a reader as one record.
+         *
+         *  @throw Json::ParseError The input isn't valid JSON;
+         *                          what was read before stays counted.
+         */
+        void add( JsonReader &reader );
+        /*! @brief  Count a record that couldn't be parsed. */
+        void add_invalid();
+
+        /*! @brief  Fold in another profiler's statistics.
+         *
+         *  Both must have been made with the same
+         *  @c top_k and @c hll_precision.
+         */
+        void merge( Profiler const &other );
+
+        uint64_t records() const;   //!< Records profiled.
+        uint64_t invalid() const;   //!< Records that couldn't be parsed.
+
+        /*! @brief  Statistics for every path seen, in path order. */
+        std::vector<FieldProfile> fields() const;
+
+        /*! @brief  Describe the records seen as a JSON Schema.
+         *
+         *  Types are those seen at each path,
+         *  and members present in every parent object are required.
+         */
+        Json infer_schema() const;
+
+        struct Node;
+    private:
+        ProfileOptions m_options;
+        std::unique_ptr<Node> m_root;
+        uint64_t m_records = 0;
+        uint64_t m_invalid = 0;
+    };
+
+    /*! @brief  Profile newline-delimited JSON on several threads.
+     *
+     *  The calling thread splits the input into chunks of whole lines,
+     *  and @c options.threads workers each profile the chunks they take
+     *  before their profilers are merged.
+     *
+     *  @throw Json::ParseError A record isn't valid JSON
+     *                          (unless @c options.skip_invalid).
+     */
+    Profiler profile_ndjson(
+            std::streambuf &input,
+            ProfileOptions const &options = ProfileOptions()
+            );
+
+    /*! @brief  Profile parsed records on several threads.
+     */
+    Profiler profile_values(
+            std::vector<Json> const &records,
+            ProfileOptions const &options = ProfileOptions()
+            );
+
+}
+#endif
+// vi: et ts=4 sts=4 sw=4
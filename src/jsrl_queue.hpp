@@ -0,0 +1,144 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#ifndef JSRL_QUEUE_HPP_8E2C5A0F71D94B3C96A4E1D07F5B2C63
+#define JSRL_QUEUE_HPP_8E2C5A0F71D94B3C96A4E1D07F5B2C63
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace jsrl {
+    using std::size_t;
+
+    /*! @brief  Bounded lock-free multi-producer, multi-consumer queue.
+     *
+     *  A ring of slots, each with a sequence number
+     *  telling producers and consumers whose turn it is
+     *  (after Dmitry Vyukov's bounded MPMC queue).
+     *  Pushing and popping take one compare-and-swap each
+     *  when uncontended, and never block:
+     *  they report failure when the queue is full or empty.
+     *
+     *  Elements are moved in and out;
+     *  a popped slot is reset to a default-constructed @c T
+     *  so that it doesn't keep the popped value alive.
+     */
+    template<
+            typename T  //!< Default-constructible, movable element type.
+            >
+    struct BoundedQueue {
+        /*! @brief  Create a queue holding at least @c capacity elements.
+         *
+         *  The capacity is rounded up to a power of two (at least 2).
+         */
+        explicit
+        BoundedQueue( size_t capacity )
+            : m_mask( round_up( capacity ) - 1 )
+            , m_slots( new Slot[ m_mask + 1 ] )
+        {
+            for ( size_t i = 0; i != m_mask + 1; ++i )
+                m_slots[i].sequence.store( i, std::memory_order_relaxed );
+        }
+
+        BoundedQueue( BoundedQueue const & ) = delete;
+        BoundedQueue &operator=( BoundedQueue const & ) = delete;
+
+        /*! @brief  Number of slots. */
+        size_t capacity() const { return m_mask + 1; }
+
+        /*! @brief  Number of elements, as of some recent moment. */
+        size_t size_approx() const {
+            size_t const tail = m_dequeue_pos.load( std::memory_order_relaxed );
+            size_t const head = m_enqueue_pos.load( std::memory_order_relaxed );
+            return head > tail ? head - tail : 0;
+        }
+
+        /*! @brief  Add an element, unless the queue is full.
+         *
+         *  @c value is only moved from if the push succeeds.
+         */
+        bool try_push( T &value ) {
+            size_t pos = m_enqueue_pos.load( std::memory_order_relaxed );
+            Slot *slot;
+            for (;;) {
+                slot = &m_slots[ pos & m_mask ];
+                size_t const sequence
+                        = slot->sequence.load( std::memory_order_acquire );
+                auto const diff = std::ptrdiff_t( sequence - pos );
+                if ( diff == 0 ) {
+                    if ( m_enqueue_pos.compare_exchange_weak(
+                                pos, pos + 1, std::memory_order_relaxed ) )
+                        break;
+                } else if ( diff < 0 ) {
+                    return false;
+                } else {
+                    pos = m_enqueue_pos.load( std::memory_order_relaxed );
+                }
+            }
+            slot->value = std::move(value);
+            slot->sequence.store( pos + 1, std::memory_order_release );
+            return true;
+        }
+        /*! @overload */
+        bool try_push( T &&value ) {
+            return try_push( value );
+        }
+
+        /*! @brief  Remove the oldest element, unless the queue is empty.
+         */
+        bool try_pop( T &value ) {
+            size_t pos = m_dequeue_pos.load( std::memory_order_relaxed );
+            Slot *slot;
+            for (;;) {
+                slot = &m_slots[ pos & m_mask ];
+                size_t const sequence
+                        = slot->sequence.load( std::memory_order_acquire );
+                auto const diff = std::ptrdiff_t( sequence - ( pos + 1 ) );
+                if ( diff == 0 ) {
+                    if ( m_dequeue_pos.compare_exchange_weak(
+                                pos, pos + 1, std::memory_order_relaxed ) )
+                        break;
+                } else if ( diff < 0 ) {
+                    return false;
+                } else {
+                    pos = m_dequeue_pos.load( std::memory_order_relaxed );
+                }
+            }
+            value = std::exchange( slot->value, T() );
+            slot->sequence.store( pos + m_mask + 1, std::memory_order_release );
+            return true;
+        }
+
+    private:
+        struct Slot {
+            std::atomic<size_t> sequence;
+            T value;
+        };
+
+        static size_t round_up( size_t capacity ) {
+            size_t result = 2;
+            while ( result < capacity )
+                result *= 2;
+            return result;
+        }
+
+        // Producers and consumers each get their own cache line.
+        alignas(64) std::atomic<size_t> m_enqueue_pos{ 0 };
+        alignas(64) std::atomic<size_t> m_dequeue_pos{ 0 };
+        alignas(64) size_t const m_mask;
+        std::unique_ptr<Slot[]> const m_slots;
+    };
+
+}
+#endif
+// vi: et ts=4 sts=4 sw=4
@@ -0,0 +1,474 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#include "jsrl_reader.hpp"
+#include "jsrl_impl_util.hpp"
+
+#include <cassert>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+
+namespace jsrl {
+    using std::make_unique;
+
+    using BadEOFParseError = Json::BadEOFParseError;
+    using NumberParseError = Json::NumberParseError;
+    using StartEOFParseError = Json::StartEOFParseError;
+    using TrailingCommaParseError = Json::TrailingCommaParseError;
+    using UnexpectedByteParseError = Json::UnexpectedByteParseError;
+
+    JsonReader::JsonReader(
+            streambuf &sbuf,
+            Json::ParseOptions parse_options
+            )
+        : m_sbuf( sbuf )
+        , m_options( parse_options )
+    { }
+
+    JsonReader::JsonReader(
+            string_view text,
+            Json::ParseOptions parse_options
+            )
+        : m_owned( make_unique<jsrl_streambuf>(
+                    text.data(), text.data() + text.size() ) )
+        , m_sbuf( *m_owned )
+        , m_options( parse_options )
+    { }
+
+    JsonReader::~JsonReader() = default;
+
+    // Next non-space byte, which must be there.
+    int JsonReader::p_next_byte()
+    {
+        int const byte = jsrl_get_nonspace_byte( m_sbuf );
+        if ( byte == EOF )
+            throw BadEOFParseError( "Premature end of input" );
+        return byte;
+    }
+
+    // First byte of the next value; only missing at the top level.
+    int JsonReader::p_value_byte()
+    {
+        int const byte = jsrl_get_nonspace_byte( m_sbuf );
+        if ( byte == EOF ) {
+            if ( m_closers.empty() )
+                throw StartEOFParseError( "Premature end of input" );
+            throw BadEOFParseError( "Premature end of input" );
+        }
+        return byte;
+    }
+
+    auto JsonReader::peek() -> Token
+    {
+        int const byte = p_value_byte();
+        m_sbuf.sungetc();
+        switch ( byte ) {
+        case 'n': return TK_NULL;
+        case 't': case 'f': return TK_BOOL;
+        case '"': return TK_STRING;
+        case '[': return TK_ARRAY;
+        case '{': return TK_OBJECT;
+        case '-': return TK_NUMBER;
+        default:
+            if ( std::isdigit( byte ) )
+                return TK_NUMBER;
+            throw UnexpectedByteParseError(
+                    "Unexpected character while looking for element",
+                    char(byte) );
+        }
+    }
+
+    void JsonReader::enter_array()
+    {
+        int const byte = p_value_byte();
+        if ( byte != '[' ) {
+            m_sbuf.sungetc();
+            throw UnexpectedByteParseError( "Expected an array", char(byte) );
+        }
+        m_closers.push_back( ']' );
+        m_first = true;
+    }
+
+    bool JsonReader::next_element()
+    {
+        assert( not m_closers.empty() && m_closers.back() == ']' );
+        int const byte = p_next_byte();
+        if ( byte == ']' ) {
+            m_closers.pop_back();
+            m_first = false;
+            return false;
+        }
+        if ( m_first ) {
+            m_sbuf.sungetc();
+            m_first = false;
+            return true;
+        }
+        if ( byte != ',' ) {
+            m_sbuf.sungetc();
+            throw UnexpectedByteParseError( "Unexpected byte in array",
+                    char(byte) );
+        }
+        if ( p_next_byte() == ']' ) {
+            m_sbuf.sungetc();
+            throw TrailingCommaParseError( "array" );
+        }
+        m_sbuf.sungetc();
+        return true;
+    }
+
+    void JsonReader::enter_object()
+    {
+        int const byte = p_value_byte();
+        if ( byte != '{' ) {
+            m_sbuf.sungetc();
+            throw UnexpectedByteParseError( "Expected an object", char(byte) );
+        }
+        m_closers.push_back( '}' );
+        m_first = true;
+    }
+
+    bool JsonReader::next_key( string &key )
+    {
+        return p_next_key( &key );
+    }
+
+    // Read the next key into *key (or skip it, if key is null).
+    bool JsonReader::p_next_key( string *key )
+    {
+        assert( not m_closers.empty() && m_closers.back() == '}' );
+        int byte = p_next_byte();
+        if ( byte == '}' ) {
+            m_closers.pop_back();
+            m_first = false;
+            return false;
+        }
+        if ( not m_first ) {
+            if ( byte != ',' ) {
+                m_sbuf.sungetc();
+                throw UnexpectedByteParseError( "Unexpected byte in object",
+                        char(byte) );
+            }
+            byte = p_next_byte();
+        }
+        m_first = false;
+        if ( byte != '"' ) {
+            m_sbuf.sungetc();
+            if ( byte == '}' )
+                throw TrailingCommaParseError( "object" );
+            throw UnexpectedByteParseError( "Unexpected byte"
+                    " while looking for an object key string", char(byte) );
+        }
+        if ( key ) {
+            key->clear();
+            read_json_string_into( m_sbuf, *key );
+        } else {
+            skip_json_string( m_sbuf );
+        }
+        byte = p_next_byte();
+        if ( byte != ':' ) {
+            m_sbuf.sungetc();
+            throw UnexpectedByteParseError(
+                    "Missing separator for object key", char(byte) );
+        }
+        return true;
+    }
+
+    void JsonReader::p_expect_word( char const *word )
+    {
+        int byte = p_value_byte();
+        for (;;) {
+            if ( byte != *word ) {
+                if ( byte == EOF ) {
+                    throw BadEOFParseError( string()
+                            + "Input ended while looking for \""
+                            + word + "\"" );
+                }
+                m_sbuf.sungetc();
+                throw UnexpectedByteParseError( "Unexpected character"
+                        " while looking for \"" + string(word) + "\"",
+                        char(byte) );
+            }
+            if ( not *++word )
+                break;
+            byte = m_sbuf.sbumpc();
+        }
+        byte = m_sbuf.sgetc();
+        if ( byte != EOF && std::isalnum( byte ) ) {
+            throw UnexpectedByteParseError(
+                    "Trailing character in keyword", char(byte) );
+        }
+    }
+
+    void JsonReader::read_null()
+    {
+        p_expect_word( "null" );
+    }
+
+    bool JsonReader::read_bool()
+    {
+        int const byte = p_value_byte();
+        m_sbuf.sungetc();
+        if ( byte == 't' ) {
+            p_expect_word( "true" );
+            return true;
+        }
+        p_expect_word( "false" );
+        return false;
+    }
+
+    void JsonReader::read_string( string &value )
+    {
+        int const byte = p_value_byte();
+        if ( byte != '"' ) {
+            m_sbuf.sungetc();
+            throw UnexpectedByteParseError( "Expected a string", char(byte) );
+        }
+        value.clear();
+        read_json_string_into( m_sbuf, value );
+    }
+
+    string JsonReader::read_string()
+    {
+        string value;
+        read_string( value );
+        return value;
+    }
+
+    Json::TypeTag JsonReader::read_number_text( string &text )
+    {
+        int const byte = p_value_byte();
+        m_sbuf.sungetc();
+        if ( byte != '-' && not std::isdigit( byte ) )
+            throw UnexpectedByteParseError( "Expected a number", char(byte) );
+        text.clear();
+        try {
+            switch ( read_json_number_text( m_sbuf, text ) ) {
+            case NTC_UNSIGNED:
+                return Json::TT_NUMBER_INTEGER_UNSIGNED;
+            case NTC_SIGNED:
+                return Json::TT_NUMBER_INTEGER;
+            default:
+                return Json::TT_NUMBER;
+            }
+        } catch ( GeneralNumber::BadEOFParseError const &e ) {
+            throw BadEOFParseError( e.what() );
+        } catch ( GeneralNumber::NumberParseError const &e ) {
+            throw NumberParseError( e.what() );
+        }
+    }
+
+    long long JsonReader::read_sint()
+    {
+        Json::TypeTag const tag = read_number_text( m_scratch );
+        if ( tag == Json::TT_NUMBER_INTEGER )
+            return std::strtoll( m_scratch.c_str(), nullptr, 10 );
+        if ( tag == Json::TT_NUMBER_INTEGER_UNSIGNED ) {
+            long long unsigned const value
+                    = std::strtoull( m_scratch.c_str(), nullptr, 10 );
+            if ( value <= ( ~0ull >> 1 ) )
+                return (long long)( value );
+        }
+        throw NumberParseError( "Number is not a signed integer in range: "
+                + m_scratch );
+    }
+
+    long long unsigned JsonReader::read_uint()
+    {
+        if ( read_number_text( m_scratch ) != Json::TT_NUMBER_INTEGER_UNSIGNED ) {
+            throw NumberParseError( "Number is not an unsigned integer"
+                    " in range: " + m_scratch );
+        }
+        return std::strtoull( m_scratch.c_str(), nullptr, 10 );
+    }
+
+    double JsonReader::read_double()
+    {
+        read_number_text( m_scratch );
+        return std::strtod( m_scratch.c_str(), nullptr );
+    }
+
+    Json JsonReader::read_value()
+    {
+        try {
+            return Json::parse( m_sbuf, m_options );
+        } catch ( StartEOFParseError const &e ) {
+            if ( m_closers.empty() )
+                throw;
+            throw BadEOFParseError( e );
+        }
+    }
+
+    void JsonReader::skip_value()
+    {
+        size_t const base = m_closers.size();
+        for (;;) {
+            switch ( peek() ) {
+            case TK_NULL: read_null(); break;
+            case TK_BOOL: read_bool(); break;
+            case TK_NUMBER: read_number_text( m_scratch ); break;
+            case TK_STRING:
+                m_sbuf.sbumpc();
+                skip_json_string( m_sbuf );
+                break;
+            case TK_ARRAY: enter_array(); break;
+            case TK_OBJECT: enter_object(); break;
+            }
+            // Find the next value still within the skipped one, if any.
+            for (;;) {
+                if ( m_closers.size() == base )
+                    return;
+                if ( m_closers.back() == ']'
+                        ? next_element()
+                        : p_next_key( nullptr ) )
+                    break;
+            }
+        }
+    }
+
+    void JsonReader::finish()
+    {
+        assert( m_closers.empty() );
+        int const byte = jsrl_get_nonspace_byte( m_sbuf );
+        if ( byte != EOF ) {
+            m_sbuf.sungetc();
+            throw Json::TrailingBytesParseError();
+        }
+    }
+
+    namespace {
+        char const *token_type_name( JsonReader::Token token ) {
+            switch ( token ) {
+            case JsonReader::TK_NULL: return "null";
+            case JsonReader::TK_BOOL: return "bool";
+            case JsonReader::TK_NUMBER: return "number";
+            case JsonReader::TK_STRING: return "string";
+            case JsonReader::TK_ARRAY: return "array";
+            default: return "object";
+            }
+        }
+    }
+
+    ElementReader::ElementReader(
+            streambuf &sbuf,
+            JsonPointer container,
+            Json::ParseOptions parse_options
+            )
+        : m_reader( sbuf, parse_options )
+        , m_container( std::move(container) )
+    { }
+
+    ElementReader::ElementReader(
+            string_view text,
+            JsonPointer container,
+            Json::ParseOptions parse_options
+            )
+        : m_reader( text, parse_options )
+        , m_container( std::move(container) )
+    { }
+
+    // Find the container and read its opening bracket; false once done.
+    bool ElementReader::p_open( bool object )
+    {
+        if ( m_state == ST_DONE )
+            return false;
+        if ( m_state == ST_OPEN ) {
+            if ( object != m_object ) {
+                throw Json::CompoundTypeError( "ElementReader::next",
+                        m_object ? "object" : "array" );
+            }
+            return true;
+        }
+        string key;
+        for ( auto &&token : m_container.tokens() ) {
+            JsonReader::Token const kind = m_reader.peek();
+            if ( kind == JsonReader::TK_OBJECT ) {
+                m_reader.enter_object();
+                m_enclosing.push_back( '{' );
+                for (;;) {
+                    if ( not m_reader.next_key( key ) )
+                        throw Json::ObjectKeyError( token );
+                    if ( key == token )
+                        break;
+                    m_reader.skip_value();
+                }
+            } else if ( kind == JsonReader::TK_ARRAY ) {
+                size_t const index = JsonPointer::s_index( token );
+                if ( index == JsonPointer::npos )
+                    throw JsonPointerError( "Not an array index: " + token );
+                m_reader.enter_array();
+                m_enclosing.push_back( '[' );
+                for ( size_t i = 0; i != index + 1; ++i ) {
+                    if ( not m_reader.next_element() )
+                        throw Json::ArrayKeyError( index, i );
+                    if ( i != index )
+                        m_reader.skip_value();
+                }
+            } else {
+                throw Json::CompoundTypeError( "JSON Pointer lookup",
+                        token_type_name( kind ) );
+            }
+        }
+        if ( object )
+            m_reader.enter_object();
+        else
+            m_reader.enter_array();
+        m_object = object;
+        m_state = ST_OPEN;
+        return true;
+    }
+
+    // After the container's end: check the rest of the document.
+    void ElementReader::p_close()
+    {
+        string key;
+        while ( not m_enclosing.empty() ) {
+            if ( m_enclosing.back() == '{' ) {
+                while ( m_reader.next_key( key ) )
+                    m_reader.skip_value();
+            } else {
+                while ( m_reader.next_element() )
+                    m_reader.skip_value();
+            }
+            m_enclosing.pop_back();
+        }
+        m_reader.finish();
+        m_state = ST_DONE;
+    }
+
+    bool ElementReader::next( Json &element )
+    {
+        if ( not p_open( false ) )
+            return false;
+        if ( not m_reader.next_element() ) {
+            p_close();
+            return false;
+        }
+        element = m_reader.read_value();
+        ++m_count;
+        return true;
+    }
+
+    bool ElementReader::next( string &key, Json &value )
+    {
+        if ( not p_open( true ) )
+            return false;
+        if ( not m_reader.next_key( key ) ) {
+            p_close();
+            return false;
+        }
+        value = m_reader.read_value();
+        ++m_count;
+        return true;
+    }
+
+}
+// vi: et ts=4 sts=4 sw=4
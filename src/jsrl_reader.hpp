@@ -0,0 +1,244 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#ifndef JSRL_READER_HPP_3A9F0C7E5B1D48E6A2C4F8B0D6E1A357
+#define JSRL_READER_HPP_3A9F0C7E5B1D48E6A2C4F8B0D6E1A357
+
+#include "jsrl.hpp"
+#include "jsrl_pointer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*! @file jsrl_reader.hpp
+ *  @brief Pull-style reading of JSON text without building @c Json trees.
+ */
+namespace jsrl {
+    using std::size_t;
+    using std::streambuf;
+    using std::string;
+    using std::string_view;
+
+    /*! @brief  Pull tokenizer over JSON text.
+     *
+     *  The caller walks the input value by value,
+     *  asking for each one as the type it expects,
+     *  so values can be decoded straight into their destination
+     *  instead of into a @c Json tree.
+     *  Strings and numbers are read with the same code as @ref Json::parse,
+     *  and the same syntax errors are thrown
+     *  (comments are skipped like whitespace).
+     *
+     *  Example:
+     *  @code
+     *      JsonReader reader( text );
+     *      reader.enter_object();
+     *      string key;
+     *      while ( reader.next_key( key ) ) {
+     *          if ( key == "id" )
+     *              id = reader.read_uint();
+     *          else
+     *              reader.skip_value();
+     *      }
+     *      reader.finish();
+     *  @endcode
+     */
+    struct JsonReader {
+        /*! @brief  Kind of the next value in the input.
+         */
+        enum Token {
+            TK_NULL,
+            TK_BOOL,
+            TK_NUMBER,
+            TK_STRING,
+            TK_ARRAY,
+            TK_OBJECT,
+        };
+
+        /*! @brief  Read from a streambuf, which must outlive the reader.
+         *
+         *  @c parse_options only applies to @ref read_value.
+         */
+        explicit
+        JsonReader(
+                streambuf &sbuf,
+                Json::ParseOptions parse_options = Json::ParseOptions(false)
+                );
+        /*! @brief  Read from text, which must outlive the reader.
+         */
+        explicit
+        JsonReader(
+                string_view text,
+                Json::ParseOptions parse_options = Json::ParseOptions(false)
+                );
+
+        JsonReader( JsonReader const & ) = delete;
+        JsonReader &operator=( JsonReader const & ) = delete;
+        ~JsonReader();
+
+        /*! @brief  Look at the kind of the next value without reading it.
+         *
+         *  @throw Json::StartEOFParseError At the end of top-level input.
+         */
+        Token peek();
+
+        /*! @brief  Read the @c [ opening an array.
+         */
+        void enter_array();
+        /*! @brief  Move to the next element of the current array.
+         *
+         *  @retval false   The array ended (its @c ] has been read).
+         */
+        bool next_element();
+
+        /*! @brief  Read the @c { opening an object.
+         */
+        void enter_object();
+        /*! @brief  Read the next key of the current object, and its colon.
+         *
+         *  @retval false   The object ended (its @c } has been read).
+         */
+        bool next_key( string &key );
+
+        void read_null();
+        bool read_bool();
+        /*! @brief  Read a string value, replacing the contents of @c value.
+         */
+        void read_string( string &value );
+        string read_string();
+
+        /*! @brief  Read a number's source text, replacing @c text.
+         *
+         *  @return @c Json::TT_NUMBER_INTEGER_UNSIGNED,
+         *          @c Json::TT_NUMBER_INTEGER, or @c Json::TT_NUMBER,
+         *          by the same rules as lazy numbers.
+         */
+        Json::TypeTag read_number_text( string &text );
+        /*! @brief  Read an integral number.
+         *
+         *  @throw Json::NumberParseError   Not an integer in range.
+         */
+        long long read_sint();
+        /*! @copydoc read_sint */
+        long long unsigned read_uint();
+        double read_double();
+
+        /*! @brief  Read the next value (of any kind) as a @c Json.
+         */
+        Json read_value();
+        /*! @brief  Read past the next value without decoding it.
+         */
+        void skip_value();
+
+        /*! @brief  Check that nothing but whitespace follows a top-level value.
+         *
+         *  @throw Json::TrailingBytesParseError    More input follows.
+         */
+        void finish();
+
+        /*! @brief  Number of arrays and objects entered and not yet ended. */
+        size_t depth() const { return m_closers.size(); }
+
+    private:
+        int p_value_byte();
+        int p_next_byte();
+        bool p_next_key( string *key );
+        void p_expect_word( char const *word );
+
+        std::unique_ptr<streambuf> m_owned;
+        streambuf &m_sbuf;
+        Json::ParseOptions const m_options;
+        // Closing bracket of each open container, innermost last.
+        std::vector<char> m_closers;
+        // Whether the innermost container has had no elements yet.
+        bool m_first = false;
+        string m_scratch;
+    };
+
+    /*! @brief  Reads the elements of one huge array or object one at a time.
+     *
+     *  Each element (or member value) is parsed into a @c Json
+     *  as it is reached, and the container itself is never built,
+     *  so memory use is bounded by the largest element
+     *  rather than by the document.
+     *  The container is the whole document by default,
+     *  or the value a JSON Pointer leads to
+     *  (for exports wrapped like @c {"data":[...]});
+     *  what comes before it is skipped without being built.
+     *
+     *  Example:
+     *  @code
+     *      std::ifstream export_file( path, std::ios::binary );
+     *      ElementReader elements( *export_file.rdbuf() );
+     *      Json element;
+     *      while ( elements.next( element ) )
+     *          process( element );
+     *  @endcode
+     */
+    struct ElementReader {
+        /*! @brief  Read from a streambuf, which must outlive the reader.
+         */
+        explicit
+        ElementReader(
+                streambuf &sbuf,
+                JsonPointer container = JsonPointer(),
+                Json::ParseOptions parse_options = Json::ParseOptions(false)
+                );
+        /*! @brief  Read from text, which must outlive the reader.
+         */
+        explicit
+        ElementReader(
+                string_view text,
+                JsonPointer container = JsonPointer(),
+                Json::ParseOptions parse_options = Json::ParseOptions(false)
+                );
+
+        /*! @brief  Read the next element of an array.
+         *
+         *  After the last element,
+         *  the rest of the document is checked and @c false returned.
+         *
+         *  @throw Json::ParseError     The input isn't valid JSON,
+         *                              or the container isn't an array.
+         *  @throw Json::KeyError       The container doesn't exist.
+         *  @throw Json::TypeError      The pointer leads through a scalar.
+         */
+        bool next( Json &element );
+        /*! @brief  Read the next member of an object.
+         *
+         *  @copydetails next(Json&)
+         */
+        bool next( string &key, Json &value );
+
+        /*! @brief  Elements or members read so far. */
+        std::uint64_t count() const { return m_count; }
+
+    private:
+        bool p_open( bool object );
+        void p_close();
+
+        JsonReader m_reader;
+        JsonPointer const m_container;
+        // Kinds of the containers around the target ('[' or '{').
+        std::vector<char> m_enclosing;
+        enum { ST_START, ST_OPEN, ST_DONE } m_state = ST_START;
+        bool m_object = false;
+        std::uint64_t m_count = 0;
+    };
+
+}
+#endif
+// vi: et ts=4 sts=4 sw=4
@@ -0,0 +1,1088 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#include "jsrl_schema.hpp"
+#include "jsrl_impl_util.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <regex>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace jsrl {
+    using std::make_shared;
+    using std::pair;
+    using std::regex;
+    using std::size_t;
+    using std::string_view;
+    using std::to_string;
+    using std::unordered_map;
+    using std::vector;
+
+    namespace {
+
+        // Type bits for the "type" keyword.
+        enum TypeBit : unsigned {
+            TB_NULL = 1,
+            TB_BOOLEAN = 2,
+            TB_INTEGER = 4,
+            TB_NUMBER = 8,
+            TB_STRING = 16,
+            TB_ARRAY = 32,
+            TB_OBJECT = 64,
+        };
+
+        enum OpCode {
+            OP_FALSE,
+            OP_ENUM,                //!< value: array of allowed values
+            OP_CONST,               //!< value
+            OP_MINIMUM,             //!< value
+            OP_MAXIMUM,             //!< value
+            OP_EXCLUSIVE_MINIMUM,   //!< value
+            OP_EXCLUSIVE_MAXIMUM,   //!< value
+            OP_MULTIPLE_OF,         //!< value
+            OP_MIN_LENGTH,          //!< n
+            OP_MAX_LENGTH,          //!< n
+            OP_PATTERN,             //!< n: regex index
+            OP_ITEMS,               //!< nodes: prefix items; n: rest (or npos)
+            OP_MIN_ITEMS,           //!< n
+            OP_MAX_ITEMS,           //!< n
+            OP_UNIQUE_ITEMS,
+            OP_PROPERTIES,          //!< keyed: sorted properties;
+                                    //!< nodes: pattern regexes and schemas
+                                    //!< (pairs); n: additional (or npos)
+            OP_REQUIRED,            //!< keyed: sorted names
+            OP_MIN_PROPERTIES,      //!< n
+            OP_MAX_PROPERTIES,      //!< n
+            OP_ALL_OF,              //!< nodes
+            OP_ANY_OF,              //!< nodes
+            OP_ONE_OF,              //!< nodes
+            OP_NOT,                 //!< n
+            OP_REF,                 //!< n
+        };
+
+        size_t const npos = size_t( -1 );
+
+        struct Op {
+            explicit Op( OpCode code ) : code( code ) { }
+
+            OpCode code;
+            size_t n = npos;
+            Json value;
+            vector<size_t> nodes;
+            vector<pair<string, size_t>> keyed;
+        };
+
+        // Operations that look at a whole value rather than its members.
+        bool needs_tree( OpCode code ) {
+            switch ( code ) {
+            case OP_ENUM:
+            case OP_CONST:
+            case OP_UNIQUE_ITEMS:
+            case OP_ANY_OF:
+            case OP_ONE_OF:
+            case OP_NOT:
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        char const *keyword_name( OpCode code ) {
+            switch ( code ) {
+            case OP_FALSE: return "false";
+            case OP_ENUM: return "enum";
+            case OP_CONST: return "const";
+            case OP_MINIMUM: return "minimum";
+            case OP_MAXIMUM: return "maximum";
+            case OP_EXCLUSIVE_MINIMUM: return "exclusiveMinimum";
+            case OP_EXCLUSIVE_MAXIMUM: return "exclusiveMaximum";
+            case OP_MULTIPLE_OF: return "multipleOf";
+            case OP_MIN_LENGTH: return "minLength";
+            case OP_MAX_LENGTH: return "maxLength";
+            case OP_PATTERN: return "pattern";
+            case OP_ITEMS: return "items";
+            case OP_MIN_ITEMS: return "minItems";
+            case OP_MAX_ITEMS: return "maxItems";
+            case OP_UNIQUE_ITEMS: return "uniqueItems";
+            case OP_PROPERTIES: return "properties";
+            case OP_REQUIRED: return "required";
+            case OP_MIN_PROPERTIES: return "minProperties";
+            case OP_MAX_PROPERTIES: return "maxProperties";
+            case OP_ALL_OF: return "allOf";
+            case OP_ANY_OF: return "anyOf";
+            case OP_ONE_OF: return "oneOf";
+            case OP_NOT: return "not";
+            case OP_REF: return "$ref";
+            }
+            return "";
+        }
+
+        unsigned type_bit( string const &name ) {
+            if ( name == "null" ) return TB_NULL;
+            if ( name == "boolean" ) return TB_BOOLEAN;
+            if ( name == "integer" ) return TB_INTEGER;
+            if ( name == "number" ) return TB_NUMBER;
+            if ( name == "string" ) return TB_STRING;
+            if ( name == "array" ) return TB_ARRAY;
+            if ( name == "object" ) return TB_OBJECT;
+            throw SchemaError( "Unknown type \"" + name + "\"" );
+        }
+
+        bool is_integral( Json const &number ) {
+            if ( number.is_number_integer() )
+                return true;
+            long double const value = number.as_number_float();
+            return std::isfinite( value ) && std::floor( value ) == value;
+        }
+
+        unsigned instance_type_bits( Json const &value ) {
+            switch ( value.get_typetag( false ) ) {
+            case Json::TT_NULL: return TB_NULL;
+            case Json::TT_BOOL: return TB_BOOLEAN;
+            case Json::TT_STRING: return TB_STRING;
+            case Json::TT_ARRAY: return TB_ARRAY;
+            case Json::TT_OBJECT: return TB_OBJECT;
+            default:
+                return is_integral( value ) ? TB_NUMBER | TB_INTEGER : TB_NUMBER;
+            }
+        }
+
+        size_t codepoint_count( string const &text ) {
+            size_t count = 0;
+            for ( char c : text )
+                count += ( c & 0xC0 ) != 0x80;
+            return count;
+        }
+
+        bool is_multiple( Json const &value, Json const &divisor ) {
+            if ( value.is_number_integer() && divisor.is_number_integer() ) {
+                long long unsigned const d = divisor.as_number_xint();
+                long long unsigned v = value.as_number_xint();
+                if ( value.is_number_sint() && value.as_number_sint() < 0 )
+                    v = 0 - v;
+                if ( divisor.is_number_sint() && divisor.as_number_sint() < 0 )
+                    return v % ( 0 - d ) == 0;
+                return v % d == 0;
+            }
+            long double const q = value.as_number_float()
+                    / divisor.as_number_float();
+            if ( not std::isfinite( q ) )
+                return false;
+            return std::fabs( q - std::round( q ) )
+                    <= 1e-9L * std::max<long double>( 1, std::fabs( q ) );
+        }
+
+        // Decode one JSON Pointer reference token.
+        string unescape_token( string_view token ) {
+            string result;
+            for ( size_t i = 0; i != token.size(); ++i ) {
+                if ( token[i] == '~' && i + 1 != token.size()
+                        && ( token[i + 1] == '0' || token[i + 1] == '1' ) ) {
+                    result.push_back( token[++i] == '0' ? '~' : '/' );
+                } else {
+                    result.push_back( token[i] );
+                }
+            }
+            return result;
+        }
+
+        string escape_token( string_view token ) {
+            string result;
+            for ( char c : token ) {
+                if ( c == '~' )
+                    result += "~0";
+                else if ( c == '/' )
+                    result += "~1";
+                else
+                    result.push_back( c );
+            }
+            return result;
+        }
+
+        // Undo %-escapes in the fragment of a URI reference.
+        string percent_decode( string_view text ) {
+            string result;
+            auto hex = []( char c ) -> int {
+                if ( c >= '0' && c <= '9' ) return c - '0';
+                if ( c >= 'a' && c <= 'f' ) return c - 'a' + 10;
+                if ( c >= 'A' && c <= 'F' ) return c - 'A' + 10;
+                return -1;
+            };
+            for ( size_t i = 0; i != text.size(); ++i ) {
+                if ( text[i] == '%' && i + 2 < text.size()
+                        && hex( text[i + 1] ) >= 0 && hex( text[i + 2] ) >= 0 ) {
+                    result.push_back( char(
+                                hex( text[i + 1] ) * 16 + hex( text[i + 2] ) ) );
+                    i += 2;
+                } else {
+                    result.push_back( text[i] );
+                }
+            }
+            return result;
+        }
+
+    }
+
+    struct CompiledSchema::Program {
+        struct Node {
+            unsigned types = 0;     // Allowed TypeBits; 0 allows all.
+            vector<Op> ops;
+        };
+        vector<Node> nodes;
+        vector<regex> regexes;
+    };
+
+    namespace {
+        using Program = CompiledSchema::Program;
+        using Node = Program::Node;
+
+        struct Compiler {
+            explicit Compiler( Json const &root )
+                : root( root )
+            {
+                collect_anchors( root );
+            }
+
+            Json const root;
+            Program program;
+            unordered_map<void const *, size_t> compiled;
+            unordered_map<string, Json> anchors;
+
+            void collect_anchors( Json const &schema ) {
+                if ( schema.is_array() ) {
+                    for ( auto &&item : schema.as_array() )
+                        collect_anchors( item );
+                    return;
+                }
+                if ( not schema.is_object() )
+                    return;
+                if ( Json const *anchor = schema.find_key( "$anchor" ) ) {
+                    if ( anchor->is_string() )
+                        anchors.emplace( anchor->as_string(), schema );
+                }
+                for ( auto &&member : schema.as_object() ) {
+                    // Values of these keywords aren't schemas.
+                    if ( member.first == "enum" || member.first == "const" )
+                        continue;
+                    collect_anchors( member.second );
+                }
+            }
+
+            Json resolve( string const &ref ) const {
+                if ( ref.empty() || ref[0] != '#' ) {
+                    throw SchemaError( "Only same-document $ref is supported: "
+                            + ref );
+                }
+                string const fragment
+                        = percent_decode( string_view( ref ).substr( 1 ) );
+                if ( not fragment.empty() && fragment[0] != '/' ) {
+                    auto const found = anchors.find( fragment );
+                    if ( found == anchors.end() )
+                        throw SchemaError( "Unknown $anchor in $ref: " + ref );
+                    return found->second;
+                }
+                Json target = root;
+                size_t pos = 0;
+                while ( pos != fragment.size() ) {
+                    size_t const next = std::min(
+                            fragment.find( '/', pos + 1 ), fragment.size() );
+                    string const token = unescape_token( string_view(
+                                fragment ).substr( pos + 1, next - pos - 1 ) );
+                    Json const *child = nullptr;
+                    if ( target.is_object() ) {
+                        child = target.find_key( string_view( token ) );
+                    } else if ( target.is_array() && not token.empty()
+                            && token.find_first_not_of( "0123456789" )
+                                == string::npos ) {
+                        child = target.find_key( size_t(
+                                    std::stoull( token ) ) );
+                    }
+                    if ( not child )
+                        throw SchemaError( "Unresolvable $ref: " + ref );
+                    target = *child;
+                    pos = next;
+                }
+                return target;
+            }
+
+            size_t count( Json const &schema, char const *keyword ) {
+                Json const value = schema.get( keyword );
+                if ( not value.is_number() || not is_integral( value )
+                        || value.as_number_float() < 0 )
+                    throw SchemaError( string( keyword )
+                            + " must be a non-negative integer" );
+                return size_t( value.as_number_xint() );
+            }
+
+            vector<size_t> compile_list( Json const &list, char const *keyword ) {
+                if ( not list.is_array() || list.as_array().empty() )
+                    throw SchemaError( string( keyword )
+                            + " must be a non-empty array" );
+                vector<size_t> result;
+                for ( auto &&item : list.as_array() )
+                    result.push_back( compile( item ) );
+                return result;
+            }
+
+            size_t compile_regex( Json const &pattern ) {
+                if ( not pattern.is_string() )
+                    throw SchemaError( "pattern must be a string" );
+                try {
+                    program.regexes.emplace_back( pattern.as_string(),
+                            regex::ECMAScript | regex::optimize );
+                } catch ( std::regex_error const & ) {
+                    throw SchemaError( "Bad pattern: " + pattern.as_string() );
+                }
+                return program.regexes.size() - 1;
+            }
+
+            // Nodes that a node applies to the same value it was given.
+            static vector<size_t> same_value_nodes( Node const &node ) {
+                vector<size_t> result;
+                for ( auto &&op : node.ops ) {
+                    switch ( op.code ) {
+                    case OP_REF:
+                    case OP_NOT:
+                        result.push_back( op.n );
+                        break;
+                    case OP_ALL_OF:
+                    case OP_ANY_OF:
+                    case OP_ONE_OF:
+                        result.insert( result.end(), op.nodes.begin(), op.nodes.end() );
+                        break;
+                    default:
+                        break;
+                    }
+                }
+                return result;
+            }
+
+            // Reject a loop of $ref (or allOf and the like) that gets back
+            // to a node without going into a member or item:
+            // validating anything against it would never end.
+            void check_loops() const {
+                enum Mark : char { UNSEEN, ON_PATH, DONE };
+                vector<Mark> marks( program.nodes.size(), UNSEEN );
+                std::function<void( size_t )> visit = [&]( size_t index ) {
+                    marks[index] = ON_PATH;
+                    for ( size_t next : same_value_nodes( program.nodes[index] ) ) {
+                        if ( marks[next] == ON_PATH ) {
+                            throw SchemaError( "$ref loops back to a schema"
+                                    " without consuming any of the instance" );
+                        }
+                        if ( marks[next] == UNSEEN )
+                            visit( next );
+                    }
+                    marks[index] = DONE;
+                };
+                for ( size_t index = 0; index != program.nodes.size(); ++index ) {
+                    if ( marks[index] == UNSEEN )
+                        visit( index );
+                }
+            }
+
+            // Compile a subschema (once per distinct value), giving its node.
+            size_t compile( Json const &schema ) {
+                auto const found = compiled.find( schema.identity() );
+                if ( found != compiled.end() )
+                    return found->second;
+                size_t const index = program.nodes.size();
+                program.nodes.emplace_back();
+                // Registered before compiling children, for recursive refs.
+                compiled.emplace( schema.identity(), index );
+                Node node = compile_node( schema );
+                program.nodes[index] = std::move(node);
+                return index;
+            }
+
+            Node compile_node( Json const &schema ) {
+                Node node;
+                if ( schema.is_bool() ) {
+                    if ( not schema.as_bool() )
+                        node.ops.push_back( Op( OP_FALSE ) );
+                    return node;
+                }
+                if ( not schema.is_object() )
+                    throw SchemaError( "A schema must be an object or boolean" );
+
+                if ( Json const *type = schema.find_key( "type" ) ) {
+                    if ( type->is_string() ) {
+                        node.types = type_bit( type->as_string() );
+                    } else if ( type->is_array() ) {
+                        for ( auto &&name : type->as_array() ) {
+                            if ( not name.is_string() )
+                                throw SchemaError( "type names must be strings" );
+                            node.types |= type_bit( name.as_string() );
+                        }
+                    } else {
+                        throw SchemaError( "type must be a string or array" );
+                    }
+                    // Every integer is a number.
+                    if ( node.types & TB_NUMBER )
+                        node.types |= TB_INTEGER;
+                }
+                if ( Json const *ref = schema.find_key( "$ref" ) ) {
+                    if ( not ref->is_string() )
+                        throw SchemaError( "$ref must be a string" );
+                    Op op( OP_REF );
+                    op.n = compile( resolve( ref->as_string() ) );
+                    node.ops.push_back( std::move(op) );
+                }
+                if ( Json const *values = schema.find_key( "enum" ) ) {
+                    if ( not values->is_array() )
+                        throw SchemaError( "enum must be an array" );
+                    Op op( OP_ENUM );
+                    op.value = *values;
+                    node.ops.push_back( std::move(op) );
+                }
+                if ( Json const *value = schema.find_key( "const" ) ) {
+                    Op op( OP_CONST );
+                    op.value = *value;
+                    node.ops.push_back( std::move(op) );
+                }
+                static pair<char const *, OpCode> const bounds[] = {
+                    { "minimum", OP_MINIMUM },
+                    { "maximum", OP_MAXIMUM },
+                    { "exclusiveMinimum", OP_EXCLUSIVE_MINIMUM },
+                    { "exclusiveMaximum", OP_EXCLUSIVE_MAXIMUM },
+                    { "multipleOf", OP_MULTIPLE_OF },
+                };
+                for ( auto &&bound : bounds ) {
+                    if ( Json const *value = schema.find_key( bound.first ) ) {
+                        if ( not value->is_number() )
+                            throw SchemaError( string( bound.first )
+                                    + " must be a number" );
+                        if ( bound.second == OP_MULTIPLE_OF
+                                && not ( value->as_number_float() > 0 ) )
+                            throw SchemaError( "multipleOf must be positive" );
+                        Op op( bound.second );
+                        op.value = *value;
+                        node.ops.push_back( std::move(op) );
+                    }
+                }
+                static pair<char const *, OpCode> const counts[] = {
+                    { "minLength", OP_MIN_LENGTH },
+                    { "maxLength", OP_MAX_LENGTH },
+                    { "minItems", OP_MIN_ITEMS },
+                    { "maxItems", OP_MAX_ITEMS },
+                    { "minProperties", OP_MIN_PROPERTIES },
+                    { "maxProperties", OP_MAX_PROPERTIES },
+                };
+                for ( auto &&limit : counts ) {
+                    if ( schema.has_key( limit.first ) ) {
+                        Op op( limit.second );
+                        op.n = count( schema, limit.first );
+                        node.ops.push_back( std::move(op) );
+                    }
+                }
+                if ( Json const *pattern = schema.find_key( "pattern" ) ) {
+                    Op op( OP_PATTERN );
+                    op.n = compile_regex( *pattern );
+                    node.ops.push_back( std::move(op) );
+                }
+                compile_items( schema, node );
+                if ( Json const *unique = schema.find_key( "uniqueItems" ) ) {
+                    if ( not unique->is_bool() )
+                        throw SchemaError( "uniqueItems must be a boolean" );
+                    if ( unique->as_bool() )
+                        node.ops.push_back( Op( OP_UNIQUE_ITEMS ) );
+                }
+                compile_properties( schema, node );
+                if ( Json const *required = schema.find_key( "required" ) ) {
+                    if ( not required->is_array() )
+                        throw SchemaError( "required must be an array" );
+                    Op op( OP_REQUIRED );
+                    for ( auto &&name : required->as_array() ) {
+                        if ( not name.is_string() )
+                            throw SchemaError( "required names must be strings" );
+                        op.keyed.emplace_back( name.as_string(), npos );
+                    }
+                    std::sort( op.keyed.begin(), op.keyed.end() );
+                    op.keyed.erase( std::unique( op.keyed.begin(), op.keyed.end() ),
+                            op.keyed.end() );
+                    node.ops.push_back( std::move(op) );
+                }
+                static pair<char const *, OpCode> const lists[] = {
+                    { "allOf", OP_ALL_OF },
+                    { "anyOf", OP_ANY_OF },
+                    { "oneOf", OP_ONE_OF },
+                };
+                for ( auto &&list : lists ) {
+                    if ( Json const *value = schema.find_key( list.first ) ) {
+                        Op op( list.second );
+                        op.nodes = compile_list( *value, list.first );
+                        node.ops.push_back( std::move(op) );
+                    }
+                }
+                if ( Json const *negated = schema.find_key( "not" ) ) {
+                    Op op( OP_NOT );
+                    op.n = compile( *negated );
+                    node.ops.push_back( std::move(op) );
+                }
+                return node;
+            }
+
+            void compile_items( Json const &schema, Node &node ) {
+                Json const *prefix = schema.find_key( "prefixItems" );
+                Json const *items = schema.find_key( "items" );
+                if ( not prefix && not items )
+                    return;
+                Op op( OP_ITEMS );
+                if ( items && items->is_array() ) {
+                    // The older array form of "items" is "prefixItems".
+                    prefix = items;
+                    items = schema.find_key( "additionalItems" );
+                }
+                if ( prefix )
+                    op.nodes = compile_list( *prefix, "prefixItems" );
+                if ( items )
+                    op.n = compile( *items );
+                node.ops.push_back( std::move(op) );
+            }
+
+            void compile_properties( Json const &schema, Node &node ) {
+                Json const *properties = schema.find_key( "properties" );
+                Json const *patterns = schema.find_key( "patternProperties" );
+                Json const *additional
+                        = schema.find_key( "additionalProperties" );
+                if ( not properties && not patterns && not additional )
+                    return;
+                Op op( OP_PROPERTIES );
+                if ( properties ) {
+                    if ( not properties->is_object() )
+                        throw SchemaError( "properties must be an object" );
+                    // ObjectBody is already sorted by key.
+                    for ( auto &&property : properties->as_object() ) {
+                        op.keyed.emplace_back( property.first,
+                                compile( property.second ) );
+                    }
+                }
+                if ( patterns ) {
+                    if ( not patterns->is_object() )
+                        throw SchemaError( "patternProperties must be an object" );
+                    for ( auto &&pattern : patterns->as_object() ) {
+                        op.nodes.push_back( compile_regex( Json( pattern.first ) ) );
+                        op.nodes.push_back( compile( pattern.second ) );
+                    }
+                }
+                if ( additional )
+                    op.n = compile( *additional );
+                node.ops.push_back( std::move(op) );
+            }
+        };
+
+        // Description of the first failure, built as the stack unwinds.
+        struct Failure {
+            vector<string> path;    // Innermost first.
+            OpCode code = OP_FALSE;
+            bool type = false;
+            string message;
+        };
+
+        struct Validator {
+            Program const &program;
+            Failure *failure;
+
+            bool fail( OpCode code, string message ) {
+                if ( failure ) {
+                    failure->code = code;
+                    failure->message = std::move(message);
+                }
+                return false;
+            }
+            bool fail_type() {
+                if ( failure ) {
+                    failure->type = true;
+                    failure->message = "Value type not allowed";
+                }
+                return false;
+            }
+            bool in( string segment, bool ok ) {
+                if ( not ok && failure )
+                    failure->path.push_back( std::move(segment) );
+                return ok;
+            }
+
+            // Check a value against several schemas, quietly.
+            bool quiet( size_t node, Json const &value ) const {
+                Validator v{ program, nullptr };
+                return v.check( node, value );
+            }
+
+            bool check( size_t index, Json const &value ) {
+                Node const &node = program.nodes[index];
+                unsigned const bits = instance_type_bits( value );
+                if ( node.types && not ( node.types & bits ) )
+                    return fail_type();
+                for ( auto &&op : node.ops ) {
+                    if ( not check_op( op, value, bits ) )
+                        return false;
+                }
+                return true;
+            }
+
+            bool check_op( Op const &op, Json const &value, unsigned bits ) {
+                switch ( op.code ) {
+                case OP_FALSE:
+                    return fail( op.code, "No value is allowed" );
+                case OP_ENUM:
+                    for ( auto &&allowed : op.value.as_array() ) {
+                        if ( json_value_compare( allowed, value ) == 0 )
+                            return true;
+                    }
+                    return fail( op.code, "Value is not one of the enum values" );
+                case OP_CONST:
+                    if ( json_value_compare( op.value, value ) == 0 )
+                        return true;
+                    return fail( op.code, "Value is not the const value" );
+                case OP_ALL_OF:
+                    for ( size_t node : op.nodes ) {
+                        if ( not check( node, value ) )
+                            return false;
+                    }
+                    return true;
+                case OP_ANY_OF:
+                    for ( size_t node : op.nodes ) {
+                        if ( quiet( node, value ) )
+                            return true;
+                    }
+                    return fail( op.code, "Value matches no anyOf schema" );
+                case OP_ONE_OF: {
+                    size_t matches = 0;
+                    for ( size_t node : op.nodes )
+                        matches += quiet( node, value );
+                    if ( matches == 1 )
+                        return true;
+                    return fail( op.code, "Value matches "
+                            + to_string( matches ) + " oneOf schemas" );
+                }
+                case OP_NOT:
+                    if ( not quiet( op.n, value ) )
+                        return true;
+                    return fail( op.code, "Value matches the not schema" );
+                case OP_REF:
+                    return check( op.n, value );
+                default:
+                    break;
+                }
+                if ( bits & TB_NUMBER )
+                    return check_number( op, value );
+                if ( bits & TB_STRING )
+                    return check_string( op, value.as_string() );
+                if ( bits & TB_ARRAY )
+                    return check_array( op, value.as_array() );
+                if ( bits & TB_OBJECT )
+                    return check_object( op, value.as_object() );
+                return true;
+            }
+
+            bool check_number( Op const &op, Json const &value ) {
+                switch ( op.code ) {
+                case OP_MINIMUM:
+                    if ( json_value_compare( value, op.value ) < 0 )
+                        return fail( op.code, "Value is below the minimum" );
+                    return true;
+                case OP_MAXIMUM:
+                    if ( json_value_compare( value, op.value ) > 0 )
+                        return fail( op.code, "Value is above the maximum" );
+                    return true;
+                case OP_EXCLUSIVE_MINIMUM:
+                    if ( json_value_compare( value, op.value ) <= 0 )
+                        return fail( op.code, "Value is not above the minimum" );
+                    return true;
+                case OP_EXCLUSIVE_MAXIMUM:
+                    if ( json_value_compare( value, op.value ) >= 0 )
+                        return fail( op.code, "Value is not below the maximum" );
+                    return true;
+                case OP_MULTIPLE_OF:
+                    if ( not is_multiple( value, op.value ) )
+                        return fail( op.code, "Value is not a multiple" );
+                    return true;
+                default:
+                    return true;
+                }
+            }
+
+            bool check_string( Op const &op, string const &text ) {
+                switch ( op.code ) {
+                case OP_MIN_LENGTH:
+                    if ( text.size() < op.n || codepoint_count( text ) < op.n )
+                        return fail( op.code, "String is too short" );
+                    return true;
+                case OP_MAX_LENGTH:
+                    if ( text.size() > op.n && codepoint_count( text ) > op.n )
+                        return fail( op.code, "String is too long" );
+                    return true;
+                case OP_PATTERN:
+                    if ( not std::regex_search( text, program.regexes[op.n] ) )
+                        return fail( op.code, "String does not match pattern" );
+                    return true;
+                default:
+                    return true;
+                }
+            }
+
+            bool check_array( Op const &op, Json::ArrayBody const &items ) {
+                switch ( op.code ) {
+                case OP_ITEMS:
+                    for ( size_t i = 0; i != items.size(); ++i ) {
+                        size_t const node = i < op.nodes.size()
+                                ? op.nodes[i]
+                                : op.n
+                                ;
+                        if ( node == npos )
+                            break;
+                        if ( not in( to_string( i ), check( node, items[i] ) ) )
+                            return false;
+                    }
+                    return true;
+                case OP_MIN_ITEMS:
+                    if ( items.size() < op.n )
+                        return fail( op.code, "Array has too few items" );
+                    return true;
+                case OP_MAX_ITEMS:
+                    if ( items.size() > op.n )
+                        return fail( op.code, "Array has too many items" );
+                    return true;
+                case OP_UNIQUE_ITEMS: {
+                    vector<Json> sorted( items.begin(), items.end() );
+                    std::sort( sorted.begin(), sorted.end(),
+                            []( Json const &l, Json const &r ) {
+                                return json_value_compare( l, r ) < 0;
+                            } );
+                    if ( std::adjacent_find( sorted.begin(), sorted.end(),
+                                []( Json const &l, Json const &r ) {
+                                    return json_value_compare( l, r ) == 0;
+                                } ) != sorted.end() )
+                        return fail( op.code, "Array items are not unique" );
+                    return true;
+                }
+                default:
+                    return true;
+                }
+            }
+
+            bool check_object( Op const &op, Json::ObjectBody const &members ) {
+                switch ( op.code ) {
+                case OP_PROPERTIES:
+                    return check_properties( op, members );
+                case OP_REQUIRED: {
+                    // Both lists are sorted: merge.
+                    auto member = members.begin();
+                    for ( auto &&name : op.keyed ) {
+                        while ( member != members.end() && member->first < name.first )
+                            ++member;
+                        if ( member == members.end() || member->first != name.first )
+                            return fail( op.code, "Missing required property \""
+                                    + name.first + "\"" );
+                    }
+                    return true;
+                }
+                case OP_MIN_PROPERTIES:
+                    if ( members.size() < op.n )
+                        return fail( op.code, "Object has too few properties" );
+                    return true;
+                case OP_MAX_PROPERTIES:
+                    if ( members.size() > op.n )
+                        return fail( op.code, "Object has too many properties" );
+                    return true;
+                default:
+                    return true;
+                }
+            }
+
+            bool check_properties(
+                    Op const &op,
+                    Json::ObjectBody const &members
+                    ) {
+                auto property = op.keyed.begin();
+                for ( auto &&member : members ) {
+                    while ( property != op.keyed.end()
+                            && property->first < member.first )
+                        ++property;
+                    bool matched = false;
+                    if ( property != op.keyed.end()
+                            && property->first == member.first ) {
+                        matched = true;
+                        if ( not in( member.first,
+                                    check( property->second, member.second ) ) )
+                            return false;
+                    }
+                    for ( size_t i = 0; i != op.nodes.size(); i += 2 ) {
+                        if ( std::regex_search( member.first,
+                                    program.regexes[ op.nodes[i] ] ) ) {
+                            matched = true;
+                            if ( not in( member.first,
+                                        check( op.nodes[i + 1], member.second ) ) )
+                                return false;
+                        }
+                    }
+                    if ( not matched && op.n != npos ) {
+                        if ( not in( member.first,
+                                    check( op.n, member.second ) ) )
+                            return false;
+                    }
+                }
+                return true;
+            }
+        };
+
+        // Validates straight from a reader, against a set of nodes at once.
+        struct StreamValidator {
+            Program const &program;
+            Failure *failure;
+            JsonReader &reader;
+
+            // Add a node and everything it applies through allOf and $ref.
+            void expand( size_t index, vector<size_t> &set ) const {
+                if ( std::find( set.begin(), set.end(), index ) != set.end() )
+                    return;
+                set.push_back( index );
+                for ( auto &&op : program.nodes[index].ops ) {
+                    if ( op.code == OP_REF ) {
+                        expand( op.n, set );
+                    } else if ( op.code == OP_ALL_OF ) {
+                        for ( size_t node : op.nodes )
+                            expand( node, set );
+                    }
+                }
+            }
+
+            bool tree( vector<size_t> const &set, Json const &value ) {
+                Validator v{ program, failure };
+                for ( size_t node : set ) {
+                    if ( not v.check( node, value ) )
+                        return false;
+                }
+                return true;
+            }
+
+            bool fail( OpCode code, string message ) {
+                Validator v{ program, failure };
+                return v.fail( code, std::move(message) );
+            }
+
+            bool in( string segment, bool ok ) {
+                Validator v{ program, failure };
+                return v.in( std::move(segment), ok );
+            }
+
+            bool check( vector<size_t> const &roots ) {
+                vector<size_t> set;
+                for ( size_t node : roots )
+                    expand( node, set );
+                JsonReader::Token const token = reader.peek();
+                bool whole = token != JsonReader::TK_ARRAY
+                        && token != JsonReader::TK_OBJECT;
+                for ( size_t node : set ) {
+                    for ( auto &&op : program.nodes[node].ops )
+                        whole = whole || needs_tree( op.code );
+                }
+                if ( whole ) {
+                    // Checks on plain values don't gain from streaming.
+                    return tree( roots, reader.read_value() );
+                }
+                unsigned const bit = token == JsonReader::TK_ARRAY
+                        ? TB_ARRAY
+                        : TB_OBJECT
+                        ;
+                for ( size_t node : set ) {
+                    Node const &n = program.nodes[node];
+                    if ( n.types && not ( n.types & bit ) )
+                        return Validator{ program, failure }.fail_type();
+                    for ( auto &&op : n.ops ) {
+                        if ( op.code == OP_FALSE )
+                            return fail( op.code, "No value is allowed" );
+                    }
+                }
+                return bit == TB_ARRAY ? check_array( set ) : check_object( set );
+            }
+
+            bool check_array( vector<size_t> const &set ) {
+                reader.enter_array();
+                size_t count = 0;
+                vector<size_t> children;
+                while ( reader.next_element() ) {
+                    children.clear();
+                    for ( size_t node : set ) {
+                        for ( auto &&op : program.nodes[node].ops ) {
+                            if ( op.code != OP_ITEMS )
+                                continue;
+                            size_t const child = count < op.nodes.size()
+                                    ? op.nodes[count]
+                                    : op.n
+                                    ;
+                            if ( child != npos )
+                                children.push_back( child );
+                        }
+                    }
+                    if ( children.empty() )
+                        reader.skip_value();
+                    else if ( not in( to_string( count ), check( children ) ) )
+                        return false;
+                    ++count;
+                }
+                for ( size_t node : set ) {
+                    for ( auto &&op : program.nodes[node].ops ) {
+                        if ( op.code == OP_MIN_ITEMS && count < op.n )
+                            return fail( op.code, "Array has too few items" );
+                        if ( op.code == OP_MAX_ITEMS && count > op.n )
+                            return fail( op.code, "Array has too many items" );
+                    }
+                }
+                return true;
+            }
+
+            bool check_object( vector<size_t> const &set ) {
+                // Members arrive unsorted: required names are marked off.
+                vector<pair<Op const *, vector<bool>>> required;
+                for ( size_t node : set ) {
+                    for ( auto &&op : program.nodes[node].ops ) {
+                        if ( op.code == OP_REQUIRED )
+                            required.emplace_back( &op,
+                                    vector<bool>( op.keyed.size() ) );
+                    }
+                }
+                reader.enter_object();
+                size_t count = 0;
+                string key;
+                vector<size_t> children;
+                while ( reader.next_key( key ) ) {
+                    ++count;
+                    children.clear();
+                    for ( size_t node : set ) {
+                        for ( auto &&op : program.nodes[node].ops ) {
+                            if ( op.code == OP_PROPERTIES )
+                                add_property_nodes( op, key, children );
+                        }
+                    }
+                    for ( auto &&r : required ) {
+                        auto const &names = r.first->keyed;
+                        auto const found = std::lower_bound( names.begin(),
+                                names.end(), key,
+                                []( pair<string, size_t> const &name,
+                                    string const &k ) {
+                                    return name.first < k;
+                                } );
+                        if ( found != names.end() && found->first == key )
+                            r.second[ size_t( found - names.begin() ) ] = true;
+                    }
+                    if ( children.empty() )
+                        reader.skip_value();
+                    else if ( not in( key, check( children ) ) )
+                        return false;
+                }
+                for ( auto &&r : required ) {
+                    for ( size_t i = 0; i != r.second.size(); ++i ) {
+                        if ( not r.second[i] )
+                            return fail( OP_REQUIRED, "Missing required property \""
+                                    + r.first->keyed[i].first + "\"" );
+                    }
+                }
+                for ( size_t node : set ) {
+                    for ( auto &&op : program.nodes[node].ops ) {
+                        if ( op.code == OP_MIN_PROPERTIES && count < op.n )
+                            return fail( op.code, "Object has too few properties" );
+                        if ( op.code == OP_MAX_PROPERTIES && count > op.n )
+                            return fail( op.code, "Object has too many properties" );
+                    }
+                }
+                return true;
+            }
+
+            void add_property_nodes(
+                    Op const &op,
+                    string const &key,
+                    vector<size_t> &children
+                    ) const {
+                bool matched = false;
+                auto const found = std::lower_bound( op.keyed.begin(),
+                        op.keyed.end(), key,
+                        []( pair<string, size_t> const &property,
+                            string const &k ) {
+                            return property.first < k;
+                        } );
+                if ( found != op.keyed.end() && found->first == key ) {
+                    matched = true;
+                    children.push_back( found->second );
+                }
+                for ( size_t i = 0; i != op.nodes.size(); i += 2 ) {
+                    if ( std::regex_search( key, program.regexes[ op.nodes[i] ] ) ) {
+                        matched = true;
+                        children.push_back( op.nodes[i + 1] );
+                    }
+                }
+                if ( not matched && op.n != npos )
+                    children.push_back( op.n );
+            }
+        };
+
+        void report( Failure const &failure, SchemaViolation &violation ) {
+            violation.instance_path.clear();
+            for ( auto segment = failure.path.rbegin();
+                    segment != failure.path.rend(); ++segment ) {
+                violation.instance_path.push_back( '/' );
+                violation.instance_path += escape_token( *segment );
+            }
+            violation.keyword = failure.type ? "type" : keyword_name( failure.code );
+            violation.message = failure.message;
+        }
+    }
+
+    CompiledSchema::CompiledSchema( Json const &schema )
+    {
+        Compiler compiler( schema );
+        compiler.compile( schema );
+        compiler.check_loops();
+        m_program = make_shared<Program const>( std::move(compiler.program) );
+    }
+
+    bool CompiledSchema::validate(
+            Json const &instance,
+            SchemaViolation *violation
+            ) const
+    {
+        Failure failure;
+        Validator validator{ *m_program, violation ? &failure : nullptr };
+        if ( validator.check( 0, instance ) )
+            return true;
+        if ( violation )
+            report( failure, *violation );
+        return false;
+    }
+
+    bool CompiledSchema::validate(
+            JsonReader &reader,
+            SchemaViolation *violation
+            ) const
+    {
+        Failure failure;
+        StreamValidator validator{
+            *m_program, violation ? &failure : nullptr, reader };
+        if ( validator.check( { 0 } ) )
+            return true;
+        if ( violation )
+            report( failure, *violation );
+        return false;
+    }
+
+    size_t CompiledSchema::size() const
+    {
+        return m_program->nodes.size();
+    }
+
+}
+// vi: et ts=4 sts=4 sw=4
@@ -0,0 +1,119 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#ifndef JSRL_SCHEMA_HPP_0B7E4D29C8A1F653E9D2B4A07C1F8E56
+#define JSRL_SCHEMA_HPP_0B7E4D29C8A1F653E9D2B4A07C1F8E56
+
+#include "jsrl.hpp"
+#include "jsrl_reader.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+/*! @file jsrl_schema.hpp
+ *  @brief JSON Schema validation.
+ */
+namespace jsrl {
+    using std::shared_ptr;
+    using std::string;
+
+    /*! @brief  Error thrown for a schema that can't be compiled.
+     */
+    struct SchemaError : Json::Error {
+        explicit SchemaError( string const &msg ) : Error( msg ) { }
+    protected:
+        char const *v_failtag() const override { return "JSON Schema Error"; }
+    };
+
+    /*! @brief  Where and why an instance failed validation.
+     */
+    struct SchemaViolation {
+        string instance_path;   //!< JSON Pointer to the failing value.
+        string keyword;         //!< Schema keyword that failed.
+        string message;         //!< Description of the failure.
+    };
+
+    /*! @brief  JSON Schema compiled for repeated validation.
+     *
+     *  The schema is compiled once into a flat table of nodes,
+     *  each holding the checks of one subschema;
+     *  every @c $ref is resolved to a node index while compiling,
+     *  and @c properties and @c required lists are kept sorted
+     *  so that they are matched against an object's (sorted) members
+     *  in a single merge pass.
+     *
+     *  The supported subset of draft 2020-12 is:
+     *  @c type, @c enum, @c const;
+     *  @c minimum, @c maximum, @c exclusiveMinimum, @c exclusiveMaximum,
+     *  @c multipleOf;
+     *  @c minLength, @c maxLength, @c pattern;
+     *  @c prefixItems, @c items, @c minItems, @c maxItems, @c uniqueItems;
+     *  @c properties, @c patternProperties, @c additionalProperties,
+     *  @c required, @c minProperties, @c maxProperties;
+     *  @c allOf, @c anyOf, @c oneOf, @c not;
+     *  boolean schemas, and @c $ref to JSON Pointers or @c $anchor names
+     *  within the same document (@c $defs included).
+     *  Other keywords are ignored.
+     *
+     *  Numbers are compared exactly by value,
+     *  so unlike @c Json comparison, @c 1 and @c 1.0 are equal.
+     *  A compiled schema is immutable,
+     *  so one can validate from several threads at once,
+     *  and copies share the compiled table.
+     */
+    struct CompiledSchema {
+        /*! @brief  Compile a schema document.
+         *
+         *  @throw SchemaError  The schema is malformed,
+         *                      has a @c $ref that can't be resolved,
+         *                      or has @c $ref (or @c allOf and the like)
+         *                      looping back without descending.
+         */
+        explicit
+        CompiledSchema( Json const &schema );
+
+        /*! @brief  Validate a parsed value.
+         *
+         *  @param[out] violation   If given, describes the first failure.
+         */
+        bool validate(
+                Json const &instance,
+                SchemaViolation *violation = nullptr
+                ) const;
+
+        /*! @brief  Validate the next value of a reader, as it is read.
+         *
+         *  Objects and arrays are checked member by member
+         *  without being built as @c Json values,
+         *  except for subtrees under keywords that need the whole value
+         *  (@c enum, @c const, @c uniqueItems, @c anyOf, @c oneOf, @c not).
+         *  On success the whole value has been read;
+         *  on failure the reader is left within the value.
+         *
+         *  @throw Json::ParseError The input isn't valid JSON.
+         */
+        bool validate(
+                JsonReader &reader,
+                SchemaViolation *violation = nullptr
+                ) const;
+
+        /*! @brief  Number of compiled subschemas. */
+        std::size_t size() const;
+
+        struct Program;
+    private:
+        shared_ptr<Program const> m_program;
+    };
+
+}
+#endif
+// vi: et ts=4 sts=4 sw=4
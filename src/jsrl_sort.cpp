@@ -0,0 +1,346 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#include "jsrl_sort.hpp"
+#include "jsrl_impl_util.hpp"
+#include "jsrl_ndjson.hpp"
+#include "jsrl_predicate.hpp"
+#include "jsrl_queue.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <system_error>
+#include <thread>
+
+namespace jsrl {
+    namespace fs = std::filesystem;
+    using std::atomic;
+    using std::memory_order_acquire;
+    using std::memory_order_release;
+    using std::string_view;
+    using std::system_error;
+    using std::unique_ptr;
+    using std::vector;
+
+    namespace {
+        using Key = vector<Json>;
+
+        int compare_keys( Key const &lhs, Key const &rhs, vector<SortKey> const &keys ) {
+            for ( size_t i = 0; i != keys.size(); ++i ) {
+                int const order = lhs[i] < rhs[i] ? -1 : rhs[i] < lhs[i] ? 1 : 0;
+                if ( order != 0 )
+                    return keys[i].descending ? -order : order;
+            }
+            return 0;
+        }
+
+        vector<JsonPointer> key_paths( vector<SortKey> const &keys ) {
+            vector<JsonPointer> paths;
+            for ( auto &&key : keys )
+                paths.push_back( key.path );
+            return paths;
+        }
+
+        size_t thread_count( SortOptions const &options ) {
+            if ( options.threads )
+                return options.threads;
+            return std::max( 1u, std::thread::hardware_concurrency() );
+        }
+
+        void write_record( std::ostream &out, string_view text ) {
+            out.write( text.data(), std::streamsize( text.size() ) );
+            out.put( '\n' );
+        }
+
+        struct KeyedRecord {
+            Key key;
+            string_view text;
+        };
+
+        // The records of an NDJSON chunk, sorted by key,
+        // in input order where keys are equal.
+        vector<KeyedRecord> sort_chunk(
+                string_view chunk,
+                RecordScanner &scanner,
+                vector<SortKey> const &keys,
+                bool skip_invalid,
+                uint64_t &invalid
+                ) {
+            vector<KeyedRecord> records;
+            while ( not chunk.empty() ) {
+                size_t const end = chunk.find( '\n' );
+                KeyedRecord record{ Key(), chunk.substr( 0, end ) };
+                chunk.remove_prefix( end == string_view::npos ? chunk.size() : end + 1 );
+                try {
+                    scanner.match( record.text, &record.key );
+                } catch ( Json::ParseError const & ) {
+                    if ( not skip_invalid )
+                        throw;
+                    ++invalid;
+                    continue;
+                }
+                records.push_back( std::move(record) );
+            }
+            std::stable_sort( records.begin(), records.end(),
+                    [&]( KeyedRecord const &lhs, KeyedRecord const &rhs ) {
+                        return compare_keys( lhs.key, rhs.key, keys ) < 0;
+                    } );
+            return records;
+        }
+
+        // A sorted run, in a file removed along with it.
+        using RunFile = TempFile;
+        using RunPtr = unique_ptr<RunFile>;
+
+        // Write a run with write( ostream & ); returns the bytes written.
+        template<typename Write>
+        uint64_t spill( RunFile const &run, Write &&write ) {
+            std::ofstream out( run.path, std::ios::binary | std::ios::trunc );
+            if ( not out ) {
+                throw system_error( errno, std::generic_category(),
+                        "Cannot write " + run.path.string() );
+            }
+            write( out );
+            auto const bytes = out.tellp();
+            if ( not out.flush() ) {
+                throw system_error( std::make_error_code( std::errc::io_error ),
+                        "Cannot write " + run.path.string() );
+            }
+            return uint64_t( bytes );
+        }
+
+        std::filebuf &open_run( std::filebuf &file, fs::path const &path ) {
+            if ( not file.open( path, std::ios::in | std::ios::binary ) ) {
+                throw system_error( errno, std::generic_category(),
+                        "Cannot read " + path.string() );
+            }
+            return file;
+        }
+
+        // Reads a run back a record at a time, with the record's key.
+        struct RunCursor {
+            explicit
+            RunCursor( fs::path const &path )
+                : reader( open_run( file, path ) )
+            { }
+
+            bool next( RecordScanner &scanner ) {
+                if ( not reader.next( text ) )
+                    return false;
+                scanner.match( text, &key );
+                return true;
+            }
+
+            std::filebuf file;
+            NdjsonReader reader;
+            string_view text;
+            Key key;
+        };
+
+        // Merge runs into out; where keys are equal,
+        // records of earlier runs come first.
+        uint64_t merge_runs(
+                vector<RunFile const *> const &runs,
+                std::ostream &out,
+                vector<SortKey> const &keys,
+                Json::ParseOptions const &parse_options
+                ) {
+            // Runs hold only valid records, so there's no need to check.
+            RecordScanner scanner( {}, key_paths( keys ), false, parse_options );
+            vector<unique_ptr<RunCursor>> cursors;
+            vector<size_t> heap;
+            for ( auto &&run : runs ) {
+                cursors.push_back( std::make_unique<RunCursor>( run->path ) );
+                if ( cursors.back()->next( scanner ) )
+                    heap.push_back( cursors.size() - 1 );
+            }
+            // The least key on top of the heap.
+            auto later = [&]( size_t lhs, size_t rhs ) {
+                int const order = compare_keys( cursors[lhs]->key, cursors[rhs]->key, keys );
+                return order > 0 || ( order == 0 && lhs > rhs );
+            };
+            std::make_heap( heap.begin(), heap.end(), later );
+            uint64_t written = 0;
+            while ( not heap.empty() ) {
+                std::pop_heap( heap.begin(), heap.end(), later );
+                RunCursor &cursor = *cursors[ heap.back() ];
+                write_record( out, cursor.text );
+                ++written;
+                if ( cursor.next( scanner ) )
+                    std::push_heap( heap.begin(), heap.end(), later );
+                else
+                    heap.pop_back();
+            }
+            return written;
+        }
+
+        void check_output( std::ostream &output ) {
+            if ( not output.flush() ) {
+                throw system_error( std::make_error_code( std::errc::io_error ),
+                        "Cannot write sorted output" );
+            }
+        }
+    }
+
+    SortStats sort_ndjson(
+            std::streambuf &input,
+            std::ostream &output,
+            vector<SortKey> const &keys,
+            SortOptions const &options
+            )
+    {
+        SortStats stats;
+        NdjsonReader reader( input );
+        string first, second;
+        reader.next_chunk( first, options.run_bytes );
+        if ( reader.next_chunk( second, options.run_bytes ) == 0 ) {
+            // One run: no need for temporary files.
+            RecordScanner scanner( {}, key_paths( keys ), true, options.parse_options );
+            for ( auto &&record : sort_chunk( first, scanner, keys,
+                        options.skip_invalid, stats.invalid ) ) {
+                write_record( output, record.text );
+                ++stats.records;
+            }
+            check_output( output );
+            return stats;
+        }
+
+        struct Chunk {
+            size_t sequence;
+            string text;
+        };
+        size_t const count = thread_count( options );
+        TempFileNamer temp( options.temp_directory, "jsrl-sort", ".ndjson" );
+        BoundedQueue<Chunk> queue( count );
+        atomic<bool> done{ false };
+        atomic<uint64_t> invalid{ 0 };
+        atomic<uint64_t> spilled{ 0 };
+        FirstError errors;
+        std::mutex mutex;
+        vector<RunPtr> runs;    // In input order.
+
+        auto sort_run = [&]( RecordScanner &scanner, Chunk const &chunk ) {
+            uint64_t bad = 0;
+            auto const records = sort_chunk( chunk.text, scanner, keys,
+                    options.skip_invalid, bad );
+            RunPtr run = temp.make();
+            spilled += spill( *run, [&]( std::ostream &out ) {
+                    for ( auto &&record : records )
+                        write_record( out, record.text );
+                } );
+            invalid += bad;
+            std::lock_guard<std::mutex> lock( mutex );
+            if ( runs.size() <= chunk.sequence )
+                runs.resize( chunk.sequence + 1 );
+            runs[ chunk.sequence ] = std::move(run);
+        };
+        auto work = [&] {
+            RecordScanner scanner( {}, key_paths( keys ), true, options.parse_options );
+            Chunk chunk;
+            unsigned spins = 0;
+            try {
+                while ( not errors.any() ) {
+                    if ( queue.try_pop( chunk ) ) {
+                        sort_run( scanner, chunk );
+                        spins = 0;
+                    } else if ( done.load( memory_order_acquire ) ) {
+                        // Anything pushed before "done" is in the queue by now.
+                        if ( not queue.try_pop( chunk ) )
+                            return;
+                        sort_run( scanner, chunk );
+                    } else {
+                        back_off( spins );
+                    }
+                }
+            } catch ( ... ) {
+                errors.capture();
+            }
+        };
+        vector<std::thread> workers;
+        auto join = [&] {
+            done.store( true, memory_order_release );
+            for ( auto &&worker : workers )
+                worker.join();
+            workers.clear();
+        };
+        try {
+            for ( size_t i = 0; i != count; ++i )
+                workers.emplace_back( work );
+            size_t sequence = 0;
+            auto push = [&]( string &text ) {
+                Chunk chunk{ sequence++, std::move(text) };
+                unsigned spins = 0;
+                while ( not queue.try_push( chunk ) && not errors.any() )
+                    back_off( spins );
+                text.clear();
+            };
+            push( first );
+            push( second );
+            string text;
+            while ( not errors.any() && reader.next_chunk( text, options.run_bytes ) )
+                push( text );
+        } catch ( ... ) {
+            join();
+            throw;
+        }
+        join();
+        errors.rethrow();
+        stats.runs = runs.size();
+
+        // Merge runs into fewer, longer runs until one merge will do.
+        size_t const width = std::max<size_t>( 2, options.merge_width );
+        while ( runs.size() > width ) {
+            vector<RunPtr> merged( ( runs.size() + width - 1 ) / width );
+            atomic<size_t> next{ 0 };
+            auto merge_group = [&] {
+                try {
+                    for ( size_t group; ( group = next++ ) < merged.size()
+                            && not errors.any(); ) {
+                        vector<RunFile const *> group_runs;
+                        for ( size_t i = group * width;
+                                i != std::min( runs.size(), ( group + 1 ) * width ); ++i )
+                            group_runs.push_back( runs[i].get() );
+                        RunPtr run = temp.make();
+                        spilled += spill( *run, [&]( std::ostream &out ) {
+                                merge_runs( group_runs, out, keys, options.parse_options );
+                            } );
+                        merged[ group ] = std::move(run);
+                    }
+                } catch ( ... ) {
+                    errors.capture();
+                }
+            };
+            for ( size_t i = 0; i != std::min( count, merged.size() ); ++i )
+                workers.emplace_back( merge_group );
+            join();
+            errors.rethrow();
+            runs = std::move(merged);
+            ++stats.merge_passes;
+        }
+
+        vector<RunFile const *> last;
+        for ( auto &&run : runs )
+            last.push_back( run.get() );
+        stats.records = merge_runs( last, output, keys, options.parse_options );
+        check_output( output );
+        stats.invalid = invalid;
+        stats.spilled_bytes = spilled;
+        return stats;
+    }
+
+}
+// vi: et ts=4 sts=4 sw=4
@@ -0,0 +1,107 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#ifndef JSRL_SORT_HPP_8B3E51D0A7C94F26B1E8D3A5907C4E1F
+#define JSRL_SORT_HPP_8B3E51D0A7C94F26B1E8D3A5907C4E1F
+
+#include "jsrl.hpp"
+#include "jsrl_pointer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+/*! @file jsrl_sort.hpp
+ *  @brief Sorting NDJSON larger than memory.
+ */
+namespace jsrl {
+    using std::size_t;
+    using std::string;
+    using std::uint64_t;
+
+    /*! @brief  A path records are ordered by.
+     *
+     *  Values compare as @c Json values do; a missing value reads as null.
+     */
+    struct SortKey {
+        JsonPointer path;
+        bool descending = false;
+    };
+
+    /*! @brief  How @ref sort_ndjson sorts.
+     */
+    struct SortOptions {
+        size_t threads = 0;             //!< Run-sorting threads (0: one per core).
+        /*! @brief  NDJSON bytes each thread sorts in memory at once.
+         *
+         *  Memory use is about twice this per thread.
+         *  Input no larger than this is sorted without temporary files.
+         */
+        size_t run_bytes = 64 << 20;
+        size_t merge_width = 64;        //!< Runs merged at once (at least 2).
+        string temp_directory;          //!< Where runs are spilled
+                                        //!< (empty: the system's).
+        bool skip_invalid = false;      //!< Count bad records instead of throwing.
+        /*! @brief  How key values are read; with @c use_GN_for_floats,
+         *          numbers compare exactly as written.
+         */
+        Json::ParseOptions parse_options = Json::ParseOptions( false );
+    };
+
+    /*! @brief  What a sort did.
+     */
+    struct SortStats {
+        uint64_t records = 0;       //!< Records written.
+        uint64_t invalid = 0;       //!< Bad records skipped.
+        uint64_t runs = 0;          //!< Sorted runs spilled to disk.
+        uint64_t merge_passes = 0;  //!< Merges of runs into longer runs,
+                                    //!< before the final one.
+        uint64_t spilled_bytes = 0; //!< Bytes written to temporary files.
+    };
+
+    /*! @brief  Sort NDJSON records by the values at @c keys.
+     *
+     *  Input is cut into runs that threads sort in memory,
+     *  on keys read from each record with a @ref RecordScanner,
+     *  and spill to temporary files; the runs are then merged,
+     *  @c merge_width at a time, into @c output.
+     *  Keys compare in order, each like @c Json::operator<,
+     *  so numbers order by value and strings by their bytes.
+     *  The sort is stable: records with equal keys keep their input order.
+     *  Records are written as they were read, one per line.
+     *  Temporary files are removed, even when an error is thrown.
+     *
+     *  Example:
+     *  @code
+     *      std::ifstream in( "events.ndjson", std::ios::binary );
+     *      std::ofstream out( "sorted.ndjson", std::ios::binary );
+     *      sort_ndjson( *in.rdbuf(), out,
+     *              { { JsonPointer( "/user" ) },
+     *                { JsonPointer( "/time" ), true } } );
+     *  @endcode
+     *
+     *  @throw Json::ParseError A record isn't valid JSON
+     *                          (unless @c skip_invalid).
+     *  @throw std::system_error A temporary file can't be written or read.
+     */
+    SortStats sort_ndjson(
+            std::streambuf &input,
+            std::ostream &output,
+            std::vector<SortKey> const &keys,
+            SortOptions const &options = SortOptions()
+            );
+
+}
+#endif
+// vi: et ts=4 sts=4 sw=4
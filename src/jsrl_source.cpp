@@ -0,0 +1,396 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#include "jsrl_source.hpp"
+#include "jsrl_impl_util.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <ostream>
+#include <sstream>
+#include <vector>
+
+namespace jsrl {
+    using std::make_shared;
+    using std::nullopt;
+    using std::ostringstream;
+    using std::sort;
+    using std::vector;
+
+    SourceMap::SourceMap(
+            shared_ptr<SourceMap const> base,
+            SourceSpan replaced,
+            ptrdiff_t delta
+            )
+        : m_base( std::move(base) )
+        , m_replaced( replaced )
+        , m_delta( delta )
+        , m_depth( m_base->depth() + 1 )
+    { }
+
+    void SourceMap::add( Json const &element, SourceSpan span )
+    {
+        m_entries.insert_or_assign( element.identity(), Entry{ element, span } );
+    }
+
+    optional<SourceSpan> SourceMap::find( Json const &element ) const
+    {
+        auto found = m_entries.find( element.identity() );
+        if ( found != m_entries.end() )
+            return found->second.span;
+        if ( not m_base )
+            return nullopt;
+        auto span = m_base->find( element );
+        if ( not span )
+            return span;
+        if ( span->begin < m_replaced.end && span->end > m_replaced.begin )
+            return nullopt;
+        if ( span->begin >= m_replaced.end ) {
+            span->begin += m_delta;
+            span->end += m_delta;
+        }
+        return span;
+    }
+
+    namespace {
+
+        struct SourceMapSink final : ParseSpanSink {
+            explicit SourceMapSink( SourceMap &spans, size_t offset = 0 )
+                : m_spans( spans )
+                , m_offset( offset )
+            { }
+
+            void element_span(
+                    Json const &element,
+                    size_t begin,
+                    size_t end
+                    ) override {
+                m_spans.add( element,
+                        SourceSpan{ m_offset + begin, m_offset + end } );
+            }
+
+        private:
+            SourceMap &m_spans;
+            size_t const m_offset;
+        };
+
+        // Layers deeper than this are flattened, to bound lookup cost.
+        size_t const max_source_map_depth = 16;
+
+        void copy_spans(
+                SourceMap &flat,
+                SourceMap const &layered,
+                Json const &element
+                ) {
+            if ( auto span = layered.find( element ) )
+                flat.add( element, *span );
+            if ( element.is_array() ) {
+                for ( auto &&child : element.as_array() )
+                    copy_spans( flat, layered, child );
+            } else if ( element.is_object() ) {
+                for ( auto &&[key, child] : element.as_object() )
+                    copy_spans( flat, layered, child );
+            }
+        }
+
+        // A container on the path from the root to an edit.
+        struct EditFrame {
+            Json container;
+            SourceSpan span;
+            size_t child;   // Index of the next frame's container.
+        };
+
+        bool span_encloses( SourceSpan const &span, SourceEdit const &edit ) {
+            // The brackets themselves must be untouched.
+            return span.begin < edit.begin && edit.end < span.end;
+        }
+
+        vector<EditFrame> find_edit_path(
+                Json const &root,
+                SourceMap const &spans,
+                SourceEdit const &edit
+                ) {
+            vector<EditFrame> path;
+            Json const *container = &root;
+            optional<SourceSpan> span = spans.find( root );
+            while ( span && span_encloses( *span, edit )
+                    && ( container->is_array() || container->is_object() ) ) {
+                path.push_back( EditFrame{ *container, *span, 0 } );
+                EditFrame &frame = path.back();
+                size_t const count = container->is_array()
+                        ? container->as_array().size()
+                        : container->as_object().size();
+                container = nullptr;
+                for ( size_t i = 0; i != count; ++i ) {
+                    Json const &child = frame.container.is_array()
+                            ? frame.container.as_array()[i]
+                            : frame.container.as_object()[i].second;
+                    if ( not child.is_array() && not child.is_object() )
+                        continue;
+                    auto child_span = spans.find( child );
+                    if ( child_span && span_encloses( *child_span, edit ) ) {
+                        frame.child = i;
+                        container = &child;
+                        span = child_span;
+                        break;
+                    }
+                }
+                if ( not container )
+                    break;
+            }
+            return path;
+        }
+
+        Json replace_child(
+                Json const &container,
+                size_t index,
+                Json child
+                ) {
+            if ( container.is_array() ) {
+                Json::ArrayBody body = container.as_array();
+                body[index] = std::move(child);
+                return Json( std::move(body) );
+            }
+            Json::ObjectBody body = container.as_object();
+            body[index].second = std::move(child);
+            return Json( std::move(body) );
+        }
+
+        // Writes an edited document, walking it in parallel with the
+        // original element found at the same path (where there is one).
+        struct Splicer {
+            string_view text;
+            SourceMap const &spans;
+            ostream &os;
+            Json::EncodeOptions options;
+
+            void write( Json const &edited, Json const *original ) {
+                if ( auto span = spans.find( edited ) ) {
+                    p_copy( span->begin, span->end );
+                    return;
+                }
+                if ( original ) {
+                    auto span = spans.find( *original );
+                    if ( span && p_splice_in_place( edited, *original, *span ) )
+                        return;
+                }
+                switch ( edited.get_typetag( false ) ) {
+                case Json::TT_OBJECT:
+                    p_write_object( edited, original );
+                    break;
+                case Json::TT_ARRAY:
+                    p_write_array( edited, original );
+                    break;
+                default:
+                    os << Json::OptionedWrite( edited, options );
+                    break;
+                }
+            }
+
+        private:
+            struct Piece {
+                SourceSpan span;
+                Json const *edited;
+                Json const *original;
+            };
+
+            void p_copy( size_t begin, size_t end ) {
+                os.write( text.data() + begin,
+                        static_cast<std::streamsize>( end - begin ) );
+            }
+
+            // A container with the same keys (or length) as the original
+            // is rewritten over the original text, so that the whitespace
+            // and member order between the children survive.
+            bool p_splice_in_place(
+                    Json const &edited,
+                    Json const &original,
+                    SourceSpan const &span
+                    ) {
+                vector<Piece> pieces;
+                if ( edited.is_object() && original.is_object() ) {
+                    auto &&edited_body = edited.as_object();
+                    auto &&original_body = original.as_object();
+                    if ( edited_body.size() != original_body.size() )
+                        return false;
+                    pieces.reserve( edited_body.size() );
+                    for ( size_t i = 0; i != edited_body.size(); ++i ) {
+                        if ( edited_body[i].first != original_body[i].first )
+                            return false;
+                        if ( not p_add_piece( pieces, edited_body[i].second,
+                                    original_body[i].second ) )
+                            return false;
+                    }
+                } else if ( edited.is_array() && original.is_array() ) {
+                    auto &&edited_body = edited.as_array();
+                    auto &&original_body = original.as_array();
+                    if ( edited_body.size() != original_body.size() )
+                        return false;
+                    pieces.reserve( edited_body.size() );
+                    for ( size_t i = 0; i != edited_body.size(); ++i ) {
+                        if ( not p_add_piece( pieces, edited_body[i],
+                                    original_body[i] ) )
+                            return false;
+                    }
+                } else {
+                    return false;
+                }
+                sort( pieces.begin(), pieces.end(),
+                        []( Piece const &lhs, Piece const &rhs ) {
+                            return lhs.span.begin < rhs.span.begin;
+                        } );
+                size_t position = span.begin;
+                for ( auto &&piece : pieces ) {
+                    p_copy( position, piece.span.begin );
+                    write( *piece.edited, piece.original );
+                    position = piece.span.end;
+                }
+                p_copy( position, span.end );
+                return true;
+            }
+
+            bool p_add_piece(
+                    vector<Piece> &pieces,
+                    Json const &edited,
+                    Json const &original
+                    ) {
+                auto span = spans.find( original );
+                if ( not span )
+                    return false;
+                pieces.push_back( Piece{ *span, &edited, &original } );
+                return true;
+            }
+
+            void p_write_object( Json const &edited, Json const *original ) {
+                if ( original && ! original->is_object() )
+                    original = nullptr;
+                os << '{';
+                bool first = true;
+                for ( auto &&[key, value] : edited.as_object() ) {
+                    if ( not first )
+                        os << ',';
+                    first = false;
+                    Json::write_JSON_string( os, key,
+                            options.fail_bad_utf8, options.write_utf );
+                    os << ':';
+                    write( value, original ? original->find_key( key ) : nullptr );
+                }
+                os << '}';
+            }
+
+            void p_write_array( Json const &edited, Json const *original ) {
+                if ( original && ! original->is_array() )
+                    original = nullptr;
+                os << '[';
+                auto &&body = edited.as_array();
+                for ( size_t i = 0; i != body.size(); ++i ) {
+                    if ( i )
+                        os << ',';
+                    write( body[i], original ? original->find_key( i ) : nullptr );
+                }
+                os << ']';
+            }
+        };
+
+    }
+
+    SourceDocument::SourceDocument(
+            string_view text,
+            Json::ParseOptions parse_options
+            )
+        : m_text( text )
+        , m_parse_options( parse_options )
+    {
+        auto spans = make_shared<SourceMap>();
+        SourceMapSink sink( *spans );
+        m_root = parse_json_with_spans( text.data(), text.data() + text.size(),
+                parse_options, sink );
+        m_spans = std::move(spans);
+    }
+
+    SourceDocument::SourceDocument(
+            string_view text,
+            Json root,
+            shared_ptr<SourceMap const> spans,
+            Json::ParseOptions parse_options
+            )
+        : m_text( text )
+        , m_root( std::move(root) )
+        , m_spans( std::move(spans) )
+        , m_parse_options( parse_options )
+    { }
+
+    void SourceDocument::write_spliced(
+            ostream &os,
+            Json const &edited,
+            Json::EncodeOptions encode_options
+            ) const
+    {
+        Splicer{ m_text, *m_spans, os, encode_options }.write( edited, &m_root );
+    }
+
+    string SourceDocument::encode_spliced( Json const &edited ) const
+    {
+        ostringstream os;
+        write_spliced( os, edited );
+        return os.str();
+    }
+
+    SourceDocument SourceDocument::reparse(
+            string_view new_text,
+            SourceEdit const &edit
+            ) const
+    {
+        if ( edit.begin > edit.end || edit.end > m_text.size()
+                || new_text.size() != m_text.size() + edit.delta() )
+            throw SourceEditError( "Edit does not match the source text" );
+
+        vector<EditFrame> path = find_edit_path( m_root, *m_spans, edit );
+        while ( not path.empty() ) {
+            SourceSpan const old_span = path.back().span;
+            SourceSpan const new_span
+                    = { old_span.begin, old_span.end + edit.delta() };
+            auto spans = make_shared<SourceMap>( m_spans, old_span, edit.delta() );
+            Json replacement;
+            try {
+                SourceMapSink sink( *spans, new_span.begin );
+                replacement = parse_json_with_spans(
+                        new_text.data() + new_span.begin,
+                        new_text.data() + new_span.end,
+                        m_parse_options, sink );
+            } catch ( Json::ParseError const & ) {
+                // The edit reached past this container; try its parent.
+                path.pop_back();
+                continue;
+            }
+            path.pop_back();
+            while ( not path.empty() ) {
+                EditFrame const &frame = path.back();
+                replacement = replace_child(
+                        frame.container, frame.child, std::move(replacement) );
+                spans->add( replacement, SourceSpan{
+                        frame.span.begin, frame.span.end + edit.delta() } );
+                path.pop_back();
+            }
+            if ( spans->depth() > max_source_map_depth ) {
+                auto flat = make_shared<SourceMap>();
+                copy_spans( *flat, *spans, replacement );
+                spans = std::move(flat);
+            }
+            return SourceDocument(
+                    new_text, std::move(replacement),
+                    std::move(spans), m_parse_options );
+        }
+        return SourceDocument( new_text, m_parse_options );
+    }
+
+}
+// vi: et ts=4 sts=4 sw=4
@@ -0,0 +1,212 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#ifndef JSRL_SOURCE_HPP_6D0B8E2F4A7C19D35E8B1F0A2C4D6E81
+#define JSRL_SOURCE_HPP_6D0B8E2F4A7C19D35E8B1F0A2C4D6E81
+
+#include "jsrl.hpp"
+
+#include <cstddef>
+#include <iosfwd>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/*! @file jsrl_source.hpp
+ *  @brief Source-preserving parsing and re-encoding.
+ *
+ *  A @ref jsrl::SourceDocument remembers where each element of a document
+ *  came from in its source text.
+ *  Edited versions of the document (made with @c mod() or @c set())
+ *  share every untouched element with the original,
+ *  so they can be written out by copying the original bytes
+ *  for anything that didn't change,
+ *  and only encoding the parts that did.
+ *  Whitespace, escape sequences and number spellings are kept
+ *  everywhere outside the edited subtrees.
+ */
+namespace jsrl {
+    using std::optional;
+    using std::ostream;
+    using std::shared_ptr;
+    using std::string;
+    using std::string_view;
+
+    /*! @brief  Byte range of an element within its source text.
+     */
+    struct SourceSpan {
+        size_t begin;   //!< Offset of the element's first byte.
+        size_t end;     //!< Offset one past the element's last byte.
+
+        size_t size() const { return end - begin; }
+    };
+
+    /*! @brief  A replacement of bytes in a source text.
+     *
+     *  Offsets are in the text before the edit.
+     */
+    struct SourceEdit {
+        size_t begin;       //!< Offset of the first replaced byte.
+        size_t end;         //!< Offset one past the last replaced byte.
+        size_t inserted;    //!< Number of bytes written in their place.
+
+        /*! @brief  Change in the length of the text. */
+        ptrdiff_t delta() const {
+            return ptrdiff_t( inserted ) - ptrdiff_t( end - begin );
+        }
+    };
+
+    /*! @brief  Error thrown for an edit that doesn't fit its source text.
+     */
+    struct SourceEditError : Json::Error {
+        explicit SourceEditError( string const &msg ) : Error( msg ) { }
+    protected:
+        char const *v_failtag() const override { return "JSON Source Error"; }
+    };
+
+    /*! @brief  Source spans of parsed elements, looked up by identity.
+     *
+     *  The map holds a handle to every element it describes,
+     *  so identities can't be recycled while the map is alive.
+     *
+     *  A map can be layered over an older one
+     *  after a span of the older text has been replaced:
+     *  spans from the older map that overlap the replaced span are hidden,
+     *  and those after it are shifted by the change in length.
+     */
+    struct SourceMap {
+        SourceMap() = default;
+        /*! @brief  Layer a map over @c base.
+         */
+        SourceMap(
+                shared_ptr<SourceMap const> base,
+                SourceSpan replaced,    //!<[in] Span in @c base coordinates.
+                ptrdiff_t delta         //!<[in] Change in length.
+                );
+
+        /*! @brief  Record the span of an element. */
+        void add( Json const &element, SourceSpan span );
+
+        /*! @brief  Look up the span of an element.
+         *  @retval nullopt The element wasn't recorded.
+         */
+        optional<SourceSpan> find( Json const &element ) const;
+
+        /*! @brief  Number of maps in this layered map. */
+        size_t depth() const { return m_depth; }
+
+    private:
+        struct Entry {
+            Json element;
+            SourceSpan span;
+        };
+        std::unordered_map<void const *, Entry> m_entries;
+        shared_ptr<SourceMap const> m_base;
+        SourceSpan m_replaced = { 0, 0 };
+        ptrdiff_t m_delta = 0;
+        size_t m_depth = 1;
+    };
+
+    /*! @brief  A JSON document parsed from a buffer, with its element spans.
+     *
+     *  The document refers to the source text without copying it;
+     *  the text must outlive the document.
+     *  Copying a @c SourceDocument is cheap (the span map is shared).
+     *
+     *  Example:
+     *  @code
+     *      SourceDocument doc( config_text );
+     *      Json edited = doc.root();
+     *      mod(edited)["server"]["port"] = 8443;
+     *      doc.write_spliced( out, edited );
+     *      // Everything except the "port" value is copied from config_text.
+     *  @endcode
+     */
+    struct SourceDocument {
+        /*! @brief  Parse @c text, recording the span of every element.
+         *
+         *  @throw Json::ParseError Invalid JSON or trailing bytes.
+         */
+        explicit
+        SourceDocument(
+                string_view text,
+                Json::ParseOptions parse_options = Json::ParseOptions(false)
+                );
+
+        string_view text() const { return m_text; }     /*!< @brief Source. */
+        Json const &root() const { return m_root; }     /*!< @brief Parsed. */
+        SourceMap const &spans() const { return *m_spans; } /*!< @brief Map. */
+
+        /*! @brief  Write an edited version of this document.
+         *
+         *  Elements of @c edited that come from this document
+         *  are copied from the source text.
+         *  Containers that were changed are rewritten in place
+         *  (keeping the original bytes between their elements)
+         *  when they still have the same keys or length,
+         *  and are otherwise encoded compactly, element by element,
+         *  with any unchanged elements still copied from the source.
+         */
+        void write_spliced(
+                ostream &os,
+                Json const &edited,
+                Json::EncodeOptions encode_options
+                ) const;
+        /*! @overload */
+        void write_spliced( ostream &os, Json const &edited ) const {
+            write_spliced( os, edited, Json::EncodeOptions(
+                        Json::EncodeOptions::TN_EXACT, false, false ) );
+        }
+
+        /*! @brief  Encode an edited version of this document as a string.
+         */
+        string encode_spliced( Json const &edited ) const;
+
+        /*! @brief  Parse the text that results from an edit of this one.
+         *
+         *  Only the smallest container enclosing the edit is parsed again;
+         *  every element outside it is shared with this document,
+         *  and spans after the edit are shifted rather than recomputed.
+         *  If the edited container no longer parses on its own
+         *  (for instance, a bracket, brace or quote was typed),
+         *  its enclosing containers are tried in turn,
+         *  and finally the whole text.
+         *
+         *  @c new_text is the text of this document with @c edit applied;
+         *  like the original, it must outlive the returned document.
+         *
+         *  @throw SourceEditError  The edit doesn't fit the two texts.
+         *  @throw Json::ParseError The edited text isn't valid JSON.
+         */
+        SourceDocument reparse(
+                string_view new_text,
+                SourceEdit const &edit
+                ) const;
+
+    private:
+        SourceDocument(
+                string_view text,
+                Json root,
+                shared_ptr<SourceMap const> spans,
+                Json::ParseOptions parse_options
+                );
+
+        string_view m_text;
+        Json m_root;
+        shared_ptr<SourceMap const> m_spans;
+        Json::ParseOptions m_parse_options;
+    };
+
+}
+#endif
+// vi: et ts=4 sts=4 sw=4
@@ -0,0 +1,311 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#include "jsrl_tail.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <system_error>
+#include <thread>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#endif
+
+namespace jsrl {
+    using std::system_error;
+    using namespace std::chrono;
+
+    namespace {
+        struct FileState {
+            bool exists;
+            uint64_t device;
+            uint64_t inode;
+            uint64_t size;
+        };
+
+#ifdef _WIN32
+        FileState file_state( struct _stat64 const &st ) {
+            return FileState{ true, uint64_t( st.st_dev ), 0, uint64_t( st.st_size ) };
+        }
+
+        FileState path_state( string const &path ) {
+            struct _stat64 st;
+            if ( ::_stat64( path.c_str(), &st ) != 0 )
+                return FileState{ false, 0, 0, 0 };
+            return file_state( st );
+        }
+
+        FileState fd_state( int fd ) {
+            struct _stat64 st;
+            if ( ::_fstat64( fd, &st ) != 0 )
+                throw system_error( errno, std::generic_category(), "Cannot stat" );
+            return file_state( st );
+        }
+#else
+        FileState file_state( struct stat const &st ) {
+            return FileState{ true, uint64_t( st.st_dev ), uint64_t( st.st_ino ),
+                uint64_t( st.st_size ) };
+        }
+
+        FileState path_state( string const &path ) {
+            struct stat st;
+            if ( ::stat( path.c_str(), &st ) != 0 )
+                return FileState{ false, 0, 0, 0 };
+            return file_state( st );
+        }
+
+        FileState fd_state( int fd ) {
+            struct stat st;
+            if ( ::fstat( fd, &st ) != 0 )
+                throw system_error( errno, std::generic_category(), "Cannot stat" );
+            return file_state( st );
+        }
+#endif
+
+        void seek_to( int fd, uint64_t offset ) {
+#ifdef _WIN32
+            bool const ok = ::_lseeki64( fd, __int64( offset ), SEEK_SET ) >= 0;
+#else
+            bool const ok = ::lseek( fd, off_t( offset ), SEEK_SET ) >= 0;
+#endif
+            if ( not ok )
+                throw system_error( errno, std::generic_category(), "Cannot seek" );
+        }
+
+        bool is_blank( string_view line ) {
+            return line.find_first_not_of( " \t\r" ) == string_view::npos;
+        }
+    }
+
+    NdjsonTailReader::NdjsonTailReader(
+            string path,
+            TailOptions const &options,
+            TailCheckpoint const &resume
+            )
+        : m_path( std::move(path) )
+        , m_options( options )
+        , m_resume( resume )
+    {
+#ifdef __linux__
+        if ( m_options.use_inotify ) {
+            m_inotify = ::inotify_init1( IN_NONBLOCK | IN_CLOEXEC );
+            // Watching the directory also sees the file being replaced.
+            size_t const slash = m_path.rfind( '/' );
+            string const directory = slash == string::npos ? string( "." )
+                    : slash == 0 ? string( "/" )
+                    : m_path.substr( 0, slash )
+                    ;
+            if ( m_inotify >= 0 && ::inotify_add_watch( m_inotify, directory.c_str(),
+                        IN_MODIFY | IN_CREATE | IN_DELETE | IN_MOVED_FROM
+                        | IN_MOVED_TO | IN_CLOSE_WRITE | IN_ATTRIB ) < 0 ) {
+                ::close( m_inotify );
+                m_inotify = -1;
+            }
+        }
+#endif
+        p_check_file();
+    }
+
+    NdjsonTailReader::~NdjsonTailReader()
+    {
+        p_close();
+#ifdef __linux__
+        if ( m_inotify >= 0 )
+            ::close( m_inotify );
+#endif
+    }
+
+    void NdjsonTailReader::p_open( uint64_t offset, bool at_end )
+    {
+#ifdef _WIN32
+        int const fd = ::_open( m_path.c_str(), _O_RDONLY | _O_BINARY );
+#else
+        int const fd = ::open( m_path.c_str(), O_RDONLY | O_CLOEXEC );
+#endif
+        if ( fd < 0 ) {
+            if ( errno == ENOENT )
+                return;
+            throw system_error( errno, std::generic_category(),
+                    "Cannot open " + m_path );
+        }
+        m_fd = fd;
+        FileState const state = fd_state( fd );
+        m_device = state.device;
+        m_inode = state.inode;
+        if ( at_end )
+            offset = state.size;
+        seek_to( fd, offset );
+        m_read_offset = m_consumed = offset;
+        m_buffer.clear();
+        m_begin = 0;
+    }
+
+    void NdjsonTailReader::p_close()
+    {
+        if ( m_fd < 0 )
+            return;
+#ifdef _WIN32
+        ::_close( m_fd );
+#else
+        ::close( m_fd );
+#endif
+        m_fd = -1;
+    }
+
+    // Read what has been appended; false if nothing was.
+    bool NdjsonTailReader::p_read()
+    {
+        size_t const old_size = m_buffer.size();
+        m_buffer.resize( old_size + m_options.block_size );
+        for (;;) {
+#ifdef _WIN32
+            auto const n = ::_read( m_fd, &m_buffer[old_size],
+                    unsigned( m_options.block_size ) );
+#else
+            auto const n = ::read( m_fd, &m_buffer[old_size], m_options.block_size );
+#endif
+            if ( n < 0 && errno == EINTR )
+                continue;
+            if ( n < 0 ) {
+                m_buffer.resize( old_size );
+                throw system_error( errno, std::generic_category(),
+                        "Cannot read " + m_path );
+            }
+            m_buffer.resize( old_size + size_t( n ) );
+            m_read_offset += uint64_t( n );
+            return n > 0;
+        }
+    }
+
+    // Follow the path to a new file, or start over after truncation;
+    // false if nothing changed.
+    bool NdjsonTailReader::p_check_file()
+    {
+        FileState const now = path_state( m_path );
+        if ( m_fd < 0 ) {
+            if ( not now.exists )
+                return false;
+            uint64_t offset = 0;
+            bool at_end = false;
+            if ( m_first_open ) {
+                m_first_open = false;
+                if ( m_resume.inode == now.inode && m_resume.device == now.device
+                        && m_resume.offset <= now.size )
+                    offset = m_resume.offset;
+                else
+                    at_end = m_options.start_at_end;
+            }
+            p_open( offset, at_end );
+            return m_fd >= 0;
+        }
+        if ( now.exists && ( now.device != m_device || now.inode != m_inode ) ) {
+            // Finish the old file, which may still have been written to.
+            if ( p_read() )
+                return true;
+            if ( m_begin != m_buffer.size() ) {
+                m_buffer.push_back( '\n' );
+                return true;
+            }
+            p_close();
+            ++m_rotations;
+            p_open( 0, false );
+            return true;
+        }
+        if ( fd_state( m_fd ).size < m_read_offset ) {
+            ++m_truncations;
+            seek_to( m_fd, 0 );
+            m_read_offset = m_consumed = 0;
+            m_buffer.clear();
+            m_begin = 0;
+            return true;
+        }
+        return false;
+    }
+
+    bool NdjsonTailReader::p_take_line( Json &record )
+    {
+        for (;;) {
+            size_t const newline = m_buffer.find( '\n', m_begin );
+            if ( newline == string::npos ) {
+                // Keep only the partial line.
+                m_buffer.erase( 0, m_begin );
+                m_begin = 0;
+                return false;
+            }
+            string_view line( m_buffer.data() + m_begin, newline - m_begin );
+            uint64_t const offset = m_consumed;
+            m_consumed += line.size() + 1;
+            m_begin = newline + 1;
+            if ( is_blank( line ) )
+                continue;
+            m_record_offset = offset;
+            if ( line.back() == '\r' )
+                line.remove_suffix( 1 );
+            try {
+                record = Json::parse( line );
+            } catch ( Json::ParseError const & ) {
+                if ( not m_options.skip_invalid )
+                    throw;
+                ++m_invalid;
+                continue;
+            }
+            return true;
+        }
+    }
+
+    void NdjsonTailReader::p_wait( milliseconds timeout )
+    {
+#ifdef __linux__
+        if ( m_inotify >= 0 ) {
+            pollfd ready = { m_inotify, POLLIN, 0 };
+            if ( ::poll( &ready, 1, int( timeout.count() ) ) > 0 ) {
+                // Only the wake-up matters, not the events themselves.
+                char events[4096];
+                while ( ::read( m_inotify, events, sizeof events ) > 0 )
+                    ;
+            }
+            return;
+        }
+#endif
+        std::this_thread::sleep_for( timeout );
+    }
+
+    bool NdjsonTailReader::next( Json &record, milliseconds timeout )
+    {
+        auto const deadline = steady_clock::now() + timeout;
+        for (;;) {
+            if ( p_take_line( record ) )
+                return true;
+            if ( m_fd >= 0 && p_read() )
+                continue;
+            if ( p_check_file() )
+                continue;
+            auto const now = steady_clock::now();
+            if ( now >= deadline )
+                return false;
+            p_wait( std::min( ceil<milliseconds>( deadline - now ),
+                        m_options.poll_interval ) );
+        }
+    }
+
+}
+// vi: et ts=4 sts=4 sw=4
@@ -0,0 +1,151 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#ifndef JSRL_TAIL_HPP_8B5E03D7C6A14F92E0B3D71C5A9F2E64
+#define JSRL_TAIL_HPP_8B5E03D7C6A14F92E0B3D71C5A9F2E64
+
+#include "jsrl.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/*! @file jsrl_tail.hpp
+ *  @brief Following NDJSON files as they grow.
+ */
+namespace jsrl {
+    using std::size_t;
+    using std::string;
+    using std::uint64_t;
+
+    /*! @brief  How an @ref NdjsonTailReader follows its file.
+     */
+    struct TailOptions {
+        /*! @brief  Longest wait before looking at the file again.
+         *
+         *  With inotify, changes are seen at once and this only bounds
+         *  how late a missed event is noticed;
+         *  without it, this is the polling interval.
+         */
+        std::chrono::milliseconds poll_interval{ 250 };
+        bool use_inotify = true;    //!< Where available (Linux).
+        bool start_at_end = false;  //!< Skip what the file holds at first.
+        bool skip_invalid = false;  //!< Count bad records instead of throwing.
+        size_t block_size = 64 * 1024;  //!< Bytes read at a time.
+    };
+
+    /*! @brief  Where to resume following a file.
+     *
+     *  The file is identified by device and inode,
+     *  so a checkpoint taken before a rotation isn't applied
+     *  to the new file at the same path.
+     */
+    struct TailCheckpoint {
+        uint64_t device = 0;
+        uint64_t inode = 0;
+        uint64_t offset = 0;    //!< Just past the last record handed out.
+    };
+
+    /*! @brief  Reads records appended to an NDJSON file, like @c "tail -F".
+     *
+     *  A line is handed out once its newline has been written;
+     *  a partial last line waits for the rest.
+     *  The reader copes with:
+     *  - rotation (the path renamed or removed and created anew):
+     *    the old file is read to its end,
+     *    including a last line without a newline,
+     *    before the new one is followed from its start;
+     *  - truncation in place (@c copytruncate):
+     *    reading starts over from the beginning;
+     *  - the file not existing yet.
+     *
+     *  On Linux, inotify on the file's directory wakes the reader
+     *  as soon as anything changes;
+     *  elsewhere, or if inotify can't be used, the file is polled.
+     *
+     *  Example:
+     *  @code
+     *      NdjsonTailReader tail( "/var/log/app.ndjson", {}, saved );
+     *      Json record;
+     *      for (;;) {
+     *          if ( tail.next( record, std::chrono::seconds( 1 ) ) )
+     *              ship( record );
+     *          else
+     *              saved = tail.checkpoint();
+     *      }
+     *  @endcode
+     */
+    struct NdjsonTailReader {
+        /*! @brief  Follow the file at @c path.
+         *
+         *  If @c resume names the file now at @c path,
+         *  reading starts at its offset.
+         */
+        explicit
+        NdjsonTailReader(
+                string path,
+                TailOptions const &options = TailOptions(),
+                TailCheckpoint const &resume = TailCheckpoint()
+                );
+        NdjsonTailReader( NdjsonTailReader const & ) = delete;
+        NdjsonTailReader &operator=( NdjsonTailReader const & ) = delete;
+        ~NdjsonTailReader();
+
+        /*! @brief  Wait up to @c timeout for the next record.
+         *
+         *  @retval false   No record arrived in time.
+         *  @throw Json::ParseError A record isn't valid JSON
+         *                          (unless @c skip_invalid);
+         *                          it is still passed, so reading can go on.
+         *  @throw std::system_error    Reading the file failed.
+         */
+        bool next( Json &record, std::chrono::milliseconds timeout );
+
+        /*! @brief  Offset in its file of the last record's first byte. */
+        uint64_t record_offset() const { return m_record_offset; }
+        /*! @brief  Where to resume to get the records after the last one. */
+        TailCheckpoint checkpoint() const {
+            return TailCheckpoint{ m_device, m_inode, m_consumed };
+        }
+        uint64_t rotations() const { return m_rotations; }     //!< Files switched.
+        uint64_t truncations() const { return m_truncations; } //!< Restarts.
+        uint64_t invalid() const { return m_invalid; }         //!< Bad records skipped.
+
+    private:
+        bool p_take_line( Json &record );
+        bool p_read();
+        bool p_check_file();
+        void p_open( uint64_t offset, bool at_end );
+        void p_close();
+        void p_wait( std::chrono::milliseconds timeout );
+
+        string const m_path;
+        TailOptions const m_options;
+        int m_fd = -1;
+        int m_inotify = -1;
+        uint64_t m_device = 0;
+        uint64_t m_inode = 0;
+        uint64_t m_read_offset = 0;     // File offset of the next read.
+        string m_buffer;                // Read and not yet handed out.
+        size_t m_begin = 0;
+        uint64_t m_record_offset = 0;
+        uint64_t m_consumed = 0;        // File offset of m_buffer[m_begin].
+        bool m_first_open = true;
+        TailCheckpoint m_resume;
+        uint64_t m_rotations = 0;
+        uint64_t m_truncations = 0;
+        uint64_t m_invalid = 0;
+    };
+
+}
+#endif
+// vi: et ts=4 sts=4 sw=4
@@ -0,0 +1,134 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+
+#include "jsrl_test_temp.hpp"
+#include "../src/jsrl_bloom.hpp"
+#include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+    using jsrl::Json;
+    using jsrl::JsonPointer;
+    using jsrl::NdjsonBloomIndex;
+    using jsrl::NdjsonFile;
+    using jsrl::NdjsonIndexError;
+    using std::string;
+    using std::vector;
+
+    // Record i has user "u<i % 500>" and a block-local sequence number.
+    string events( int count ) {
+        string text;
+        for ( int i = 0; i != count; ++i ) {
+            text += "{\"user\":\"u" + std::to_string( i * 7 % 500 )
+                    + "\",\"seq\":" + std::to_string( i ) + "}\n";
+        }
+        return text;
+    }
+
+    NdjsonBloomIndex build( string const &text, uint64_t block_records ) {
+        std::istringstream iss( text );
+        return NdjsonBloomIndex::s_build( *iss.rdbuf(),
+                { JsonPointer( "/user" ), JsonPointer( "/seq" ) }, block_records );
+    }
+}
+
+TEST( JsrlBloom,NoFalseNegatives ) {
+    string const text = events( 2000 );
+    NdjsonBloomIndex const index = build( text, 100 );
+    EXPECT_EQ( 20u, index.blocks() );
+    for ( int i = 0; i != 2000; ++i ) {
+        uint64_t const block = uint64_t( i / 100 );
+        EXPECT_TRUE( index.may_contain( block, JsonPointer( "/seq" ), Json( i ) ) );
+        EXPECT_TRUE( index.may_contain( block, JsonPointer( "/user" ),
+                    Json( "u" + std::to_string( i * 7 % 500 ) ) ) );
+    }
+    EXPECT_THROW( index.may_contain( 0, JsonPointer( "/other" ), Json( 1 ) ),
+            NdjsonIndexError );
+}
+
+TEST( JsrlBloom,FewFalsePositives ) {
+    NdjsonBloomIndex const index = build( events( 2000 ), 100 );
+    size_t hits = 0;
+    // Sequence numbers from other blocks, and values never present.
+    for ( int i = 0; i != 2000; ++i ) {
+        for ( uint64_t block : { 3, 11 } ) {
+            if ( uint64_t( i / 100 ) != block )
+                hits += index.may_contain( block, JsonPointer( "/seq" ), Json( i ) );
+        }
+        hits += index.may_contain( 5, JsonPointer( "/user" ),
+                Json( "x" + std::to_string( i ) ) );
+    }
+    // About 1% of 5800 lookups.
+    EXPECT_LT( hits, 150u );
+}
+
+TEST( JsrlBloom,FindReadsCandidateBlocks ) {
+    TempPath file;
+    string const text = events( 3000 );
+    std::ofstream( file.path, std::ios::binary ) << text;
+    NdjsonBloomIndex const index = build( text, 64 );
+    NdjsonFile const ndjson( file.path );
+
+    auto const ranges = index.candidates( JsonPointer( "/seq" ), Json( 1234 ) );
+    ASSERT_FALSE( ranges.empty() );
+    uint64_t records = 0;
+    for ( auto &&range : ranges )
+        records += range.records;
+    EXPECT_LT( records, 3000u / 4 );
+
+    EXPECT_EQ( ( vector<string>{ "{\"user\":\"u138\",\"seq\":1234}" } ),
+            index.find( ndjson, JsonPointer( "/seq" ), Json( 1234 ) ) );
+    // u7 appears every 500 records.
+    auto const found = index.find( ndjson, JsonPointer( "/user" ), Json( "u7" ) );
+    EXPECT_EQ( 6u, found.size() );
+    EXPECT_TRUE( index.find( ndjson, JsonPointer( "/user" ), Json( "nobody" ) ).empty() );
+}
+
+TEST( JsrlBloom,ValuesCompareByValue ) {
+    TempPath file;
+    string const text = "{\"u\":1e2}\n{\"u\":\"100\"}\n{\"u\":{\"b\":2.0,\"a\":[1]}}\n";
+    std::ofstream( file.path, std::ios::binary ) << text;
+    std::istringstream iss( text );
+    NdjsonBloomIndex const index = NdjsonBloomIndex::s_build( *iss.rdbuf(),
+            { JsonPointer( "/u" ) }, 2 );
+    NdjsonFile const ndjson( file.path );
+    EXPECT_TRUE( index.may_contain( 0, JsonPointer( "/u" ), Json( 100 ) ) );
+    EXPECT_EQ( ( vector<string>{ "{\"u\":1e2}" } ),
+            index.find( ndjson, JsonPointer( "/u" ), Json( 100 ) ) );
+    EXPECT_EQ( 1u, index.find( ndjson, JsonPointer( "/u" ),
+                Json::parse( R"({"a":[1.0],"b":2})" ) ).size() );
+}
+
+TEST( JsrlBloom,SaveLoad ) {
+    NdjsonBloomIndex const index = build( events( 1000 ), 128 );
+    std::stringstream saved;
+    index.save( saved );
+    NdjsonBloomIndex const loaded = NdjsonBloomIndex::s_load( saved );
+    EXPECT_EQ( index.blocks(), loaded.blocks() );
+    EXPECT_EQ( index.paths(), loaded.paths() );
+    EXPECT_EQ( index.offsets().records(), loaded.offsets().records() );
+    for ( uint64_t block = 0; block != index.blocks(); ++block ) {
+        for ( int i = 0; i < 1000; i += 37 ) {
+            EXPECT_EQ( index.may_contain( block, JsonPointer( "/seq" ), Json( i ) ),
+                    loaded.may_contain( block, JsonPointer( "/seq" ), Json( i ) ) );
+        }
+    }
+    std::istringstream truncated( saved.str().substr( 0, saved.str().size() - 5 ) );
+    EXPECT_THROW( NdjsonBloomIndex::s_load( truncated ), NdjsonIndexError );
+    std::istringstream bad_magic( "JSRLNDX1" );
+    EXPECT_THROW( NdjsonBloomIndex::s_load( bad_magic ), NdjsonIndexError );
+}
+
+// vi: et ts=4 sts=4 sw=4
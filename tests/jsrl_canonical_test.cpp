@@ -0,0 +1,136 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+
+#include "../src/jsrl_canonical.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include <string>
+
+namespace {
+    using namespace jsrl::literals;
+    using jsrl::canonical_encode;
+    using jsrl::CanonicalError;
+    using jsrl::Hash64;
+    using jsrl::Json;
+    using jsrl::Sha256;
+    using std::string;
+
+    string sha256_hex( string const &bytes ) {
+        Sha256 sha;
+        sha.update( bytes );
+        return Sha256::s_hex( sha.finish() );
+    }
+}
+
+TEST(JsrlCanonical, Rfc8785Example) {
+    Json const value = Json::parse(
+        R"({"numbers":[333333333.33333329,1E30,4.50,2e-3,0.000000000000000000000000001],)"
+        R"("string":"€$\u000F\u000aA'\u0042\u0022\u005c\\\"\/",)"
+        R"("literals":[null,true,false]})" );
+    EXPECT_EQ( canonical_encode( value ),
+        "{\"literals\":[null,true,false],"
+        "\"numbers\":[333333333.3333333,1e+30,4.5,0.002,1e-27],"
+        "\"string\":\"\xe2\x82\xac$\\u000f\\nA'B\\\"\\\\\\\\\\\"/\"}" );
+}
+
+TEST(JsrlCanonical, Numbers) {
+    auto number = []( char const *text ) {
+        return canonical_encode( Json::parse( text, Json::ParseOptions( true ) ) );
+    };
+    EXPECT_EQ( number( "0" ), "0" );
+    EXPECT_EQ( number( "-0.0" ), "0" );
+    EXPECT_EQ( number( "1.0" ), "1" );
+    EXPECT_EQ( number( "1e0" ), "1" );
+    EXPECT_EQ( number( "-12.5" ), "-12.5" );
+    EXPECT_EQ( number( "1e21" ), "1e+21" );
+    EXPECT_EQ( number( "1e20" ), "100000000000000000000" );
+    EXPECT_EQ( number( "123456789012345678901" ), "123456789012345680000" );
+    EXPECT_EQ( number( "0.000001" ), "0.000001" );
+    EXPECT_EQ( number( "0.0000001" ), "1e-7" );
+    EXPECT_EQ( number( "-1.5e-10" ), "-1.5e-10" );
+    EXPECT_EQ( number( "5e-324" ), "5e-324" );
+    EXPECT_EQ( number( "1.7976931348623157e308" ), "1.7976931348623157e+308" );
+    EXPECT_EQ( number( "9007199254740993" ), "9007199254740992" );
+    EXPECT_EQ( canonical_encode( Json( 0.1 ) ), "0.1" );
+    EXPECT_EQ( canonical_encode( Json( -7 ) ), "-7" );
+    EXPECT_THROW( canonical_encode( Json::parse( "1e400", Json::ParseOptions( true ) ) ),
+            CanonicalError );
+    EXPECT_THROW( canonical_encode( Json( std::numeric_limits<double>::infinity() ) ),
+            CanonicalError );
+}
+
+TEST(JsrlCanonical, KeysInUtf16Order) {
+    // RFC 8785 section 3.2.3: U+1F600, as surrogates, sorts before U+FB33.
+    Json const value = Json::parse(
+        R"({"€":"Euro Sign","\r":"Carriage Return","דּ":"Hebrew Letter Dalet With Dagesh",)"
+        R"("1":"One","😀":"Emoji: Grinning Face","\u0080":"Control",)"
+        R"("ö":"Latin Small Letter O With Diaeresis"})" );
+    string const text = canonical_encode( value );
+    string const values[] = { "Carriage Return", "One", "Control",
+        "Latin Small Letter O With Diaeresis", "Euro Sign",
+        "Emoji: Grinning Face", "Hebrew Letter Dalet With Dagesh" };
+    size_t at = 0;
+    for ( auto &&expected : values ) {
+        size_t const found = text.find( expected );
+        ASSERT_NE( found, string::npos ) << expected;
+        EXPECT_GT( found, at ) << expected;
+        at = found;
+    }
+    EXPECT_EQ( canonical_encode( R"({"b":[{"d":1,"c":2}],"a":{}})"_Json ),
+            R"({"a":{},"b":[{"c":2,"d":1}]})" );
+}
+
+TEST(JsrlCanonical, Sha256) {
+    EXPECT_EQ( sha256_hex( "" ),
+            "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855" );
+    EXPECT_EQ( sha256_hex( "abc" ),
+            "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad" );
+    EXPECT_EQ( sha256_hex( "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq" ),
+            "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1" );
+    // Split across calls in awkward places.
+    string const million( 1000000, 'a' );
+    Sha256 sha;
+    for ( size_t at = 0, step = 1; at < million.size(); at += step, step = step % 97 + 13 )
+        sha.update( std::string_view( million ).substr( at, step ) );
+    EXPECT_EQ( Sha256::s_hex( sha.finish() ),
+            "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0" );
+}
+
+TEST(JsrlCanonical, StreamingHashes) {
+    string items;
+    for ( int i = 0; i != 5000; ++i )
+        items += ( i ? "," : "" ) + std::to_string( i ) + ".50";
+    Json const value = Json::parse( "{\"z\":[" + items + "],\"a\":\"x\"}" );
+    string const text = canonical_encode( value );
+    ASSERT_GT( text.size(), 4096u );    // More than one piece.
+
+    EXPECT_EQ( Sha256::s_hex( jsrl::canonical_sha256( value ) ), sha256_hex( text ) );
+
+    Hash64 whole( 3 );
+    whole.update( text );
+    EXPECT_EQ( jsrl::canonical_hash( value, 3 ), whole.finish() );
+    Hash64 pieces( 3 );
+    for ( size_t at = 0; at < text.size(); at += 5 )
+        pieces.update( std::string_view( text ).substr( at, 5 ) );
+    EXPECT_EQ( pieces.finish(), whole.finish() );
+    EXPECT_NE( jsrl::canonical_hash( value, 4 ), whole.finish() );
+
+    // Equal canonical forms hash alike.
+    EXPECT_EQ( jsrl::canonical_hash( R"({"a":1.0,"b":[1e2]})"_Json ),
+            jsrl::canonical_hash( R"({"b":[100],"a":1})"_Json ) );
+    EXPECT_NE( jsrl::canonical_hash( R"({"a":1})"_Json ),
+            jsrl::canonical_hash( R"({"a":"1"})"_Json ) );
+    EXPECT_NE( Hash64().finish(), [] { Hash64 h; h.update( string( 1, '\0' ) ); return h.finish(); }() );
+}
+
+// vi: et ts=4 sts=4 sw=4
@@ -0,0 +1,124 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+
+#include "Event.hpp"
+#include "Metric.hpp"
+#include "Shapes.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <type_traits>
+
+namespace {
+    using namespace jsrl::literals;
+    using jsrl::Json;
+    using jsrl::decode_fields;
+    using jsrl::encode_fields;
+    using std::string;
+    using codegen_test::Event;
+    using codegen_test::Metric;
+    using codegen_test::Shapes;
+}
+
+TEST( JsrlCodegen,SchemaTypes ) {
+    Event e;
+    static_assert( std::is_same<decltype( e.id ), std::uint64_t>::value, "" );
+    static_assert( std::is_same<decltype( e.offset ), std::int64_t>::value, "" );
+    static_assert( std::is_same<decltype( e.score ),
+            std::optional<double>>::value, "" );
+    static_assert( std::is_same<decltype( e.user ),
+            codegen_test::Event_user>::value, "" );
+    static_assert( std::is_same<decltype( e.user.class_ ), string>::value, "" );
+    static_assert( std::is_same<decltype( e.points ),
+            std::vector<codegen_test::Event_points_item>>::value, "" );
+    static_assert( std::is_same<decltype( e.extra ), Json>::value, "" );
+    static_cast<void>( e );
+}
+
+TEST( JsrlCodegen,Decode ) {
+    Event const e = decode_fields<Event>( R"JSON({
+        "kind": "click", "kids": ["a"], "id": 9, "offset": -4,
+        "unknown": [1, {"kind": 2}],
+        "score": null, "ok": true,
+        "user": {"class": "admin", "name": "Ann"},
+        "points": [{"x": 1, "y": 2}, {"y": 3}],
+        "extra": {"any": ["thing"]},
+        "szé": "key with escapes"
+    })JSON" );
+    EXPECT_EQ( 9u, e.id );
+    EXPECT_EQ( "click", e.kind );
+    EXPECT_EQ( std::vector<string>{ "a" }, e.kids );
+    EXPECT_EQ( -4, e.offset );
+    EXPECT_FALSE( e.score );
+    EXPECT_TRUE( e.ok );
+    EXPECT_EQ( "Ann", e.user.name );
+    EXPECT_EQ( "admin", e.user.class_ );
+    ASSERT_EQ( 2u, e.points.size() );
+    EXPECT_EQ( 3, e.points[1].y );
+    EXPECT_EQ( R"JSON({"any": ["thing"]})JSON"_Json, e.extra );
+    EXPECT_EQ( "key with escapes", e.sz__ );
+}
+
+TEST( JsrlCodegen,Encode ) {
+    Event e;
+    e.id = 1;
+    e.kind = "k";
+    e.score = 0.5;
+    e.sz__ = "s";
+    // Members follow the parsed schema's (sorted) key order.
+    EXPECT_EQ( R"JSON({"extra":null,"id":1,"kids":[],"kind":"k","offset":0,)JSON"
+            R"JSON("ok":false,"points":[],"score":0.5,"sz\u00e9":"s",)JSON"
+            R"JSON("user":{"class":"","name":""}})JSON",
+            encode_fields( e ) );
+    Event const copy = decode_fields<Event>( encode_fields( e ) );
+    EXPECT_EQ( encode_fields( e ), encode_fields( copy ) );
+}
+
+TEST( JsrlCodegen,RequiredKeys ) {
+    EXPECT_THROW( decode_fields<Event>( R"JSON({"id": 1})JSON" ),
+            Json::ObjectKeyError );
+    EXPECT_NO_THROW( decode_fields<Event>( R"JSON({"id": 1, "kind": ""})JSON" ) );
+}
+
+TEST( JsrlCodegen,FromExample ) {
+    Metric const m = decode_fields<Metric>( R"JSON({
+        "name": "latency", "value": 3, "count": 7,
+        "tags": [], "host": {"zone": 5}
+    })JSON" );
+    EXPECT_EQ( "latency", m.name );
+    EXPECT_EQ( 3.0, m.value );
+    static_assert( std::is_same<decltype( m.count ), std::int64_t>::value,
+            "" );
+    EXPECT_EQ( 7, m.count );
+    EXPECT_EQ( 5, m.host.zone );
+    EXPECT_EQ( R"JSON({"count":7,"host":{"region":"","zone":5},)JSON"
+            R"JSON("name":"latency","tags":[],"value":3})JSON",
+            encode_fields( m ) );
+}
+
+TEST( JsrlCodegen,ExampleShapes ) {
+    // The example must decode into the struct made from it.
+    auto const text = string( R"JSON({"a":{"b":{"y":"z"}},"a_b":{"x":1},)JSON"
+            R"JSON("big":18446744073709551615,"small":-3})JSON" );
+    Shapes const s = decode_fields<Shapes>( text );
+    static_assert( std::is_same<decltype( s.big ), std::uint64_t>::value, "" );
+    static_assert( std::is_same<decltype( s.small ), std::int64_t>::value, "" );
+    EXPECT_EQ( 18446744073709551615u, s.big );
+    EXPECT_EQ( -3, s.small );
+    // "a" then "b", and "a_b", are different structs.
+    static_assert( not std::is_same<decltype( s.a.b ), decltype( s.a_b )>::value,
+            "" );
+    EXPECT_EQ( "z", s.a.b.y );
+    EXPECT_EQ( 1, s.a_b.x );
+    EXPECT_EQ( text, encode_fields( s ) );
+}
+
+// vi: et ts=4 sts=4 sw=4
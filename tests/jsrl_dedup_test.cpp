@@ -0,0 +1,135 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+
+#include "jsrl_test_temp.hpp"
+#include "../src/jsrl_dedup.hpp"
+#include "../src/jsrl_impl_util.hpp"
+#include "../src/jsrl_pipeline.hpp"
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+    using namespace jsrl::literals;
+    using jsrl::DedupOptions;
+    using jsrl::Deduplicator;
+    using jsrl::Fingerprint;
+    using jsrl::Json;
+    using jsrl::JsonPointer;
+    using std::string;
+}
+
+TEST(JsrlDedup, Fingerprints) {
+    // Equal numbers, however written, and any key order.
+    EXPECT_EQ( Fingerprint::s_of( R"({"a":1,"b":[2.50,"x"]})"_Json ),
+            Fingerprint::s_of( R"({"b":[2.5,"x"],"a":1})"_Json ) );
+    EXPECT_EQ( Fingerprint::s_of( R"({"n":1.0e2})"_Json ),
+            Fingerprint::s_of( Json::parse( R"({"n":100.0})", Json::ParseOptions( true ) ) ) );
+    // As for Json's ==, an integer is not the equal double.
+    EXPECT_NE( Fingerprint::s_of( R"({"a":1})"_Json ), Fingerprint::s_of( R"({"a":1.0})"_Json ) );
+    EXPECT_NE( Fingerprint::s_of( R"({"a":1})"_Json ), Fingerprint::s_of( R"({"a":"1"})"_Json ) );
+    EXPECT_NE( Fingerprint::s_of( R"([1,2])"_Json ), Fingerprint::s_of( R"([2,1])"_Json ) );
+    Fingerprint const value = Fingerprint::s_of( R"("x")"_Json );
+    EXPECT_NE( value.high, value.low );
+}
+
+TEST(JsrlDedup, FingerprintsFollowNumberCompare) {
+    char const *const numbers[] = { "0", "-0", "0.0", "1", "1.0", "1e0", "1.50",
+        "1.5", "0.1", "100", "1e2", "-7", "-7.0", "2.5e-3", "0.0025",
+        "18446744073709551615", "18446744073709551616",
+        "123456789012345678901234567890", "1.23456789012345678901234567890e29",
+        "0.1000000000000000000000001" };
+    std::vector<Json> values;
+    for ( char const *text : numbers ) {
+        values.push_back( Json::parse( text ) );
+        values.push_back( Json::parse( text, Json::ParseOptions( true ) ) );
+        values.push_back( Json::parse( text, Json::ParseOptions( true, true ) ) );
+    }
+    values.push_back( Json( 0.1 ) );
+    values.push_back( Json( 2.5 ) );
+    for ( auto &&lhs : values ) {
+        for ( auto &&rhs : values ) {
+            EXPECT_EQ( jsrl::json_number_compare( lhs, rhs ) == 0,
+                    Fingerprint::s_of( lhs ) == Fingerprint::s_of( rhs ) )
+                    << lhs << " " << rhs;
+        }
+    }
+}
+
+TEST(JsrlDedup, Global) {
+    Deduplicator dedup;
+    EXPECT_TRUE( dedup.first( R"({"id":1,"v":"a"})"_Json ) );
+    EXPECT_TRUE( dedup.first( R"({"id":2,"v":"a"})"_Json ) );
+    EXPECT_FALSE( dedup.first( R"({"v":"a","id":1})"_Json ) );
+    EXPECT_EQ( dedup.records(), 3u );
+    EXPECT_EQ( dedup.duplicates(), 1u );
+
+    DedupOptions options;
+    options.keys = { JsonPointer( "/id" ) };
+    Deduplicator by_id( options );
+    EXPECT_TRUE( by_id.first( R"({"id":1,"v":"a"})"_Json ) );
+    EXPECT_FALSE( by_id.first( R"({"id":1,"v":"b"})"_Json ) );
+    EXPECT_TRUE( by_id.first( R"({"v":"c"})"_Json ) );
+    EXPECT_FALSE( by_id.first( R"({"id":null})"_Json ) );
+}
+
+TEST(JsrlDedup, Window) {
+    DedupOptions options;
+    options.window = 100;
+    Deduplicator dedup( options );
+    for ( int round = 0; round != 3; ++round ) {
+        for ( int i = 0; i != 1000; ++i )
+            EXPECT_EQ( dedup.first( Json( i / 2 ) ), i % 2 == 0 ) << i;
+    }
+    // Only the last 100 distinct records are remembered.
+    for ( int i = 400; i != 500; ++i )
+        EXPECT_FALSE( dedup.first( Json( i ) ) ) << i;
+    EXPECT_TRUE( dedup.first( Json( 399 ) ) );
+    EXPECT_TRUE( dedup.first( Json( 0 ) ) );
+}
+
+TEST(JsrlDedup, Spills) {
+    TempDirectory directory;
+    {
+        DedupOptions options;
+        options.memory_fingerprints = 500;
+        options.temp_directory = directory.path.string();
+        Deduplicator dedup( options );
+        for ( int i = 0; i != 20000; ++i )
+            EXPECT_TRUE( dedup.first( Json( i ) ) ) << i;
+        EXPECT_GT( dedup.spilled(), 19000u );
+        for ( int i = 0; i < 20000; i += 7 )
+            EXPECT_FALSE( dedup.first( Json( i ) ) ) << i;
+        for ( int i = 20000; i != 21000; ++i )
+            EXPECT_TRUE( dedup.first( Json( i ) ) ) << i;
+        EXPECT_FALSE( directory.empty() );
+    }
+    EXPECT_TRUE( directory.empty() );
+}
+
+TEST(JsrlDedup, PipelineStage) {
+    string input;
+    for ( int i = 0; i != 3000; ++i )
+        input += "{\"event\":" + std::to_string( i % 1000 ) + ",\"at\":" + std::to_string( i % 1000 ) + ".0}\n";
+    jsrl::PipelineOptions options;
+    options.batch_bytes = 256;
+    jsrl::Pipeline pipeline( options );
+    Deduplicator dedup;
+    pipeline.stage( "dedup", dedup, 4 );
+    std::istringstream in( input );
+    std::ostringstream out;
+    EXPECT_EQ( pipeline.run( *in.rdbuf(), out ), 1000u );
+    EXPECT_EQ( dedup.duplicates(), 2000u );
+}
+
+// vi: et ts=4 sts=4 sw=4
@@ -0,0 +1,126 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+
+#include "../src/jsrl_doc_index.hpp"
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+
+namespace {
+    using namespace jsrl::literals;
+    using jsrl::DocumentIndex;
+    using jsrl::DocumentIndexError;
+    using jsrl::Json;
+    using jsrl::JsonPointer;
+    using std::string;
+
+    string const catalog = R"JSON({
+        "version": 3,
+        "products": {
+            "ab-1": {"name": "lamp", "tags": ["home", "light"], "price": 19.5},
+            "a/b~2": {"name": "odd key", "tags": []},
+            "cd-3": {"name": "desk", "size": {"w": 120, "d": 60}}
+        },
+        "regions": [ "eu", {"code": "us", "stores": [1, 2, 3]} ]
+    })JSON";
+
+    // Look up every pointer both through the index and in the parsed tree.
+    void expect_same_answers( DocumentIndex const &index, string const &text ) {
+        Json const doc = Json::parse( text );
+        std::stringbuf document( text );
+        for ( char const *path : {
+                "", "/version", "/products", "/products/ab-1",
+                "/products/ab-1/tags/1", "/products/a~1b~02", "/products/cd-3/size/w",
+                "/regions/1/stores/2", "/regions/0", "/regions/2", "/regions/x",
+                "/products/zz", "/products/ab-1/none", "/version/0", "/missing",
+                "/regions/1/stores/7" } ) {
+            JsonPointer const pointer( path );
+            Json const *expected = pointer.find( doc );
+            Json found;
+            EXPECT_EQ( expected != nullptr, index.find( document, pointer, found ) )
+                    << path;
+            if ( expected ) {
+                EXPECT_EQ( *expected, found ) << path;
+            }
+        }
+    }
+}
+
+TEST( JsrlDocIndex,Lookups ) {
+    for ( size_t depth : { 0, 1, 2, 5 } ) {
+        std::istringstream iss( catalog );
+        DocumentIndex const index = DocumentIndex::s_build( *iss.rdbuf(), depth );
+        EXPECT_EQ( depth, index.max_depth() );
+        expect_same_answers( index, catalog );
+    }
+}
+
+TEST( JsrlDocIndex,Extents ) {
+    std::istringstream iss( catalog );
+    DocumentIndex const index = DocumentIndex::s_build( *iss.rdbuf(), 2 );
+    auto const lamp = index.entry( JsonPointer( "/products/ab-1" ) );
+    ASSERT_TRUE( lamp );
+    EXPECT_EQ( R"JSON({"name": "lamp", "tags": ["home", "light"], "price": 19.5})JSON",
+            catalog.substr( lamp->begin, lamp->end - lamp->begin ) );
+    auto const version = index.entry( JsonPointer( "/version" ) );
+    ASSERT_TRUE( version );
+    EXPECT_EQ( "3", catalog.substr( version->begin, version->end - version->begin ) );
+    EXPECT_TRUE( index.entry( JsonPointer( "/regions/1" ) ) );
+    // Deeper than indexed.
+    EXPECT_FALSE( index.entry( JsonPointer( "/products/ab-1/name" ) ) );
+    EXPECT_EQ( 9u, index.entries().size() );
+}
+
+TEST( JsrlDocIndex,SaveLoad ) {
+    std::istringstream iss( catalog );
+    DocumentIndex const index = DocumentIndex::s_build( *iss.rdbuf(), 2 );
+    std::stringstream saved;
+    index.save( saved );
+    DocumentIndex const loaded = DocumentIndex::s_load( saved );
+    EXPECT_EQ( index.max_depth(), loaded.max_depth() );
+    ASSERT_EQ( index.entries().size(), loaded.entries().size() );
+    for ( size_t i = 0; i != index.entries().size(); ++i ) {
+        EXPECT_EQ( index.entries()[i].pointer, loaded.entries()[i].pointer );
+        EXPECT_EQ( index.entries()[i].begin, loaded.entries()[i].begin );
+        EXPECT_EQ( index.entries()[i].end, loaded.entries()[i].end );
+    }
+    expect_same_answers( loaded, catalog );
+
+    std::istringstream bad_magic( "JSRLNDX1" );
+    EXPECT_THROW( DocumentIndex::s_load( bad_magic ), DocumentIndexError );
+    std::istringstream truncated( saved.str().substr( 0, saved.str().size() - 3 ) );
+    EXPECT_THROW( DocumentIndex::s_load( truncated ), DocumentIndexError );
+}
+
+TEST( JsrlDocIndex,LargeArray ) {
+    // Values spanning many reads of the underlying buffer.
+    string text = "{\"rows\":[";
+    for ( int i = 0; i != 20000; ++i )
+        text += ( i ? "," : "" ) + string( "{\"id\":" ) + std::to_string( i ) + "}";
+    text += "]}";
+    std::istringstream iss( text );
+    DocumentIndex const index = DocumentIndex::s_build( *iss.rdbuf(), 2 );
+    std::stringbuf document( text );
+    Json row;
+    ASSERT_TRUE( index.find( document, JsonPointer( "/rows/12345" ), row ) );
+    EXPECT_EQ( R"({"id":12345})"_Json, row );
+    ASSERT_TRUE( index.find( document, JsonPointer( "/rows/19999/id" ), row ) );
+    EXPECT_EQ( 19999, row.as_number_xint() );
+    EXPECT_FALSE( index.find( document, JsonPointer( "/rows/20000" ), row ) );
+}
+
+TEST( JsrlDocIndex,BadDocument ) {
+    std::istringstream iss( R"({"a": [1, 2)" );
+    EXPECT_THROW( DocumentIndex::s_build( *iss.rdbuf(), 2 ), Json::ParseError );
+}
+
+// vi: et ts=4 sts=4 sw=4
@@ -0,0 +1,170 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+
+#include "../src/jsrl_encoder.hpp"
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <utility>
+
+namespace {
+    using namespace jsrl::literals;
+    using jsrl::Json;
+    using jsrl::ChunkedEncoder;
+    using jsrl::encode_bounded;
+    using std::string;
+
+    string drain( ChunkedEncoder &encoder, size_t cap ) {
+        string result;
+        string buf( cap, '\0' );
+        while ( size_t n = encoder.next_chunk( &buf[0], cap ) ) {
+            EXPECT_LE( n, cap );
+            result.append( buf, 0, n );
+        }
+        return result;
+    }
+
+    Json const sample = R"JSON({
+        "name": "café \"quoted\"",
+        "values": [1, -2, 3.25, 1e300, true, false, null, [], {}],
+        "nested": {"a": [[["deep"]]], "b": {"c": {}}},
+        "big": 123456789012345678901234567890
+    })JSON"_Json;
+}
+
+TEST( JsrlEncoder,ChunksMatchEncode ) {
+    string const expected = encode( sample );
+    for ( size_t cap : { 1, 2, 3, 7, 64, 4096 } ) {
+        ChunkedEncoder encoder( sample );
+        EXPECT_FALSE( encoder.done() );
+        EXPECT_EQ( expected, drain( encoder, cap ) ) << "cap " << cap;
+        EXPECT_TRUE( encoder.done() );
+        char c;
+        EXPECT_EQ( 0u, encoder.next_chunk( &c, 1 ) );
+    }
+}
+
+TEST( JsrlEncoder,Scalars ) {
+    for ( auto &&value : { Json(), Json( true ), Json( 42 ), Json( "text" ),
+                Json( Json::ArrayBody{} ), Json( Json::ObjectBody{} ) } ) {
+        ChunkedEncoder encoder( value );
+        EXPECT_EQ( encode( value ), drain( encoder, 2 ) );
+    }
+}
+
+TEST( JsrlEncoder,FillsBuffer ) {
+    ChunkedEncoder encoder( sample );
+    char buf[16];
+    EXPECT_EQ( sizeof buf, encoder.next_chunk( buf, sizeof buf ) );
+    EXPECT_EQ( 0u, encoder.next_chunk( buf, 0 ) );
+    EXPECT_FALSE( encoder.done() );
+}
+
+TEST( JsrlEncoder,MoveKeepsPosition ) {
+    string const expected = encode( sample );
+    ChunkedEncoder encoder( sample );
+    char buf[10];
+    string result( buf, encoder.next_chunk( buf, sizeof buf ) );
+    ChunkedEncoder moved( std::move(encoder) );
+    result += drain( moved, 5 );
+    EXPECT_EQ( expected, result );
+}
+
+TEST( JsrlEncoder,EncodeOptions ) {
+    Json const value = Json::parse( R"JSON(["café", 0.1])JSON",
+            Json::ParseOptions( true ) );
+    Json::EncodeOptions const options(
+            Json::EncodeOptions::TN_DOUBLE, false, true );
+    std::ostringstream expected;
+    expected << Json::OptionedWrite( value, options );
+    ChunkedEncoder encoder( value, options );
+    EXPECT_EQ( expected.str(), drain( encoder, 3 ) );
+}
+
+TEST( JsrlEncoder,BoundedFitsUnchanged ) {
+    string const expected = encode( sample );
+    EXPECT_EQ( expected, encode_bounded( sample, 1 << 20 ) );
+}
+
+TEST( JsrlEncoder,BoundedExactBudget ) {
+    // No room is set aside for markers that aren't needed.
+    for ( char const *text : { "[-854]", "[[[266,540]],[],false,false]",
+                R"JSON({"k16":[null]})JSON", R"JSON({"a":[1,{"b":"cd"}],"e":[]})JSON" } ) {
+        Json const value = Json::parse( text );
+        string const full = encode( value );
+        EXPECT_EQ( full, encode_bounded( value, full.size() ) ) << text;
+    }
+    string const full = encode( sample );
+    EXPECT_EQ( full, encode_bounded( sample, full.size() ) );
+    EXPECT_EQ( "\"m\"", encode_bounded( Json( "m" ), 3 ) );
+    // Once the last element fits, so does the whole.
+    Json const tail = R"JSON([1,2,3,"abcdefghijklmnop"])JSON"_Json;
+    EXPECT_EQ( encode( tail ), encode_bounded( tail, encode( tail ).size() ) );
+}
+
+TEST( JsrlEncoder,BoundedIsValidAndWithinBudget ) {
+    string const full = encode( sample );
+    for ( size_t budget = 12; budget != full.size(); ++budget ) {
+        string const result = encode_bounded( sample, budget );
+        EXPECT_LE( result.size(), budget );
+        EXPECT_NO_THROW( static_cast<void>( Json::parse( result ) ) )
+                << result;
+    }
+}
+
+TEST( JsrlEncoder,BoundedArrayTail ) {
+    Json::ArrayBody body;
+    for ( int i = 0; i != 1000; ++i )
+        body.push_back( Json( i ) );
+    EXPECT_EQ( R"JSON([0,1,2,"\u2026 997 more"])JSON",
+            encode_bounded( Json( body ), 26 ) );
+    EXPECT_EQ( R"JSON([0,"\u2026 999 more"])JSON",
+            encode_bounded( Json( body ), 21 ) );
+    EXPECT_EQ( R"JSON(["\u2026 1000 more"])JSON",
+            encode_bounded( Json( body ), 20 ) );
+}
+
+TEST( JsrlEncoder,BoundedObjectKeys ) {
+    Json const value = R"JSON({"a":1,"b":2,"c":3,"d":4})JSON"_Json;
+    EXPECT_EQ( R"JSON({"a":1,"b":2,"\u2026":2})JSON",
+            encode_bounded( value, 24 ) );
+}
+
+TEST( JsrlEncoder,BoundedString ) {
+    Json const value( string( 100000, 'x' ) );
+    Json::EncodeOptions const utf( Json::EncodeOptions::TN_EXACT, false, true );
+    EXPECT_EQ( "\"xxxxx\xE2\x80\xA6\"", encode_bounded( value, 10, utf ) );
+    EXPECT_EQ( "\"xxxx\\u2026\"", encode_bounded( value, 12 ) );
+    // Escapes and multi-byte characters aren't split.
+    Json const mixed( "ab\"\xC3\xA9\xF0\x9F\x98\x80" "cd" );
+    EXPECT_EQ( "\"ab\\\"\\u00e9\\u2026\"",
+            encode_bounded( mixed, 20 ) );
+    EXPECT_EQ( "\"ab\\\"\xC3\xA9\xE2\x80\xA6\"",
+            encode_bounded( mixed, 13, utf ) );
+}
+
+TEST( JsrlEncoder,BoundedNested ) {
+    Json const value = Json::ObjectBody{
+        { "list", Json::ArrayBody{
+            Json::ArrayBody{ Json( string( 40, 'a' ) ) }, Json( 2 ), Json( 3 ) } },
+        { "z", Json( 0 ) },
+    };
+    EXPECT_EQ( R"JSON({"list":[["aaaaaaaaaaaa\u2026"],"\u2026 2 more"],"\u2026":1})JSON",
+            encode_bounded( value, 60 ) );
+}
+
+TEST( JsrlEncoder,BoundedTooSmall ) {
+    EXPECT_EQ( "\"\\u2026\"", encode_bounded( Json( 1234567 ), 3 ) );
+    EXPECT_EQ( "\"\\u2026\"", encode_bounded( sample, 0 ) );
+}
+
+// vi: et ts=4 sts=4 sw=4
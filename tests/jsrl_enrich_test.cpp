@@ -0,0 +1,98 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+
+#include "../src/jsrl_enrich.hpp"
+#include "../src/jsrl_pipeline.hpp"
+#include <gtest/gtest.h>
+#include <memory>
+#include <sstream>
+#include <string>
+
+namespace {
+    using namespace jsrl::literals;
+    using jsrl::Enricher;
+    using jsrl::Json;
+    using jsrl::JsonPointer;
+    using jsrl::ReferenceIndex;
+    using std::string;
+
+    std::shared_ptr<ReferenceIndex const> customers() {
+        return std::make_shared<ReferenceIndex const>( R"([
+            {"id":1,"name":"Ann"},
+            {"id":"2","name":"Bob"},
+            {"name":"nobody"},
+            {"id":1,"name":"duplicate"},
+            {"id":{"region":"eu","n":7},"name":"Eve"}
+        ])"_Json, JsonPointer( "/id" ) );
+    }
+}
+
+TEST(JsrlEnrich, Find) {
+    auto const index = customers();
+    EXPECT_EQ( index->size(), 3u );
+    ASSERT_NE( index->find( Json( 1 ) ), nullptr );
+    EXPECT_EQ( ( *index->find( Json( 1 ) ) )["name"], Json( "Ann" ) );
+    // Numbers of equal value match, whatever their type.
+    EXPECT_EQ( index->find( "1.0"_Json ), index->find( Json( 1 ) ) );
+    EXPECT_EQ( index->find( Json( 2 ) ), nullptr );
+    EXPECT_NE( index->find( Json( "2" ) ), nullptr );
+    EXPECT_NE( index->find( R"({"n":7,"region":"eu"})"_Json ), nullptr );
+    EXPECT_EQ( index->find( Json() ), nullptr );
+    EXPECT_THROW( ReferenceIndex( R"({"id":1})"_Json, JsonPointer( "/id" ) ),
+            Json::TypeError );
+}
+
+TEST(JsrlEnrich, AttachesWithoutCopying) {
+    auto const index = customers();
+    Enricher const enrich( index, JsonPointer( "/customer" ), "who" );
+    Json record = R"({"customer":1,"amount":5,"z":0})"_Json;
+    ASSERT_TRUE( enrich( record ) );
+    EXPECT_EQ( record, R"({"amount":5,"customer":1,"who":{"id":1,"name":"Ann"},"z":0})"_Json );
+    // The record holds the reference element itself.
+    EXPECT_EQ( &record["who"].as_object(), &index->find( Json( 1 ) )->as_object() );
+
+    Json unmatched = R"({"customer":9})"_Json;
+    EXPECT_TRUE( enrich( unmatched ) );
+    EXPECT_EQ( unmatched, R"({"customer":9})"_Json );
+    EXPECT_FALSE( Enricher( index, JsonPointer( "/customer" ), "who", false )( unmatched ) );
+}
+
+TEST(JsrlEnrich, WithMember) {
+    Json const object = R"({"a":1,"c":3})"_Json;
+    EXPECT_EQ( jsrl::with_member( object, "b", Json( 2 ) ), R"({"a":1,"b":2,"c":3})"_Json );
+    EXPECT_EQ( jsrl::with_member( object, "c", Json( 4 ) ), R"({"a":1,"c":4})"_Json );
+    EXPECT_EQ( jsrl::with_member( object, "d", Json( 5 ) ).as_object().size(), 3u );
+    EXPECT_THROW( jsrl::with_member( Json( 1 ), "a", Json() ), Json::TypeError );
+}
+
+TEST(JsrlEnrich, PipelineStage) {
+    string input;
+    for ( int i = 0; i != 1000; ++i )
+        input += "{\"seq\":" + std::to_string( i ) + ",\"customer\":" + std::to_string( i % 3 ) + "}\n";
+    jsrl::PipelineOptions options;
+    options.parse_threads = 2;
+    options.batch_bytes = 512;
+    jsrl::Pipeline pipeline( options );
+    pipeline.stage( "enrich", Enricher( customers(), JsonPointer( "/customer" ), "who", false ), 4 );
+    std::istringstream in( input );
+    std::ostringstream out;
+    EXPECT_EQ( pipeline.run( *in.rdbuf(), out ), 333u );
+    std::istringstream written( out.str() );
+    string line;
+    while ( std::getline( written, line ) ) {
+        Json const record = Json::parse( line );
+        EXPECT_EQ( record["seq"].as_number_sint() % 3, 1 );
+        EXPECT_EQ( record["who"]["name"], Json( "Ann" ) );
+    }
+}
+
+// vi: et ts=4 sts=4 sw=4
@@ -0,0 +1,131 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+
+#include "../src/jsrl_fields.hpp"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace test_dto {
+    struct Point {
+        double x = 0;
+        double y = 0;
+    };
+    JSRL_FIELDS( Point, x, y )
+
+    struct Record {
+        std::uint32_t id = 0;
+        std::int8_t level = 0;
+        bool active = false;
+        std::string name;
+        std::vector<Point> path;
+        std::optional<std::string> note;
+        std::vector<bool> flags;
+        jsrl::Json extra;
+    };
+    JSRL_FIELDS( Record, id, level, active, name, path, note, flags, extra )
+}
+
+namespace {
+    using namespace jsrl::literals;
+    using jsrl::Json;
+    using jsrl::decode_fields;
+    using jsrl::encode_fields;
+    using std::string;
+    using test_dto::Point;
+    using test_dto::Record;
+
+    Record sample() {
+        Record r;
+        r.id = 42;
+        r.level = -3;
+        r.active = true;
+        r.name = "caf\xC3\xA9 \"q\"\n";
+        r.path = { Point{ 1.5, -2 }, Point{ 0.1, 1e300 } };
+        r.flags = { true, false };
+        r.extra = R"JSON({"k": [1, "v"]})JSON"_Json;
+        return r;
+    }
+}
+
+TEST( JsrlFields,Encode ) {
+    EXPECT_EQ( R"JSON({"id":42,"level":-3,"active":true,)JSON"
+            R"JSON("name":"caf\u00e9 \"q\"\n",)JSON"
+            R"JSON("path":[{"x":1.5,"y":-2},{"x":0.1,"y":1e+300}],)JSON"
+            R"JSON("note":null,"flags":[true,false],"extra":{"k":[1,"v"]}})JSON",
+            encode_fields( sample() ) );
+}
+
+TEST( JsrlFields,MatchesJsonTree ) {
+    string const text = encode_fields( sample() );
+    Json const tree = Json::parse( text );
+    EXPECT_EQ( 42u, tree["id"].as_number_uint() );
+    EXPECT_EQ( "caf\xC3\xA9 \"q\"\n", tree["name"].as_string() );
+    EXPECT_EQ( 0.1, double( tree["path"][1]["x"].as_number_float() ) );
+}
+
+TEST( JsrlFields,RoundTrip ) {
+    Record r = sample();
+    r.note = "n";
+    Record const copy = decode_fields<Record>( encode_fields( r ) );
+    EXPECT_EQ( r.id, copy.id );
+    EXPECT_EQ( r.level, copy.level );
+    EXPECT_EQ( r.active, copy.active );
+    EXPECT_EQ( r.name, copy.name );
+    ASSERT_EQ( 2u, copy.path.size() );
+    EXPECT_EQ( 0.1, copy.path[1].x );
+    EXPECT_EQ( 1e300, copy.path[1].y );
+    EXPECT_EQ( r.note, copy.note );
+    EXPECT_EQ( r.flags, copy.flags );
+    EXPECT_EQ( r.extra, copy.extra );
+}
+
+TEST( JsrlFields,DecodeLeniency ) {
+    Record r;
+    r.name = "kept";
+    decode_fields( R"JSON({
+        "unknown": {"deep": [1, 2, {"x": null}]},
+        "extra": null,
+        "id": 1, "id": 2,
+        "path": [{"y": 4, "x": 3}]
+    })JSON", r );
+    EXPECT_EQ( 2u, r.id );
+    EXPECT_EQ( "kept", r.name );
+    ASSERT_EQ( 1u, r.path.size() );
+    EXPECT_EQ( 3, r.path[0].x );
+    EXPECT_EQ( 4, r.path[0].y );
+    EXPECT_TRUE( r.extra.is_null() );
+}
+
+TEST( JsrlFields,DecodeErrors ) {
+    Record r;
+    EXPECT_THROW( decode_fields( R"JSON({"level": 200})JSON", r ),
+            Json::NumberParseError );
+    EXPECT_THROW( decode_fields( R"JSON({"id": -1})JSON", r ),
+            Json::NumberParseError );
+    EXPECT_THROW( decode_fields( R"JSON({"name": 5})JSON", r ),
+            Json::UnexpectedByteParseError );
+    EXPECT_THROW( decode_fields( R"JSON({"id": 1} x)JSON", r ),
+            Json::TrailingBytesParseError );
+}
+
+TEST( JsrlFields,NonFinite ) {
+    Point p{ std::nan( "" ), 1 };
+    EXPECT_EQ( R"JSON({"x":null,"y":1})JSON", encode_fields( p ) );
+    Point const copy = decode_fields<Point>( encode_fields( p ) );
+    EXPECT_TRUE( std::isnan( copy.x ) );
+}
+
+// vi: et ts=4 sts=4 sw=4
@@ -0,0 +1,192 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+
+#include "../src/jsrl_groupby.hpp"
+#include "../src/jsrl_impl_util.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace {
+    using namespace jsrl::literals;
+    using jsrl::Aggregate;
+    using jsrl::GroupBy;
+    using jsrl::GroupByOptions;
+    using jsrl::Json;
+    using jsrl::JsonPointer;
+    using std::string;
+    using std::vector;
+
+    vector<Aggregate> all_aggregates() {
+        return {
+            Aggregate::s_count( "records" ),
+            Aggregate::s_count( "amounts", JsonPointer( "/amount" ) ),
+            Aggregate::s_sum( "total", JsonPointer( "/amount" ) ),
+            Aggregate::s_min( "least", JsonPointer( "/amount" ) ),
+            Aggregate::s_max( "most", JsonPointer( "/amount" ) ),
+            Aggregate::s_avg( "mean", JsonPointer( "/amount" ) ),
+            Aggregate::s_distinct( "users", JsonPointer( "/user" ) ),
+        };
+    }
+
+    char const *const orders[] = {
+        R"({"country":"US","amount":10,"user":"a"})",
+        R"({"country":"FR","amount":2.5,"user":"b"})",
+        R"({"country":"US","amount":-4,"user":"a"})",
+        R"({"country":"US","user":"c"})",
+        R"({"country":"FR","amount":"n/a","user":"b"})",
+        R"({"amount":1,"user":"d"})",
+    };
+
+    string ndjson( size_t count ) {
+        string text;
+        for ( size_t i = 0; i != count; ++i ) {
+            text += "{\"k\":" + std::to_string( i % 7 ) + ",\"v\":"
+                    + std::to_string( i ) + ",\"u\":\"u" + std::to_string( i % 50 )
+                    + "\"}\n";
+        }
+        return text;
+    }
+}
+
+TEST( JsrlGroupBy,Aggregates ) {
+    GroupBy by_json( { JsonPointer( "/country" ) }, all_aggregates() );
+    GroupBy by_text( { JsonPointer( "/country" ) }, all_aggregates() );
+    for ( char const *order : orders ) {
+        by_json.add( Json::parse( order ) );
+        by_text.add( jsrl::string_view( order ) );
+    }
+    for ( GroupBy const *groups : { &by_json, &by_text } ) {
+        EXPECT_EQ( 6u, groups->records() );
+        auto const rows = groups->rows();
+        ASSERT_EQ( 3u, rows.size() );
+        // Ordered by key: the missing country (null) first.
+        EXPECT_EQ( Json(), rows[0].key[0] );
+        EXPECT_EQ( "FR", rows[1].key[0] );
+        EXPECT_EQ( "US", rows[2].key[0] );
+
+        auto const &fr = rows[1].values;
+        EXPECT_EQ( 2, fr[0] );
+        EXPECT_EQ( 2, fr[1] );          // The string counts too...
+        EXPECT_EQ( Json( 2.5 ), fr[2] );    // ...but isn't summed.
+        EXPECT_EQ( Json( 2.5 ), fr[3] );
+        EXPECT_EQ( "n/a", fr[4] );      // Strings order after numbers.
+        EXPECT_EQ( Json( 2.5L ), fr[5] );
+        EXPECT_EQ( 1, fr[6] );
+
+        auto const &us = rows[2].values;
+        EXPECT_EQ( 3, us[0] );
+        EXPECT_EQ( 2, us[1] );
+        EXPECT_EQ( 6, us[2] );
+        EXPECT_EQ( -4, us[3] );
+        EXPECT_EQ( 10, us[4] );
+        EXPECT_EQ( Json( 3.0L ), us[5] );
+        EXPECT_EQ( 2, us[6] );
+    }
+}
+
+TEST( JsrlGroupBy,EqualNumbersGroupTogether ) {
+    EXPECT_EQ( jsrl::json_value_hash( Json( 1 ) ), jsrl::json_value_hash( Json( 1.0 ) ) );
+    EXPECT_EQ( jsrl::json_value_hash( Json::parse( "[1,{\"a\":2}]" ) ),
+            jsrl::json_value_hash( Json::parse( "[1.0,{\"a\":2e0}]", true ) ) );
+    EXPECT_NE( jsrl::json_value_hash( Json( 1 ) ), jsrl::json_value_hash( Json( 2 ) ) );
+    EXPECT_NE( jsrl::json_value_hash( Json( "1" ) ), jsrl::json_value_hash( Json( 1 ) ) );
+
+    GroupBy groups( { JsonPointer( "/k" ) },
+            { Aggregate::s_count( "n" ), Aggregate::s_distinct( "v", JsonPointer( "/v" ) ) } );
+    groups.add( R"({"k":1,"v":3})"_Json );
+    groups.add( R"({"k":1.0,"v":3.0})"_Json );
+    groups.add( Json::parse( R"({"k":1e0,"v":30e-1})", true ) );
+    groups.add( R"({"k":2,"v":3})"_Json );
+    auto const rows = groups.rows();
+    ASSERT_EQ( 2u, rows.size() );
+    EXPECT_EQ( ( vector<Json>{ 3, 1 } ), rows[0].values );
+    EXPECT_EQ( ( vector<Json>{ 1, 1 } ), rows[1].values );
+}
+
+TEST( JsrlGroupBy,ExactSums ) {
+    GroupByOptions options;
+    options.exact_sums = true;
+    GroupBy groups( {}, { Aggregate::s_sum( "sum", JsonPointer( "/x" ) ),
+            Aggregate::s_avg( "avg", JsonPointer( "/x" ) ) }, options );
+    for ( int i = 0; i != 10; ++i )
+        groups.add( jsrl::string_view( R"({"x":0.1})" ) );
+    EXPECT_EQ( "1.0", encode( groups.rows()[0].values[0] ) );
+
+    GroupBy mixed( {}, { Aggregate::s_sum( "sum", JsonPointer( "/x" ) ) }, options );
+    for ( char const *record : { R"({"x":5})", R"({"x":-7.25})", R"({"x":0.000001})" } )
+        mixed.add( jsrl::string_view( record ) );
+    EXPECT_EQ( "-2.249999", encode( mixed.rows()[0].values[0] ) );
+
+    GroupBy large( {}, { Aggregate::s_sum( "sum", JsonPointer( "/x" ) ) }, options );
+    large.add( jsrl::string_view( R"({"x":9223372036854775807})" ) );
+    large.add( jsrl::string_view( R"({"x":18446744073709551615})" ) );
+    EXPECT_EQ( "27670116110564327422", encode( large.rows()[0].values[0] ) );
+
+    // Without exact sums, integers overflowing a long long fall back to floating point.
+    GroupBy rounded( {}, { Aggregate::s_sum( "sum", JsonPointer( "/x" ) ) } );
+    rounded.add( jsrl::string_view( R"({"x":9223372036854775807})" ) );
+    rounded.add( jsrl::string_view( R"({"x":1})" ) );
+    EXPECT_TRUE( rounded.rows()[0].values[0].is_number_float() );
+}
+
+TEST( JsrlGroupBy,Parallel ) {
+    string const text = ndjson( 20000 );
+    vector<Aggregate> const aggregates = {
+        Aggregate::s_count( "n" ),
+        Aggregate::s_sum( "sum", JsonPointer( "/v" ) ),
+        Aggregate::s_min( "min", JsonPointer( "/v" ) ),
+        Aggregate::s_max( "max", JsonPointer( "/v" ) ),
+        Aggregate::s_distinct( "users", JsonPointer( "/u" ) ),
+    };
+    GroupBy serial( { JsonPointer( "/k" ) }, aggregates );
+    jsrl::string_view rest( text );
+    while ( not rest.empty() ) {
+        size_t const end = rest.find( '\n' );
+        serial.add( rest.substr( 0, end ) );
+        rest.remove_prefix( end + 1 );
+    }
+    GroupByOptions options;
+    options.threads = 4;
+    options.chunk_bytes = 1000;
+    jsrl::jsrl_streambuf input( text.data(), text.data() + text.size() );
+    GroupBy const parallel = jsrl::group_ndjson( input,
+            { JsonPointer( "/k" ) }, aggregates, options );
+    EXPECT_EQ( 20000u, parallel.records() );
+    auto const expected = serial.rows();
+    auto const rows = parallel.rows();
+    ASSERT_EQ( 7u, rows.size() );
+    for ( size_t i = 0; i != rows.size(); ++i ) {
+        EXPECT_EQ( expected[i].key, rows[i].key );
+        EXPECT_EQ( expected[i].values, rows[i].values );
+    }
+    EXPECT_EQ( 0, rows[0].values[2] );
+    EXPECT_EQ( 19997, rows[5].values[3] );
+    EXPECT_NEAR( 50.0, rows[0].values[4].as_number_float(), 3.0 );
+}
+
+TEST( JsrlGroupBy,InvalidRecords ) {
+    string const text = "{\"k\":1}\n{\"k\":\n{\"k\":1}\n";
+    jsrl::jsrl_streambuf strict_input( text.data(), text.data() + text.size() );
+    EXPECT_THROW( jsrl::group_ndjson( strict_input, { JsonPointer( "/k" ) },
+                { Aggregate::s_count( "n" ) } ), Json::ParseError );
+
+    GroupByOptions options;
+    options.skip_invalid = true;
+    jsrl::jsrl_streambuf input( text.data(), text.data() + text.size() );
+    GroupBy const groups = jsrl::group_ndjson( input, { JsonPointer( "/k" ) },
+            { Aggregate::s_count( "n" ) }, options );
+    EXPECT_EQ( 1u, groups.invalid() );
+    EXPECT_EQ( 2, groups.rows()[0].values[0] );
+}
+
+// vi: et ts=4 sts=4 sw=4
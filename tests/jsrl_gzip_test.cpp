@@ -0,0 +1,128 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+
+#include "../src/jsrl_gzip.hpp"
+#include "../src/jsrl_ndjson.hpp"
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <zlib.h>
+
+namespace {
+    using jsrl::GzipError;
+    using jsrl::GzipOptions;
+    using jsrl::GzipStreambuf;
+    using jsrl::Json;
+    using jsrl::NdjsonReader;
+    using std::string;
+    using std::string_view;
+
+    // Compress with a gzip (31) or zlib (15) header.
+    string deflated( string const &text, int window_bits = 31 ) {
+        z_stream stream = z_stream();
+        EXPECT_EQ( Z_OK, deflateInit2( &stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                    window_bits, 8, Z_DEFAULT_STRATEGY ) );
+        string out( deflateBound( &stream, uLong( text.size() ) ), '\0' );
+        stream.next_in = reinterpret_cast<Bytef *>( const_cast<char *>( text.data() ) );
+        stream.avail_in = uInt( text.size() );
+        stream.next_out = reinterpret_cast<Bytef *>( &out[0] );
+        stream.avail_out = uInt( out.size() );
+        EXPECT_EQ( Z_STREAM_END, deflate( &stream, Z_FINISH ) );
+        out.resize( stream.total_out );
+        deflateEnd( &stream );
+        return out;
+    }
+
+    string events( int count ) {
+        string text;
+        for ( int i = 0; i != count; ++i )
+            text += "{\"seq\":" + std::to_string( i ) + ",\"pad\":\""
+                    + string( size_t( i % 50 ), 'x' ) + "\"}\n";
+        return text;
+    }
+
+    string inflate_all( string const &compressed, GzipOptions const &options ) {
+        std::istringstream iss( compressed );
+        GzipStreambuf inflated( *iss.rdbuf(), options );
+        // Not through an ostream, which would swallow exceptions.
+        string out;
+        char block[777];
+        while ( auto const got = inflated.sgetn( block, sizeof block ) )
+            out.append( block, size_t( got ) );
+        EXPECT_EQ( out.size(), inflated.inflated() );
+        return out;
+    }
+}
+
+TEST( JsrlGzip,Inflates ) {
+    string const text = events( 5000 );
+    for ( bool background : { false, true } ) {
+        GzipOptions options;
+        options.block_size = 1000;
+        options.background = background;
+        EXPECT_EQ( text, inflate_all( deflated( text ), options ) );
+        EXPECT_EQ( text, inflate_all( deflated( text, 15 ), options ) );
+        // Concatenated members, as from "cat a.gz b.gz".
+        EXPECT_EQ( text + "tail\n",
+                inflate_all( deflated( text ) + deflated( "tail\n" ), options ) );
+        EXPECT_EQ( "", inflate_all( "", options ) );
+        EXPECT_EQ( "", inflate_all( deflated( "" ), options ) );
+    }
+}
+
+TEST( JsrlGzip,NdjsonRecords ) {
+    string const compressed = deflated( events( 20000 ) );
+    for ( bool background : { false, true } ) {
+        std::istringstream iss( compressed );
+        GzipOptions options;
+        options.background = background;
+        GzipStreambuf inflated( *iss.rdbuf(), options );
+        NdjsonReader records( inflated, 4096 );
+        string_view record;
+        long long expected = 0;
+        while ( records.next( record ) ) {
+            ASSERT_EQ( expected, Json::parse( record )["seq"].as_number_sint() );
+            ++expected;
+        }
+        EXPECT_EQ( 20000, expected );
+    }
+}
+
+TEST( JsrlGzip,BadInput ) {
+    string const compressed = deflated( events( 2000 ) );
+    for ( bool background : { false, true } ) {
+        GzipOptions options;
+        options.background = background;
+        EXPECT_THROW( inflate_all( compressed.substr( 0, compressed.size() / 2 ), options ),
+                GzipError );
+        string corrupt = compressed;
+        corrupt[ corrupt.size() / 2 ] ^= 0x55;
+        corrupt[ corrupt.size() / 2 + 1 ] ^= 0x55;
+        EXPECT_THROW( inflate_all( corrupt, options ), GzipError );
+        EXPECT_THROW( inflate_all( "not compressed at all", options ), GzipError );
+    }
+}
+
+TEST( JsrlGzip,AbandonedEarly ) {
+    // The background thread is stopped while blocks are still pending.
+    string const compressed = deflated( events( 20000 ) );
+    std::istringstream iss( compressed );
+    GzipOptions options;
+    options.block_size = 512;
+    options.background = true;
+    GzipStreambuf inflated( *iss.rdbuf(), options );
+    char first[10];
+    EXPECT_EQ( 10, inflated.sgetn( first, 10 ) );
+    EXPECT_EQ( "{\"seq\":0,\"", string( first, 10 ) );
+}
+
+// vi: et ts=4 sts=4 sw=4
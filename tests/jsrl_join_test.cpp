@@ -0,0 +1,132 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+
+#include "../src/jsrl_join.hpp"
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+    using namespace jsrl::literals;
+    using jsrl::Json;
+    using jsrl::JoinError;
+    using jsrl::JoinOptions;
+    using jsrl::JsonPointer;
+    using jsrl::MergeJoin;
+    using std::string;
+    using std::vector;
+
+    // Sorted as sort_ndjson would: missing keys read as null, which orders first.
+    string const orders =
+        "{\"item\":\"gift\"}\n"
+        "{\"id\":1,\"item\":\"pen\"}\n"
+        "{\"id\":2,\"item\":\"ink\"}\n"
+        "{\"id\":4,\"item\":\"pad\"}\n";
+    string const payments =
+        "{\"order\":2,\"paid\":3}\n"
+        "{\"order\":3,\"paid\":9}\n"
+        "{\"order\":4,\"paid\":1}\n"
+        "{\"order\":4,\"paid\":2}\n";
+
+    vector<Json> join( JoinOptions::Kind kind, vector<vector<bool>> *sources = nullptr ) {
+        std::istringstream left( orders ), right( payments );
+        JoinOptions options;
+        options.kind = kind;
+        MergeJoin joined( { { left.rdbuf(), JsonPointer( "/id" ) },
+                            { right.rdbuf(), JsonPointer( "/order" ) } }, options );
+        vector<Json> records;
+        Json record;
+        while ( joined.next( record ) ) {
+            records.push_back( record );
+            if ( sources )
+                sources->push_back( joined.sources() );
+        }
+        return records;
+    }
+}
+
+TEST(JsrlJoin, Inner) {
+    EXPECT_EQ( join( JoinOptions::JK_INNER ), ( vector<Json>{
+        R"({"id":2,"item":"ink","order":2,"paid":3})"_Json,
+        R"({"id":4,"item":"pad","order":4,"paid":1})"_Json,
+        R"({"id":4,"item":"pad","order":4,"paid":2})"_Json,
+    } ) );
+}
+
+TEST(JsrlJoin, Left) {
+    vector<vector<bool>> sources;
+    EXPECT_EQ( join( JoinOptions::JK_LEFT, &sources ), ( vector<Json>{
+        R"({"item":"gift"})"_Json,
+        R"({"id":1,"item":"pen"})"_Json,
+        R"({"id":2,"item":"ink","order":2,"paid":3})"_Json,
+        R"({"id":4,"item":"pad","order":4,"paid":1})"_Json,
+        R"({"id":4,"item":"pad","order":4,"paid":2})"_Json,
+    } ) );
+    EXPECT_EQ( sources[1], ( vector<bool>{ true, false } ) );
+    EXPECT_EQ( sources[2], ( vector<bool>{ true, true } ) );
+}
+
+TEST(JsrlJoin, Full) {
+    vector<vector<bool>> sources;
+    vector<Json> const records = join( JoinOptions::JK_FULL, &sources );
+    ASSERT_EQ( records.size(), 6u );
+    EXPECT_EQ( records[3], R"({"order":3,"paid":9})"_Json );
+    EXPECT_EQ( sources[3], ( vector<bool>{ false, true } ) );
+}
+
+TEST(JsrlJoin, ThreeInputs) {
+    std::istringstream a( "{\"k\":\"x\",\"a\":1}\n{\"k\":\"y\",\"a\":2}\n" );
+    std::istringstream b( "{\"k\":\"x\",\"b\":1}\n{\"k\":\"y\",\"b\":2}\n" );
+    std::istringstream c( "{\"k\":\"y\",\"a\":0,\"c\":3}\n" );
+    std::ostringstream out;
+    EXPECT_EQ( jsrl::merge_join_ndjson( {
+                { a.rdbuf(), JsonPointer( "/k" ) },
+                { b.rdbuf(), JsonPointer( "/k" ) },
+                { c.rdbuf(), JsonPointer( "/k" ) } }, out ), 1u );
+    // The later input's value wins.
+    EXPECT_EQ( out.str(), "{\"a\":0,\"b\":2,\"c\":3,\"k\":\"y\"}\n" );
+}
+
+TEST(JsrlJoin, Errors) {
+    std::istringstream left( "{\"id\":2}\n{\"id\":1}\n" ), right( "{\"id\":2}\n" );
+    MergeJoin unsorted( { { left.rdbuf(), JsonPointer( "/id" ) },
+                          { right.rdbuf(), JsonPointer( "/id" ) } } );
+    Json record;
+    EXPECT_THROW( unsorted.next( record ), JoinError );
+
+    std::istringstream array( "[1]\n" ), other( "{\"id\":1}\n" );
+    MergeJoin arrays( { { array.rdbuf(), JsonPointer( "/id" ) },
+                        { other.rdbuf(), JsonPointer( "/id" ) } } );
+    EXPECT_THROW( arrays.next( record ), JoinError );
+
+    std::istringstream bad( "{\"id\":1}\n{\"id\n{\"id\":3}\n" ), good( "{\"id\":3}\n" );
+    JoinOptions options;
+    options.skip_invalid = true;
+    MergeJoin skipping( { { bad.rdbuf(), JsonPointer( "/id" ) },
+                          { good.rdbuf(), JsonPointer( "/id" ) } }, options );
+    ASSERT_TRUE( skipping.next( record ) );
+    EXPECT_EQ( record, R"({"id":3})"_Json );
+    EXPECT_FALSE( skipping.next( record ) );
+    EXPECT_EQ( skipping.invalid(), 1u );
+}
+
+TEST(JsrlJoin, MergeObjectBodies) {
+    Json const a = R"({"a":1,"c":3,"e":5})"_Json;
+    Json const b = R"({"b":2,"c":4,"f":6})"_Json;
+    Json::ObjectBody const merged = jsrl::merge_object_bodies(
+            { &a.as_object(), &b.as_object() } );
+    EXPECT_EQ( Json( merged ), R"({"a":1,"b":2,"c":4,"e":5,"f":6})"_Json );
+    EXPECT_EQ( merged.size(), 5u );
+}
+
+// vi: et ts=4 sts=4 sw=4
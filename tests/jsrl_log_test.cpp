@@ -0,0 +1,121 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+
+#include "jsrl_test_temp.hpp"
+#include "../src/jsrl_log.hpp"
+#include <gtest/gtest.h>
+#include <fstream>
+#include <set>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace {
+    using jsrl::AsyncLogOptions;
+    using jsrl::AsyncLogSink;
+    using jsrl::Json;
+    using std::string;
+
+    // The records in an NDJSON file.
+    std::vector<Json> read_records( string const &path ) {
+        std::vector<Json> result;
+        std::ifstream in( path );
+        string line;
+        while ( std::getline( in, line ) )
+            result.push_back( Json::parse( line ) );
+        return result;
+    }
+
+    Json make_record( int thread, int index ) {
+        return Json::ObjectBody{
+            { "thread", Json( thread ) },
+            { "index", Json( index ) },
+            { "msg", Json( "request \"done\"" ) },
+        };
+    }
+}
+
+TEST( JsrlLog,WritesEveryRecordOnce ) {
+    TempPath file;
+    AsyncLogOptions options;
+    options.encoder_threads = 2;
+    options.batch_bytes = 256;
+    options.backpressure = AsyncLogOptions::BP_BLOCK;
+    options.capacity = 16;
+    {
+        AsyncLogSink sink( file.path, options );
+        std::vector<std::thread> threads;
+        for ( int t = 0; t != 4; ++t ) {
+            threads.emplace_back( [&sink, t] {
+                for ( int i = 0; i != 500; ++i )
+                    EXPECT_TRUE( sink.log( make_record( t, i ) ) );
+            } );
+        }
+        for ( auto &&thread : threads )
+            thread.join();
+        sink.flush();
+        auto const stats = sink.stats();
+        EXPECT_EQ( 2000u, stats.queued );
+        EXPECT_EQ( 2000u, stats.written );
+        EXPECT_EQ( 0u, stats.dropped );
+    }
+    std::set<std::pair<long long, long long>> seen;
+    for ( auto &&record : read_records( file.path ) ) {
+        EXPECT_EQ( "request \"done\"", record["msg"].as_string() );
+        seen.emplace( record["thread"].as_number_sint(),
+                record["index"].as_number_sint() );
+    }
+    EXPECT_EQ( 2000u, seen.size() );
+}
+
+TEST( JsrlLog,SingleThreadKeepsOrder ) {
+    TempPath file;
+    {
+        AsyncLogSink sink( file.path, AsyncLogOptions() );
+        for ( int i = 0; i != 100; ++i )
+            sink.log( make_record( 0, i ) );
+    }
+    auto const records = read_records( file.path );
+    ASSERT_EQ( 100u, records.size() );
+    for ( int i = 0; i != 100; ++i )
+        EXPECT_EQ( i, records[i]["index"].as_number_sint() );
+}
+
+TEST( JsrlLog,DropAndSampleAccounting ) {
+    for ( auto policy : { AsyncLogOptions::BP_DROP, AsyncLogOptions::BP_SAMPLE } ) {
+        TempPath file;
+        AsyncLogOptions options;
+        options.capacity = 4;
+        options.backpressure = policy;
+        options.sample_rate = 4;
+        size_t accepted = 0;
+        {
+            AsyncLogSink sink( file.path, options );
+            for ( int i = 0; i != 5000; ++i )
+                accepted += sink.log( make_record( 0, i ) );
+            sink.flush();
+            auto const stats = sink.stats();
+            EXPECT_EQ( 5000u, stats.queued + stats.dropped );
+            EXPECT_EQ( accepted, stats.queued );
+            EXPECT_EQ( stats.queued, stats.written );
+        }
+        EXPECT_EQ( accepted, read_records( file.path ).size() );
+    }
+}
+
+TEST( JsrlLog,OpenFailure ) {
+    EXPECT_THROW( AsyncLogSink( "/nonexistent-dir/log.ndjson", AsyncLogOptions() ),
+            std::system_error );
+}
+
+// vi: et ts=4 sts=4 sw=4
@@ -0,0 +1,214 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+
+#include "jsrl_test_temp.hpp"
+#include "../src/jsrl_ndjson.hpp"
+#include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace {
+    using jsrl::Json;
+    using jsrl::NdjsonFile;
+    using jsrl::NdjsonIndex;
+    using jsrl::NdjsonIndexError;
+    using jsrl::NdjsonReader;
+    using std::string;
+    using std::string_view;
+    using std::vector;
+
+    string numbered_records( int count ) {
+        string text;
+        for ( int i = 0; i != count; ++i ) {
+            text += "{\"n\":" + std::to_string( i ) + "}\n";
+            if ( i % 7 == 3 )
+                text += "\n";
+        }
+        return text;
+    }
+
+    NdjsonIndex build_index( string const &text, uint64_t every ) {
+        std::istringstream iss( text );
+        return NdjsonIndex::s_build( *iss.rdbuf(), every );
+    }
+}
+
+TEST( JsrlNdjson,Records ) {
+    std::istringstream iss( "{\"a\":1}\r\n\n  \n[2]\n\"three\"" );
+    // A tiny block size exercises lines spanning blocks.
+    NdjsonReader records( *iss.rdbuf(), 4 );
+    string_view record;
+    ASSERT_TRUE( records.next( record ) );
+    EXPECT_EQ( "{\"a\":1}", record );
+    EXPECT_EQ( 0u, records.record_offset() );
+    EXPECT_EQ( 1u, records.line_number() );
+    ASSERT_TRUE( records.next( record ) );
+    EXPECT_EQ( "[2]", record );
+    EXPECT_EQ( 13u, records.record_offset() );
+    EXPECT_EQ( 4u, records.line_number() );
+    ASSERT_TRUE( records.next( record ) );
+    EXPECT_EQ( "\"three\"", record );
+    EXPECT_EQ( 17u, records.record_offset() );
+    EXPECT_FALSE( records.next( record ) );
+    EXPECT_FALSE( records.next( record ) );
+}
+
+TEST( JsrlNdjson,LongLines ) {
+    string const long_line( 1000, 'x' );
+    std::istringstream iss( long_line + "\n" + long_line + "y\n" );
+    NdjsonReader records( *iss.rdbuf(), 16 );
+    string_view record;
+    ASSERT_TRUE( records.next( record ) );
+    EXPECT_EQ( long_line, record );
+    ASSERT_TRUE( records.next( record ) );
+    EXPECT_EQ( long_line + "y", record );
+    EXPECT_EQ( 1001u, records.record_offset() );
+    EXPECT_FALSE( records.next( record ) );
+}
+
+TEST( JsrlNdjson,Chunks ) {
+    std::istringstream iss( "1\n2\n\n3\n4\n5" );
+    NdjsonReader records( *iss.rdbuf() );
+    vector<string> chunks;
+    string chunk;
+    while ( records.next_chunk( chunk, 4 ) ) {
+        chunks.push_back( chunk );
+        chunk.clear();
+    }
+    EXPECT_EQ( ( vector<string>{ "1\n2\n", "3\n4\n", "5\n" } ), chunks );
+}
+
+TEST( JsrlNdjson,RequiredLiterals ) {
+    std::istringstream iss(
+            "{\"event\":\"view\",\"id\":1}\n"
+            "{\"event\":\"purchase\",\"id\":2}\n"
+            "{\"event\": \"purchase\",\"id\":3}\n"
+            "{\"id\":4,\"event\":\"purchase\",\"vip\":true}\n" );
+    NdjsonReader records( *iss.rdbuf(), 8 );
+    records.require_literals( { "\"event\":\"purchase\"", "" } );
+    string_view record;
+    vector<uint64_t> lines;
+    while ( records.next( record ) ) {
+        lines.push_back( records.line_number() );
+        if ( lines.size() == 1 ) {
+            EXPECT_EQ( "{\"event\":\"purchase\",\"id\":2}", record );
+            records.require_literals( { "vip", "\"event\":\"purchase\"" } );
+        }
+    }
+    EXPECT_EQ( ( vector<uint64_t>{ 2, 4 } ), lines );
+    EXPECT_EQ( 2u, records.filtered() );
+}
+
+TEST( JsrlNdjson,TextReader ) {
+    string const text = "a\n\nb\r\nc";
+    NdjsonReader records{ string_view( text ) };
+    string_view record;
+    vector<string> seen;
+    while ( records.next( record ) )
+        seen.emplace_back( record );
+    EXPECT_EQ( ( vector<string>{ "a", "b", "c" } ), seen );
+    EXPECT_EQ( text.size(), records.end_offset() );
+}
+
+TEST( JsrlNdjson,IndexLocate ) {
+    string const text = numbered_records( 50 );
+    for ( uint64_t every : { 1, 4, 64 } ) {
+        NdjsonIndex const index = build_index( text, every );
+        EXPECT_EQ( 50u, index.records() );
+        EXPECT_EQ( text.size(), index.data_size() );
+        for ( uint64_t k = 0; k != 50; ++k ) {
+            auto const position = index.locate( k );
+            EXPECT_EQ( k % every, position.skip );
+            NdjsonReader records{ string_view( text ).substr(
+                    position.offset, position.end - position.offset ) };
+            string_view record;
+            for ( uint64_t i = 0; i <= position.skip; ++i )
+                ASSERT_TRUE( records.next( record ) );
+            EXPECT_EQ( Json::parse( record )["n"].as_number_xint(), int64_t( k ) );
+        }
+        EXPECT_THROW( index.locate( 50 ), Json::ArrayKeyError );
+    }
+}
+
+TEST( JsrlNdjson,IndexSaveLoad ) {
+    string const text = numbered_records( 300 );
+    NdjsonIndex const index = build_index( text, 3 );
+    std::stringstream saved;
+    index.save( saved );
+    // Offsets are delta coded: one byte each here.
+    EXPECT_LT( saved.str().size(), 8 + 8 + index.records() / 3 + 1 );
+    NdjsonIndex const loaded = NdjsonIndex::s_load( saved );
+    EXPECT_EQ( index.records(), loaded.records() );
+    EXPECT_EQ( index.data_size(), loaded.data_size() );
+    EXPECT_EQ( index.sample_every(), loaded.sample_every() );
+    for ( uint64_t k : { 0, 1, 150, 299 } )
+        EXPECT_EQ( index.locate( k ).offset, loaded.locate( k ).offset );
+
+    std::istringstream bad_magic( "JSONNDX1" );
+    EXPECT_THROW( NdjsonIndex::s_load( bad_magic ), NdjsonIndexError );
+    std::istringstream truncated( saved.str().substr( 0, saved.str().size() - 2 ) );
+    EXPECT_THROW( NdjsonIndex::s_load( truncated ), NdjsonIndexError );
+}
+
+TEST( JsrlNdjson,IndexSplit ) {
+    string const text = numbered_records( 1000 );
+    NdjsonIndex const index = build_index( text, 10 );
+    auto const ranges = index.split( 4 );
+    ASSERT_EQ( 4u, ranges.size() );
+    uint64_t offset = 0;
+    uint64_t record = 0;
+    for ( auto &&range : ranges ) {
+        EXPECT_EQ( offset, range.begin );
+        EXPECT_EQ( record, range.first_record );
+        EXPECT_NEAR( double( range.end - range.begin ), text.size() / 4.0,
+                text.size() / 20.0 );
+        // Each range holds exactly its records.
+        NdjsonReader records{ string_view( text ).substr(
+                range.begin, range.end - range.begin ) };
+        string_view line;
+        uint64_t count = 0;
+        while ( records.next( line ) )
+            ++count;
+        EXPECT_EQ( range.records, count );
+        offset = range.end;
+        record += range.records;
+    }
+    EXPECT_EQ( text.size(), offset );
+    EXPECT_EQ( 1000u, record );
+
+    EXPECT_EQ( 1u, build_index( "1\n2\n", 1 ).split( 1 ).size() );
+    EXPECT_EQ( 2u, build_index( "1\n2\n", 1 ).split( 8 ).size() );
+    EXPECT_TRUE( build_index( "", 1 ).split( 4 ).empty() );
+}
+
+TEST( JsrlNdjson,FileRecords ) {
+    TempPath file;
+    string const text = numbered_records( 100 );
+    std::ofstream( file.path, std::ios::binary ) << text;
+    NdjsonIndex const index = build_index( text, 8 );
+    NdjsonFile const ndjson( file.path );
+    EXPECT_EQ( text.size(), ndjson.size() );
+    EXPECT_EQ( "{\"n\":0}", ndjson.record( index, 0 ) );
+    EXPECT_EQ( "{\"n\":42}", ndjson.record( index, 42 ) );
+    EXPECT_EQ( "{\"n\":99}", ndjson.record( index, 99 ) );
+    EXPECT_THROW( ndjson.record( index, 100 ), Json::ArrayKeyError );
+    string bytes;
+    ndjson.read( 0, 7, bytes );
+    EXPECT_EQ( "{\"n\":0}", bytes );
+    EXPECT_THROW( ndjson.read( 0, text.size() + 1, bytes ), std::system_error );
+    EXPECT_THROW( NdjsonFile( file.path + ".missing" ), std::system_error );
+}
+
+// vi: et ts=4 sts=4 sw=4
@@ -0,0 +1,165 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+
+#include "../src/jsrl_pipeline.hpp"
+#include "../src/jsrl_impl_util.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    using jsrl::Json;
+    using jsrl::Pipeline;
+    using jsrl::PipelineOptions;
+    using std::string;
+    using std::vector;
+
+    string numbered( size_t count ) {
+        string text;
+        for ( size_t i = 0; i != count; ++i )
+            text += "{\"n\":" + std::to_string( i ) + "}\n";
+        return text;
+    }
+
+    string run( Pipeline &pipeline, string const &input ) {
+        jsrl::jsrl_streambuf in( input.data(), input.data() + input.size() );
+        std::ostringstream out;
+        pipeline.run( in, out );
+        return out.str();
+    }
+
+    vector<long long> numbers( string const &output ) {
+        vector<long long> result;
+        std::istringstream lines( output );
+        string line;
+        while ( std::getline( lines, line ) )
+            result.push_back( Json::parse( line )["n"].as_number_sint() );
+        return result;
+    }
+
+    PipelineOptions small_batches() {
+        PipelineOptions options;
+        options.parse_threads = 3;
+        options.encode_threads = 2;
+        options.queue_capacity = 2;
+        options.batch_bytes = 64;
+        return options;
+    }
+}
+
+TEST( JsrlPipeline,Passthrough ) {
+    string const input = "{ \"a\": [1, 2.50] }\n\n\"x\"";
+    Pipeline pipeline;
+    EXPECT_EQ( "{\"a\":[1,2.5]}\n\"x\"\n", run( pipeline, input ) );
+    EXPECT_EQ( "", run( pipeline, "" ) );
+
+    // Lazy numbers are written as they were read.
+    PipelineOptions options;
+    options.parse_options = Json::ParseOptions( false, true );
+    Pipeline verbatim( options );
+    EXPECT_EQ( "{\"a\":[1,2.50]}\n\"x\"\n", run( verbatim, input ) );
+}
+
+TEST( JsrlPipeline,OrderedStages ) {
+    Pipeline pipeline( small_batches() );
+    pipeline
+        .filter( "even", []( Json const &record ) {
+                return record["n"].as_number_sint() % 2 == 0; }, 3 )
+        .map( "halve", []( Json const &record ) {
+                Json result = record;
+                result.set( "n", record["n"].as_number_sint() / 2 );
+                return result; }, 4 );
+    auto const result = numbers( run( pipeline, numbered( 5000 ) ) );
+    ASSERT_EQ( 2500u, result.size() );
+    for ( size_t i = 0; i != result.size(); ++i )
+        ASSERT_EQ( (long long)i, result[i] );
+
+    auto const metrics = pipeline.metrics();
+    vector<string> names;
+    for ( auto &&stage : metrics )
+        names.push_back( stage.name );
+    EXPECT_EQ( ( vector<string>{ "source", "parse", "even", "halve", "encode", "sink" } ),
+            names );
+    EXPECT_EQ( 5000u, metrics[0].records_out );
+    EXPECT_EQ( 5000u, metrics[2].records_in );
+    EXPECT_EQ( 2500u, metrics[2].records_out );
+    EXPECT_EQ( 2500u, metrics[5].records_out );
+    EXPECT_EQ( 3u, metrics[2].threads );
+    EXPECT_EQ( 0u, metrics[0].queue_capacity );
+    for ( size_t i = 1; i != metrics.size(); ++i ) {
+        EXPECT_EQ( 2u, metrics[i].queue_capacity );
+        EXPECT_LE( metrics[i].max_queue_depth, 2u );
+        EXPECT_GT( metrics[i].seconds, 0 );
+    }
+}
+
+TEST( JsrlPipeline,OrderedHoldsBackWhileOneBatchIsSlow ) {
+    PipelineOptions options = small_batches();
+    options.batch_bytes = 1;    // A record a batch.
+    Pipeline pipeline( options );
+    std::atomic<size_t> passed{ 0 };
+    size_t passed_while_slow = 0;
+    pipeline.filter( "slow first", [&]( Json const &record ) {
+            if ( record["n"].as_number_sint() == 0 ) {
+                std::this_thread::sleep_for( std::chrono::milliseconds( 200 ) );
+                passed_while_slow = passed.load();
+            }
+            ++passed;
+            return true; }, 4 );
+    auto const result = numbers( run( pipeline, numbered( 2000 ) ) );
+    ASSERT_EQ( 2000u, result.size() );
+    for ( size_t i = 0; i != result.size(); ++i )
+        ASSERT_EQ( (long long)i, result[i] );
+    // Later batches wait for the first, rather than pile up behind it.
+    EXPECT_LT( passed_while_slow, 100u );
+}
+
+TEST( JsrlPipeline,Unordered ) {
+    PipelineOptions options = small_batches();
+    options.ordered = false;
+    Pipeline pipeline( options );
+    pipeline.map( "same", []( Json const &record ) { return record; }, 4 );
+    auto result = numbers( run( pipeline, numbered( 3000 ) ) );
+    std::sort( result.begin(), result.end() );
+    ASSERT_EQ( 3000u, result.size() );
+    for ( size_t i = 0; i != result.size(); ++i )
+        ASSERT_EQ( (long long)i, result[i] );
+}
+
+TEST( JsrlPipeline,InvalidRecords ) {
+    string const input = "{\"n\":0}\n{\"n\":\n{\"n\":2}\n";
+    Pipeline strict;
+    EXPECT_THROW( run( strict, input ), Json::ParseError );
+
+    PipelineOptions options;
+    options.skip_invalid = true;
+    Pipeline lenient( options );
+    EXPECT_EQ( ( vector<long long>{ 0, 2 } ), numbers( run( lenient, input ) ) );
+    EXPECT_EQ( 1u, lenient.invalid() );
+}
+
+TEST( JsrlPipeline,StageFailure ) {
+    Pipeline pipeline( small_batches() );
+    pipeline.stage( "fail", []( Json &record ) -> bool {
+            if ( record["n"] == 1234 )
+                throw std::runtime_error( "stage failed" );
+            return true; }, 2 );
+    EXPECT_THROW( run( pipeline, numbered( 10000 ) ), std::runtime_error );
+}
+
+// vi: et ts=4 sts=4 sw=4
@@ -0,0 +1,58 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+
+#include "../src/jsrl_pointer.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace {
+    using namespace jsrl::literals;
+    using jsrl::Json;
+    using jsrl::JsonPointer;
+    using jsrl::JsonPointerError;
+    using std::string;
+    using std::vector;
+}
+
+TEST( JsrlPointer,Parse ) {
+    EXPECT_TRUE( JsonPointer( "" ).empty() );
+    EXPECT_EQ( ( vector<string>{ "a", "", "b/c", "~d" } ),
+            JsonPointer( "/a//b~1c/~0d" ).tokens() );
+    EXPECT_EQ( "/a//b~1c/~0d", JsonPointer( "/a//b~1c/~0d" ).to_string() );
+    EXPECT_EQ( JsonPointer( "/x/0" ), JsonPointer( vector<string>{ "x", "0" } ) );
+    EXPECT_THROW( JsonPointer( "a" ), JsonPointerError );
+    EXPECT_THROW( JsonPointer( "/a~2" ), JsonPointerError );
+    EXPECT_THROW( JsonPointer( "/a~" ), JsonPointerError );
+}
+
+TEST( JsrlPointer,Find ) {
+    Json const doc = R"JSON({"a": [10, {"b/c": true}], "": 1})JSON"_Json;
+    EXPECT_EQ( doc, *JsonPointer().find( doc ) );
+    EXPECT_EQ( Json( 10 ), *JsonPointer( "/a/0" ).find( doc ) );
+    EXPECT_EQ( Json( true ), *JsonPointer( "/a/1/b~1c" ).find( doc ) );
+    EXPECT_EQ( Json( 1 ), *JsonPointer( "/" ).find( doc ) );
+    EXPECT_EQ( nullptr, JsonPointer( "/a/2" ).find( doc ) );
+    EXPECT_EQ( nullptr, JsonPointer( "/a/01" ).find( doc ) );
+    EXPECT_EQ( nullptr, JsonPointer( "/a/0/x" ).find( doc ) );
+    EXPECT_EQ( nullptr, JsonPointer( "/b" ).find( doc ) );
+}
+
+TEST( JsrlPointer,Index ) {
+    EXPECT_EQ( 0u, JsonPointer::s_index( "0" ) );
+    EXPECT_EQ( 123u, JsonPointer::s_index( "123" ) );
+    EXPECT_EQ( JsonPointer::npos, JsonPointer::s_index( "" ) );
+    EXPECT_EQ( JsonPointer::npos, JsonPointer::s_index( "-" ) );
+    EXPECT_EQ( JsonPointer::npos, JsonPointer::s_index( "007" ) );
+    EXPECT_EQ( JsonPointer::npos,
+            JsonPointer::s_index( "99999999999999999999999" ) );
+}
@@ -0,0 +1,127 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+
+#include "../src/jsrl_predicate.hpp"
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+    using namespace jsrl::literals;
+    using jsrl::FieldPredicate;
+    using jsrl::Json;
+    using jsrl::JsonPointer;
+    using jsrl::NdjsonReader;
+    using jsrl::PredicateError;
+    using jsrl::RecordScanner;
+    using std::string;
+    using std::string_view;
+    using std::vector;
+
+    JsonPointer operator""_ptr( char const *text, size_t size ) {
+        return JsonPointer( string_view( text, size ) );
+    }
+}
+
+TEST( JsrlPredicate,Tests ) {
+    auto const equals = FieldPredicate::s_equals( "/a"_ptr, 1 );
+    EXPECT_TRUE( equals.test( 1 ) );
+    EXPECT_TRUE( equals.test( "1.0"_Json ) );
+    EXPECT_FALSE( equals.test( "1" ) );
+
+    auto const in_set = FieldPredicate::s_in_set( "/a"_ptr, { "x", 3, Json(), "y" } );
+    EXPECT_TRUE( in_set.test( "y" ) );
+    EXPECT_TRUE( in_set.test( "3e0"_Json ) );
+    EXPECT_TRUE( in_set.test( Json() ) );
+    EXPECT_FALSE( in_set.test( "z" ) );
+
+    auto const range = FieldPredicate::s_range( "/a"_ptr, 10, "20.5"_Json );
+    EXPECT_TRUE( range.test( 10 ) );
+    EXPECT_TRUE( range.test( "20.5"_Json ) );
+    EXPECT_FALSE( range.test( "20.6"_Json ) );
+    EXPECT_FALSE( range.test( "15" ) );
+    auto const from = FieldPredicate::s_range( "/a"_ptr, "m", Json() );
+    EXPECT_TRUE( from.test( "zebra" ) );
+    EXPECT_FALSE( from.test( "apple" ) );
+    EXPECT_FALSE( from.test( 99 ) );
+    EXPECT_THROW( FieldPredicate::s_range( "/a"_ptr, 1, "9" ), PredicateError );
+    EXPECT_THROW( FieldPredicate::s_range( "/a"_ptr, true, Json() ), PredicateError );
+
+    EXPECT_TRUE( FieldPredicate::s_exists( "/a"_ptr ).test( Json() ) );
+}
+
+TEST( JsrlPredicate,Match ) {
+    RecordScanner scanner(
+            { FieldPredicate::s_equals( "/event"_ptr, "purchase" ),
+              FieldPredicate::s_range( "/cart/total"_ptr, 100, Json() ) },
+            { "/user"_ptr, "/cart/items/0"_ptr, "/missing"_ptr } );
+    vector<Json> fields;
+    EXPECT_TRUE( scanner.match( R"({"user":"u1","event":"purchase",)"
+                R"("cart":{"items":["a","b"],"total":150}})", &fields ) );
+    EXPECT_EQ( ( vector<Json>{ "u1", "a", Json() } ), fields );
+    EXPECT_FALSE( scanner.match( R"({"event":"purchase","cart":{"total":99}})" ) );
+    // A missing path fails its predicate.
+    EXPECT_FALSE( scanner.match( R"({"event":"purchase"})" ) );
+    // The record is given up at the first failing predicate,
+    // before the bad bytes that follow.
+    EXPECT_FALSE( scanner.match( R"({"event":"view", "cart": oops)" ) );
+    EXPECT_THROW( scanner.match( R"({"event":"purchase", "cart": oops)" ),
+            Json::ParseError );
+    EXPECT_EQ( 5u, scanner.scanned() );
+    EXPECT_EQ( 1u, scanner.matched() );
+}
+
+TEST( JsrlPredicate,NestedPaths ) {
+    // A value read whole for one path answers the paths below it.
+    RecordScanner scanner(
+            { FieldPredicate::s_exists( "/a"_ptr ),
+              FieldPredicate::s_in_set( "/a/b/1"_ptr, { 2, 3 } ) },
+            { "/a/c"_ptr } );
+    vector<Json> fields;
+    EXPECT_TRUE( scanner.match( R"({"a":{"b":[1,2],"c":"x"}})", &fields ) );
+    EXPECT_EQ( ( vector<Json>{ "x" } ), fields );
+    EXPECT_FALSE( scanner.match( R"({"a":{"b":[1,5]}})" ) );
+    EXPECT_FALSE( scanner.match( R"({"a":{"b":[1]}})" ) );
+}
+
+TEST( JsrlPredicate,EarlyExit ) {
+    RecordScanner validating( { FieldPredicate::s_equals( "/id"_ptr, 7 ) } );
+    EXPECT_THROW( validating.match( R"({"id":7, "rest": [)" ), Json::ParseError );
+    RecordScanner early( { FieldPredicate::s_equals( "/id"_ptr, 7 ) },
+            { "/name"_ptr }, false );
+    vector<Json> fields;
+    EXPECT_TRUE( early.match( R"({"name":"n","id":7, "rest": [)", &fields ) );
+    EXPECT_EQ( ( vector<Json>{ "n" } ), fields );
+    // Still reads on until every field is found.
+    EXPECT_THROW( early.match( R"({"id":7, "rest": [)" ), Json::ParseError );
+}
+
+TEST( JsrlPredicate,NdjsonRecords ) {
+    std::istringstream iss(
+            "{\"n\":1,\"kind\":\"a\"}\n"
+            "{\"n\":2,\"kind\":\"b\"}\n"
+            "{\"n\":3,\"kind\":\"c\"}\n"
+            "{\"n\":4}\n" );
+    NdjsonReader records( *iss.rdbuf() );
+    RecordScanner scanner( { FieldPredicate::s_in_set( "/kind"_ptr, { "a", "c" } ) },
+            { "/n"_ptr } );
+    string_view record;
+    vector<Json> fields;
+    vector<Json> found;
+    while ( scanner.next( records, record, &fields ) )
+        found.push_back( fields[0] );
+    EXPECT_EQ( ( vector<Json>{ 1, 3 } ), found );
+    EXPECT_EQ( 4u, scanner.scanned() );
+}
+
+// vi: et ts=4 sts=4 sw=4
@@ -0,0 +1,190 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+
+#include "../src/jsrl_profile.hpp"
+#include <gtest/gtest.h>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+    using namespace jsrl::literals;
+    using jsrl::FieldProfile;
+    using jsrl::Json;
+    using jsrl::JsonReader;
+    using jsrl::ProfileOptions;
+    using jsrl::Profiler;
+    using std::string;
+    using std::vector;
+
+    std::map<string, FieldProfile> by_path( Profiler const &profiler ) {
+        std::map<string, FieldProfile> result;
+        for ( auto &&field : profiler.fields() )
+            result[field.path] = field;
+        return result;
+    }
+
+    char const *const records[] = {
+        R"JSON({"id": 1, "name": "a", "tags": ["x", "y"], "score": 2.5})JSON",
+        R"JSON({"id": 2, "name": "b", "tags": [], "score": null})JSON",
+        R"JSON({"id": 3, "name": "a", "tags": ["x"]})JSON",
+        R"JSON({"id": 18446744073709551615, "name": "a", "a/b": true})JSON",
+    };
+}
+
+TEST( JsrlProfile,Fields ) {
+    Profiler profiler;
+    for ( char const *record : records )
+        profiler.add( Json::parse( record ) );
+    EXPECT_EQ( 4u, profiler.records() );
+    auto fields = by_path( profiler );
+    vector<string> paths;
+    for ( auto &&field : profiler.fields() )
+        paths.push_back( field.path );
+    EXPECT_EQ( ( vector<string>{ "", "/a~1b", "/id", "/name", "/score",
+                "/tags", "/tags/*" } ), paths );
+
+    EXPECT_EQ( 4u, fields[""].objects );
+    FieldProfile const &id = fields["/id"];
+    EXPECT_EQ( 4u, id.integers );
+    EXPECT_EQ( 1.0, id.presence );
+    EXPECT_EQ( Json( 1 ), id.minimum );
+    EXPECT_EQ( "18446744073709551615"_Json, id.maximum );
+    EXPECT_EQ( 4u, id.distinct );
+
+    FieldProfile const &name = fields["/name"];
+    EXPECT_EQ( 4u, name.strings );
+    EXPECT_EQ( 1u, name.min_length );
+    EXPECT_EQ( 2u, name.distinct );
+    ASSERT_EQ( 2u, name.top_values.size() );
+    EXPECT_EQ( Json( "a" ), name.top_values[0].first );
+    EXPECT_EQ( 3u, name.top_values[0].second );
+
+    FieldProfile const &score = fields["/score"];
+    EXPECT_EQ( 0.5, score.presence );
+    EXPECT_EQ( 1u, score.numbers );
+    EXPECT_EQ( 1u, score.nulls );
+    EXPECT_EQ( 0.25, fields["/a~1b"].presence );
+    EXPECT_EQ( 3u, fields["/tags/*"].count );
+    EXPECT_EQ( 1.0, fields["/tags/*"].presence );
+}
+
+TEST( JsrlProfile,ReaderMatchesTree ) {
+    Profiler tree;
+    Profiler streamed;
+    for ( char const *record : records ) {
+        tree.add( Json::parse( record ) );
+        JsonReader reader( record );
+        streamed.add( reader );
+    }
+    EXPECT_EQ( tree.infer_schema(), streamed.infer_schema() );
+    auto const lhs = tree.fields();
+    auto const rhs = streamed.fields();
+    ASSERT_EQ( lhs.size(), rhs.size() );
+    for ( size_t i = 0; i != lhs.size(); ++i ) {
+        EXPECT_EQ( lhs[i].path, rhs[i].path );
+        EXPECT_EQ( lhs[i].count, rhs[i].count );
+        EXPECT_EQ( lhs[i].minimum, rhs[i].minimum );
+        EXPECT_EQ( lhs[i].maximum, rhs[i].maximum );
+        EXPECT_EQ( lhs[i].distinct, rhs[i].distinct );
+    }
+}
+
+TEST( JsrlProfile,NumbersKeyedByValue ) {
+    // However a number is spelled, and whichever way it is read,
+    // it counts as one value.
+    char const *const spellings[] = { "100", "1e2", "100.0", "1.50", "1.5",
+        "-0", "0.0", "0.125", "12.5e-2" };
+    Profiler tree;
+    Profiler streamed;
+    for ( char const *text : spellings ) {
+        tree.add( Json::parse( text ) );
+        tree.add( Json::parse( text, Json::ParseOptions( true, true ) ) );
+        JsonReader reader( text );
+        streamed.add( reader );
+    }
+    tree.merge( streamed );
+    auto const field = tree.fields().at( 0 );
+    auto const &top = field.top_values;
+    ASSERT_EQ( 4u, top.size() );
+    std::map<Json, uint64_t> counts( top.begin(), top.end() );
+    EXPECT_EQ( 9u, counts[Json( 100 )] );
+    EXPECT_EQ( 6u, counts[Json( 1.5 )] );
+    EXPECT_EQ( 6u, counts[Json( 0 )] );
+    EXPECT_EQ( 6u, counts[Json( 0.125 )] );
+    EXPECT_EQ( 4u, field.distinct );
+}
+
+TEST( JsrlProfile,InferSchema ) {
+    Profiler profiler;
+    for ( char const *record : records )
+        profiler.add( Json::parse( record ) );
+    EXPECT_EQ( R"JSON({
+        "type": "object",
+        "properties": {
+            "a/b": {"type": "boolean"},
+            "id": {"type": "integer"},
+            "name": {"type": "string"},
+            "score": {"type": ["null", "number"]},
+            "tags": {"type": "array", "items": {"type": "string"}}
+        },
+        "required": ["id", "name"]
+    })JSON"_Json, profiler.infer_schema() );
+}
+
+TEST( JsrlProfile,ParallelNdjson ) {
+    string text;
+    for ( int i = 0; i != 20000; ++i ) {
+        text += R"JSON({"n": )JSON" + std::to_string( i )
+                + R"JSON(, "k": ")JSON" + std::to_string( i % 7 ) + "\"}\n";
+    }
+    text += "not json\n";
+    std::istringstream iss( text );
+    ProfileOptions options;
+    options.threads = 4;
+    options.chunk_bytes = 4096;
+    options.skip_invalid = true;
+    Profiler profiler = jsrl::profile_ndjson( *iss.rdbuf(), options );
+    EXPECT_EQ( 20000u, profiler.records() );
+    EXPECT_EQ( 1u, profiler.invalid() );
+    auto fields = by_path( profiler );
+    FieldProfile const &n = fields["/n"];
+    EXPECT_EQ( 20000u, n.integers );
+    EXPECT_EQ( Json( 0 ), n.minimum );
+    EXPECT_EQ( Json( 19999 ), n.maximum );
+    // HyperLogLog at the default precision is within a few percent.
+    EXPECT_NEAR( 20000.0, double( n.distinct ), 1000.0 );
+    FieldProfile const &k = fields["/k"];
+    EXPECT_EQ( 7u, k.distinct );
+    ASSERT_EQ( 7u, k.top_values.size() );
+    uint64_t total = 0;
+    for ( auto &&value : k.top_values )
+        total += value.second;
+    EXPECT_EQ( 20000u, total );
+
+    std::istringstream bad( "{}\n{\n" );
+    EXPECT_THROW( jsrl::profile_ndjson( *bad.rdbuf() ), Json::ParseError );
+}
+
+TEST( JsrlProfile,ParallelValues ) {
+    vector<Json> values;
+    for ( int i = 0; i != 1000; ++i )
+        values.push_back( Json::ObjectBody{ { "v", i % 3 == 0 ? Json( i ) : Json() } } );
+    ProfileOptions options;
+    options.threads = 3;
+    Profiler profiler = jsrl::profile_values( values, options );
+    auto fields = by_path( profiler );
+    EXPECT_EQ( 334u, fields["/v"].integers );
+    EXPECT_EQ( 666u, fields["/v"].nulls );
+    EXPECT_EQ( Json( 999 ), fields["/v"].maximum );
+}
@@ -0,0 +1,87 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+
+#include "../src/jsrl_queue.hpp"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+    using jsrl::BoundedQueue;
+}
+
+TEST( JsrlQueue,FifoAndBounds ) {
+    BoundedQueue<int> queue( 3 );
+    EXPECT_EQ( 4u, queue.capacity() );
+    for ( int i = 0; i != 4; ++i )
+        EXPECT_TRUE( queue.try_push( i ) );
+    EXPECT_FALSE( queue.try_push( 4 ) );
+    EXPECT_EQ( 4u, queue.size_approx() );
+    int value = -1;
+    for ( int i = 0; i != 4; ++i ) {
+        EXPECT_TRUE( queue.try_pop( value ) );
+        EXPECT_EQ( i, value );
+    }
+    EXPECT_FALSE( queue.try_pop( value ) );
+    EXPECT_TRUE( queue.try_push( 5 ) );
+    EXPECT_TRUE( queue.try_pop( value ) );
+    EXPECT_EQ( 5, value );
+}
+
+TEST( JsrlQueue,PoppedSlotReleasesValue ) {
+    BoundedQueue<std::shared_ptr<int>> queue( 2 );
+    auto value = std::make_shared<int>( 1 );
+    std::weak_ptr<int> watch = value;
+    EXPECT_TRUE( queue.try_push( std::move(value) ) );
+    std::shared_ptr<int> popped;
+    EXPECT_TRUE( queue.try_pop( popped ) );
+    popped.reset();
+    EXPECT_TRUE( watch.expired() );
+}
+
+TEST( JsrlQueue,ConcurrentProducersAndConsumers ) {
+    BoundedQueue<long> queue( 64 );
+    int const producers = 4, per_producer = 20000;
+    std::atomic<long> sum{ 0 };
+    std::atomic<int> consumed{ 0 };
+    std::vector<std::thread> threads;
+    for ( int p = 0; p != producers; ++p ) {
+        threads.emplace_back( [&, p] {
+            for ( int i = 1; i <= per_producer; ++i ) {
+                long value = long( p ) * per_producer + i;
+                while ( not queue.try_push( value ) )
+                    std::this_thread::yield();
+            }
+        } );
+    }
+    for ( int c = 0; c != 3; ++c ) {
+        threads.emplace_back( [&] {
+            long value;
+            while ( consumed.load() != producers * per_producer ) {
+                if ( queue.try_pop( value ) ) {
+                    sum += value;
+                    ++consumed;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        } );
+    }
+    for ( auto &&thread : threads )
+        thread.join();
+    long const n = long( producers ) * per_producer;
+    EXPECT_EQ( n * ( n + 1 ) / 2, sum.load() );
+}
+
+// vi: et ts=4 sts=4 sw=4
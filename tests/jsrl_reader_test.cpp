@@ -0,0 +1,203 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+
+#include "../src/jsrl_reader.hpp"
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+
+namespace {
+    using namespace jsrl::literals;
+    using jsrl::ElementReader;
+    using jsrl::Json;
+    using jsrl::JsonPointer;
+    using jsrl::JsonReader;
+    using std::string;
+}
+
+TEST( JsrlReader,WalkObject ) {
+    JsonReader reader( R"JSON( {"id": 7, "name": "aé\n", "tags": [true, null],
+            /* comment */ "neg": -3, "f": 2.5e1} )JSON" );
+    EXPECT_EQ( JsonReader::TK_OBJECT, reader.peek() );
+    reader.enter_object();
+    EXPECT_EQ( 1u, reader.depth() );
+    string key;
+    ASSERT_TRUE( reader.next_key( key ) );
+    EXPECT_EQ( "id", key );
+    EXPECT_EQ( 7u, reader.read_uint() );
+    ASSERT_TRUE( reader.next_key( key ) );
+    EXPECT_EQ( "name", key );
+    EXPECT_EQ( JsonReader::TK_STRING, reader.peek() );
+    EXPECT_EQ( "a\xC3\xA9\n", reader.read_string() );
+    ASSERT_TRUE( reader.next_key( key ) );
+    reader.enter_array();
+    ASSERT_TRUE( reader.next_element() );
+    EXPECT_TRUE( reader.read_bool() );
+    ASSERT_TRUE( reader.next_element() );
+    EXPECT_EQ( JsonReader::TK_NULL, reader.peek() );
+    reader.read_null();
+    EXPECT_FALSE( reader.next_element() );
+    ASSERT_TRUE( reader.next_key( key ) );
+    EXPECT_EQ( -3, reader.read_sint() );
+    ASSERT_TRUE( reader.next_key( key ) );
+    EXPECT_EQ( 25.0, reader.read_double() );
+    EXPECT_FALSE( reader.next_key( key ) );
+    EXPECT_EQ( 0u, reader.depth() );
+    reader.finish();
+}
+
+TEST( JsrlReader,NumberText ) {
+    JsonReader reader( "[0, -1, 1.5, 18446744073709551616]" );
+    string text;
+    reader.enter_array();
+    reader.next_element();
+    EXPECT_EQ( Json::TT_NUMBER_INTEGER_UNSIGNED, reader.read_number_text( text ) );
+    reader.next_element();
+    EXPECT_EQ( Json::TT_NUMBER_INTEGER, reader.read_number_text( text ) );
+    EXPECT_EQ( "-1", text );
+    reader.next_element();
+    EXPECT_EQ( Json::TT_NUMBER, reader.read_number_text( text ) );
+    reader.next_element();
+    EXPECT_THROW( reader.read_uint(), Json::NumberParseError );
+}
+
+TEST( JsrlReader,SkipAndReadValue ) {
+    JsonReader reader( R"JSON([{"a": [1, {"b": "]"}], "c": {}}, [], "x", {"k": [2]}])JSON" );
+    reader.enter_array();
+    ASSERT_TRUE( reader.next_element() );
+    reader.skip_value();
+    ASSERT_TRUE( reader.next_element() );
+    reader.skip_value();
+    ASSERT_TRUE( reader.next_element() );
+    reader.skip_value();
+    ASSERT_TRUE( reader.next_element() );
+    EXPECT_EQ( R"JSON({"k":[2]})JSON"_Json, reader.read_value() );
+    EXPECT_FALSE( reader.next_element() );
+    reader.finish();
+}
+
+TEST( JsrlReader,StreamInput ) {
+    std::istringstream iss( R"JSON({"a": "b"} {"a": "c"})JSON" );
+    JsonReader reader( *iss.rdbuf() );
+    string key;
+    for ( char const *expected : { "b", "c" } ) {
+        reader.enter_object();
+        ASSERT_TRUE( reader.next_key( key ) );
+        EXPECT_EQ( expected, reader.read_string() );
+        EXPECT_FALSE( reader.next_key( key ) );
+    }
+    EXPECT_THROW( reader.peek(), Json::StartEOFParseError );
+}
+
+TEST( JsrlReader,Errors ) {
+    {
+        JsonReader reader( "[1,]" );
+        reader.enter_array();
+        reader.next_element();
+        reader.skip_value();
+        EXPECT_THROW( reader.next_element(), Json::TrailingCommaParseError );
+    }
+    {
+        JsonReader reader( R"JSON({"a":1,})JSON" );
+        string key;
+        reader.enter_object();
+        reader.next_key( key );
+        reader.skip_value();
+        EXPECT_THROW( reader.next_key( key ), Json::TrailingCommaParseError );
+    }
+    {
+        JsonReader reader( "[1 2]" );
+        reader.enter_array();
+        reader.next_element();
+        reader.skip_value();
+        EXPECT_THROW( reader.next_element(), Json::UnexpectedByteParseError );
+    }
+    {
+        JsonReader reader( "[1" );
+        reader.enter_array();
+        reader.next_element();
+        reader.skip_value();
+        EXPECT_THROW( reader.next_element(), Json::BadEOFParseError );
+    }
+    {
+        JsonReader reader( "nul" );
+        EXPECT_THROW( reader.read_null(), Json::BadEOFParseError );
+    }
+    {
+        JsonReader reader( "truex" );
+        EXPECT_THROW( reader.read_bool(), Json::UnexpectedByteParseError );
+    }
+    {
+        JsonReader reader( "\"x\"" );
+        EXPECT_THROW( reader.read_sint(), Json::UnexpectedByteParseError );
+    }
+    {
+        JsonReader reader( "1 2" );
+        reader.read_sint();
+        EXPECT_THROW( reader.finish(), Json::TrailingBytesParseError );
+    }
+}
+
+// vi: et ts=4 sts=4 sw=4
+
+TEST( JsrlReader,ElementsOfArray ) {
+    std::istringstream iss( R"JSON( [1, {"a": [2]}, "x"] )JSON" );
+    ElementReader elements( *iss.rdbuf() );
+    Json element;
+    ASSERT_TRUE( elements.next( element ) );
+    EXPECT_EQ( Json( 1 ), element );
+    ASSERT_TRUE( elements.next( element ) );
+    EXPECT_EQ( R"JSON({"a": [2]})JSON"_Json, element );
+    ASSERT_TRUE( elements.next( element ) );
+    EXPECT_EQ( Json( "x" ), element );
+    EXPECT_FALSE( elements.next( element ) );
+    EXPECT_FALSE( elements.next( element ) );
+    EXPECT_EQ( 3u, elements.count() );
+}
+
+TEST( JsrlReader,ElementsOfObject ) {
+    ElementReader members( R"JSON({"b": [], "a": null})JSON" );
+    string key;
+    Json value;
+    ASSERT_TRUE( members.next( key, value ) );
+    EXPECT_EQ( "b", key );
+    EXPECT_EQ( Json( Json::ArrayBody() ), value );
+    ASSERT_TRUE( members.next( key, value ) );
+    EXPECT_EQ( "a", key );
+    EXPECT_TRUE( value.is_null() );
+    EXPECT_FALSE( members.next( key, value ) );
+    EXPECT_THROW( ElementReader( "[1]" ).next( key, value ),
+            Json::UnexpectedByteParseError );
+}
+
+TEST( JsrlReader,ElementsAtPointer ) {
+    char const *const text = R"JSON({"meta": {"n": [0]}, "data": [[], [{"id": 1}, {"id": 2}], 3],
+            "after": {"x": [1, 2]}})JSON";
+    ElementReader elements( text, JsonPointer( "/data/1" ) );
+    Json element;
+    ASSERT_TRUE( elements.next( element ) );
+    EXPECT_EQ( R"JSON({"id": 1})JSON"_Json, element );
+    ASSERT_TRUE( elements.next( element ) );
+    EXPECT_FALSE( elements.next( element ) );
+
+    EXPECT_THROW( ElementReader( text, JsonPointer( "/none" ) ).next( element ),
+            Json::ObjectKeyError );
+    EXPECT_THROW( ElementReader( text, JsonPointer( "/data/5" ) ).next( element ),
+            Json::ArrayKeyError );
+    EXPECT_THROW( ElementReader( text, JsonPointer( "/data/2/x" ) ).next( element ),
+            Json::CompoundTypeError );
+    // The rest of the document must still be valid.
+    ElementReader truncated( R"JSON({"data": [1], "more": )JSON",
+            JsonPointer( "/data" ) );
+    ASSERT_TRUE( truncated.next( element ) );
+    EXPECT_THROW( truncated.next( element ), Json::ParseError );
+}
@@ -0,0 +1,197 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+
+#include "../src/jsrl_schema.hpp"
+#include <gtest/gtest.h>
+#include <string>
+
+namespace {
+    using namespace jsrl::literals;
+    using jsrl::CompiledSchema;
+    using jsrl::Json;
+    using jsrl::JsonReader;
+    using jsrl::SchemaError;
+    using jsrl::SchemaViolation;
+    using std::string;
+
+    // Validate both ways, checking that they agree.
+    bool valid( CompiledSchema const &schema, string const &text,
+            SchemaViolation *violation = nullptr ) {
+        bool const tree = schema.validate( Json::parse( text ), violation );
+        SchemaViolation streamed;
+        JsonReader reader( text );
+        bool const stream = schema.validate( reader, &streamed );
+        EXPECT_EQ( tree, stream ) << text;
+        if ( violation && not tree ) {
+            EXPECT_EQ( violation->instance_path, streamed.instance_path ) << text;
+        }
+        return tree;
+    }
+}
+
+TEST( JsrlSchema,Types ) {
+    CompiledSchema schema( R"JSON({"type": ["integer", "string"]})JSON"_Json );
+    EXPECT_TRUE( valid( schema, "3" ) );
+    EXPECT_TRUE( valid( schema, "3.0" ) );
+    EXPECT_TRUE( valid( schema, "\"x\"" ) );
+    EXPECT_FALSE( valid( schema, "3.5" ) );
+    EXPECT_FALSE( valid( schema, "null" ) );
+    EXPECT_FALSE( valid( schema, "[]" ) );
+
+    CompiledSchema number( R"JSON({"type": "number"})JSON"_Json );
+    EXPECT_TRUE( valid( number, "-7" ) );
+    EXPECT_TRUE( valid( number, "1e400" ) );
+    EXPECT_FALSE( valid( number, "true" ) );
+
+    EXPECT_TRUE( valid( CompiledSchema( Json( true ) ), "{}" ) );
+    EXPECT_FALSE( valid( CompiledSchema( Json( false ) ), "{}" ) );
+}
+
+TEST( JsrlSchema,Scalars ) {
+    CompiledSchema schema( R"JSON({
+        "properties": {
+            "n": {"minimum": 1, "exclusiveMaximum": 10, "multipleOf": 0.5},
+            "s": {"minLength": 2, "maxLength": 3, "pattern": "^[a-zé]+$"},
+            "e": {"enum": [1, "one", [1]]},
+            "c": {"const": {"a": 1}}
+        }
+    })JSON"_Json );
+    EXPECT_TRUE( valid( schema, R"JSON({"n": 9.5, "s": "éé", "e": [1], "c": {"a": 1.0}})JSON" ) );
+    EXPECT_FALSE( valid( schema, R"JSON({"n": 0.5})JSON" ) );
+    EXPECT_FALSE( valid( schema, R"JSON({"n": 10})JSON" ) );
+    EXPECT_FALSE( valid( schema, R"JSON({"n": 1.2})JSON" ) );
+    EXPECT_FALSE( valid( schema, R"JSON({"s": "é"})JSON" ) );
+    EXPECT_FALSE( valid( schema, R"JSON({"s": "abcd"})JSON" ) );
+    EXPECT_FALSE( valid( schema, R"JSON({"s": "aB"})JSON" ) );
+    EXPECT_FALSE( valid( schema, R"JSON({"e": 2})JSON" ) );
+    EXPECT_FALSE( valid( schema, R"JSON({"c": {"a": 2}})JSON" ) );
+    // Numbers compare exactly, beyond the range of doubles.
+    CompiledSchema big( R"JSON({"maximum": 18446744073709551615})JSON"_Json );
+    EXPECT_TRUE( valid( big, "18446744073709551615" ) );
+    EXPECT_FALSE( valid( big, "18446744073709551616" ) );
+    // Integer multiples are exact.
+    CompiledSchema multiple( R"JSON({"multipleOf": 3})JSON"_Json );
+    EXPECT_TRUE( valid( multiple, "-9223372036854775806" ) );
+    EXPECT_FALSE( valid( multiple, "9223372036854775807" ) );
+}
+
+TEST( JsrlSchema,Objects ) {
+    CompiledSchema schema( R"JSON({
+        "type": "object",
+        "required": ["id", "name"],
+        "properties": {"id": {"type": "integer"}, "name": {"type": "string"}},
+        "patternProperties": {"^x-": {"type": "boolean"}},
+        "additionalProperties": false,
+        "maxProperties": 3
+    })JSON"_Json );
+    EXPECT_TRUE( valid( schema, R"JSON({"name": "a", "id": 1})JSON" ) );
+    EXPECT_TRUE( valid( schema, R"JSON({"id": 1, "x-y": true, "name": "a"})JSON" ) );
+    SchemaViolation violation;
+    EXPECT_FALSE( valid( schema, R"JSON({"name": "a"})JSON", &violation ) );
+    EXPECT_EQ( "required", violation.keyword );
+    EXPECT_EQ( "", violation.instance_path );
+    EXPECT_FALSE( valid( schema, R"JSON({"id": 1, "name": "a", "x-y": 1})JSON",
+                &violation ) );
+    EXPECT_EQ( "type", violation.keyword );
+    EXPECT_EQ( "/x-y", violation.instance_path );
+    EXPECT_FALSE( valid( schema, R"JSON({"id": 1, "name": "a", "z": 1})JSON",
+                &violation ) );
+    EXPECT_EQ( "false", violation.keyword );
+    EXPECT_EQ( "/z", violation.instance_path );
+    EXPECT_FALSE( valid( schema,
+                R"JSON({"id": 1, "name": "a", "x-a": true, "x-b": true})JSON",
+                &violation ) );
+    EXPECT_EQ( "maxProperties", violation.keyword );
+}
+
+TEST( JsrlSchema,Arrays ) {
+    CompiledSchema schema( R"JSON({
+        "prefixItems": [{"type": "string"}],
+        "items": {"type": "number"},
+        "minItems": 1,
+        "maxItems": 3
+    })JSON"_Json );
+    EXPECT_TRUE( valid( schema, R"JSON(["a", 1, 2])JSON" ) );
+    SchemaViolation violation;
+    EXPECT_FALSE( valid( schema, R"JSON(["a", 1, "b"])JSON", &violation ) );
+    EXPECT_EQ( "/2", violation.instance_path );
+    EXPECT_FALSE( valid( schema, "[]" ) );
+    EXPECT_FALSE( valid( schema, R"JSON(["a", 1, 2, 3])JSON" ) );
+
+    CompiledSchema unique( R"JSON({"uniqueItems": true})JSON"_Json );
+    EXPECT_TRUE( valid( unique, R"JSON([1, "1", [1]])JSON" ) );
+    EXPECT_FALSE( valid( unique, R"JSON([{"a": 1}, 2, {"a": 1.0}])JSON" ) );
+}
+
+TEST( JsrlSchema,Combinators ) {
+    CompiledSchema schema( R"JSON({
+        "allOf": [{"type": "integer"}, {"minimum": 0}],
+        "anyOf": [{"maximum": 10}, {"multipleOf": 100}],
+        "oneOf": [{"multipleOf": 2}, {"multipleOf": 3}],
+        "not": {"const": 300}
+    })JSON"_Json );
+    EXPECT_TRUE( valid( schema, "4" ) );
+    EXPECT_TRUE( valid( schema, "200" ) );
+    EXPECT_FALSE( valid( schema, "6" ) );
+    EXPECT_FALSE( valid( schema, "14" ) );
+    EXPECT_FALSE( valid( schema, "-2" ) );
+    EXPECT_FALSE( valid( schema, "300" ) );
+}
+
+TEST( JsrlSchema,Refs ) {
+    CompiledSchema schema( R"JSON({
+        "$defs": {
+            "node": {
+                "type": "object",
+                "required": ["value"],
+                "properties": {
+                    "value": {"$ref": "#/$defs/val~1ue"},
+                    "children": {"type": "array", "items": {"$ref": "#/$defs/node"}}
+                }
+            },
+            "val/ue": {"$anchor": "v", "type": "integer"}
+        },
+        "properties": {"root": {"$ref": "#/$defs/node"}, "v": {"$ref": "#v"}}
+    })JSON"_Json );
+    EXPECT_TRUE( valid( schema,
+                R"JSON({"root": {"value": 1, "children": [{"value": 2}]}, "v": 3})JSON" ) );
+    SchemaViolation violation;
+    EXPECT_FALSE( valid( schema,
+                R"JSON({"root": {"value": 1, "children": [{"value": 2}, {}]}})JSON",
+                &violation ) );
+    EXPECT_EQ( "/root/children/1", violation.instance_path );
+    EXPECT_EQ( "required", violation.keyword );
+    EXPECT_FALSE( valid( schema, R"JSON({"v": "3"})JSON" ) );
+
+    EXPECT_THROW( CompiledSchema( R"JSON({"$ref": "#/$defs/none"})JSON"_Json ),
+            SchemaError );
+    EXPECT_THROW( CompiledSchema( R"JSON({"$ref": "other.json"})JSON"_Json ),
+            SchemaError );
+    EXPECT_THROW( CompiledSchema( R"JSON({"type": "float"})JSON"_Json ),
+            SchemaError );
+    EXPECT_THROW( CompiledSchema( R"JSON({"pattern": "("})JSON"_Json ),
+            SchemaError );
+    // Loops that never descend into the instance.
+    EXPECT_THROW( CompiledSchema( R"JSON({"$defs": {"a": {"$ref": "#/$defs/a"}},
+                "$ref": "#/$defs/a"})JSON"_Json ), SchemaError );
+    EXPECT_THROW( CompiledSchema( R"JSON({"$defs": {"a": {"allOf": [{"$ref": "#"}]}},
+                "not": {"$ref": "#/$defs/a"}})JSON"_Json ), SchemaError );
+}
+
+TEST( JsrlSchema,StreamSkipsUnconstrained ) {
+    CompiledSchema schema( R"JSON({"properties": {"a": {"type": "string"}}})JSON"_Json );
+    JsonReader reader( R"JSON({"b": [1, {"c": 2}], "a": "x"} [1,)JSON" );
+    EXPECT_TRUE( schema.validate( reader ) );
+    EXPECT_EQ( 0u, reader.depth() );
+    EXPECT_EQ( JsonReader::TK_ARRAY, reader.peek() );
+    EXPECT_THROW( schema.validate( reader ), Json::BadEOFParseError );
+}
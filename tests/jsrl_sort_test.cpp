@@ -0,0 +1,148 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+
+#include "jsrl_test_temp.hpp"
+#include "../src/jsrl_sort.hpp"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+    using jsrl::Json;
+    using jsrl::JsonPointer;
+    using jsrl::SortKey;
+    using jsrl::SortOptions;
+    using jsrl::SortStats;
+    using jsrl::sort_ndjson;
+    using std::string;
+    using std::vector;
+
+    string sort_text( string const &text, vector<SortKey> const &keys,
+            SortOptions const &options, SortStats *stats = nullptr ) {
+        std::istringstream in( text );
+        std::ostringstream out;
+        SortStats const done = sort_ndjson( *in.rdbuf(), out, keys, options );
+        if ( stats )
+            *stats = done;
+        return out.str();
+    }
+
+    vector<Json> lines( string const &text ) {
+        vector<Json> records;
+        std::istringstream in( text );
+        string line;
+        while ( std::getline( in, line ) )
+            records.push_back( Json::parse( line ) );
+        return records;
+    }
+}
+
+TEST(JsrlSort, InMemory) {
+    string const input =
+        "{\"k\":\"b\",\"n\":1}\n"
+        "\n"
+        "{\"k\":\"a\",\"n\":2}\n"
+        "{\"n\":3}\n"
+        "{\"k\":\"b\",\"n\":0}\n";
+    SortStats stats;
+    string const sorted = sort_text( input, { { JsonPointer( "/k" ) } },
+            SortOptions(), &stats );
+    // Missing keys read as null, which orders first; ties keep input order.
+    EXPECT_EQ( sorted,
+        "{\"n\":3}\n"
+        "{\"k\":\"a\",\"n\":2}\n"
+        "{\"k\":\"b\",\"n\":1}\n"
+        "{\"k\":\"b\",\"n\":0}\n" );
+    EXPECT_EQ( stats.records, 4u );
+    EXPECT_EQ( stats.runs, 0u );
+    EXPECT_EQ( stats.spilled_bytes, 0u );
+}
+
+TEST(JsrlSort, KeysCompareLikeJson) {
+    string const input =
+        "{\"v\":10}\n"
+        "{\"v\":9.5}\n"
+        "{\"v\":-3}\n"
+        "{\"v\":\"10\"}\n"
+        "{\"v\":\"9\"}\n"
+        "{\"v\":1e1}\n";
+    string const sorted = sort_text( input, { { JsonPointer( "/v" ) } },
+            SortOptions() );
+    vector<Json> records = lines( input );
+    std::stable_sort( records.begin(), records.end(),
+            []( Json const &lhs, Json const &rhs ) { return lhs["v"] < rhs["v"]; } );
+    EXPECT_EQ( lines( sorted ), records );
+}
+
+TEST(JsrlSort, SpillsAndMerges) {
+    TempDirectory temp;
+    string input;
+    vector<Json> records;
+    for ( int i = 0; i != 2000; ++i ) {
+        string const line = "{\"group\":" + std::to_string( ( i * 7 ) % 13 )
+                + ",\"time\":" + std::to_string( ( i * 31 ) % 101 )
+                + ",\"seq\":" + std::to_string( i ) + "}";
+        input += line + "\n";
+        records.push_back( Json::parse( line ) );
+    }
+    SortOptions options;
+    options.threads = 3;
+    options.run_bytes = 1000;
+    options.merge_width = 4;
+    options.temp_directory = temp.path.string();
+    SortStats stats;
+    string const sorted = sort_text( input,
+            { { JsonPointer( "/group" ) }, { JsonPointer( "/time" ), true } },
+            options, &stats );
+
+    std::stable_sort( records.begin(), records.end(),
+            []( Json const &lhs, Json const &rhs ) {
+                if ( lhs["group"] != rhs["group"] )
+                    return lhs["group"] < rhs["group"];
+                return rhs["time"] < lhs["time"];
+            } );
+    EXPECT_EQ( lines( sorted ), records );
+    EXPECT_EQ( stats.records, 2000u );
+    EXPECT_GT( stats.runs, 16u );
+    EXPECT_GE( stats.merge_passes, 2u );
+    EXPECT_GT( stats.spilled_bytes, input.size() );
+    EXPECT_TRUE( temp.empty() );
+}
+
+TEST(JsrlSort, InvalidRecords) {
+    TempDirectory temp;
+    string input;
+    for ( int i = 0; i != 200; ++i )
+        input += i == 150 ? "{\"k\":\n" : "{\"k\":" + std::to_string( 200 - i ) + "}\n";
+    SortOptions options;
+    options.threads = 2;
+    options.run_bytes = 100;
+    options.temp_directory = temp.path.string();
+    EXPECT_THROW( sort_text( input, { { JsonPointer( "/k" ) } }, options ),
+            Json::ParseError );
+    EXPECT_TRUE( temp.empty() );
+
+    options.skip_invalid = true;
+    SortStats stats;
+    vector<Json> const sorted = lines( sort_text( input, { { JsonPointer( "/k" ) } },
+                options, &stats ) );
+    EXPECT_EQ( stats.records, 199u );
+    EXPECT_EQ( stats.invalid, 1u );
+    ASSERT_EQ( sorted.size(), 199u );
+    EXPECT_EQ( sorted.front()["k"].as_number_sint(), 1 );
+    EXPECT_EQ( sorted.back()["k"].as_number_sint(), 200 );
+    EXPECT_TRUE( temp.empty() );
+}
+
+// vi: et ts=4 sts=4 sw=4
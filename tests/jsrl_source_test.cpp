@@ -0,0 +1,219 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+
+#include "../src/jsrl_source.hpp"
+#include "../src/jsrl_mod.hpp"
+#include <gtest/gtest.h>
+#include <string>
+
+namespace {
+    using namespace jsrl::literals;
+    using jsrl::Json;
+    using jsrl::SourceDocument;
+    using jsrl::SourceEdit;
+    using std::string;
+
+    // Apply an edit to a text, reparse, and check against a full parse.
+    SourceDocument apply_edit(
+            SourceDocument const &doc,
+            string &text,
+            size_t begin,
+            size_t end,
+            string const &insert
+            ) {
+        text.replace( begin, end - begin, insert );
+        SourceDocument result = doc.reparse(
+                text, SourceEdit{ begin, end, insert.size() } );
+        EXPECT_EQ( Json::parse( text ), result.root() );
+        auto span = result.spans().find( result.root() );
+        EXPECT_TRUE( span );
+        if ( span ) {
+            EXPECT_EQ( text.substr( span->begin, span->size() ),
+                    result.encode_spliced( result.root() ) );
+        }
+        return result;
+    }
+
+    string const config_text = R"JSON({
+    // Service configuration
+    "server": { "host": "example.org", "port": 8080 },
+    "limits": [ 1.50, 2E+3, 3 ],   /* tuned by hand */
+    "name":   "svc"
+}
+)JSON";
+}
+
+TEST( JsrlSource,SpansCoverElements ) {
+    SourceDocument doc( config_text );
+    auto &&root = doc.root();
+    auto span = doc.spans().find( root["server"]["port"] );
+    ASSERT_TRUE( span );
+    EXPECT_EQ( "8080", doc.text().substr( span->begin, span->size() ) );
+    span = doc.spans().find( root["limits"] );
+    ASSERT_TRUE( span );
+    EXPECT_EQ( "[ 1.50, 2E+3, 3 ]",
+            doc.text().substr( span->begin, span->size() ) );
+    span = doc.spans().find( root );
+    ASSERT_TRUE( span );
+    EXPECT_EQ( 0u, span->begin );
+    EXPECT_EQ( config_text.size() - 1, span->end );
+    EXPECT_FALSE( doc.spans().find( Json( 8080 ) ) );
+}
+
+TEST( JsrlSource,UnchangedIsByteExact ) {
+    SourceDocument doc( config_text );
+    EXPECT_EQ( config_text.substr( 0, config_text.size() - 1 ),
+            doc.encode_spliced( doc.root() ) );
+}
+
+TEST( JsrlSource,ChangedValueKeepsRest ) {
+    SourceDocument doc( config_text );
+    Json edited = doc.root();
+    mod(edited)["server"]["port"] = 8443;
+    EXPECT_EQ( R"JSON({
+    // Service configuration
+    "server": { "host": "example.org", "port": 8443 },
+    "limits": [ 1.50, 2E+3, 3 ],   /* tuned by hand */
+    "name":   "svc"
+})JSON", doc.encode_spliced( edited ) );
+}
+
+TEST( JsrlSource,ChangedArrayElement ) {
+    SourceDocument doc( config_text );
+    Json edited = doc.root();
+    mod(edited)["limits"][2] = "three";
+    EXPECT_EQ( R"JSON({
+    // Service configuration
+    "server": { "host": "example.org", "port": 8080 },
+    "limits": [ 1.50, 2E+3, "three" ],   /* tuned by hand */
+    "name":   "svc"
+})JSON", doc.encode_spliced( edited ) );
+}
+
+TEST( JsrlSource,AddedKeyReencodesContainer ) {
+    SourceDocument doc( config_text );
+    Json edited = doc.root();
+    mod(edited)["server"]["tls"] = true;
+    EXPECT_EQ( R"JSON({
+    // Service configuration
+    "server": {"host":"example.org","port":8080,"tls":true},
+    "limits": [ 1.50, 2E+3, 3 ],   /* tuned by hand */
+    "name":   "svc"
+})JSON", doc.encode_spliced( edited ) );
+}
+
+TEST( JsrlSource,ShortenedArrayKeepsElementText ) {
+    SourceDocument doc( config_text );
+    Json edited = doc.root();
+    mod(edited)["limits"][0].erase();
+    EXPECT_EQ( R"JSON({
+    // Service configuration
+    "server": { "host": "example.org", "port": 8080 },
+    "limits": [2E+3,3],   /* tuned by hand */
+    "name":   "svc"
+})JSON", doc.encode_spliced( edited ) );
+}
+
+TEST( JsrlSource,ReplacedRootReusesChildren ) {
+    SourceDocument doc( config_text );
+    Json edited = Json::ObjectBody{
+        { "limits", doc.root()["limits"] },
+        { "renamed", doc.root()["name"] },
+    };
+    EXPECT_EQ( R"JSON({"limits":[ 1.50, 2E+3, 3 ],"renamed":"svc"})JSON",
+            doc.encode_spliced( edited ) );
+}
+
+TEST( JsrlSource,NullsAreDistinct ) {
+    SourceDocument doc( "[ null ,null]" );
+    Json edited = doc.root();
+    mod(edited)[1] = Json();
+    EXPECT_EQ( "[ null ,null]", doc.encode_spliced( edited ) );
+    mod(edited)[0] = 0;
+    EXPECT_EQ( "[ 0 ,null]", doc.encode_spliced( edited ) );
+}
+
+TEST( JsrlSource,DuplicateKeysFallBack ) {
+    SourceDocument doc( R"JSON({ "a": 1, "a": 2, "b": 3 })JSON" );
+    EXPECT_EQ( 2, doc.root()["a"].as_number_sint() );
+    Json edited = doc.root();
+    mod(edited)["b"] = 4;
+    EXPECT_EQ( R"JSON({ "a": 1, "a": 2, "b": 4 })JSON",
+            doc.encode_spliced( edited ) );
+}
+
+TEST( JsrlSource,ParseErrors ) {
+    EXPECT_THROW( SourceDocument( "[1,2" ), Json::ParseError );
+    EXPECT_THROW( SourceDocument( "[1,2] x" ), Json::ParseError );
+}
+
+TEST( JsrlSource,ReparseReusesUntouchedElements ) {
+    string text = R"JSON({"a": [1, 2, {"x": 10}], "b": {"c": [3]}})JSON";
+    SourceDocument doc( text );
+    size_t const at = text.find( "10" );
+    SourceDocument edited = apply_edit( doc, text, at, at + 2, "1234" );
+    EXPECT_EQ( 1234, edited.root()["a"][2]["x"].as_number_sint() );
+    EXPECT_EQ( doc.root()["b"].identity(), edited.root()["b"].identity() );
+    EXPECT_EQ( doc.root()["a"][0].identity(), edited.root()["a"][0].identity() );
+    EXPECT_NE( doc.root()["a"].identity(), edited.root()["a"].identity() );
+    auto span = edited.spans().find( edited.root()["b"]["c"] );
+    ASSERT_TRUE( span );
+    EXPECT_EQ( "[3]", edited.text().substr( span->begin, span->size() ) );
+    EXPECT_FALSE( edited.spans().find( doc.root()["a"] ) );
+    EXPECT_FALSE( edited.spans().find( doc.root()["a"][2]["x"] ) );
+}
+
+TEST( JsrlSource,ReparseFallsBackToParent ) {
+    string text = R"JSON({"a": [1, 2], "b": [3]})JSON";
+    SourceDocument doc( text );
+    size_t const at = text.find( "2" );
+    SourceDocument edited
+            = apply_edit( doc, text, at, at + 1, R"JSON(2], "c": [4)JSON" );
+    EXPECT_EQ( 4, edited.root()["c"][0].as_number_sint() );
+    EXPECT_EQ( 2u, edited.root()["a"].as_array().size() );
+}
+
+TEST( JsrlSource,ReparseWholeDocument ) {
+    string text = "[1, 2]";
+    SourceDocument doc( text );
+    SourceDocument edited = apply_edit( doc, text, 0, 0, "  " );
+    EXPECT_EQ( 2u, edited.spans().find( edited.root() )->begin );
+    edited = apply_edit( edited, text, 8, 8, " /* done */" );
+    EXPECT_EQ( 2u, edited.root().as_array().size() );
+}
+
+TEST( JsrlSource,ReparseManyEdits ) {
+    string text = R"JSON({"log": [], "meta": {"n": 0}})JSON";
+    SourceDocument doc( text );
+    for ( int i = 0; i != 40; ++i ) {
+        size_t const at = text.find( ']' );
+        doc = apply_edit( doc, text, at, at,
+                ( i ? ", " : "" ) + std::to_string( i ) );
+    }
+    EXPECT_EQ( 40u, doc.root()["log"].as_array().size() );
+    EXPECT_LE( doc.spans().depth(), 17u );
+}
+
+TEST( JsrlSource,ReparseErrors ) {
+    string text = R"JSON({"a": [1, 2]})JSON";
+    SourceDocument doc( text );
+    string broken = text;
+    broken.replace( 7, 0, "/*" );
+    EXPECT_THROW( doc.reparse( broken, SourceEdit{ 7, 7, 2 } ),
+            Json::ParseError );
+    EXPECT_THROW( doc.reparse( broken, SourceEdit{ 7, 7, 3 } ),
+            jsrl::SourceEditError );
+    EXPECT_THROW( doc.reparse( broken, SourceEdit{ 7, 99, 2 } ),
+            jsrl::SourceEditError );
+}
+
+// vi: et ts=4 sts=4 sw=4
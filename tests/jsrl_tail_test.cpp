@@ -0,0 +1,174 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+
+#include "jsrl_test_temp.hpp"
+#include "../src/jsrl_tail.hpp"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    using namespace std::chrono;
+    using namespace jsrl::literals;
+    using jsrl::Json;
+    using jsrl::NdjsonTailReader;
+    using jsrl::TailCheckpoint;
+    using jsrl::TailOptions;
+    using std::string;
+    using std::vector;
+
+    // A file to follow, and the name it is rotated to.
+    struct TailFile : TempPath {
+        TailFile() { remove_rotated(); }
+        ~TailFile() { remove_rotated(); }
+
+        void append( string const &text ) const {
+            std::ofstream( path, std::ios::binary | std::ios::app ) << text;
+        }
+
+    private:
+        void remove_rotated() const {
+            std::remove( ( path + ".1" ).c_str() );
+        }
+    };
+
+    milliseconds const no_wait( 0 );
+
+    // Records available now, without waiting.
+    vector<Json> drain( NdjsonTailReader &tail ) {
+        vector<Json> records;
+        Json record;
+        while ( tail.next( record, no_wait ) )
+            records.push_back( record );
+        return records;
+    }
+
+    TailOptions polling() {
+        TailOptions options;
+        options.use_inotify = false;
+        options.poll_interval = milliseconds( 5 );
+        return options;
+    }
+}
+
+TEST( JsrlTail,PartialLines ) {
+    TailFile file;
+    NdjsonTailReader tail( file.path );
+    // The file doesn't exist yet.
+    EXPECT_TRUE( drain( tail ).empty() );
+    file.append( "{\"a\":1}\n{\"a\"" );
+    EXPECT_EQ( ( vector<Json>{ R"({"a":1})"_Json } ), drain( tail ) );
+    EXPECT_EQ( 0u, tail.record_offset() );
+    EXPECT_EQ( 8u, tail.checkpoint().offset );
+    file.append( ":2}\r\n\n" );
+    EXPECT_EQ( ( vector<Json>{ R"({"a":2})"_Json } ), drain( tail ) );
+    EXPECT_EQ( 8u, tail.record_offset() );
+    EXPECT_EQ( 18u, tail.checkpoint().offset );
+}
+
+TEST( JsrlTail,Rotation ) {
+    TailFile file;
+    file.append( "1\n2\n" );
+    NdjsonTailReader tail( file.path, polling() );
+    EXPECT_EQ( ( vector<Json>{ 1, 2 } ), drain( tail ) );
+    // Written to the old file after it was renamed, without a newline.
+    file.append( "3" );
+    ASSERT_EQ( 0, std::rename( file.path.c_str(), ( file.path + ".1" ).c_str() ) );
+    std::ofstream( file.path + ".1", std::ios::binary | std::ios::app ) << "4";
+    file.append( "5\n" );
+    EXPECT_EQ( ( vector<Json>{ 34, 5 } ), drain( tail ) );
+    EXPECT_EQ( 1u, tail.rotations() );
+    EXPECT_EQ( 0u, tail.record_offset() );
+}
+
+TEST( JsrlTail,Truncation ) {
+    TailFile file;
+    file.append( "\"one\"\n\"two\"\n" );
+    NdjsonTailReader tail( file.path, polling() );
+    EXPECT_EQ( 2u, drain( tail ).size() );
+    std::ofstream( file.path, std::ios::binary | std::ios::trunc ) << "\"x\"\n";
+    EXPECT_EQ( ( vector<Json>{ "x" } ), drain( tail ) );
+    EXPECT_EQ( 1u, tail.truncations() );
+}
+
+TEST( JsrlTail,Checkpoints ) {
+    TailFile file;
+    file.append( "1\n2\n3\n" );
+    TailCheckpoint saved;
+    {
+        NdjsonTailReader tail( file.path );
+        Json record;
+        ASSERT_TRUE( tail.next( record, no_wait ) );
+        ASSERT_TRUE( tail.next( record, no_wait ) );
+        saved = tail.checkpoint();
+    }
+    file.append( "4\n" );
+    NdjsonTailReader resumed( file.path, TailOptions(), saved );
+    EXPECT_EQ( ( vector<Json>{ 3, 4 } ), drain( resumed ) );
+
+    // A checkpoint of another file is ignored.
+    TailCheckpoint other = saved;
+    ++other.inode;
+    NdjsonTailReader restarted( file.path, TailOptions(), other );
+    EXPECT_EQ( 4u, drain( restarted ).size() );
+
+    TailOptions at_end;
+    at_end.start_at_end = true;
+    NdjsonTailReader from_end( file.path, at_end );
+    file.append( "5\n" );
+    EXPECT_EQ( ( vector<Json>{ 5 } ), drain( from_end ) );
+}
+
+TEST( JsrlTail,InvalidRecords ) {
+    TailFile file;
+    file.append( "1\n{oops\n2\n" );
+    NdjsonTailReader strict( file.path );
+    Json record;
+    EXPECT_TRUE( strict.next( record, no_wait ) );
+    EXPECT_THROW( strict.next( record, no_wait ), Json::ParseError );
+    EXPECT_TRUE( strict.next( record, no_wait ) );
+    EXPECT_EQ( 2, record );
+
+    TailOptions options;
+    options.skip_invalid = true;
+    NdjsonTailReader lenient( file.path, options );
+    EXPECT_EQ( ( vector<Json>{ 1, 2 } ), drain( lenient ) );
+    EXPECT_EQ( 1u, lenient.invalid() );
+}
+
+TEST( JsrlTail,WakesOnAppend ) {
+    for ( bool inotify : { true, false } ) {
+        TailFile file;
+        file.append( "" );
+        TailOptions options;
+        options.use_inotify = inotify;
+        options.poll_interval = milliseconds( inotify ? 10000 : 10 );
+        NdjsonTailReader tail( file.path, options );
+        std::thread writer( [&] {
+                std::this_thread::sleep_for( milliseconds( 50 ) );
+                file.append( "{\"late\":true}\n" );
+            } );
+        auto const start = steady_clock::now();
+        Json record;
+        EXPECT_TRUE( tail.next( record, seconds( 5 ) ) );
+        EXPECT_LT( steady_clock::now() - start, seconds( 2 ) );
+        writer.join();
+        EXPECT_EQ( R"({"late":true})"_Json, record );
+        EXPECT_FALSE( tail.next( record, milliseconds( 20 ) ) );
+    }
+}
+
+// vi: et ts=4 sts=4 sw=4
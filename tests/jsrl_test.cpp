@@ -1795,4 +1795,81 @@ TEST(Jsrl,Comparator) {
     ct.add(__LINE__,false,"{\"foo\":[null]}");
     ct();
 }
+
+TEST(Jsrl,LazyNumbersMatchEagerTypes) {
+    static char const *const inputs[] = {
+            "0", "-0", "1", "-1", "1234", "-1234.5e-1", "1.50", "1e2",
+            "9223372036854775807", "-9223372036854775808",
+            "-9223372036854775809", "18446744073709551615",
+            "18446744073709551616", "123456789012345678901234567890",
+            "3.14159265358979323846264338327950288",
+            "0.1", "1e400", "-2.5e-4000",
+        };
+    for ( bool use_GN : { false, true } ) {
+        for ( char const *input : inputs ) {
+            Json const eager = Json::parse( input,
+                    Json::ParseOptions( use_GN ) );
+            Json const lazy = Json::parse( input,
+                    Json::ParseOptions( use_GN, true ) );
+            EXPECT_EQ( eager.get_typetag(true), lazy.get_typetag(true) )
+                    << input;
+            EXPECT_EQ( eager, lazy ) << input;
+            if ( eager.is_number_uint() ) {
+                EXPECT_EQ( eager.as_number_uint(), lazy.as_number_uint() );
+            }
+            if ( eager.is_number_integer() ) {
+                EXPECT_EQ( eager.as_number_sint(), lazy.as_number_sint() );
+            }
+            EXPECT_EQ( eager.as_number_float(), lazy.as_number_float() )
+                    << input;
+            EXPECT_EQ( *eager.as_number_general(), *lazy.as_number_general() )
+                    << input;
+        }
+    }
+}
+
+TEST(Jsrl,LazyNumbersEncodeVerbatim) {
+    auto const text = string(
+            R"JSON([1.50,-0,1E+2,12345678901234567890123,-7])JSON" );
+    Json const lazy = Json::parse( text, Json::ParseOptions( false, true ) );
+    EXPECT_EQ( text, encode( lazy ) );
+    // Only TN_EXACT copies the text.
+    auto const float_text = string( R"JSON([1.50,-0,1E+2,0.125e1,-7])JSON" );
+    ostringstream lazy_oss, eager_oss;
+    lazy_oss << loose_doubles( Json::parse( float_text,
+            Json::ParseOptions( false, true ) ) );
+    eager_oss << loose_doubles( Json::parse( float_text ) );
+    EXPECT_EQ( eager_oss.str(), lazy_oss.str() );
+}
+
+TEST(Jsrl,LazyNumbersCompare) {
+    Json const lazy = Json::parse( R"JSON([5,5.0,-5,5e0])JSON",
+            Json::ParseOptions( true, true ) );
+    EXPECT_EQ( Json(5), lazy[0] );
+    EXPECT_LT( lazy[0], lazy[1] );
+    EXPECT_LT( lazy[2], lazy[0] );
+    EXPECT_EQ( lazy[1], lazy[3] );
+    EXPECT_EQ( lazy, R"JSON([5,5.0,-5,5.0])JSON"_Json );
+}
+
+TEST(Jsrl,LazyNumbersParseErrors) {
+    static char const *const bad_inputs[] = {
+            "-", "01", "1.", "1.e5", "1e", "1e+", "-01.5", "[1.x]",
+            "1e99999",
+        };
+    for ( char const *input : bad_inputs ) {
+        EXPECT_THROW( Json::parse( input, Json::ParseOptions( false, true ) ),
+                Json::ParseError ) << input;
+    }
+}
+
+TEST(Jsrl,LazyNumbersOptionedParse) {
+    istringstream iss( R"JSON({"a":[1,2.25]})JSON" );
+    Json json;
+    iss >> lazy_numbers( json );
+    ASSERT_TRUE( iss );
+    EXPECT_PRED1( is_number_uint, json["a"][0] );
+    EXPECT_PRED1( is_number_float, json["a"][1] );
+    EXPECT_EQ( 2.25L, json["a"][1].as_number_float() );
+}
 // vi: et ts=4 sts=4 sw=4
@@ -0,0 +1,76 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+#ifndef JSRL_TEST_TEMP_HPP_2D8F61B4C7A3E95018F4B6D2C0E79A13
+#define JSRL_TEST_TEMP_HPP_2D8F61B4C7A3E95018F4B6D2C0E79A13
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <string>
+#include <system_error>
+
+namespace jsrl_test_temp_impl {
+    namespace fs = std::filesystem;
+    using std::string;
+
+    // Temporary name for the running test, unique across test programs.
+    inline string test_temp_name( string const &suffix ) {
+        auto const *const test = ::testing::UnitTest::GetInstance()->current_test_info();
+        return ::testing::TempDir() + test->test_suite_name() + "_" + test->name() + suffix;
+    }
+
+    // A file path for the running test, removed before and after.
+    struct TempPath {
+        TempPath()
+            : path( test_temp_name( ".ndjson" ) )
+        {
+            remove();
+        }
+        ~TempPath() { remove(); }
+        TempPath( TempPath const & ) = delete;
+        TempPath &operator=( TempPath const & ) = delete;
+
+        string const path;
+
+    private:
+        void remove() const {
+            std::error_code ignored;
+            fs::remove( path, ignored );
+        }
+    };
+
+    // An empty directory for the running test, removed with what's in it.
+    struct TempDirectory {
+        TempDirectory()
+            : path( test_temp_name( ".d" ) )
+        {
+            fs::remove_all( path );
+            fs::create_directories( path );
+        }
+        ~TempDirectory() {
+            std::error_code ignored;
+            fs::remove_all( path, ignored );
+        }
+        TempDirectory( TempDirectory const & ) = delete;
+        TempDirectory &operator=( TempDirectory const & ) = delete;
+
+        bool empty() const {
+            return fs::is_empty( path );
+        }
+
+        fs::path const path;
+    };
+}
+using jsrl_test_temp_impl::TempDirectory;
+using jsrl_test_temp_impl::TempPath;
+
+#endif
+// vi: et ts=4 sts=4 sw=4
@@ -0,0 +1,485 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+
+/*! @file jsrl_codegen.cpp
+ *  @brief Generate specialized struct parsers and encoders from a JSON shape.
+ *
+ *  Usage:
+ *  @code
+ *      jsrl_codegen [--example] [--namespace NS] NAME INPUT OUTPUT
+ *  @endcode
+ *
+ *  INPUT is a JSON Schema (the @c type, @c properties, @c required,
+ *  and @c items keywords are used), or with @c --example,
+ *  a sample document whose shape is copied.
+ *  OUTPUT is a header defining a struct @c NAME (and one per nested object)
+ *  with @c jsrl::FieldCodec specializations,
+ *  so that @c jsrl::encode_fields and @c jsrl::decode_fields work on it.
+ *  The generated decoder switches on key length and then on key bytes,
+ *  and stores each value straight into its member.
+ */
+
+#include "jsrl.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+    using jsrl::Json;
+    using std::int64_t;
+    using std::ostream;
+    using std::size_t;
+    using std::string;
+    using std::uint64_t;
+    using std::vector;
+
+    struct CodegenError : std::runtime_error {
+        using std::runtime_error::runtime_error;
+    };
+
+    struct FieldModel {
+        string key;         // JSON key
+        string member;      // C++ member name
+        string type;        // C++ member type
+        bool required;
+    };
+
+    struct StructModel {
+        string name;
+        vector<FieldModel> fields;
+    };
+
+    bool is_keyword( string const &word ) {
+        static std::set<string> const keywords{
+            "alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand",
+            "bitor", "bool", "break", "case", "catch", "char", "char16_t",
+            "char32_t", "class", "compl", "const", "constexpr", "const_cast",
+            "continue", "decltype", "default", "delete", "do", "double",
+            "dynamic_cast", "else", "enum", "explicit", "export", "extern",
+            "false", "float", "for", "friend", "goto", "if", "inline", "int",
+            "long", "mutable", "namespace", "new", "noexcept", "not",
+            "not_eq", "nullptr", "operator", "or", "or_eq", "private",
+            "protected", "public", "register", "reinterpret_cast", "return",
+            "short", "signed", "sizeof", "static", "static_assert",
+            "static_cast", "struct", "switch", "template", "this",
+            "thread_local", "throw", "true", "try", "typedef", "typeid",
+            "typename", "union", "unsigned", "using", "virtual", "void",
+            "volatile", "wchar_t", "while", "xor", "xor_eq",
+        };
+        return keywords.count( word ) != 0;
+    }
+
+    // A C++ identifier for a JSON key.
+    string identifier( string const &key ) {
+        string result;
+        for ( char c : key ) {
+            result.push_back( std::isalnum( (unsigned char)( c ) ) ? c : '_' );
+        }
+        if ( result.empty() || std::isdigit( (unsigned char)( result[0] ) ) )
+            result.insert( 0, 1, '_' );
+        if ( is_keyword( result ) )
+            result.push_back( '_' );
+        return result;
+    }
+
+    // A C++ string literal holding exactly these bytes.
+    string cpp_literal( string const &bytes ) {
+        string result = "\"";
+        for ( char c : bytes ) {
+            unsigned char const u = c;
+            if ( c == '"' || c == '\\' ) {
+                result.push_back( '\\' );
+                result.push_back( c );
+            } else if ( u < 0x20 || u >= 0x7F ) {
+                // Octal, so that a following hex digit isn't absorbed.
+                result.push_back( '\\' );
+                result.push_back( char( '0' + ( ( u >> 6 ) & 7 ) ) );
+                result.push_back( char( '0' + ( ( u >> 3 ) & 7 ) ) );
+                result.push_back( char( '0' + ( u & 7 ) ) );
+            } else {
+                result.push_back( c );
+            }
+        }
+        result.push_back( '"' );
+        return result;
+    }
+
+    // A C++ case label for a byte.
+    string case_label( char c ) {
+        unsigned char const u = c;
+        if ( u >= 0x20 && u < 0x7F && c != '\'' && c != '\\' )
+            return string( "'" ) + c + "'";
+        return std::to_string( unsigned( u ) );
+    }
+
+    string json_key_text( string const &key ) {
+        string result;
+        Json::append_JSON_string( result, key );
+        return result;
+    }
+
+    // Builds struct models, innermost first.
+    struct ModelBuilder {
+        vector<StructModel> structs;
+        std::set<string> names;     // Every struct name handed out.
+        bool from_example;
+
+        string schema_type( Json const &schema, string const &name ) {
+            if ( not schema.is_object() )
+                return "::jsrl::Json";
+            Json const type = schema.get( "type" );
+            string single;
+            bool nullable = false;
+            if ( type.is_string() ) {
+                single = type.as_string();
+            } else if ( type.is_array() ) {
+                for ( auto &&t : type.as_array() ) {
+                    if ( not t.is_string() )
+                        return "::jsrl::Json";
+                    if ( t.as_string() == "null" ) {
+                        nullable = true;
+                    } else if ( single.empty() ) {
+                        single = t.as_string();
+                    } else {
+                        return "::jsrl::Json";
+                    }
+                }
+            } else if ( schema.has_key( "properties" ) ) {
+                single = "object";
+            } else {
+                return "::jsrl::Json";
+            }
+            string result;
+            if ( single == "boolean" ) {
+                result = "bool";
+            } else if ( single == "integer" ) {
+                Json const minimum = schema.get( "minimum" );
+                result = minimum.is_number() && minimum.as_number_float() >= 0
+                        ? "std::uint64_t"
+                        : "std::int64_t"
+                        ;
+            } else if ( single == "number" ) {
+                result = "double";
+            } else if ( single == "string" ) {
+                result = "std::string";
+            } else if ( single == "array" ) {
+                result = "std::vector<"
+                        + schema_type( schema.get( "items" ), name + "_item" )
+                        + ">";
+            } else if ( single == "object" ) {
+                Json const properties = schema.get( "properties" );
+                if ( not properties.is_object() )
+                    result = "::jsrl::Json";
+                else
+                    result = add_struct( name, properties,
+                            schema.get( "required" ) );
+            } else if ( single == "null" ) {
+                return "::jsrl::Json";
+            } else {
+                throw CodegenError( "Unknown schema type \"" + single + "\"" );
+            }
+            if ( nullable && result != "::jsrl::Json" )
+                result = "std::optional<" + result + ">";
+            return result;
+        }
+
+        string example_type( Json const &example, string const &name ) {
+            switch ( example.get_typetag( false ) ) {
+            case Json::TT_BOOL:
+                return "bool";
+            case Json::TT_NUMBER:
+                if ( not example.is_number_integer() )
+                    return "double";
+                if ( example.is_number_uint() && example.as_number_uint()
+                        > uint64_t( std::numeric_limits<int64_t>::max() ) )
+                    return "std::uint64_t";
+                return "std::int64_t";
+            case Json::TT_STRING:
+                return "std::string";
+            case Json::TT_ARRAY:
+                if ( example.as_array().empty() )
+                    return "std::vector<::jsrl::Json>";
+                return "std::vector<"
+                        + example_type( example[0], name + "_item" ) + ">";
+            case Json::TT_OBJECT:
+                return add_struct( name, example, Json() );
+            default:
+                return "::jsrl::Json";
+            }
+        }
+
+        // Add a struct for an object's properties (or example members).
+        // Nested structs are named after the path to them, which can
+        // still collide ("a_b" and "a" then "b"), so a name already
+        // taken gets a number.
+        string add_struct(
+                string const &wanted,
+                Json const &properties,
+                Json const &required
+                ) {
+            string name = wanted;
+            for ( int n = 2; not names.insert( name ).second; ++n )
+                name = wanted + "_" + std::to_string( n );
+            StructModel model;
+            model.name = name;
+            std::set<string> members;
+            for ( auto &&property : properties.as_object() ) {
+                FieldModel field;
+                field.key = property.first;
+                field.member = identifier( property.first );
+                while ( not members.insert( field.member ).second )
+                    field.member.push_back( '_' );
+                string const nested = name + "_" + field.member;
+                field.required = false;
+                if ( required.is_array() ) {
+                    for ( auto &&r : required.as_array() ) {
+                        if ( r.is_string() && r.as_string() == property.first )
+                            field.required = true;
+                    }
+                }
+                field.type = from_example
+                        ? example_type( property.second, nested )
+                        : schema_type( property.second, nested );
+                model.fields.push_back( std::move(field) );
+            }
+            if ( model.fields.empty() )
+                return "::jsrl::Json";
+            structs.push_back( std::move(model) );
+            return name;
+        }
+    };
+
+    // Emits the decoder's key dispatch: by length, then first byte.
+    void write_dispatch( ostream &os, StructModel const &model ) {
+        vector<size_t> order( model.fields.size() );
+        for ( size_t i = 0; i != order.size(); ++i )
+            order[i] = i;
+        std::stable_sort( order.begin(), order.end(),
+                [&]( size_t a, size_t b ) {
+                    string const &ka = model.fields[a].key;
+                    string const &kb = model.fields[b].key;
+                    if ( ka.size() != kb.size() )
+                        return ka.size() < kb.size();
+                    return ka < kb;
+                } );
+        os << "            char const *const k = key.data();\n"
+              "            switch ( key.size() ) {\n";
+        for ( size_t i = 0; i != order.size(); ) {
+            size_t const length = model.fields[ order[i] ].key.size();
+            os << "            case " << length << ":\n";
+            if ( length )
+                os << "                switch ( (unsigned char)( k[0] ) ) {\n";
+            while ( i != order.size()
+                    && model.fields[ order[i] ].key.size() == length ) {
+                char const first = length ? model.fields[ order[i] ].key[0] : 0;
+                if ( length ) {
+                    os << "                case " << case_label( first ) << ":\n";
+                }
+                while ( i != order.size()
+                        && model.fields[ order[i] ].key.size() == length
+                        && ( not length
+                            || model.fields[ order[i] ].key[0] == first ) ) {
+                    size_t const index = order[i];
+                    FieldModel const &field = model.fields[ index ];
+                    char const *const indent = length ? "    " : "";
+                    os << indent << "                if ( ";
+                    if ( length > 1 ) {
+                        os << "std::memcmp( k + 1, "
+                           << cpp_literal( field.key.substr( 1 ) ) << ", "
+                           << length - 1 << " ) == 0";
+                    } else {
+                        os << "true";
+                    }
+                    os << " ) {\n"
+                       << indent << "                    ::jsrl::read_fields( reader, value."
+                       << field.member << " );\n";
+                    if ( field.required ) {
+                        os << indent << "                    seen["
+                           << index << "] = true;\n";
+                    }
+                    os << indent << "                    continue;\n"
+                       << indent << "                }\n";
+                    ++i;
+                }
+                if ( length )
+                    os << "                    break;\n";
+            }
+            if ( length )
+                os << "                }\n";
+            os << "                break;\n";
+        }
+        os << "            }\n";
+    }
+
+    void write_struct( ostream &os, StructModel const &model ) {
+        os << "    struct " << model.name << " {\n";
+        for ( auto &&field : model.fields ) {
+            os << "        " << field.type << " " << field.member << "{};\n";
+        }
+        os << "    };\n\n";
+    }
+
+    void write_codec(
+            ostream &os,
+            StructModel const &model,
+            string const &qualified
+            ) {
+        os << "template<>\n"
+              "struct jsrl::FieldCodec<" << qualified << "> {\n"
+              "    static void write( std::string &out, "
+           << qualified << " const &value ) {\n";
+        bool first = true;
+        for ( auto &&field : model.fields ) {
+            string const prefix = ( first ? "{" : "," )
+                    + json_key_text( field.key ) + ":";
+            first = false;
+            os << "        out.append( " << cpp_literal( prefix ) << ", "
+               << prefix.size() << " );\n"
+               << "        ::jsrl::encode_fields_into( out, value."
+               << field.member << " );\n";
+        }
+        os << "        out.push_back( '}' );\n"
+              "    }\n"
+              "\n"
+              "    static void read( ::jsrl::JsonReader &reader, "
+           << qualified << " &value ) {\n";
+        bool any_required = false;
+        for ( auto &&field : model.fields )
+            any_required = any_required || field.required;
+        if ( any_required ) {
+            os << "        bool seen[" << model.fields.size() << "] = {};\n";
+        }
+        os << "        thread_local std::string key;\n"
+              "        reader.enter_object();\n"
+              "        while ( reader.next_key( key ) ) {\n";
+        write_dispatch( os, model );
+        os << "            reader.skip_value();\n"
+              "        }\n";
+        for ( size_t i = 0; i != model.fields.size(); ++i ) {
+            if ( not model.fields[i].required )
+                continue;
+            os << "        if ( not seen[" << i << "] )\n"
+                  "            throw ::jsrl::Json::ObjectKeyError( "
+               << cpp_literal( model.fields[i].key ) << " );\n";
+        }
+        os << "    }\n"
+              "};\n\n";
+    }
+
+    void write_header(
+            ostream &os,
+            vector<StructModel> const &structs,
+            string const &name,
+            string const &ns
+            ) {
+        string guard = "JSRL_GENERATED_";
+        for ( char c : ns + "_" + name )
+            guard.push_back( std::isalnum( (unsigned char)( c ) )
+                    ? char( std::toupper( (unsigned char)( c ) ) )
+                    : '_' );
+        guard += "_HPP";
+        os << "// Generated by jsrl_codegen; do not edit.\n"
+              "#ifndef " << guard << "\n"
+              "#define " << guard << "\n"
+              "\n"
+              "#include \"jsrl_fields.hpp\"\n"
+              "#include \"jsrl_reader.hpp\"\n"
+              "\n"
+              "#include <cstdint>\n"
+              "#include <cstring>\n"
+              "#include <optional>\n"
+              "#include <string>\n"
+              "#include <vector>\n"
+              "\n";
+        string const scope = ns.empty() ? "" : "::" + ns;
+        if ( not ns.empty() )
+            os << "namespace " << ns << " {\n";
+        for ( auto &&model : structs )
+            write_struct( os, model );
+        if ( not ns.empty() )
+            os << "}\n\n";
+        for ( auto &&model : structs )
+            write_codec( os, model, scope + "::" + model.name );
+        os << "#endif\n";
+    }
+
+    int usage() {
+        std::cerr << "usage: jsrl_codegen [--example] [--namespace NS]"
+                " NAME INPUT OUTPUT\n";
+        return 2;
+    }
+
+}
+
+int main( int argc, char **argv ) {
+    bool from_example = false;
+    string ns;
+    vector<string> positional;
+    for ( int i = 1; i < argc; ++i ) {
+        string const arg = argv[i];
+        if ( arg == "--example" ) {
+            from_example = true;
+        } else if ( arg == "--namespace" && i + 1 < argc ) {
+            ns = argv[++i];
+        } else if ( arg.size() > 1 && arg[0] == '-' ) {
+            return usage();
+        } else {
+            positional.push_back( arg );
+        }
+    }
+    if ( positional.size() != 3 )
+        return usage();
+    string const &name = positional[0];
+    if ( identifier( name ) != name ) {
+        std::cerr << "jsrl_codegen: bad struct name " << name << "\n";
+        return 2;
+    }
+    try {
+        std::ifstream in( positional[1], std::ios::binary );
+        if ( not in )
+            throw CodegenError( "cannot read " + positional[1] );
+        std::stringstream text;
+        text << in.rdbuf();
+        Json const input = Json::parse( text.str() );
+
+        ModelBuilder builder;
+        builder.from_example = from_example;
+        string const root = from_example
+                ? builder.example_type( input, name )
+                : builder.schema_type( input, name );
+        if ( root != name )
+            throw CodegenError( "the top level must be an object" );
+
+        std::ostringstream header;
+        write_header( header, builder.structs, name, ns );
+        std::ofstream out( positional[2], std::ios::binary );
+        out << header.str();
+        if ( not out.flush() )
+            throw CodegenError( "cannot write " + positional[2] );
+    } catch ( std::exception const &e ) {
+        std::cerr << "jsrl_codegen: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+// vi: et ts=4 sts=4 sw=4
@@ -0,0 +1,129 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+
+/*! @file jsrl_ndjson_index.cpp
+ *  @brief Build and use record offset indexes of NDJSON files.
+ *
+ *  Usage:
+ *  @code
+ *      jsrl_ndjson_index [--every N] [--output INDEX] INPUT
+ *      jsrl_ndjson_index [--index INDEX] --get K INPUT
+ *      jsrl_ndjson_index [--index INDEX] --split N INPUT
+ *  @endcode
+ *
+ *  The first form indexes INPUT, keeping every Nth record's offset,
+ *  and writes the index to INDEX (by default INPUT.idx).
+ *  @c --get prints record K (from 0),
+ *  and @c --split prints N or fewer ranges of about equal size,
+ *  one per line as: begin offset, end offset, first record, record count.
+ */
+
+#include "jsrl_ndjson.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+    using jsrl::NdjsonFile;
+    using jsrl::NdjsonIndex;
+    using std::string;
+    using std::uint64_t;
+
+    int usage() {
+        std::cerr << "usage: jsrl_ndjson_index [--every N] [--output INDEX] INPUT\n"
+                "       jsrl_ndjson_index [--index INDEX] --get K INPUT\n"
+                "       jsrl_ndjson_index [--index INDEX] --split N INPUT\n";
+        return 2;
+    }
+
+    bool parse_count( char const *text, uint64_t &value ) {
+        try {
+            size_t used;
+            value = std::stoull( text, &used );
+            return text[used] == '\0' && text[0] != '-';
+        } catch ( std::exception const & ) {
+            return false;
+        }
+    }
+
+    NdjsonIndex load_index( string const &path ) {
+        std::ifstream in( path, std::ios::binary );
+        if ( not in )
+            throw std::runtime_error( "cannot read " + path );
+        return NdjsonIndex::s_load( in );
+    }
+
+}
+
+int main( int argc, char **argv ) {
+    enum { BUILD, GET, SPLIT } mode = BUILD;
+    uint64_t every = 1;
+    uint64_t arg_count = 0;
+    string index_path;
+    string input;
+    for ( int i = 1; i < argc; ++i ) {
+        string const arg = argv[i];
+        if ( arg == "--every" && i + 1 < argc ) {
+            if ( not parse_count( argv[++i], every ) || every == 0 )
+                return usage();
+        } else if ( ( arg == "--output" || arg == "--index" ) && i + 1 < argc ) {
+            index_path = argv[++i];
+        } else if ( ( arg == "--get" || arg == "--split" ) && i + 1 < argc ) {
+            mode = arg == "--get" ? GET : SPLIT;
+            if ( not parse_count( argv[++i], arg_count ) )
+                return usage();
+        } else if ( arg.size() > 1 && arg[0] == '-' ) {
+            return usage();
+        } else if ( input.empty() ) {
+            input = arg;
+        } else {
+            return usage();
+        }
+    }
+    if ( input.empty() || ( mode == SPLIT && arg_count == 0 ) )
+        return usage();
+    if ( index_path.empty() )
+        index_path = input + ".idx";
+    try {
+        if ( mode == BUILD ) {
+            std::ifstream in( input, std::ios::binary );
+            if ( not in )
+                throw std::runtime_error( "cannot read " + input );
+            NdjsonIndex const index = NdjsonIndex::s_build( *in.rdbuf(), every );
+            std::ofstream out( index_path, std::ios::binary );
+            index.save( out );
+            if ( not out.flush() )
+                throw std::runtime_error( "cannot write " + index_path );
+            std::cout << index.records() << " records, "
+                    << index.data_size() << " bytes\n";
+        } else if ( mode == GET ) {
+            NdjsonIndex const index = load_index( index_path );
+            NdjsonFile const file( input );
+            std::cout << file.record( index, arg_count ) << "\n";
+        } else {
+            NdjsonIndex const index = load_index( index_path );
+            for ( auto &&range : index.split( size_t( arg_count ) ) ) {
+                std::cout << range.begin << " " << range.end << " "
+                        << range.first_record << " " << range.records << "\n";
+            }
+        }
+    } catch ( std::exception const &e ) {
+        std::cerr << "jsrl_ndjson_index: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+// vi: et ts=4 sts=4 sw=4
@@ -0,0 +1,127 @@
+/**
+ * Copyright 2026 Adobe. All rights reserved.
+ * This file is licensed to you under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain a copy
+ * of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software distributed under
+ * the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR REPRESENTATIONS
+ * OF ANY KIND, either express or implied. See the License for the specific language
+ * governing permissions and limitations under the License.
+ */
+
+/*! @file jsrl_ndjson_sort.cpp
+ *  @brief Sort NDJSON files by JSON field values.
+ *
+ *  Usage:
+ *  @code
+ *      jsrl_ndjson_sort (--key PATH | --desc PATH)... [--threads N]
+ *              [--run-bytes N] [--temp DIR] [--exact] [--skip-invalid]
+ *              [--output OUTPUT] INPUT
+ *  @endcode
+ *
+ *  Records are ordered by the value at each JSON Pointer PATH in turn,
+ *  ascending for @c --key and descending for @c --desc.
+ *  @c --exact compares numbers exactly as written,
+ *  and @c --skip-invalid drops records that aren't valid JSON.
+ *  The result goes to OUTPUT, or to the standard output.
+ */
+
+#include "jsrl_sort.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+    using std::string;
+    using std::uint64_t;
+
+    int usage() {
+        std::cerr << "usage: jsrl_ndjson_sort (--key PATH | --desc PATH)... [--threads N]\n"
+                "           [--run-bytes N] [--temp DIR] [--exact] [--skip-invalid]\n"
+                "           [--output OUTPUT] INPUT\n";
+        return 2;
+    }
+
+    bool parse_count( char const *text, uint64_t &value ) {
+        try {
+            size_t used;
+            value = std::stoull( text, &used );
+            return text[used] == '\0' && text[0] != '-';
+        } catch ( std::exception const & ) {
+            return false;
+        }
+    }
+
+}
+
+int main( int argc, char **argv ) {
+    std::vector<jsrl::SortKey> keys;
+    jsrl::SortOptions options;
+    string output_path;
+    string input;
+    try {
+        for ( int i = 1; i < argc; ++i ) {
+            string const arg = argv[i];
+            uint64_t count;
+            if ( ( arg == "--key" || arg == "--desc" ) && i + 1 < argc ) {
+                keys.push_back( jsrl::SortKey{
+                        jsrl::JsonPointer( argv[++i] ), arg == "--desc" } );
+            } else if ( arg == "--threads" && i + 1 < argc ) {
+                if ( not parse_count( argv[++i], count ) )
+                    return usage();
+                options.threads = size_t( count );
+            } else if ( arg == "--run-bytes" && i + 1 < argc ) {
+                if ( not parse_count( argv[++i], count ) || count == 0 )
+                    return usage();
+                options.run_bytes = size_t( count );
+            } else if ( arg == "--temp" && i + 1 < argc ) {
+                options.temp_directory = argv[++i];
+            } else if ( arg == "--exact" ) {
+                options.parse_options = jsrl::Json::ParseOptions( true );
+            } else if ( arg == "--skip-invalid" ) {
+                options.skip_invalid = true;
+            } else if ( arg == "--output" && i + 1 < argc ) {
+                output_path = argv[++i];
+            } else if ( arg.size() > 1 && arg[0] == '-' ) {
+                return usage();
+            } else if ( input.empty() ) {
+                input = arg;
+            } else {
+                return usage();
+            }
+        }
+    } catch ( jsrl::Json::Error const &e ) {
+        std::cerr << "jsrl_ndjson_sort: " << e.what() << "\n";
+        return usage();
+    }
+    if ( input.empty() || keys.empty() )
+        return usage();
+    try {
+        std::ifstream in( input, std::ios::binary );
+        if ( not in )
+            throw std::runtime_error( "cannot read " + input );
+        std::ofstream file;
+        if ( not output_path.empty() ) {
+            file.open( output_path, std::ios::binary );
+            if ( not file )
+                throw std::runtime_error( "cannot write " + output_path );
+        }
+        jsrl::SortStats const stats = jsrl::sort_ndjson( *in.rdbuf(),
+                output_path.empty() ? std::cout : file, keys, options );
+        std::cerr << stats.records << " records, " << stats.runs << " runs";
+        if ( stats.invalid )
+            std::cerr << ", " << stats.invalid << " invalid";
+        std::cerr << "\n";
+    } catch ( std::exception const &e ) {
+        std::cerr << "jsrl_ndjson_sort: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+// vi: et ts=4 sts=4 sw=4